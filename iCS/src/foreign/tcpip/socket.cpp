@@ -77,7 +77,10 @@ namespace tcpip
 		socket_(-1),
 		server_socket_(-1),
 		blocking_(true),
-		verbose_(false)
+		verbose_(false),
+		sentBytes_(0),
+		receivedBytes_(0),
+		receivedMessages_(0)
 	{
 		init();
 	}
@@ -90,7 +93,10 @@ namespace tcpip
 		socket_(-1),
 		server_socket_(-1),
 		blocking_(true),
-		verbose_(false)
+		verbose_(false),
+		sentBytes_(0),
+		receivedBytes_(0),
+		receivedMessages_(0)
 	{
 		init();
 	}
@@ -407,6 +413,7 @@ namespace tcpip
 		msg.insert(msg.end(), length_storage.begin(), length_storage.end());
 		msg.insert(msg.end(), b.begin(), b.end());
 		send(msg);
+		sentBytes_ += msg.size();
 	}
 
 
@@ -516,6 +523,8 @@ namespace tcpip
 		msg.reset();
 		msg.writePacket(&buffer[lengthLen], totalLen - lengthLen);
 		printBufferOnVerbose(buffer, "Rcvd Storage with");
+		receivedBytes_ += totalLen;
+		++receivedMessages_;
 
 		return true;
 	}
@@ -110,6 +110,13 @@ namespace tcpip
 		bool verbose() { return verbose_; }
 		void set_verbose(bool newVerbose) { verbose_ = newVerbose; }
 
+		/// Bytes sent with sendExact(), length prefix included
+		unsigned long long sentBytes() const { return sentBytes_; }
+		/// Bytes received with receiveExact(), length prefix included
+		unsigned long long receivedBytes() const { return receivedBytes_; }
+		/// Messages received with receiveExact(), i.e. request/reply round trips
+		unsigned long receivedMessages() const { return receivedMessages_; }
+
 	protected:
 		/// Length of the message length part of a TraCI message
 		static const int lengthLen;
@@ -137,6 +144,10 @@ namespace tcpip
 		bool blocking_;
 
 		bool verbose_;
+
+		unsigned long long sentBytes_;
+		unsigned long long receivedBytes_;
+		unsigned long receivedMessages_;
 #ifdef WIN32
 		static bool init_windows_sockets_;
 		static bool windows_sockets_initialized_;
@@ -65,6 +65,8 @@
 #include "ics/utilities.h"
 #include "utils/ics/log/ics-log.h"
 #include "ics/itetris-simulation-config.h"
+#include "ics/checkpoint.h"
+#include "ics/configfile_parsers/facilities-configfile-parser.h"
 
 #ifdef CHECK_MEMORY_LEAKS
 #include <foreign/nvwa/debug_new.h>
@@ -118,6 +120,15 @@ fillOptions()
     oc.doRegister("interactive", new Option_Bool(false));
     oc.addDescription("interactive", "Scenario", "Whether iCS shall be run in interactive mode");
 
+    oc.doRegister("checkpoint-step", new Option_Integer(-1));
+    oc.addDescription("checkpoint-step", "Scenario", "Saves a checkpoint at the end of the given timestep");
+
+    oc.doRegister("checkpoint-file", new Option_FileName());
+    oc.addDescription("checkpoint-file", "Scenario", "Defines the checkpoint file (SUMO saves its state to <FILE>.sumo.xml)");
+
+    oc.doRegister("restore-checkpoint", new Option_FileName());
+    oc.addDescription("restore-checkpoint", "Scenario", "Starts the simulation from the given checkpoint");
+
 
     // insert options for traffic simulation
     oc.doRegister("traffic-executable", new Option_String());
@@ -132,12 +143,18 @@ fillOptions()
     oc.doRegister("traffic-port", new Option_Integer());
     oc.addDescription("traffic-port", "TrafficSim", "Defines the port the traffic simulation shall use");
 
+    oc.doRegister("traffic-trace-record", new Option_FileName());
+    oc.addDescription("traffic-trace-record", "TrafficSim", "Records the traffic simulation to the given binary trace");
+
+    oc.doRegister("traffic-trace-replay", new Option_FileName());
+    oc.addDescription("traffic-trace-replay", "TrafficSim", "Replays the given traffic trace instead of running the traffic simulation. Only valid if the applications do not change the traffic");
+
     // insert options for communication simulation
     oc.doRegister("communication-executable", new Option_String());
     oc.addDescription("communication-executable", "CommunicationSim", "Defines the communication simulation executable");
 
     oc.doRegister("communication-host", new Option_String("localhost"));
-    oc.addDescription("communication-host", "CommunicationSim", "Defines the host the communication simulation shall run on");
+    oc.addDescription("communication-host", "CommunicationSim", "Defines the host the communication simulation shall run on (shm://<name> for a shared memory channel on this host)");
 
     oc.doRegister("communication-port", new Option_Integer());
     oc.addDescription("communication-port", "CommunicationSim", "Defines the port the communication simulation shall use");
@@ -169,6 +186,10 @@ fillOptions()
     oc.doRegister("ns3-log-path", new Option_FileName());
     oc.addDescription("ns3-log-path", "Logs", "Defines the place where the ns-3 log file will be stored");
 
+    // insert option for the per step statistics
+    oc.doRegister("step-statistics-output", new Option_FileName());
+    oc.addDescription("step-statistics-output", "Logs", "Writes the time of each phase, the traffic with each peer and the number of nodes, subscriptions and messages of every timestep (CSV, or JSON if the name ends with .json)");
+
     // add rand options
     RandHelper::insertRandOptions();
 }
@@ -203,23 +224,42 @@ checkOptions()
         ret = false;
     }
 
-#ifdef SUMO_ON
-    // sumo executable
-    if (!oc.isSet("traffic-executable")) {
-        MsgHandler::getErrorInstance()->inform("Missing definition of the traffic executable.");
+    // checkpoints
+    if (oc.getInt("checkpoint-step") >= 0 && !oc.isSet("checkpoint-file")) {
+        MsgHandler::getErrorInstance()->inform("Missing definition of the checkpoint file.");
         ret = false;
     }
 
-    // traffic scenario defintion file
-    if (!oc.isSet("traffic-file")) {
-        MsgHandler::getErrorInstance()->inform("Missing traffic simulation configuration file definition.");
+#ifdef SUMO_ON
+    if (oc.isSet("restore-checkpoint") && oc.isSet("traffic-trace-replay")) {
+        MsgHandler::getErrorInstance()->inform("A checkpoint cannot be restored while replaying a traffic trace.");
         ret = false;
     }
 
-    // check traffic simulation settings
-    if (!oc.isSet("traffic-port")) {
-        MsgHandler::getErrorInstance()->inform("Missing definition of the traffic simulation port to use.");
-        ret = false;
+    // a replayed trace takes the place of sumo
+    if (oc.isSet("traffic-trace-replay")) {
+        if (oc.isSet("traffic-trace-record")) {
+            MsgHandler::getErrorInstance()->inform("A traffic trace cannot be recorded while replaying one.");
+            ret = false;
+        }
+    } else {
+        // sumo executable
+        if (!oc.isSet("traffic-executable")) {
+            MsgHandler::getErrorInstance()->inform("Missing definition of the traffic executable.");
+            ret = false;
+        }
+
+        // traffic scenario defintion file
+        if (!oc.isSet("traffic-file")) {
+            MsgHandler::getErrorInstance()->inform("Missing traffic simulation configuration file definition.");
+            ret = false;
+        }
+
+        // check traffic simulation settings
+        if (!oc.isSet("traffic-port")) {
+            MsgHandler::getErrorInstance()->inform("Missing definition of the traffic simulation port to use.");
+            ret = false;
+        }
     }
 #endif
 
@@ -290,11 +330,29 @@ launchIcsThreadless()
 {
 
 	OptionsCont &oc = OptionsCont::getOptions();
-    ICS *ics = new ICS(oc.getInt("communication-port"), oc.getInt("traffic-port"), oc.getString("traffic-host"),
+    // The traffic communicator is chosen when the ICS is built
+    if (oc.isSet("traffic-trace-record")) {
+        ics::ITetrisSimulationConfig::m_trafficTraceRecordFile = oc.getString("traffic-trace-record");
+    }
+    if (oc.isSet("traffic-trace-replay")) {
+        ics::ITetrisSimulationConfig::m_trafficTraceReplayFile = oc.getString("traffic-trace-replay");
+    }
+    ics::ITetrisSimulationConfig::m_checkpointStep = oc.getInt("checkpoint-step");
+    if (oc.isSet("checkpoint-file")) {
+        ics::ITetrisSimulationConfig::m_checkpointFile = oc.getString("checkpoint-file");
+    }
+    if (oc.isSet("restore-checkpoint")) {
+        ics::ITetrisSimulationConfig::m_restoreCheckpointFile = oc.getString("restore-checkpoint");
+    }
+    int trafficPort = oc.isSet("traffic-port") ? oc.getInt("traffic-port") : 0;
+    ICS *ics = new ICS(oc.getInt("communication-port"), trafficPort, oc.getString("traffic-host"),
                        oc.getString("communication-host"), oc.getInt("begin"), oc.getInt("end"), oc.getInt("penetration-rate"),
                        oc.getBool("interactive"));
    // cout << "iCS --> Error occurred here" << endl;
     ics::ITetrisSimulationConfig::m_scheduleMessageCleanUp = oc.getInt("message-reception-window");
+    if (oc.isSet("step-statistics-output")) {
+        ics::ITetrisSimulationConfig::m_stepStatisticsFile = oc.getString("step-statistics-output");
+    }
     cout << "iCS --> Error occurred here e " << endl;
     if (ics->Setup(oc.getString("facilities-config-file"),oc.getString("apps")) == EXIT_SUCCESS) {
     //	cout << "iCS --> Error occurred here r" << endl;
@@ -408,15 +466,20 @@ main(int argc, char **argv)
         }
 
 #ifdef SUMO_ON
-        //Launch SUMO
-        std::string sumoCall = oc.getString("traffic-executable") + " " + oc.getString("traffic-file");
-        char* sumoChain = strdup(sumoCall.c_str());
-        pthread_create(&sumoThread, NULL, launchSystemExecutable, (void *) sumoChain);
-        cout << "iCS --> SUMO launched." << endl;
+        //Launch SUMO, unless its trace is replayed
+        if (!oc.isSet("traffic-trace-replay")) {
+            std::string sumoCall = oc.getString("traffic-executable") + " " + oc.getString("traffic-file");
+            // SUMO starts from the state it saved with the checkpoint
+            if (oc.isSet("restore-checkpoint"))
+                sumoCall += " --load-state " + Checkpoint::TrafficStateFile(oc.getString("restore-checkpoint"));
+            char* sumoChain = strdup(sumoCall.c_str());
+            pthread_create(&sumoThread, NULL, launchSystemExecutable, (void *) sumoChain);
+            cout << "iCS --> SUMO launched." << endl;
 #ifdef LOG_ON
-        IcsLog::LogLevel("SUMO launched.", ics::kLogLevelWarning);
+            IcsLog::LogLevel("SUMO launched.", ics::kLogLevelWarning);
 #endif
-        Sleep(1);
+            Sleep(1);
+        }
 #endif
 
 #ifdef NS3_ON
@@ -428,8 +491,22 @@ main(int argc, char **argv)
         std::string ns3Call;
         ns3Call = oc.getString("communication-executable") + " ";
         ns3Call += " --inciPort=" + out.str();
+        // A "shm://<name>" communication host selects the shared memory channel instead of TCP
+        std::string ns3Host = oc.getString("communication-host");
+        if (ns3Host.compare(0, 6, "shm://") == 0)
+            ns3Call += " --inciShm=" + ns3Host.substr(6);
         ns3Call += " --fileGeneralParameters=" + oc.getString("communication-general-params-file");
         ns3Call += " --fileConfTechnologies=" + oc.getString("communication-config-technologies-file");
+        // ns-3 converts the node positions with the same local coordinates origin as the facilities
+        ics_parsing::FacilitiesGetConfig facConfig;
+        std::string facilitiesFile = oc.getString("facilities-config-file");
+        facConfig.readConfigFile(facilitiesFile);
+        stringstream origin;
+        origin.precision(10);
+        origin << " --originLatitude=" << facConfig.getLocalLatitude() << " --originLongitude=" << facConfig.getLocalLongitude();
+        if (facConfig.getLocalAltitude() != -10000)
+            origin << " --originAltitude=" << facConfig.getLocalAltitude();
+        ns3Call += origin.str();
 	if (!oc.getString("ns3-log-path").empty())
             ns3Call += " --logFile=" + oc.getString("ns3-log-path");
 	    /*if (!oc.getString("ns3-log-path").empty())
@@ -494,6 +494,11 @@ vector<RATID>*                      FacilitiesManager::getStationActiveRATs(stat
     return sta->getActiveRATs();
 }
 
+void                                FacilitiesManager::setStationRATs(stationID_t stationID, const vector< pair<RATID, bool> >& RATs) {
+    Station* sta = (Station*) getStation(stationID);
+    sta->setRATs(RATs);
+}
+
 bool                                FacilitiesManager::isRATdefinedInStation(stationID_t stationID, RATID technology) {
     vector<RATID>* rats = getStationRATs(stationID);
     vector<RATID>::const_iterator it;
@@ -852,6 +857,13 @@ void                             	FacilitiesManager::updateClock(icstime_t newSi
     abort();
 }
 
+bool                                FacilitiesManager::isLDMEmpty() const {
+    if (facilities != NULL)
+        return facilities->isLDMEmpty();
+    cerr << "[iCS - Facilities] ERROR: Facilities not allocated by the Facilities Manager" << endl;
+    abort();
+}
+
 Area2D*                             FacilitiesManager::getWholeArea(vector<Area2D*> areas) {
     if (facilities != NULL)
         return facilities->getWholeArea(areas);
@@ -1138,10 +1150,17 @@ vector<TCamInformation>*                FacilitiesManager::getInfoFromLastCAMsRe
                 camInfo.width = 0;
                 camInfo.lights = 0;
             }
-            // Location Referencing information
-            camInfo.laneID = convertPoint2LaneID(camInfo.senderPosition);
-            camInfo.edgeID = getEdgeIDFromLane(camInfo.laneID);
-            camInfo.junctionID = getJunctionIDFromLane(camInfo.laneID);
+            // Location Referencing information, recorded when the CAM was created
+            const TRoadLocation& location = (*it)->getRoadLocation();
+            if (location.lane >= 0) {
+                camInfo.laneID = facilities->getInternedRoadElementID(location.lane);
+                camInfo.edgeID = facilities->getInternedRoadElementID(location.edge);
+                camInfo.junctionID = facilities->getInternedRoadElementID(location.junction);
+            } else {
+                camInfo.laneID = convertPoint2LaneID(camInfo.senderPosition);
+                camInfo.edgeID = getEdgeIDFromLane(camInfo.laneID);
+                camInfo.junctionID = getJunctionIDFromLane(camInfo.laneID);
+            }
 
             // Compute the bufferSize
             camInfo.camInfoBuffSize = 0;
@@ -368,6 +368,12 @@ public:
     */
     vector<RATID>* getStationActiveRATs(stationID_t stationID);
 
+    /**
+    * @brief Replaces the radio access technologies of the station, e.g. when it is restored from a checkpoint.
+    * @param[in] ID of the station and its technologies, with true for the active ones.
+    */
+    void setStationRATs(stationID_t stationID, const vector< pair<RATID, bool> >& RATs);
+
     /**
     * @brief Checks if a station has a certain RAT available.
     * @param[in] ID of the station and interested RAT.
@@ -710,6 +716,11 @@ public:
     */
     void updateClock(icstime_t newSimTime);
 
+    /**
+    * @brief Tell whether the LDM holds no received nor pending message.
+    */
+    bool isLDMEmpty() const;
+
     /**
     * @brief Given a vector of areas, it returns the rectangle that encloses them all.
     * @param[in] areas Vector of areas (they can be geometric shapes or road elements).
@@ -122,6 +122,15 @@
 // send to the application the status of the application message scheduling process
 #define CMD_APP_MSG_RECEIVE 0x3B
 
+// send to the application all the subscribed data of a node in a single message
+#define CMD_SUBSCRIBED_DATA_BATCH 0x3C
+
+// command: negotiate the version of the protocol with the application
+#define CMD_APP_PROTOCOL_VERSION 0x3D
+
+// send to the application the commands of all the nodes in one phase of the timestep in a single message
+#define CMD_MULTI_NODE_BATCH 0x3E
+
 // ****************************************
 // OUTPUT OF APPLICATIONS
 // Where the result of the application should be applied
@@ -165,6 +174,18 @@
 // result type: error
 #define APP_RTYPE_ERR   0xFF
 
+// ****************************************
+// PROTOCOL VERSIONS
+// ****************************************
+
+// one command and one reply for each subscription of each node
+#define APP_PROTOCOL_VERSION_LEGACY 1
+// the subscribed data of a node for an application is sent with CMD_SUBSCRIBED_DATA_BATCH
+#define APP_PROTOCOL_VERSION_BATCH 2
+// each phase of the timestep (subscriptions, unsubscriptions, subscribed data, message status,
+// execution) is one CMD_MULTI_NODE_BATCH message with the commands of all the nodes
+#define APP_PROTOCOL_VERSION_MULTI_NODE 3
+
 // ****************************************
 // MESSAGE STATUS
 // ****************************************
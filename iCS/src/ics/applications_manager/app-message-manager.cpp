@@ -64,6 +64,8 @@ namespace ics
 AppMessageManager::AppMessageManager(SyncManager* syncManager)
 {
     this->m_syncManager = syncManager;
+    m_socket = NULL;
+    m_protocolVersion = APP_PROTOCOL_VERSION_LEGACY;
 }
 
 // ===========================================================================
@@ -80,6 +82,9 @@ AppMessageManager::Connect(string host, int port)
         try {
             cout << "iCS --> Trying " << i <<" to connect Application on port " << port << "..." << endl;
             m_socket->connect();
+            if (!CommandSetProtocolVersion(APP_PROTOCOL_VERSION_MULTI_NODE)) {
+                cout << "iCS --> Application on port " << port << " does not support batched data, using one command per subscription" << endl;
+            }
             return true;
         } catch (SocketException e) {
             cout << "iCS --> No connection to Application; waiting..." << endl;
@@ -90,6 +95,77 @@ AppMessageManager::Connect(string host, int port)
     return false;
 }
 
+int
+AppMessageManager::GetProtocolVersion() const
+{
+    return m_protocolVersion;
+}
+
+bool
+AppMessageManager::CommandSetProtocolVersion(int version)
+{
+    tcpip::Storage outMsg;
+    tcpip::Storage inMsg;
+
+    // Until the application answers, both sides speak the legacy protocol
+    m_protocolVersion = APP_PROTOCOL_VERSION_LEGACY;
+
+    // command length
+    outMsg.writeInt(4 + 1 + 4);
+    // command id
+    outMsg.writeUnsignedByte(CMD_APP_PROTOCOL_VERSION);
+    // proposed version
+    outMsg.writeInt(version);
+
+    if (!ExchangeCommand(outMsg, inMsg))
+        return false;
+
+    // an application built before the negotiation answers not implemented
+    if (!ReportResultState(inMsg, CMD_APP_PROTOCOL_VERSION))
+        return false;
+
+    try {
+        int acceptedVersion = inMsg.readInt();
+        if (acceptedVersion < APP_PROTOCOL_VERSION_LEGACY || acceptedVersion > version) {
+            cout << "App --> iCS #Error: unexpected protocol version " << acceptedVersion << endl;
+            return false;
+        }
+        m_protocolVersion = acceptedVersion;
+    } catch (std::invalid_argument e) {
+        cout << "App --> iCS #Error: an exception was thrown while reading the protocol version." << endl;
+        return false;
+    }
+
+    return m_protocolVersion >= APP_PROTOCOL_VERSION_BATCH;
+}
+
+bool
+AppMessageManager::ExchangeCommand(tcpip::Storage& outMsg, tcpip::Storage& inMsg)
+{
+    if (m_socket == NULL) {
+        cout << "iCS --> #Error while sending command: Socket is off" << endl;
+        return false;
+    }
+
+    // send request message
+    try {
+        m_socket->sendExact(outMsg);
+    } catch (SocketException e) {
+        cout << "iCS --> #Error while sending command to Application: " << e.what() << endl;
+        return false;
+    }
+
+    // receive answer message
+    try {
+        m_socket->receiveExact(inMsg);
+    } catch (SocketException e) {
+        cout << "iCS --> #Error while receiving response from Application: " << e.what() << endl;
+        return false;
+    }
+
+    return true;
+}
+
 bool
 AppMessageManager::Close()
 {
@@ -147,43 +223,24 @@ AppMessageManager::CommandGetNewSubscriptions(int nodeId, int appId, vector<Subs
     tcpip::Storage outMsg;
     tcpip::Storage inMsg;
 
-    if (m_socket == NULL) {
-        cout << "iCS --> #Error while sending command: Socket is off" << endl;;
-        return false;
-    }
-
-    // command length
-    outMsg.writeInt(4 + 1 + 4 + 4);
-    // command id
-    outMsg.writeUnsignedByte(CMD_ASK_FOR_SUBSCRIPTION);
-    // simulation timestep
-    outMsg.writeInt(SyncManager::m_simStep);
-    // node identifier
-    outMsg.writeInt(nodeId);
-
     if (nodeId == 0) {
         cout << "Node id 0" << endl;
     }
 
-    // send request message
-    try {
-        m_socket->sendExact(outMsg);
-    } catch (SocketException e) {
-        cout << "iCS --> #Error while sending command to Application: " << e.what() << endl;
-        return false;
-    }
+    EncodeAskForSubscription(outMsg, nodeId);
 
-    // receive answer message
-    try {
-        m_socket->receiveExact(inMsg);
-    } catch (SocketException e) {
-        cout << "iCS --> #Error while receiving response from Application: " << e.what() << endl;
+    if (!ExchangeCommand(outMsg, inMsg))
         return false;
-    }
 
     if (!ReportResultState(inMsg, CMD_ASK_FOR_SUBSCRIPTION))
         return false;
 
+    return ReadNewSubscription(inMsg, nodeId, appId, subscriptions, noMoreSubs);
+}
+
+bool
+AppMessageManager::ReadNewSubscription(tcpip::Storage& inMsg, int nodeId, int appId, vector<Subscription*> *subscriptions, bool &noMoreSubs)
+{
     int cmdLength;
     int cmdStart;
     int subscriptionCode;
@@ -513,69 +570,10 @@ AppMessageManager::CommandUnsubscribe(int nodeId, Subscription* subscription)
     tcpip::Storage outMsg;
     tcpip::Storage inMsg;
 
-    if (m_socket == NULL) {
-        cout << "iCS --> #Error while sending command: Socket is off" << endl;;
-        return -1;
-    }
-
-    if (subscription == NULL) {
-        cout << "iCS --> #Error while sending command: subscriptions is NULL" << endl;;
-        return -1;
-    }
-
-    // command length
-    outMsg.writeInt(4 + 1 + 4 + 4 + 1);
-    // command id
-    outMsg.writeUnsignedByte(CMD_END_SUBSCRIPTION);
-    // simulation timestep
-    outMsg.writeInt(SyncManager::m_simStep);
-    // node identifier
-    outMsg.writeInt(nodeId);
-    // subscription to be maintained or dropped
-    const type_info& typeinfo = typeid(*subscription);
-    if (typeinfo == typeid(SubsSetCamArea)) {
-        outMsg.writeUnsignedByte(SUB_SET_CAM_AREA);
-    }
-    if (typeinfo == typeid(SubsReturnsCarInZone)) {
-        outMsg.writeUnsignedByte(SUB_RETURNS_CARS_IN_ZONE);
-    }
-    if (typeinfo == typeid(SubsGetReceivedCamInfo)) {
-        outMsg.writeUnsignedByte(SUB_RECEIVED_CAM_INFO);
-    }
-    if (typeinfo == typeid(SubsGetFacilitiesInfo)) {
-            outMsg.writeUnsignedByte(SUB_FACILITIES_INFORMATION);
-    }
-    if (typeinfo == typeid(SubsXApplicationData)) {
-            outMsg.writeUnsignedByte(SUB_X_APPLICATION_DATA);
-    }
-    if (typeinfo == typeid(SubsAppMessageSend)) {
-            outMsg.writeUnsignedByte(SUB_APP_MSG_SEND);
-    }
-    if (typeinfo == typeid(SubsAppMessageReceive)) {
-            outMsg.writeUnsignedByte(SUB_APP_MSG_RECEIVE);
-    }
-    if (typeinfo == typeid(SubsAppCmdTraffSim)) {
-            outMsg.writeUnsignedByte(SUB_APP_CMD_TRAFF_SIM);
-    }
-    if (typeinfo == typeid(SubsAppResultTraffSim)) {
-            outMsg.writeUnsignedByte(SUB_APP_RESULT_TRAFF_SIM);
-    }
-
-    // send request message
-    try {
-        m_socket->sendExact(outMsg);
-    } catch (SocketException e) {
-        cout << "iCS --> #Error while sending command to Application: " << e.what() << endl;
-        return -1;
-    }
+    EncodeUnsubscribe(outMsg, nodeId, subscription);
 
-    // receive answer message
-    try {
-        m_socket->receiveExact(inMsg);
-    } catch (SocketException e) {
-        cout << "iCS --> #Error while receiving response from Application: " << e.what() << endl;
+    if (!ExchangeCommand(outMsg, inMsg))
         return -1;
-    }
 
     // check out the status of the primitive
     if (!ReportResultState(inMsg, CMD_END_SUBSCRIPTION)) {
@@ -593,75 +591,16 @@ AppMessageManager::CommandSendSubscriptionCarsInZone(vector<VehicleNode*>* carsI
         return false;
     }
 
-    tcpip::Storage outMsg;
-    tcpip::Storage inMsg;
-
-    if (m_socket == NULL) {
-        cout << "iCS --> #Error while sending command: Socket is off" << endl;;
-        return false;
-    }
-
-    int numberOfCars = (int)carsInZone->size();
-    int numberOfCarsSize = numberOfCars * (4 + 4 + 4 + 4 +4);
-
-    // command length
-    outMsg.writeInt(4 + 1 + 4 + 4 + 4 + numberOfCarsSize);
-    // command id
-    outMsg.writeUnsignedByte(CMD_CARS_IN_ZONE);
-    // simulation timestep
-    outMsg.writeInt(SyncManager::m_simStep);
-    // subscribed node id
-    outMsg.writeInt(nodeId);
-    // number of cars
-    outMsg.writeInt((int)carsInZone->size());
-
     if (nodeId == 0) {
         cout << "Node id 0" << endl;
     }
 
-    vector<VehicleNode*>::iterator nodeIt;
-    for (nodeIt = carsInZone->begin() ; nodeIt < carsInZone->end() ; nodeIt++) {
-        VehicleNode* node = *nodeIt;
-        //car identifier
-        outMsg.writeInt(node->m_icsId);
-        //car position x
-        outMsg.writeFloat(node->GetPositionX());
-        //car position y
-        outMsg.writeFloat(node->GetPositionY());
-        ////////////////////////////////////////
-        // ADDED by Florent KAISSER 02/21/2017
-        //
-        // write speed and heading to transmit them 
-        // to the application
-        //
-        //car speed
-        outMsg.writeFloat(node->GetSpeed());
-        //car heading
-        outMsg.writeFloat(node->GetHeading());
-        //
-        ////////////////////////////////////////
-
-        stringstream log;
-        log << "[INFO] CommandSendSubscriptionCarsInZone() Node Id " << node->m_icsId << " X: " << node->GetPositionX() << " Y: " << node->GetPositionY() << " Speed: " << node->GetSpeed() << " Direction: " << node->GetHeading();
-        IcsLog::LogLevel((log.str()).c_str(), kLogLevelInfo);
-
-    }
-
-    // send request message
-    try {
-        m_socket->sendExact(outMsg);
-    } catch (SocketException e) {
-        cout << "iCS --> #Error while sending command to Application: " << e.what() << endl;
-        return false;
-    }
+    tcpip::Storage outMsg;
+    tcpip::Storage inMsg;
+    EncodeCarsInZone(outMsg, *carsInZone, nodeId);
 
-    // receive answer message
-    try {
-        m_socket->receiveExact(inMsg);
-    } catch (SocketException e) {
-        cout << "iCS --> #Error while receiving response from Application: " << e.what() << endl;
+    if (!ExchangeCommand(outMsg, inMsg))
         return false;
-    }
 
     if (!ReportResultState(inMsg, CMD_CARS_IN_ZONE))
         return false;
@@ -672,51 +611,16 @@ AppMessageManager::CommandSendSubscriptionCarsInZone(vector<VehicleNode*>* carsI
 int
 AppMessageManager::CommandSendSubcriptionCalculateTravelTimeFlags(int nodeId, int startStation, int stopStation)
 {
-    tcpip::Storage outMsg;
-    tcpip::Storage inMsg;
-
-    if (m_socket == NULL) {
-        cout << "iCS --> #Error while sending command: Socket is off" << endl;
-        return EXIT_FAILURE;
-    }
-
     if (nodeId == 0) {
         cout << "Node id 0" << endl;
     }
 
-    // command length
-//    outMsg.writeUnsignedByte(1 + 1 + 4 + 4 + 4 + 4);
-    outMsg.writeInt(1 + 1 + 4 + 4 + 4 + 4);
-    // command id
-    outMsg.writeUnsignedByte(CMD_TRAVEL_TIME_ESTIMATION);
-    // simulation timestep
-    outMsg.writeInt(SyncManager::m_simStep);
-    // subscribed node id
-    outMsg.writeInt(nodeId);
-    // start station
-    outMsg.writeInt(startStation);
-    // stop station
-    outMsg.writeInt(stopStation);
-
-    // send request message
-    try {
-        m_socket->sendExact(outMsg);
-    } catch (SocketException e) {
-        cout << "iCS --> #Error while sending command to Application: " << e.what() << endl;
-        return EXIT_FAILURE;
-    }
-
-    stringstream log;
-    log << "Start and stop station info: " << startStation << " | " << stopStation;
-    IcsLog::LogLevel((log.str()).c_str(), kLogLevelInfo);
+    tcpip::Storage outMsg;
+    tcpip::Storage inMsg;
+    EncodeTravelTimeFlags(outMsg, nodeId, startStation, stopStation);
 
-    // receive answer message
-    try {
-        m_socket->receiveExact(inMsg);
-    } catch (SocketException e) {
-        cout << "iCS --> #Error while receiving response from Application: " << e.what() << endl;
+    if (!ExchangeCommand(outMsg, inMsg))
         return EXIT_FAILURE;
-    }
 
     if (!ReportResultState(inMsg, CMD_TRAVEL_TIME_ESTIMATION))
         return EXIT_FAILURE;
@@ -738,89 +642,126 @@ AppMessageManager::CommandSendSubscriptionReceivedCamInfo(vector<TCamInformation
 
     tcpip::Storage outMsg;
     tcpip::Storage inMsg;
+    EncodeReceivedCamInfo(outMsg, *camInfo, nodeId);
 
-    if (m_socket == NULL) {
-        cout << "iCS --> #Error while sending command: Socket is off" << endl;;
+    if (!ExchangeCommand(outMsg, inMsg))
         return false;
-    }
 
-    // Compute the information length to be sent
-    int numberOfSendersSize = 0;
-    vector<TCamInformation>::iterator it;
-    for (it = camInfo->begin(); it < camInfo->end(); it++) {
-        numberOfSendersSize += it->camInfoBuffSize;
-    }
+    if (!ReportResultState(inMsg, CMD_RECEIVED_CAM_INFO))
+        return false;
 
-    // command length
-    int totalLengthPacket = 4 /*length*/
-                            + 1 /*commandId*/
-                            + 4 /*timeStep*/
-                            + 4 /*nodeId*/
-                            + 4 /*nodeX*/
-                            + 4 /*nodeY*/
-                            + 4 /*NumCAMs*/
-                            + numberOfSendersSize;
+    return true;
+}
 
-    outMsg.writeInt(totalLengthPacket);                 // bytes: 0-3
-    // command id
-    outMsg.writeUnsignedByte(CMD_RECEIVED_CAM_INFO);    // bytes: 4
-    // simulation timestep
-    outMsg.writeInt(SyncManager::m_simStep);            // bytes: 5-8
-    // subscribed node id
-    outMsg.writeInt(nodeId);                            // bytes: 9-12
-    // node's position when receiving
-    Point2D pos = SyncManager::m_facilitiesManager->getStationPosition(nodeId);
-    outMsg.writeFloat(pos.x());                         // bytes: 13-16
-    outMsg.writeFloat(pos.y());                         // bytes: 17-20
-    // number of cams
-    outMsg.writeInt((int)camInfo->size());              // bytes: 21-24
+bool
+AppMessageManager::CommandSendSubscriptionFacilitiesInfo(vector<unsigned char>& facInfo, int nodeId)
+{
+    if (nodeId == 0) {
+        cout << "Node id 0" << endl;
+        return false;
+    }
 
-    for (it = camInfo->begin(); it < camInfo->end(); it++) {
-        TCamInformation currCamInfo = *it;
-        // General basic CAM profile
-        outMsg.writeInt(currCamInfo.senderID);             // sender identifier
-        outMsg.writeFloat(currCamInfo.senderPosition.x()); // sender x position
-        outMsg.writeFloat(currCamInfo.senderPosition.y()); // sender y position
-        outMsg.writeInt(currCamInfo.generationTime);       // message generationTime
-        outMsg.writeInt((int) currCamInfo.staType);        // station Type
-        // Vehicle CAM profile
-        outMsg.writeFloat(currCamInfo.speed);              // speed
-        outMsg.writeFloat(currCamInfo.angle);              // angle
-        outMsg.writeFloat(currCamInfo.acceleration);       // acceleration
-        outMsg.writeFloat(currCamInfo.length);             // vehicle length
-        outMsg.writeFloat(currCamInfo.width);              // vehicle width
-        outMsg.writeInt(currCamInfo.lights);               // vehicle exterior lights
-        // Location Referencing information
-        outMsg.writeString(currCamInfo.laneID);            // laneID
-        outMsg.writeString(currCamInfo.edgeID);            // edgeID
-        outMsg.writeString(currCamInfo.junctionID);        // junctionID
+    tcpip::Storage outMsg;
+    tcpip::Storage inMsg;
+    EncodeNodeData(outMsg, CMD_FACILITIES_INFORMATION, facInfo, nodeId);
+
+    if (!ExchangeCommand(outMsg, inMsg)) {
+        cout << "iCS --> #Error sent " << outMsg.size() <<  " bytes to application" << endl;
+        return false;
     }
 
+    if (!ReportResultState(inMsg, CMD_FACILITIES_INFORMATION))
+        return false;
 
-    // send request message
-    try {
-        m_socket->sendExact(outMsg);
-    } catch (SocketException e) {
-        cout << "iCS --> #Error while sending command to Application: " << e.what() << endl;
+    return true;
+}
+
+int
+AppMessageManager::NotifyMessageStatus(int nodeId, vector<pair<int,stationID_t> >& receivedMessages)
+{
+    tcpip::Storage outMsg;
+    tcpip::Storage inMsg;
+
+    if (nodeId == 0) {
+        cout << "Node id 0" << endl;
+    }
+
+    cout << "iCS --> AppMessageMananger: in NotifyMessageStatus..." << endl;
+
+    EncodeMessageStatus(outMsg, nodeId, receivedMessages);
+
+    if (!ExchangeCommand(outMsg, inMsg))
+        return EXIT_FAILURE;
+
+    if (!ReportResultState(inMsg, CMD_NOTIFY_APP_MESSAGE_STATUS))
+        return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
+
+bool
+AppMessageManager::CommandSendSubscriptionAppMessageSend(bool status, int nodeId)
+{
+    if (nodeId == 0) {
+        cout << "Node id 0" << endl;
         return false;
     }
 
-    // receive answer message
-    try {
-        m_socket->receiveExact(inMsg);
-    } catch (SocketException e) {
-        cout << "iCS --> #Error while receiving response from Application: " << e.what() << endl;
+    tcpip::Storage outMsg;
+    tcpip::Storage inMsg;
+    EncodeNodeStatus(outMsg, CMD_APP_MSG_SEND, status, nodeId);
+
+    if (!ExchangeCommand(outMsg, inMsg))
         return false;
+
+    if (!ReportResultState(inMsg, CMD_APP_MSG_SEND))
+        return false;
+
+    return true;
+}
+
+bool
+AppMessageManager::CommandSendSubscriptionAppMessageReceive(std::vector<std::pair<ScheduledAPPMessageData,stationID_t> >& msgInfo)
+{
+    tcpip::Storage outMsg;
+    tcpip::Storage inMsg;
+    EncodeAppMessageReceive(outMsg, msgInfo);
+
+    if (!ExchangeCommand(outMsg, inMsg))
+        return EXIT_FAILURE;
+
+    if (!ReportResultState(inMsg, CMD_APP_MSG_RECEIVE)) {
+        cout << "iCS --> #Error while checking response state from Application: " << endl;
+        return EXIT_FAILURE;
     }
 
-    if (!ReportResultState(inMsg, CMD_RECEIVED_CAM_INFO))
+    return EXIT_SUCCESS;
+}
+
+bool
+AppMessageManager::CommandSendSubscriptionAppResultTraffSim(vector<unsigned char>& tsInfo, int nodeId)
+{
+    if (nodeId == 0) {
+        cout << "Node id 0" << endl;
+        return false;
+    }
+
+    tcpip::Storage outMsg;
+    tcpip::Storage inMsg;
+    EncodeNodeData(outMsg, CMD_APP_RESULT_TRAFF_SIM, tsInfo, nodeId);
+
+    if (!ExchangeCommand(outMsg, inMsg))
+        return false;
+
+    if (!ReportResultState(inMsg, CMD_APP_RESULT_TRAFF_SIM))
         return false;
 
     return true;
 }
 
+
 bool
-AppMessageManager::CommandSendSubscriptionFacilitiesInfo(vector<unsigned char>& facInfo, int nodeId)
+AppMessageManager::CommandSendSubscriptionXApplicationData(vector<unsigned char>& xAppData, int nodeId)
 {
     if (nodeId == 0) {
         cout << "Node id 0" << endl;
@@ -829,69 +770,335 @@ AppMessageManager::CommandSendSubscriptionFacilitiesInfo(vector<unsigned char>&
 
     tcpip::Storage outMsg;
     tcpip::Storage inMsg;
+    EncodeNodeData(outMsg, CMD_X_APPLICATION_DATA, xAppData, nodeId);
 
-    if (m_socket == NULL) {
-        cout << "iCS --> #Error while sending command: Socket is off" << endl;;
+    if (!ExchangeCommand(outMsg, inMsg))
+        return false;
+
+    if (!ReportResultState(inMsg, CMD_X_APPLICATION_DATA))
+        return false;
+
+    return true;
+}
+
+bool
+AppMessageManager::CommandSendSubscriptionAppCmdTraffSim(bool status, int nodeId)
+{
+    if (nodeId == 0) {
+        cout << "Node id 0" << endl;
         return false;
     }
 
-    // command length
-    int totalLengthPacket = 4 /*length*/
-                            + 1 /*commandId*/
-                            + 4 /*timeStep*/
-                            + 4 /*nodeId*/
-                            + facInfo.size();
+    tcpip::Storage outMsg;
+    tcpip::Storage inMsg;
+    EncodeNodeStatus(outMsg, CMD_APP_CMD_TRAFF_SIM, status, nodeId);
 
-    outMsg.writeInt(totalLengthPacket);                                             // bytes: 0-3
-    // command id
-    outMsg.writeUnsignedByte(CMD_FACILITIES_INFORMATION);                          // bytes: 4
-    // simulation timestep
-    outMsg.writeInt(SyncManager::m_simStep);                                        // bytes: 5-8
-    // subscribed node id
-    outMsg.writeInt(nodeId);                                                        // bytes: 9-12
-    // facilities information (expressed according to the Type-Length-Value syntax)
-    outMsg.writePacket(facInfo); // bytes: 13-(13+facInfo.size())
+    if (!ExchangeCommand(outMsg, inMsg))
+        return false;
 
-    // send request message
-    try {
-        m_socket->sendExact(outMsg);
-    } catch (SocketException e) {
-        cout << "iCS --> #Error while sending command to Application: " << e.what() << endl;
+    if (!ReportResultState(inMsg, CMD_APP_CMD_TRAFF_SIM))
         return false;
+
+    return true;
+}
+
+bool
+AppMessageManager::CommandSendSubscribedData(int nodeId, AppCommandBatch& batch)
+{
+    if (batch.Size() == 0) {
+        return true;
     }
 
-    // receive answer message
-    try {
-        m_socket->receiveExact(inMsg);
-    } catch (SocketException e) {
-        cout << "iCS --> #Error while receiving response from Application: " << e.what() << endl;
-        cout << "iCS --> #Error sent " << totalLengthPacket <<  " bytes to application" << endl;
+    if (m_protocolVersion < APP_PROTOCOL_VERSION_BATCH) {
+        for (int i = 0; i < batch.Size(); ++i) {
+            tcpip::Storage outMsg;
+            tcpip::Storage inMsg;
+            batch.GetCommand(i, outMsg);
+
+            if (!ExchangeCommand(outMsg, inMsg))
+                return false;
+
+            if (!ReportResultState(inMsg, batch.GetCommandId(i)))
+                return false;
+        }
+        return true;
+    }
+
+    tcpip::Storage outMsg;
+    tcpip::Storage inMsg;
+    EncodeSubscribedData(outMsg, nodeId, batch);
+
+    if (!ExchangeCommand(outMsg, inMsg))
         return false;
+
+    return ReadSubscribedDataStatus(inMsg, batch);
+}
+
+bool
+AppMessageManager::ReadSubscribedDataStatus(tcpip::Storage& inMsg, const AppCommandBatch& batch)
+{
+    // one status for each command, in the same order
+    for (int i = 0; i < batch.Size(); ++i) {
+        if (!ReportResultState(inMsg, batch.GetCommandId(i)))
+            return false;
     }
+    return true;
+}
 
-    if (!ReportResultState(inMsg, CMD_FACILITIES_INFORMATION))
+bool
+AppMessageManager::CommandGetNewSubscriptions(const vector<int>& nodeIds, int appId, vector<vector<Subscription*> >& subscriptions)
+{
+    subscriptions.assign(nodeIds.size(), vector<Subscription*>());
+    if (nodeIds.empty())
+        return true;
+
+    AppCommandBatch batch;
+    for (vector<int>::const_iterator it = nodeIds.begin(); it != nodeIds.end(); ++it) {
+        EncodeAskForSubscription(batch.GetStorage(), *it);
+        batch.EndCommand(CMD_ASK_FOR_SUBSCRIPTION);
+    }
+
+    tcpip::Storage inMsg;
+    if (!ExchangeBatch(batch, inMsg))
         return false;
 
+    // The reply of each node holds all its new subscriptions, up to the end of the subscription request
+    for (unsigned int i = 0; i < nodeIds.size(); ++i) {
+        tcpip::Storage reply;
+        if (!ReadBatchReply(inMsg, reply))
+            return false;
+        bool noMoreSubs = false;
+        while (!noMoreSubs) {
+            if (!ReportResultState(reply, CMD_ASK_FOR_SUBSCRIPTION))
+                return false;
+            if (!ReadNewSubscription(reply, nodeIds[i], appId, &subscriptions[i], noMoreSubs))
+                return false;
+        }
+    }
+
     return true;
 }
 
-int
-AppMessageManager::NotifyMessageStatus(int nodeId, vector<pair<int,stationID_t> >& receivedMessages)
+bool
+AppMessageManager::CommandUnsubscribe(const vector<pair<int,Subscription*> >& candidates, vector<int>& results)
 {
-    tcpip::Storage outMsg;
+    results.assign(candidates.size(), -1);
+    if (candidates.empty())
+        return true;
+
+    AppCommandBatch batch;
+    for (vector<pair<int,Subscription*> >::const_iterator it = candidates.begin(); it != candidates.end(); ++it) {
+        EncodeUnsubscribe(batch.GetStorage(), it->first, it->second);
+        batch.EndCommand(CMD_END_SUBSCRIPTION);
+    }
+
     tcpip::Storage inMsg;
+    if (!ExchangeBatch(batch, inMsg))
+        return false;
 
-    if (m_socket == NULL) {
-        cout << "iCS --> #Error while sending command: Socket is off" << endl;
+    for (unsigned int i = 0; i < candidates.size(); ++i) {
+        tcpip::Storage reply;
+        if (!ReadBatchReply(inMsg, reply))
+            return false;
+        if (!ReportResultState(reply, CMD_END_SUBSCRIPTION))
+            return false;
+        results[i] = ValidateUnsubscriptions(reply);
+    }
+
+    return true;
+}
+
+bool
+AppMessageManager::CommandSendSubscribedData(const vector<int>& nodeIds, vector<AppCommandBatch>& batches)
+{
+    // Each node keeps its own CMD_SUBSCRIBED_DATA_BATCH, nodes without data are left out
+    AppCommandBatch batch;
+    vector<int> sent;
+    for (unsigned int i = 0; i < nodeIds.size(); ++i) {
+        if (batches[i].Size() == 0)
+            continue;
+        EncodeSubscribedData(batch.GetStorage(), nodeIds[i], batches[i]);
+        batch.EndCommand(CMD_SUBSCRIBED_DATA_BATCH);
+        sent.push_back(i);
+    }
+    if (sent.empty())
+        return true;
+
+    tcpip::Storage inMsg;
+    if (!ExchangeBatch(batch, inMsg))
+        return false;
+
+    for (vector<int>::iterator it = sent.begin(); it != sent.end(); ++it) {
+        tcpip::Storage reply;
+        if (!ReadBatchReply(inMsg, reply))
+            return false;
+        if (!ReadSubscribedDataStatus(reply, batches[*it]))
+            return false;
+    }
+
+    return true;
+}
+
+int
+AppMessageManager::NotifyMessageStatus(const vector<int>& nodeIds, const vector<vector<pair<int,stationID_t> > >& receivedMessages)
+{
+    if (nodeIds.empty())
+        return EXIT_SUCCESS;
+
+    AppCommandBatch batch;
+    for (unsigned int i = 0; i < nodeIds.size(); ++i) {
+        EncodeMessageStatus(batch.GetStorage(), nodeIds[i], receivedMessages[i]);
+        batch.EndCommand(CMD_NOTIFY_APP_MESSAGE_STATUS);
+    }
+
+    tcpip::Storage inMsg;
+    if (!ExchangeBatch(batch, inMsg))
         return EXIT_FAILURE;
+
+    for (unsigned int i = 0; i < nodeIds.size(); ++i) {
+        tcpip::Storage reply;
+        if (!ReadBatchReply(inMsg, reply))
+            return EXIT_FAILURE;
+        if (!ReportResultState(reply, CMD_NOTIFY_APP_MESSAGE_STATUS))
+            return EXIT_FAILURE;
     }
 
-    if (nodeId == 0) {
-        cout << "Node id 0" << endl;
+    return EXIT_SUCCESS;
+}
+
+bool
+AppMessageManager::CommandApplicationToExecute(const vector<int>& nodeIds, vector<ResultContainer*>& resultContainers)
+{
+    if (nodeIds.empty())
+        return true;
+
+    AppCommandBatch batch;
+    for (vector<int>::const_iterator it = nodeIds.begin(); it != nodeIds.end(); ++it) {
+        EncodeApplicationToExecute(batch.GetStorage(), *it);
+        batch.EndCommand(CMD_NOTIFY_APP_EXECUTE);
     }
 
-    cout << "iCS --> AppMessageMananger: in NotifyMessageStatus..." << endl;
+    tcpip::Storage inMsg;
+    if (!ExchangeBatch(batch, inMsg))
+        return false;
+
+    for (unsigned int i = 0; i < nodeIds.size(); ++i) {
+        tcpip::Storage reply;
+        if (!ReadBatchReply(inMsg, reply))
+            return false;
+        if (!ReportResultState(reply, CMD_NOTIFY_APP_EXECUTE))
+            return false;
+        if (!resultContainers[i]->ProcessResult(reply)) {
+            cout << "iCS --> #Error processing the result of node " << nodeIds[i] << "." << endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool
+AppMessageManager::ExchangeBatch(AppCommandBatch& batch, tcpip::Storage& inMsg)
+{
+    tcpip::Storage outMsg;
+
+    // command length
+    outMsg.writeInt(4 + 1 + 4 + 4 + 4 * batch.Size() + batch.GetStorage().size());
+    // command id
+    outMsg.writeUnsignedByte(CMD_MULTI_NODE_BATCH);
+    // simulation timestep
+    outMsg.writeInt(SyncManager::m_simStep);
+    // number of commands
+    outMsg.writeInt(batch.Size());
+    // each command is preceded by its size, some legacy commands carry a wrong length field
+    for (int i = 0; i < batch.Size(); ++i) {
+        tcpip::Storage command;
+        batch.GetCommand(i, command);
+        outMsg.writeInt(command.size());
+        outMsg.writeStorage(command);
+    }
+
+    return ExchangeCommand(outMsg, inMsg);
+}
+
+bool
+AppMessageManager::ReadBatchReply(tcpip::Storage& inMsg, tcpip::Storage& reply)
+{
+    try {
+        int size = inMsg.readInt();
+        if (size < 0) {
+            cout << "App --> iCS #Error: wrong size " << size << " of a reply in the batch." << endl;
+            return false;
+        }
+        vector<unsigned char> bytes(size);
+        for (int i = 0; i < size; ++i)
+            bytes[i] = inMsg.readChar();
+        reply.writePacket(bytes);
+    } catch (std::invalid_argument e) {
+        cout << "App --> iCS #Error: the batch holds less replies than commands." << endl;
+        return false;
+    }
+    return true;
+}
 
+void
+AppMessageManager::EncodeAskForSubscription(tcpip::Storage& outMsg, int nodeId)
+{
+    // command length
+    outMsg.writeInt(4 + 1 + 4 + 4);
+    // command id
+    outMsg.writeUnsignedByte(CMD_ASK_FOR_SUBSCRIPTION);
+    // simulation timestep
+    outMsg.writeInt(SyncManager::m_simStep);
+    // node identifier
+    outMsg.writeInt(nodeId);
+}
+
+void
+AppMessageManager::EncodeUnsubscribe(tcpip::Storage& outMsg, int nodeId, Subscription* subscription)
+{
+    // command length
+    outMsg.writeInt(4 + 1 + 4 + 4 + 1);
+    // command id
+    outMsg.writeUnsignedByte(CMD_END_SUBSCRIPTION);
+    // simulation timestep
+    outMsg.writeInt(SyncManager::m_simStep);
+    // node identifier
+    outMsg.writeInt(nodeId);
+    // subscription to be maintained or dropped
+    const type_info& typeinfo = typeid(*subscription);
+    if (typeinfo == typeid(SubsSetCamArea)) {
+        outMsg.writeUnsignedByte(SUB_SET_CAM_AREA);
+    }
+    if (typeinfo == typeid(SubsReturnsCarInZone)) {
+        outMsg.writeUnsignedByte(SUB_RETURNS_CARS_IN_ZONE);
+    }
+    if (typeinfo == typeid(SubsGetReceivedCamInfo)) {
+        outMsg.writeUnsignedByte(SUB_RECEIVED_CAM_INFO);
+    }
+    if (typeinfo == typeid(SubsGetFacilitiesInfo)) {
+            outMsg.writeUnsignedByte(SUB_FACILITIES_INFORMATION);
+    }
+    if (typeinfo == typeid(SubsXApplicationData)) {
+            outMsg.writeUnsignedByte(SUB_X_APPLICATION_DATA);
+    }
+    if (typeinfo == typeid(SubsAppMessageSend)) {
+            outMsg.writeUnsignedByte(SUB_APP_MSG_SEND);
+    }
+    if (typeinfo == typeid(SubsAppMessageReceive)) {
+            outMsg.writeUnsignedByte(SUB_APP_MSG_RECEIVE);
+    }
+    if (typeinfo == typeid(SubsAppCmdTraffSim)) {
+            outMsg.writeUnsignedByte(SUB_APP_CMD_TRAFF_SIM);
+    }
+    if (typeinfo == typeid(SubsAppResultTraffSim)) {
+            outMsg.writeUnsignedByte(SUB_APP_RESULT_TRAFF_SIM);
+    }
+}
+
+void
+AppMessageManager::EncodeMessageStatus(tcpip::Storage& outMsg, int nodeId, const vector<pair<int,stationID_t> >& receivedMessages)
+{
     int messagesSize = (receivedMessages.size() * 4) * 2;
 
     // command length
@@ -904,298 +1111,237 @@ AppMessageManager::NotifyMessageStatus(int nodeId, vector<pair<int,stationID_t>
     outMsg.writeInt(nodeId);
     // number of received messages
     outMsg.writeInt(receivedMessages.size());
-    int index = 0;
-    for (vector<pair<int,stationID_t> >::iterator it=receivedMessages.begin() ; it != receivedMessages.end() ; ++it) {
+    for (vector<pair<int,stationID_t> >::const_iterator it=receivedMessages.begin() ; it != receivedMessages.end() ; ++it) {
         int messageId = (*it).first;
         int receiverId = (*it).second;
         outMsg.writeInt(messageId);
         outMsg.writeInt(receiverId);
-        index++;
 
-        stringstream log;
-        log << "[INFO] NotifyMessageStatus() Receiver Id: " << receiverId << " Message Id: " << messageId << " sent as ARRIVED to the App";
-        IcsLog::LogLevel((log.str()).c_str(), kLogLevelInfo);
-
-    }
-
-    // send request message
-    try {
-        m_socket->sendExact(outMsg);
-    } catch (SocketException e) {
-        cout << "iCS --> #Error while sending command to Application: " << e.what() << endl;
-        return EXIT_FAILURE;
-    }
-
-    // receive answer message
-    try {
-        m_socket->receiveExact(inMsg);
-    } catch (SocketException e) {
-        cout << "iCS --> #Error while receiving response from Application: " << e.what() << endl;
-        return EXIT_FAILURE;
+        if (IcsLog::IsEnabled(kLogLevelInfo)) {
+            stringstream log;
+            log << "[INFO] NotifyMessageStatus() Receiver Id: " << receiverId << " Message Id: " << messageId << " sent as ARRIVED to the App";
+            IcsLog::LogLevel((log.str()).c_str(), kLogLevelInfo);
+        }
     }
+}
 
-    if (!ReportResultState(inMsg, CMD_NOTIFY_APP_MESSAGE_STATUS))
-        return EXIT_FAILURE;
+void
+AppMessageManager::EncodeApplicationToExecute(tcpip::Storage& outMsg, int nodeId)
+{
+    // command length
+    outMsg.writeInt(4 + 1 + 4 + 4); // Added by Ramon Bauza 29-09-10
+    // command id
+    outMsg.writeUnsignedByte(CMD_NOTIFY_APP_EXECUTE);
+    // simulation timestep
+    outMsg.writeInt(SyncManager::m_simStep);
+    // the node in which the applications is running
+    outMsg.writeInt(nodeId);
+}
 
-    return EXIT_SUCCESS;
+void
+AppMessageManager::EncodeSubscribedData(tcpip::Storage& outMsg, int nodeId, AppCommandBatch& batch)
+{
+    // command length
+    outMsg.writeInt(4 + 1 + 4 + 4 + 4 + batch.GetStorage().size());
+    // command id
+    outMsg.writeUnsignedByte(CMD_SUBSCRIBED_DATA_BATCH);
+    // simulation timestep
+    outMsg.writeInt(SyncManager::m_simStep);
+    // subscribed node id
+    outMsg.writeInt(nodeId);
+    // number of commands
+    outMsg.writeInt(batch.Size());
+    // the commands, framed as in the legacy protocol
+    outMsg.writeStorage(batch.GetStorage());
 }
 
-bool
-AppMessageManager::CommandSendSubscriptionAppMessageSend(bool status, int nodeId)
+void
+AppMessageManager::EncodeCarsInZone(tcpip::Storage& outMsg, const vector<VehicleNode*>& carsInZone, int nodeId)
 {
-    if (nodeId == 0) {
-        cout << "Node id 0" << endl;
-        return false;
-    }
+    int numberOfCars = (int)carsInZone.size();
+    int numberOfCarsSize = numberOfCars * (4 + 4 + 4 + 4 +4);
 
-    tcpip::Storage outMsg;
-    tcpip::Storage inMsg;
+    // command length
+    outMsg.writeInt(4 + 1 + 4 + 4 + 4 + numberOfCarsSize);
+    // command id
+    outMsg.writeUnsignedByte(CMD_CARS_IN_ZONE);
+    // simulation timestep
+    outMsg.writeInt(SyncManager::m_simStep);
+    // subscribed node id
+    outMsg.writeInt(nodeId);
+    // number of cars
+    outMsg.writeInt(numberOfCars);
 
-    if (m_socket == NULL) {
-        cout << "iCS --> #Error while sending command: Socket is off" << endl;;
-        return false;
-    }
+    bool logInfo = IcsLog::IsEnabled(kLogLevelInfo);
+    vector<VehicleNode*>::const_iterator nodeIt;
+    for (nodeIt = carsInZone.begin() ; nodeIt < carsInZone.end() ; nodeIt++) {
+        VehicleNode* node = *nodeIt;
+        //car identifier
+        outMsg.writeInt(node->m_icsId);
+        //car position x
+        outMsg.writeFloat(node->GetPositionX());
+        //car position y
+        outMsg.writeFloat(node->GetPositionY());
+        ////////////////////////////////////////
+        // ADDED by Florent KAISSER 02/21/2017
+        //
+        // write speed and heading to transmit them 
+        // to the application
+        //
+        //car speed
+        outMsg.writeFloat(node->GetSpeed());
+        //car heading
+        outMsg.writeFloat(node->GetHeading());
+        //
+        ////////////////////////////////////////
 
-    // command length
-    int totalLengthPacket = 4 /*length*/
-                            + 1 /*commandId*/
-                            + 4 /*timeStep*/
-                            + 4 /*nodeId*/
-                            + 1;/*scheduling status*/
+        if (logInfo) {
+            stringstream log;
+            log << "[INFO] CommandSendSubscriptionCarsInZone() Node Id " << node->m_icsId << " X: " << node->GetPositionX() << " Y: " << node->GetPositionY() << " Speed: " << node->GetSpeed() << " Direction: " << node->GetHeading();
+            IcsLog::LogLevel((log.str()).c_str(), kLogLevelInfo);
+        }
+    }
+}
 
-    outMsg.writeInt(totalLengthPacket);                                             // bytes: 0-3
+void
+AppMessageManager::EncodeTravelTimeFlags(tcpip::Storage& outMsg, int nodeId, int startStation, int stopStation)
+{
+    // command length (the value does not count the last int, kept as the applications expect it)
+    outMsg.writeInt(1 + 1 + 4 + 4 + 4 + 4);
     // command id
-    outMsg.writeUnsignedByte(CMD_APP_MSG_SEND);                                     // bytes: 4
+    outMsg.writeUnsignedByte(CMD_TRAVEL_TIME_ESTIMATION);
     // simulation timestep
-    outMsg.writeInt(SyncManager::m_simStep);                                        // bytes: 5-8
+    outMsg.writeInt(SyncManager::m_simStep);
     // subscribed node id
-    outMsg.writeInt(nodeId);                                                        // bytes: 9-12
-    // scheduling status information (0x00 = NOT SCHEDULED, 0x01 = SCHEDULED)
-    outMsg.writeUnsignedByte(status);                                               // bytes: 13
-
-    // send request message
-    try {
-        m_socket->sendExact(outMsg);
-    } catch (SocketException e) {
-        cout << "iCS --> #Error while sending command to Application: " << e.what() << endl;
-        return false;
-    }
+    outMsg.writeInt(nodeId);
+    // start station
+    outMsg.writeInt(startStation);
+    // stop station
+    outMsg.writeInt(stopStation);
 
-    // receive answer message
-    try {
-        m_socket->receiveExact(inMsg);
-    } catch (SocketException e) {
-        cout << "iCS --> #Error while receiving response from Application: " << e.what() << endl;
-        return false;
+    if (IcsLog::IsEnabled(kLogLevelInfo)) {
+        stringstream log;
+        log << "Start and stop station info: " << startStation << " | " << stopStation;
+        IcsLog::LogLevel((log.str()).c_str(), kLogLevelInfo);
     }
-
-    if (!ReportResultState(inMsg, CMD_APP_MSG_SEND))
-        return false;
-
-    return true;
 }
 
-bool
-AppMessageManager::CommandSendSubscriptionAppMessageReceive(std::vector<std::pair<ScheduledAPPMessageData,stationID_t> >& msgInfo)
+void
+AppMessageManager::EncodeReceivedCamInfo(tcpip::Storage& outMsg, const vector<TCamInformation>& camInfo, int nodeId)
 {
+    // Compute the information length to be sent
+    int numberOfSendersSize = 0;
+    vector<TCamInformation>::const_iterator it;
+    for (it = camInfo.begin(); it < camInfo.end(); it++) {
+        numberOfSendersSize += it->camInfoBuffSize;
+    }
 
-	tcpip::Storage outMsg;
-	tcpip::Storage inMsg;
-	tcpip::Storage tmpMsg;
-
-	int rcvMsg = 0;
-
-	if (m_socket == NULL) {
-	   cout << "iCS --> #Error while sending command: Socket is off" << endl;
-	   return EXIT_FAILURE;
-	}
-
-	for (std::vector<std::pair<ScheduledAPPMessageData,stationID_t> >::iterator it = msgInfo.begin(); it != msgInfo.end(); ++it) {
-
-      if ((*it).second == 0) {
-        cout << "Node id 0" << endl;
-        continue;
-      }
-      rcvMsg++;
-      // subscribed node id
-      tmpMsg.writeInt((*it).second);                                                        // bytes: 9-12
-      // the received application message ID
-      tmpMsg.writeInt((*it).first.appMessageId);
-	}
-
-	// command length
+    // command length
     int totalLengthPacket = 4 /*length*/
-	                     + 1 /*commandId*/
-	                     + 4 /*timeStep*/
-	                     + 4 /* number of Rcv. Messages */
-	                     + tmpMsg.size(); /*contains sequences of nodeId and appMsgId*/
-
+                            + 1 /*commandId*/
+                            + 4 /*timeStep*/
+                            + 4 /*nodeId*/
+                            + 4 /*nodeX*/
+                            + 4 /*nodeY*/
+                            + 4 /*NumCAMs*/
+                            + numberOfSendersSize;
 
-	outMsg.writeInt(totalLengthPacket);                                             // bytes: 0-3
+    outMsg.writeInt(totalLengthPacket);                 // bytes: 0-3
     // command id
-	outMsg.writeUnsignedByte(CMD_APP_MSG_RECEIVE);                          // bytes: 4
+    outMsg.writeUnsignedByte(CMD_RECEIVED_CAM_INFO);    // bytes: 4
     // simulation timestep
-	outMsg.writeInt(SyncManager::m_simStep);                                        // bytes: 5-8
-
-    // number of messages
-    outMsg.writeInt(rcvMsg);
-
-    // the tmp storage
-    outMsg.writeStorage(tmpMsg);
-
-    // send request message
-      try {
-          m_socket->sendExact(outMsg);
-      } catch (SocketException e) {
-          cout << "iCS --> #Error while sending command to Application: " << e.what() << endl;
-          return EXIT_FAILURE;
-      }
-
-      // receive answer message
-      try {
-        m_socket->receiveExact(inMsg);
-      } catch (SocketException e) {
-        cout << "iCS --> #Error while receiving response from Application: " << e.what() << endl;
-        return EXIT_FAILURE;
-      }
-
-      if (!ReportResultState(inMsg, CMD_APP_MSG_RECEIVE)) {
-    	  cout << "iCS --> #Error while checking response state from Application: " << endl;
-    	  //return false;
-    	  return EXIT_FAILURE;
-      }
+    outMsg.writeInt(SyncManager::m_simStep);            // bytes: 5-8
+    // subscribed node id
+    outMsg.writeInt(nodeId);                            // bytes: 9-12
+    // node's position when receiving
+    Point2D pos = SyncManager::m_facilitiesManager->getStationPosition(nodeId);
+    outMsg.writeFloat(pos.x());                         // bytes: 13-16
+    outMsg.writeFloat(pos.y());                         // bytes: 17-20
+    // number of cams
+    outMsg.writeInt((int)camInfo.size());               // bytes: 21-24
 
-    return EXIT_SUCCESS;
+    for (it = camInfo.begin(); it < camInfo.end(); it++) {
+        const TCamInformation& currCamInfo = *it;
+        // General basic CAM profile
+        outMsg.writeInt(currCamInfo.senderID);             // sender identifier
+        outMsg.writeFloat(currCamInfo.senderPosition.x()); // sender x position
+        outMsg.writeFloat(currCamInfo.senderPosition.y()); // sender y position
+        outMsg.writeInt(currCamInfo.generationTime);       // message generationTime
+        outMsg.writeInt((int) currCamInfo.staType);        // station Type
+        // Vehicle CAM profile
+        outMsg.writeFloat(currCamInfo.speed);              // speed
+        outMsg.writeFloat(currCamInfo.angle);              // angle
+        outMsg.writeFloat(currCamInfo.acceleration);       // acceleration
+        outMsg.writeFloat(currCamInfo.length);             // vehicle length
+        outMsg.writeFloat(currCamInfo.width);              // vehicle width
+        outMsg.writeInt(currCamInfo.lights);               // vehicle exterior lights
+        // Location Referencing information
+        outMsg.writeString(currCamInfo.laneID);            // laneID
+        outMsg.writeString(currCamInfo.edgeID);            // edgeID
+        outMsg.writeString(currCamInfo.junctionID);        // junctionID
+    }
 }
 
-bool
-AppMessageManager::CommandSendSubscriptionAppResultTraffSim(vector<unsigned char>& tsInfo, int nodeId)
+void
+AppMessageManager::EncodeAppMessageReceive(tcpip::Storage& outMsg, const vector<pair<ScheduledAPPMessageData,stationID_t> >& msgInfo)
 {
-    if (nodeId == 0) {
-        cout << "Node id 0" << endl;
-        return false;
-    }
-
-    tcpip::Storage outMsg;
-    tcpip::Storage inMsg;
+    tcpip::Storage tmpMsg;
+    int rcvMsg = 0;
 
-    if (m_socket == NULL) {
-        cout << "iCS --> #Error while sending command: Socket is off" << endl;;
-        return false;
+    for (vector<pair<ScheduledAPPMessageData,stationID_t> >::const_iterator it = msgInfo.begin(); it != msgInfo.end(); ++it) {
+        if ((*it).second == 0) {
+            cout << "Node id 0" << endl;
+            continue;
+        }
+        rcvMsg++;
+        // subscribed node id
+        tmpMsg.writeInt((*it).second);
+        // the received application message ID
+        tmpMsg.writeInt((*it).first.appMessageId);
     }
 
     // command length
     int totalLengthPacket = 4 /*length*/
                             + 1 /*commandId*/
                             + 4 /*timeStep*/
-                            + 4 /*nodeId*/
-                            + tsInfo.size();
+                            + 4 /* number of Rcv. Messages */
+                            + tmpMsg.size(); /*contains sequences of nodeId and appMsgId*/
 
     outMsg.writeInt(totalLengthPacket);                                             // bytes: 0-3
     // command id
-    outMsg.writeUnsignedByte(CMD_APP_RESULT_TRAFF_SIM);                          // bytes: 4
+    outMsg.writeUnsignedByte(CMD_APP_MSG_RECEIVE);                                  // bytes: 4
     // simulation timestep
     outMsg.writeInt(SyncManager::m_simStep);                                        // bytes: 5-8
-    // subscribed node id
-    outMsg.writeInt(nodeId);                                                        // bytes: 9-12
-    // facilities information (expressed according to the Type-Length-Value syntax)
-    outMsg.writePacket(tsInfo); // bytes: 13-(13+tsInfo.size())
-
-    // send request message
-    try {
-        m_socket->sendExact(outMsg);
-    } catch (SocketException e) {
-        cout << "iCS --> #Error while sending command to Application: " << e.what() << endl;
-        return false;
-    }
-
-    // receive answer message
-    try {
-        m_socket->receiveExact(inMsg);
-    } catch (SocketException e) {
-        cout << "iCS --> #Error while receiving response from Application: " << e.what() << endl;
-        return false;
-    }
-
-    if (!ReportResultState(inMsg, CMD_APP_RESULT_TRAFF_SIM))
-        return false;
-
-    return true;
+    // number of messages
+    outMsg.writeInt(rcvMsg);
+    // the tmp storage
+    outMsg.writeStorage(tmpMsg);
 }
 
-
-bool
-AppMessageManager::CommandSendSubscriptionXApplicationData(vector<unsigned char>& xAppData, int nodeId)
+void
+AppMessageManager::EncodeNodeData(tcpip::Storage& outMsg, int commandId, const vector<unsigned char>& data, int nodeId)
 {
-    if (nodeId == 0) {
-        cout << "Node id 0" << endl;
-        return false;
-    }
-
-    tcpip::Storage outMsg;
-    tcpip::Storage inMsg;
-
-    if (m_socket == NULL) {
-        cout << "iCS --> #Error while sending command: Socket is off" << endl;;
-        return false;
-    }
-
     // command length
     int totalLengthPacket = 4 /*length*/
                             + 1 /*commandId*/
                             + 4 /*timeStep*/
                             + 4 /*nodeId*/
-                            + xAppData.size();
-
+                            + data.size();
 
     outMsg.writeInt(totalLengthPacket);                                             // bytes: 0-3
     // command id
-    outMsg.writeUnsignedByte(CMD_X_APPLICATION_DATA);                          // bytes: 4
+    outMsg.writeUnsignedByte(commandId);                                            // bytes: 4
     // simulation timestep
     outMsg.writeInt(SyncManager::m_simStep);                                        // bytes: 5-8
     // subscribed node id
     outMsg.writeInt(nodeId);                                                        // bytes: 9-12
-    // facilities information (expressed according to the Type-Length-Value syntax)
-    outMsg.writePacket(xAppData); // bytes: 13-(13+tsInfo.size())
-
-    // send request message
-    try {
-        m_socket->sendExact(outMsg);
-    } catch (SocketException e) {
-        cout << "iCS --> #Error while sending command to Application: " << e.what() << endl;
-        return false;
-    }
-
-    // receive answer message
-    try {
-        m_socket->receiveExact(inMsg);
-    } catch (SocketException e) {
-        cout << "iCS --> #Error while receiving response from Application: " << e.what() << endl;
-        return false;
-    }
-
-    if (!ReportResultState(inMsg, CMD_X_APPLICATION_DATA))
-        return false;
-
-    return true;
+    // data (expressed according to the Type-Length-Value syntax)
+    outMsg.writePacket(data);                                                       // bytes: 13-(13+data.size())
 }
 
-bool
-AppMessageManager::CommandSendSubscriptionAppCmdTraffSim(bool status, int nodeId)
+void
+AppMessageManager::EncodeNodeStatus(tcpip::Storage& outMsg, int commandId, bool status, int nodeId)
 {
-    if (nodeId == 0) {
-        cout << "Node id 0" << endl;
-        return false;
-    }
-
-    tcpip::Storage outMsg;
-    tcpip::Storage inMsg;
-
-    if (m_socket == NULL) {
-        cout << "iCS --> #Error while sending command: Socket is off" << endl;;
-        return false;
-    }
-
     // command length
     int totalLengthPacket = 4 /*length*/
                             + 1 /*commandId*/
@@ -1205,34 +1351,13 @@ AppMessageManager::CommandSendSubscriptionAppCmdTraffSim(bool status, int nodeId
 
     outMsg.writeInt(totalLengthPacket);                                             // bytes: 0-3
     // command id
-    outMsg.writeUnsignedByte(CMD_APP_CMD_TRAFF_SIM);                                     // bytes: 4
+    outMsg.writeUnsignedByte(commandId);                                            // bytes: 4
     // simulation timestep
     outMsg.writeInt(SyncManager::m_simStep);                                        // bytes: 5-8
     // subscribed node id
     outMsg.writeInt(nodeId);                                                        // bytes: 9-12
-    // scheduling status information (0x00 = NOT SCHEDULED, 0x01 = SCHEDULED)
+    // status information (0x00 = NOT SCHEDULED, 0x01 = SCHEDULED)
     outMsg.writeUnsignedByte(status);                                               // bytes: 13
-
-    // send request message
-    try {
-        m_socket->sendExact(outMsg);
-    } catch (SocketException e) {
-        cout << "iCS --> #Error while sending command to Application: " << e.what() << endl;
-        return false;
-    }
-
-    // receive answer message
-    try {
-        m_socket->receiveExact(inMsg);
-    } catch (SocketException e) {
-        cout << "iCS --> #Error while receiving response from Application: " << e.what() << endl;
-        return false;
-    }
-
-    if (!ReportResultState(inMsg, CMD_APP_CMD_TRAFF_SIM))
-        return false;
-
-    return true;
 }
 
 bool
@@ -1241,37 +1366,14 @@ AppMessageManager::CommandApplicationToExecute(int nodeId, ResultContainer* resu
     tcpip::Storage outMsg;
     tcpip::Storage inMsg;
 
-    // command length
-    outMsg.writeInt(4 + 1 + 4 + 4); // Added by Ramon Bauza 29-09-10
-    // command id
-    outMsg.writeUnsignedByte(CMD_NOTIFY_APP_EXECUTE);
-    // simulation timestep
-    outMsg.writeInt(SyncManager::m_simStep);
-    // the node in which the applications is running
-    outMsg.writeInt(nodeId);
-
     if (nodeId == 0) {
         cout << "Node id 0" << endl;
     }
 
-    // send request message
-    try {
-        m_socket->sendExact(outMsg);
-    }
-    catch (SocketException e) {
-        cout << "iCS --> #Error while sending command to Application: " << e.what() << endl;
-        return false;
-    }
-
-    // receive answer message
-    try {
-        m_socket->receiveExact(inMsg);
+    EncodeApplicationToExecute(outMsg, nodeId);
 
-    }
-    catch (SocketException e) {
-        cout << "iCS --> #Error while receiving response from Application: " << e.what() << endl;
+    if (!ExchangeCommand(outMsg, inMsg))
         return false;
-    }
 
     if (!ReportResultState(inMsg, CMD_NOTIFY_APP_EXECUTE))
         return false;
@@ -1469,4 +1571,50 @@ AppMessageManager::ValidateUnsubscriptions(Storage& inMsg)
     }
 }
 
+// ===========================================================================
+// AppCommandBatch method definitions
+// ===========================================================================
+AppCommandBatch::AppCommandBatch() { }
+
+tcpip::Storage&
+AppCommandBatch::GetStorage()
+{
+    return m_storage;
+}
+
+void
+AppCommandBatch::EndCommand(int commandId)
+{
+    m_commandIds.push_back(commandId);
+    m_commandEnds.push_back(m_storage.size());
+}
+
+int
+AppCommandBatch::Size() const
+{
+    return m_commandIds.size();
+}
+
+int
+AppCommandBatch::GetCommandId(int index) const
+{
+    return m_commandIds[index];
+}
+
+void
+AppCommandBatch::GetCommand(int index, tcpip::Storage& command) const
+{
+    unsigned int start = (index == 0) ? 0 : m_commandEnds[index - 1];
+    vector<unsigned char> bytes(m_storage.begin() + start, m_storage.begin() + m_commandEnds[index]);
+    command.writePacket(bytes);
+}
+
+void
+AppCommandBatch::Clear()
+{
+    m_storage.reset();
+    m_commandIds.clear();
+    m_commandEnds.clear();
+}
+
 }
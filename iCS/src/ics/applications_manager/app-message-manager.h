@@ -49,6 +49,55 @@ class ResultContainer;
 // ===========================================================================
 // class definitions
 // ===========================================================================
+/**
+ * @class AppCommandBatch
+ * @brief Sequence of commands framed as in the legacy protocol, sent to an application in a single message.
+ *
+ * It holds the subscribed data of a node (CMD_SUBSCRIBED_DATA_BATCH) or the commands of all the nodes
+ * in one phase of the timestep (CMD_MULTI_NODE_BATCH). Applications which do not support batches
+ * get the commands one by one.
+ */
+class AppCommandBatch
+{
+public:
+
+    AppCommandBatch();
+
+    /// @brief Storage the commands are appended to.
+    tcpip::Storage& GetStorage();
+
+    /**
+    * @brief Closes the command just appended to the storage.
+    * @param[in] commandId The ID of the command, expected in the status reply of the application.
+    */
+    void EndCommand(int commandId);
+
+    /// @brief Number of commands in the batch.
+    int Size() const;
+
+    /// @brief ID of the index-th command.
+    int GetCommandId(int index) const;
+
+    /**
+    * @brief Copies the index-th command.
+    * @param[in] index Position of the command in the batch.
+    * @param[out] command Storage the bytes of the command are appended to.
+    */
+    void GetCommand(int index, tcpip::Storage& command) const;
+
+    /// @brief Empties the batch, e.g. to reuse it for another node.
+    void Clear();
+
+private:
+    tcpip::Storage m_storage;
+
+    /// @brief ID of each command.
+    std::vector<int> m_commandIds;
+
+    /// @brief Offset of the end of each command in the storage.
+    std::vector<unsigned int> m_commandEnds;
+};
+
 /**
  * @class AppMessageManager
  * @brief Manages the data exchange with the applications through a predefined brief set of commands.
@@ -74,6 +123,9 @@ public:
     */
     bool Connect(std::string host, int port);
 
+    /// @brief Version of the protocol agreed with the application (APP_PROTOCOL_VERSION_*).
+    int GetProtocolVersion() const;
+
     /**
     * @brief Closes the connection with the application module.
     * @return True: If the connection closes successfully.
@@ -199,6 +251,38 @@ public:
      */
     bool CommandSendSubscriptionXApplicationData(vector<unsigned char>& xAppData , int nodeId);
 
+    /**
+    * @brief Sends to the application the subscribed data of a node collected in the current timestep.
+    * All the commands go in one CMD_SUBSCRIBED_DATA_BATCH message if the application negotiated
+    * APP_PROTOCOL_VERSION_BATCH, otherwise one by one as in the legacy protocol.
+    * @param[in] nodeId The identifier of the node the subscriptions belong to.
+    * @param[in] batch The commands encoded by the subscriptions. Nothing is sent if it is empty.
+    * @return True: If the application acknowledged all the commands
+    * @return False: If an error occurs
+    */
+    bool CommandSendSubscribedData(int nodeId, AppCommandBatch& batch);
+
+    /// @brief Encodes the command CMD_CARS_IN_ZONE.
+    static void EncodeCarsInZone(tcpip::Storage& outMsg, const std::vector<VehicleNode*>& carsInZone, int nodeId);
+
+    /// @brief Encodes the command CMD_TRAVEL_TIME_ESTIMATION. -1 stands for a station not crossed yet.
+    static void EncodeTravelTimeFlags(tcpip::Storage& outMsg, int nodeId, int startStation, int stopStation);
+
+    /// @brief Encodes the command CMD_RECEIVED_CAM_INFO, with the current position of the node.
+    static void EncodeReceivedCamInfo(tcpip::Storage& outMsg, const std::vector<ics_types::TCamInformation>& camInfo, int nodeId);
+
+    /// @brief Encodes the command CMD_APP_MSG_RECEIVE. It is not bound to a node, the receivers are in the message.
+    static void EncodeAppMessageReceive(tcpip::Storage& outMsg, const std::vector<std::pair<ScheduledAPPMessageData,ics_types::stationID_t> >& msgInfo);
+
+    /**
+    * @brief Encodes a command whose payload is a block of Type-Length-Value data
+    * (CMD_FACILITIES_INFORMATION, CMD_APP_RESULT_TRAFF_SIM, CMD_X_APPLICATION_DATA).
+    */
+    static void EncodeNodeData(tcpip::Storage& outMsg, int commandId, const std::vector<unsigned char>& data, int nodeId);
+
+    /// @brief Encodes a command whose payload is a status byte (CMD_APP_MSG_SEND, CMD_APP_CMD_TRAFF_SIM).
+    static void EncodeNodeStatus(tcpip::Storage& outMsg, int commandId, bool status, int nodeId);
+
 
     /**
     * @brief Command Application to execute its main functionality/algorithm.
@@ -217,8 +301,112 @@ public:
     */
     int NotifyMessageStatus(int nodeId, std::vector<std::pair<int,ics_types::stationID_t> >& receivedMessages);
 
+    // The commands below send the commands of several nodes in one CMD_MULTI_NODE_BATCH message,
+    // to be used only if the application negotiated APP_PROTOCOL_VERSION_MULTI_NODE.
+    // The reply holds, for each command, its size followed by the reply of the legacy protocol.
+
+    /**
+    * @brief Asks the application for the new subscriptions of several nodes.
+    * The reply of each node holds all its new subscriptions, up to CMD_END_SUBSCRIPTION_REQUEST.
+    * @param[in] nodeIds The nodes the application is running on top of.
+    * @param[in] appId The identifier of the application.
+    * @param[out] subscriptions The new subscriptions of each node, in the order of nodeIds.
+    * @return False: If an error occurs
+    */
+    bool CommandGetNewSubscriptions(const std::vector<int>& nodeIds, int appId, std::vector<std::vector<Subscription*> >& subscriptions);
+
+    /**
+    * @brief Asks the application whether it wants to keep several subscriptions.
+    * @param[in] candidates The subscriptions and the iCS identifier of the node they belong to.
+    * @param[out] results For each candidate, as returned by CommandUnsubscribe(int, Subscription*).
+    * @return False: If an error occurs
+    */
+    bool CommandUnsubscribe(const std::vector<std::pair<int,Subscription*> >& candidates, std::vector<int>& results);
+
+    /**
+    * @brief Sends the subscribed data of several nodes, each one as a CMD_SUBSCRIBED_DATA_BATCH command.
+    * @param[in] nodeIds The nodes the subscriptions belong to.
+    * @param[in] batches The commands encoded for each node. The empty ones are not sent.
+    * @return False: If an error occurs
+    */
+    bool CommandSendSubscribedData(const std::vector<int>& nodeIds, std::vector<AppCommandBatch>& batches);
+
+    /**
+    * @brief Notifies the status of the scheduled messages of several nodes.
+    * @return EXIT_SUCCESS if the information was delivered correctly, EXIT_FAILURE otherwise
+    */
+    int NotifyMessageStatus(const std::vector<int>& nodeIds, const std::vector<std::vector<std::pair<int,ics_types::stationID_t> > >& receivedMessages);
+
+    /**
+    * @brief Commands the application to execute on several nodes.
+    * @param[in] nodeIds The nodes the application is running on top of.
+    * @param[in,out] resultContainers The result container of each node.
+    * @return False: If an error occurs
+    */
+    bool CommandApplicationToExecute(const std::vector<int>& nodeIds, std::vector<ResultContainer*>& resultContainers);
+
 private:
 
+    /// @brief Encodes the command CMD_ASK_FOR_SUBSCRIPTION.
+    static void EncodeAskForSubscription(tcpip::Storage& outMsg, int nodeId);
+
+    /// @brief Encodes the command CMD_END_SUBSCRIPTION for a subscription.
+    static void EncodeUnsubscribe(tcpip::Storage& outMsg, int nodeId, Subscription* subscription);
+
+    /// @brief Encodes the command CMD_NOTIFY_APP_MESSAGE_STATUS.
+    static void EncodeMessageStatus(tcpip::Storage& outMsg, int nodeId, const std::vector<std::pair<int,ics_types::stationID_t> >& receivedMessages);
+
+    /// @brief Encodes the command CMD_NOTIFY_APP_EXECUTE.
+    static void EncodeApplicationToExecute(tcpip::Storage& outMsg, int nodeId);
+
+    /// @brief Encodes the command CMD_SUBSCRIBED_DATA_BATCH with the subscribed data of a node.
+    static void EncodeSubscribedData(tcpip::Storage& outMsg, int nodeId, AppCommandBatch& batch);
+
+    /**
+    * @brief Reads a subscription requested by the application, after the status of CMD_ASK_FOR_SUBSCRIPTION.
+    * @param[in,out] subscriptions The new subscription is appended.
+    * @param[out] noMoreSubs True if the application ended the subscription request.
+    */
+    bool ReadNewSubscription(tcpip::Storage& inMsg, int nodeId, int appId, std::vector<Subscription*>* subscriptions, bool &noMoreSubs);
+
+    /// @brief Reads the status of each command of a CMD_SUBSCRIBED_DATA_BATCH.
+    bool ReadSubscribedDataStatus(tcpip::Storage& inMsg, const AppCommandBatch& batch);
+
+    /**
+    * @brief Sends the commands of a batch in one CMD_MULTI_NODE_BATCH message and waits for the reply.
+    * @param[in] batch The commands, e.g. one for each node.
+    * @param[out] inMsg The reply, to be split with ReadBatchReply().
+    */
+    bool ExchangeBatch(AppCommandBatch& batch, tcpip::Storage& inMsg);
+
+    /**
+    * @brief Extracts the reply to the next command of a CMD_MULTI_NODE_BATCH.
+    * @param[in,out] inMsg The reply of the application.
+    * @param[out] reply The reply to the command, to be read as in the legacy protocol.
+    * @return False: If the reply is truncated.
+    */
+    bool ReadBatchReply(tcpip::Storage& inMsg, tcpip::Storage& reply);
+
+    /**
+    * @brief Proposes a protocol version to the application, which replies with the version it accepts.
+    * Applications which do not know the command answer APP_RTYPE_NOTIMPLEMENTED and keep the legacy protocol.
+    * @param[in] version The highest version supported by the iCS.
+    * @return True: If the application accepted a version.
+    * @return False: If the legacy protocol stays in use.
+    */
+    bool CommandSetProtocolVersion(int version);
+
+    /**
+    * @brief Sends a command and waits for the reply of the application.
+    * @param[in] outMsg The command.
+    * @param[out] inMsg The reply.
+    * @return False: If the socket is off or the exchange fails.
+    */
+    bool ExchangeCommand(tcpip::Storage& outMsg, tcpip::Storage& inMsg);
+
+    /// @brief Version of the protocol in use, APP_PROTOCOL_VERSION_LEGACY until negotiated.
+    int m_protocolVersion;
+
     /**
     * @brief Reports the result of a command execution.
     * @param[in,out] &inMsg Object to stored the reply from the application.
@@ -72,6 +72,14 @@ public:
     */
     virtual std::vector<std::pair<int,ics_types::stationID_t> > GetReceivedMessages() = 0;
 
+    /**
+    * @brief Determines if the application is told about the status of the messages it sent.
+    * @return True: If GetReceivedMessages() is notified to the application every timestep.
+    */
+    virtual bool ReportsMessageStatus() const {
+        return false;
+    };
+
     /**
     * @brief Determines if the container of results is empty or not.
     * @return True: If the container is empty.
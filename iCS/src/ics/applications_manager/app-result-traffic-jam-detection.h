@@ -107,6 +107,11 @@ public:
     /// @todo TO BE COMMENTED
     std::vector<std::pair<int,ics_types::stationID_t> > GetReceivedMessages();
 
+    /// @brief The application is notified about the messages received.
+    bool ReportsMessageStatus() const {
+        return true;
+    };
+
     /*bool push(unsigned char CMD_TYPE, std::string TAG, std::vector<unsigned char> result);
     std::vector<unsigned char> pull(unsigned char CMD_TYPE, std::string TAG);*/
 
@@ -47,6 +47,7 @@
 #include "../vehicle-node.h"
 #include "../wirelesscom_sim_message_tracker/V2X-message-manager.h"
 #include "../ics.h"
+#include "../sync-manager.h"
 #include "../../utils/ics/log/ics-log.h"
 
 using namespace std;
@@ -154,245 +155,30 @@ ApplicationHandler::AskForUnsubscriptions(int nodeId, vector<Subscription*>* sub
 }
 
 int
-ApplicationHandler::SendSubscribedData(int nodeId, Subscription* subscription, vector<ITetrisNode*>* nodes)
+ApplicationHandler::SendSubscribedData(int nodeId, vector<Subscription*>& subscriptions)
 {
-    if (subscription == NULL || nodes == NULL) {
-        cout << "iCS --> [ERROR] SendSubscribedData() Subscription or nodes are NULL." << endl;
-        IcsLog::LogLevel("SendSubscribedData() Subscription or nodes are NULL.", kLogLevelError);
-        return EXIT_FAILURE;
-    }
-
-    Subscription& sub = *subscription;
-    const std::type_info& typeinfo = typeid(sub);
-
-    if (typeinfo == typeid(SubsReturnsCarInZone)) { // Subscription to return car IDs in certain zone
-#ifdef LOG_ON
-        stringstream log;
-        log << "iCS --> [ApplicationHanlder] - SendSubscribedData() - forward subscribed cars in zone to node "<< nodeId <<" ";
-        IcsLog::LogLevel((log.str()).c_str(), kLogLevelInfo);
-#endif
-        // From all the stations in the simulation just get the ones that are vehicles
-        vector<VehicleNode*>* vehicles = new vector<VehicleNode*>();
-        for (vector<ITetrisNode*>::iterator nodesIt = nodes->begin() ; nodesIt < nodes->end() ; nodesIt++) {
-            ITetrisNode& node = *(*nodesIt);
-            const std::type_info& typeinfo2 = typeid(node);
-            if (typeinfo2 == typeid(VehicleNode)) {
-                VehicleNode* vehicle = static_cast<VehicleNode*>((*nodesIt));
-                vehicles->push_back(vehicle);
-            }
-        }
-
-        // Check out from the vehicles which ones are in the zone
-        SubsReturnsCarInZone* subCarsInZone = static_cast<SubsReturnsCarInZone*>(subscription);
-        vector<VehicleNode*>* carsInZone = subCarsInZone->GetCarsInZone(vehicles);
-        if (carsInZone == NULL) {
-            cout << "iCS --> [ERROR] SendSubscribedData() Cars in zone are NULL." << endl;
-            IcsLog::LogLevel("SendSubscribedData() SendSubscribedData() Cars in zone are NULL.", kLogLevelError);
-            return EXIT_FAILURE;
-        }
-        if (carsInZone->size() > 0) {
-	  
-            if (!m_appMessageManager->CommandSendSubscriptionCarsInZone(carsInZone, nodeId)) {
-                cout << "iCS --> [ERROR] SendSubscribedData() Error sending data of cars in zone." << endl;
-                IcsLog::LogLevel("SendSubscribedData() SendSubscribedData() Error sending data of cars in zone.", kLogLevelError);
-                delete carsInZone;
-                return EXIT_FAILURE;
-            } else {
-	        cout << "iCS --> AppHandler SendSubscribedData() Cars in subscribed zones are "<< carsInZone->size() << endl;
-                delete carsInZone;
-                return EXIT_SUCCESS;
-            }
-        } else {
-            if (carsInZone->size() == 0) {
-                IcsLog::LogLevel("SendSubscribedData() Cars in zone are 0.", kLogLevelInfo);
-                delete carsInZone;
-                return EXIT_SUCCESS;
-            } else {
-                cout << "[ERROR] SendSubscribedData() Returned cars in zone value is negative." << endl;
-                IcsLog::LogLevel("SendSubscribedData() Returned cars in zone value is negative.", kLogLevelError);
-                return EXIT_FAILURE;
-            }
-        }
-    }
-
-    if (typeinfo == typeid(SubsSetCamArea)) {  // Subscription of setting a CAM beaconing area
-        IcsLog::LogLevel("SendSubscribedData() SubsSetCamArea does not inform about anything.", kLogLevelInfo);
-        return EXIT_SUCCESS;
-    }
-
-    if (typeinfo == typeid(SubsStartTravelTimeCalculation)) { // Subscription of starting the calculation
-        IcsLog::LogLevel("SendSubscribedData() Subscription SubsStartTravelTimeCalculation does not inform about anything.", kLogLevelInfo);
-        return EXIT_SUCCESS;
-    }
-
-    if (typeinfo == typeid(SubsStopTravelTimeCalculation)) { // Subscription of stopping the calculation
-        IcsLog::LogLevel("SendSubscribedData() Subscription SubsStopTravelTimeCalculation does not inform about anything.", kLogLevelInfo);
-        return EXIT_SUCCESS;
-    }
-
-    // Subscription to calculate travel time
-    if (typeinfo == typeid(SubsCalculateTravelTime)) {
-        SubsCalculateTravelTime* subCalculateTT = static_cast<SubsCalculateTravelTime*>(subscription);
-        if (subCalculateTT->InformApp(m_appMessageManager) == EXIT_FAILURE) {
-            return EXIT_FAILURE;
-        }
-        return EXIT_SUCCESS;
-    }
-
-    // Subscription to return information about the received CAMs
-    if (typeinfo == typeid(SubsGetReceivedCamInfo)) {
-
-        SubsGetReceivedCamInfo* subsGetReceivedCamInfo = static_cast<SubsGetReceivedCamInfo*>(subscription);
-        vector<TCamInformation>* camInfo = NULL;
-        camInfo = subsGetReceivedCamInfo->getInformationFromLastReceivedCAMs();
-        if (camInfo == NULL) {
-            cout << "iCS --> [ERROR] SendSubscribedData() received CAMs are NULL" << endl;
-            IcsLog::LogLevel("SendSubscribedData() received CAMs are NULL.", kLogLevelError);
-            return EXIT_FAILURE;
-        }
-        if (camInfo->size() > 0) {
+    AppCommandBatch batch;
 
+    // Each subscription gathers and encodes its own data, subscriptions without data add nothing
+    for (vector<Subscription*>::iterator it = subscriptions.begin(); it != subscriptions.end(); ++it) {
+        Subscription* subscription = *it;
+        if (subscription->Collect(m_syncManager) == EXIT_FAILURE) {
             stringstream log;
-            log << "SendSubscribedData() Node " << nodeId << " received " << camInfo->size() << " CAM messages in the last time step.";
-            IcsLog::LogLevel((log.str()).c_str(), kLogLevelInfo);
-
-            if (!m_appMessageManager->CommandSendSubscriptionReceivedCamInfo(camInfo, nodeId)) {
-                cout << "iCS --> [ERROR] SendSubscribedData() Error sending information about received CAMs." << endl;
-                IcsLog::LogLevel("SendSubscribedData() Error sending information about received CAMs.", kLogLevelError);
-                delete camInfo;
-                return EXIT_FAILURE;
-            }
-            delete camInfo;
-            return EXIT_SUCCESS;
-        } else {
-            if (camInfo->size() == 0) {
-
-                stringstream log;
-                log << "[INFO] SendSubscribedData() Node " << nodeId << " did not receive CAM messages in the last time step.";
-                IcsLog::LogLevel((log.str()).c_str(), kLogLevelInfo);
-
-                delete camInfo;
-                return EXIT_SUCCESS;
-            } else {
-                cout << "iCS --> [ERROR] SendSubscribedData() Number of received CAMs is negative." << endl;
-
-                stringstream log;
-                log << "[ERROR] SendSubscribedData() Number of received CAMs is negative.";
-                IcsLog::LogLevel((log.str()).c_str(), kLogLevelError);
-
-                delete camInfo;
-                return EXIT_FAILURE;
-            }
-        }
-    }
-
-    // Subscription to return information about facilities information about a node
-    if (typeinfo == typeid(SubsGetFacilitiesInfo)) {
-
-        SubsGetFacilitiesInfo* subsGetFacilitiesInfo = static_cast<SubsGetFacilitiesInfo*>(subscription);
-        vector<unsigned char> facInfo = subsGetFacilitiesInfo->getFacilitiesInformation();
-
-        stringstream log;
-        log << "SendSubscribedData() Node " << nodeId << " will be updated about " << subsGetFacilitiesInfo->getNumberOfSubscribedFields() << " location related fields.";
-        IcsLog::LogLevel((log.str()).c_str(), kLogLevelInfo);
-
-        if (!m_appMessageManager->CommandSendSubscriptionFacilitiesInfo(facInfo, nodeId)) {
-            cout << "iCS --> [ERROR] SendSubscribedData() Error sending facilities information." << endl;
-            IcsLog::LogLevel("SendSubscribedData() Error sending facilities information.", kLogLevelError);
-            return EXIT_FAILURE;
-        }
-        return EXIT_SUCCESS;
-    }
-    // Subscription to send an Application-level message
-    if (typeinfo == typeid(SubsAppMessageSend)) {
-
-        SubsAppMessageSend* subsAppMessageSend = static_cast<SubsAppMessageSend*>(subscription);
-        bool schedulingStatus = subsAppMessageSend->returnStatus();
-
-#ifdef LOG_ON
-        stringstream log;
-        log << "SubsAppMessageSend() Node " << nodeId << " will be updated about the scheduling of the message.";
-        IcsLog::LogLevel((log.str()).c_str(), kLogLevelInfo);
-#endif
-
-        if (!m_appMessageManager->CommandSendSubscriptionAppMessageSend(schedulingStatus, nodeId)) {
-            IcsLog::LogLevel("SendSubscribedData() Error sending scheduling status report.", kLogLevelError);
-            return EXIT_FAILURE;
-        }
-        return EXIT_SUCCESS;
-    }
-    if (typeinfo == typeid(SubsAppMessageReceive)) {
-
-    	SubsAppMessageReceive* subsAppMessageReceive = static_cast<SubsAppMessageReceive*>(subscription);
-
-#ifdef LOG_ON
-        stringstream log;
-        log << "SubsAppMessageReceive() Node " << nodeId << " will Pull the Communication Simulator for received data.";
-        IcsLog::LogLevel((log.str()).c_str(), kLogLevelInfo);
-#endif
-
-        if (subsAppMessageReceive->InformApp(m_appMessageManager) == EXIT_FAILURE) {
-        	IcsLog::LogLevel("SendSubscribedData() Error sending scheduling status report.", kLogLevelError);
-        	return EXIT_FAILURE;
-        }
-        return EXIT_SUCCESS;
-    }
-    if (typeinfo == typeid(SubsAppCmdTraffSim)) {
-
-        SubsAppCmdTraffSim* subsAppCmdTraffSim = static_cast<SubsAppCmdTraffSim*>(subscription);
-        bool resultStatus = subsAppCmdTraffSim->returnStatus();
-
-#ifdef LOG_ON
-        stringstream log;
-        log << "SubsAppCmdTraffSim() Node " << nodeId << " will be updated about the status of the command to Traffic Simulator.";
-        IcsLog::LogLevel((log.str()).c_str(), kLogLevelInfo);
-#endif
-
-        if (!m_appMessageManager->CommandSendSubscriptionAppCmdTraffSim(resultStatus, nodeId)) {
-            IcsLog::LogLevel("SendSubscribedData() Error sending scheduling status report.", kLogLevelError);
-            return EXIT_FAILURE;
-        }
-        return EXIT_SUCCESS;
-    }
-    if (typeinfo == typeid(SubsAppResultTraffSim)) {
-
-        SubsAppResultTraffSim* subsAppResultTraffSim = static_cast<SubsAppResultTraffSim*>(subscription);
-        vector<unsigned char> tsInfo = subsAppResultTraffSim->pull(m_syncManager);
-
-#ifdef LOG_ON
-        stringstream log;
-        log << "SubsAppResultTraffSim() Node " << nodeId << " will pull the Traffic Simulator for data.";
-        IcsLog::LogLevel((log.str()).c_str(), kLogLevelInfo);
-#endif
-
-        if (!m_appMessageManager->CommandSendSubscriptionAppResultTraffSim(tsInfo, nodeId)) {
-            IcsLog::LogLevel("SendSubscribedData() Error sending scheduling status report.", kLogLevelError);
+            log << "SendSubscribedData() Error collecting the data of subscription " << subscription->m_name << " of node " << nodeId;
+            IcsLog::LogLevel((log.str()).c_str(), kLogLevelError);
+            cout << "iCS --> [ERROR] " << log.str() << endl;
             return EXIT_FAILURE;
         }
-        return EXIT_SUCCESS;
+        subscription->Encode(nodeId, batch);
     }
-    if (typeinfo == typeid(SubsXApplicationData)) {
-
 
-        SubsXApplicationData* subsXApplicationData = static_cast<SubsXApplicationData*>(subscription);
-       // vector<unsigned char> xAppData = subsXApplicationData->pull(m_syncManager);
-        vector<unsigned char> xAppData = subsXApplicationData->returnStatus();
-
-#ifdef LOG_ON
-        stringstream log;
-        log << "SubsXApplicationData() Node " << nodeId << " will pull cross-application data.";
-        IcsLog::LogLevel((log.str()).c_str(), kLogLevelInfo);
-#endif
-
-        if (!m_appMessageManager->CommandSendSubscriptionXApplicationData(xAppData, nodeId)) {
-            IcsLog::LogLevel("SendSubscribedData() Error sending scheduling status report.", kLogLevelError);
-            return EXIT_FAILURE;
-        }
-        return EXIT_SUCCESS;
+    if (!m_appMessageManager->CommandSendSubscribedData(nodeId, batch)) {
+        cout << "iCS --> [ERROR] SendSubscribedData() Error sending the subscribed data of node " << nodeId << endl;
+        IcsLog::LogLevel("SendSubscribedData() Error sending the subscribed data.", kLogLevelError);
+        return EXIT_FAILURE;
     }
 
-
-    return EXIT_FAILURE;
+    return EXIT_SUCCESS;
 }
 
 bool
@@ -415,65 +201,170 @@ ApplicationHandler::SendMessageStatus(int nodeId, ResultContainer* result)
         return EXIT_FAILURE;
     }
 
-    const std::type_info& typeinfo = typeid(*result);
-    if (typeinfo == typeid(ResultSetMaximumSpeed)) {
-        ResultSetMaximumSpeed* resultMaxSpeed = static_cast<ResultSetMaximumSpeed*>(result);
-        vector< pair<int,stationID_t> > messages;
-        messages = resultMaxSpeed->GetReceivedMessages();
-        if (m_appMessageManager->NotifyMessageStatus(nodeId, messages) == EXIT_FAILURE) {
-            return EXIT_FAILURE;
-        }
+    if (!result->ReportsMessageStatus()) {
+        IcsLog::LogLevel("SendMessageStatus() The application does not send message status.", kLogLevelInfo);
         return EXIT_SUCCESS;
     }
 
-    if (typeinfo == typeid(ResultTravelTime)) {
-        ResultTravelTime* resultTravelTime= static_cast<ResultTravelTime*>(result);
-        vector< pair<int,stationID_t> > messages;
-        messages = resultTravelTime->GetReceivedMessages();
-        if (m_appMessageManager->NotifyMessageStatus(nodeId, messages) == EXIT_FAILURE) {
-            return EXIT_FAILURE;
-        }
-        return EXIT_SUCCESS;
+    vector< pair<int,stationID_t> > messages = result->GetReceivedMessages();
+    if (m_appMessageManager->NotifyMessageStatus(nodeId, messages) == EXIT_FAILURE) {
+        return EXIT_FAILURE;
     }
+    return EXIT_SUCCESS;
+}
 
-    if (typeinfo == typeid(ResultTrafficJamDetection)) {
-        ResultTrafficJamDetection* resultTrafficJam = static_cast<ResultTrafficJamDetection*>(result);
-        vector< pair<int,stationID_t> > messages;
-        messages = resultTrafficJam->GetReceivedMessages();
-        if (m_appMessageManager->NotifyMessageStatus(nodeId, messages) == EXIT_FAILURE) {
-            return EXIT_FAILURE;
-        }
-        return EXIT_SUCCESS;
+bool
+ApplicationHandler::UsesMultiNodeBatches() const
+{
+    return m_appMessageManager->GetProtocolVersion() >= APP_PROTOCOL_VERSION_MULTI_NODE;
+}
+
+ResultContainer*
+ApplicationHandler::GetResultContainer(ITetrisNode* node) const
+{
+    for (vector<ResultContainer*>::iterator it = node->m_resultContainerCollection->begin(); it != node->m_resultContainerCollection->end(); ++it) {
+        if ((*it)->m_applicationHandlerId == m_id)
+            return *it;
     }
+    return NULL;
+}
 
-    if (typeinfo == typeid(ResultTravelTime)) {
+bool
+ApplicationHandler::AskForNewSubscriptions(const vector<ITetrisNode*>& nodes, vector<vector<Subscription*> >& subscriptions)
+{
+    vector<int> nodeIds;
+    nodeIds.reserve(nodes.size());
+    for (vector<ITetrisNode*>::const_iterator it = nodes.begin(); it != nodes.end(); ++it)
+        nodeIds.push_back((*it)->m_icsId);
 
-        stringstream log;
-        log << "SendMessageStatus() The application does not send message status.";
-        IcsLog::LogLevel((log.str()).c_str(), kLogLevelInfo);
+    return m_appMessageManager->CommandGetNewSubscriptions(nodeIds, m_id, subscriptions);
+}
 
-        return EXIT_SUCCESS;
+bool
+ApplicationHandler::AskForUnsubscriptions(const vector<ITetrisNode*>& nodes)
+{
+    // As in the per node variant, the application is asked about all the subscriptions of the node
+    vector<pair<int,Subscription*> > candidates;
+    for (vector<ITetrisNode*>::const_iterator it = nodes.begin(); it != nodes.end(); ++it) {
+        vector<Subscription*>* subscriptions = (*it)->m_subscriptionCollection;
+        for (vector<Subscription*>::iterator subIt = subscriptions->begin(); subIt != subscriptions->end(); ++subIt)
+            candidates.push_back(make_pair((*it)->m_icsId, *subIt));
     }
 
-    if (typeinfo == typeid(ResultVoid)) {
+    vector<int> results;
+    if (!m_appMessageManager->CommandUnsubscribe(candidates, results))
+        return false;
+
+    unsigned int index = 0;
+    for (vector<ITetrisNode*>::const_iterator it = nodes.begin(); it != nodes.end(); ++it) {
+        int nodeId = (*it)->m_icsId;
+        vector<Subscription*>* subscriptions = (*it)->m_subscriptionCollection;
+        vector<Subscription*> kept;
+        kept.reserve(subscriptions->size());
+        for (vector<Subscription*>::iterator subIt = subscriptions->begin(); subIt != subscriptions->end(); ++subIt, ++index) {
+            switch (results[index]) {
+            case 0: {
+                stringstream log;
+                log << "AskForUnsubscriptions() subscription in node [iCD-ID] [" << nodeId << "] is alive.";
+                IcsLog::LogLevel((log.str()).c_str(), kLogLevelInfo);
+                kept.push_back(*subIt);
+                break;
+            }
+            case 1: {
+                stringstream log;
+                log << "AskForUnsubscriptions() unsubscribing in node [iCD-ID] [" << nodeId << "]";
+                IcsLog::LogLevel((log.str()).c_str(), kLogLevelInfo);
+                break;
+            }
+            case -1: {
+                stringstream log;
+                log << "AskForUnsubscriptions() unsubscribing in node [iCD-ID] [" << nodeId << "]";
+                IcsLog::LogLevel((log.str()).c_str(), kLogLevelError);
+                cerr << "iCS --> [ERROR] AskForUnsubscriptions() unsubscribing node [iCD-ID] [" << nodeId << "]" << endl;
+                return false;
+            }
+            default:
+                IcsLog::LogLevel("AskForUnsubscriptions() Unknown error code.", kLogLevelWarning);
+                kept.push_back(*subIt);
+                break;
+            }
+        }
+        subscriptions->swap(kept);
+    }
 
-        stringstream log;
-        log << "SendMessageStatus() The application does not send message status.";
-        IcsLog::LogLevel((log.str()).c_str(), kLogLevelInfo);
+    return true;
+}
 
-        return EXIT_SUCCESS;
+int
+ApplicationHandler::SendSubscribedData(const vector<ITetrisNode*>& nodes)
+{
+    vector<int> nodeIds;
+    vector<AppCommandBatch> batches;
+    nodeIds.reserve(nodes.size());
+    batches.reserve(nodes.size());
+
+    for (vector<ITetrisNode*>::const_iterator it = nodes.begin(); it != nodes.end(); ++it) {
+        ITetrisNode* node = *it;
+        bool hasSubscriptions = false;
+        for (vector<Subscription*>::iterator subIt = node->m_subscriptionCollection->begin(); subIt != node->m_subscriptionCollection->end(); ++subIt) {
+            Subscription* subscription = *subIt;
+            if (subscription->m_appId != m_id) // Check if the subscription was created by the application
+                continue;
+            if (!hasSubscriptions) {
+                nodeIds.push_back(node->m_icsId);
+                batches.push_back(AppCommandBatch());
+                hasSubscriptions = true;
+            }
+            if (subscription->Collect(m_syncManager) == EXIT_FAILURE) {
+                stringstream log;
+                log << "SendSubscribedData() Error collecting the data of subscription " << subscription->m_name << " of node " << node->m_icsId;
+                IcsLog::LogLevel((log.str()).c_str(), kLogLevelError);
+                cout << "iCS --> [ERROR] " << log.str() << endl;
+                return EXIT_FAILURE;
+            }
+            subscription->Encode(node->m_icsId, batches.back());
+        }
     }
-    if (typeinfo == typeid(ResultGeneric)) {
 
-        stringstream log;
-        log << "SendMessageStatus() The application does not send message status.";
-        IcsLog::LogLevel((log.str()).c_str(), kLogLevelInfo);
+    if (!m_appMessageManager->CommandSendSubscribedData(nodeIds, batches)) {
+        cout << "iCS --> [ERROR] SendSubscribedData() Error sending the subscribed data of the nodes." << endl;
+        IcsLog::LogLevel("SendSubscribedData() Error sending the subscribed data.", kLogLevelError);
+        return EXIT_FAILURE;
+    }
 
-        return EXIT_SUCCESS;
+    return EXIT_SUCCESS;
+}
+
+bool
+ApplicationHandler::ExecuteApplication(const vector<ITetrisNode*>& nodes)
+{
+    vector<int> nodeIds;
+    vector<ResultContainer*> resultContainers;
+    for (vector<ITetrisNode*>::const_iterator it = nodes.begin(); it != nodes.end(); ++it) {
+        ResultContainer* resultContainer = GetResultContainer(*it);
+        if (resultContainer == NULL)
+            continue;
+        nodeIds.push_back((*it)->m_icsId);
+        resultContainers.push_back(resultContainer);
+    }
+
+    return m_appMessageManager->CommandApplicationToExecute(nodeIds, resultContainers);
+}
+
+int
+ApplicationHandler::SendMessageStatus(const vector<ITetrisNode*>& nodes)
+{
+    vector<int> nodeIds;
+    vector< vector< pair<int,stationID_t> > > messages;
+    for (vector<ITetrisNode*>::const_iterator it = nodes.begin(); it != nodes.end(); ++it) {
+        ResultContainer* result = GetResultContainer(*it);
+        if (result == NULL || !result->ReportsMessageStatus())
+            continue;
+        nodeIds.push_back((*it)->m_icsId);
+        messages.push_back(result->GetReceivedMessages());
     }
 
-    cerr << "iCS --> [ERROR] SendMessageStatus() node " << nodeId << " The result type is not implemented in iTETRIS " << typeinfo.name() << endl;
-    return EXIT_FAILURE;
+    return m_appMessageManager->NotifyMessageStatus(nodeIds, messages);
 }
 
 
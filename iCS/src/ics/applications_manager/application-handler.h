@@ -147,13 +147,12 @@ public:
     bool AskForUnsubscriptions(int nodeId, std::vector<Subscription*>* subscriptions);
 
     /**
-    * @brief Sends the information about the subscription to the application.
+    * @brief Sends the data of the subscriptions of a node to the application, in a single batch.
     * @param[in] nodeId Node identifier.
-    * @param[in] subscription Subscription.
-    * @param[in] nodes Collection of iTetris nodes.
+    * @param[in] subscriptions The subscriptions of the node created by the application.
     * @return EXIT_SUCCESS if the information is sent correctly, EXIT_FAILURE otherwise.
     */
-    int SendSubscribedData(int nodeId, Subscription* subscription, std::vector<ITetrisNode*>* nodes);
+    int SendSubscribedData(int nodeId, std::vector<Subscription*>& subscriptions);
 
     /**
     * @brief Executes the application
@@ -171,6 +170,36 @@ public:
     * @return EXIT_SUCCESS if the information is sent correctly, EXIT_FAILURE otherwise.
     */
     int SendMessageStatus(int nodeId, ResultContainer* result);
+
+    /// @brief True if the application takes the commands of all the nodes in one message per phase.
+    bool UsesMultiNodeBatches() const;
+
+    // Variants of the phases above for all the nodes the application is installed in,
+    // each one sent in a single message. Only for applications using multi-node batches.
+
+    /**
+    * @brief Asks the application for the new subscriptions of several nodes.
+    * @param[in] nodes The nodes the application is installed in.
+    * @param[out] subscriptions The new subscriptions of each node, in the order of nodes.
+    */
+    bool AskForNewSubscriptions(const std::vector<ITetrisNode*>& nodes, std::vector<std::vector<Subscription*> >& subscriptions);
+
+    /// @brief Asks the application whether to drop the subscriptions of several nodes, and removes the dropped ones from the nodes.
+    bool AskForUnsubscriptions(const std::vector<ITetrisNode*>& nodes);
+
+    /// @brief Sends the data of the subscriptions created by the application in several nodes.
+    int SendSubscribedData(const std::vector<ITetrisNode*>& nodes);
+
+    /// @brief Executes the application in several nodes.
+    bool ExecuteApplication(const std::vector<ITetrisNode*>& nodes);
+
+    /// @brief Tells the application about the status of the messages of several nodes.
+    int SendMessageStatus(const std::vector<ITetrisNode*>& nodes);
+
+private:
+
+    /// @brief The result container of the application in a node, NULL if there is none.
+    ResultContainer* GetResultContainer(ITetrisNode* node) const;
 };
 
 }
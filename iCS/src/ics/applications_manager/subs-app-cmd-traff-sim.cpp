@@ -22,6 +22,7 @@
 #include <cstring>
 
 #include "subs-app-cmd-traff-sim.h"
+#include "app-message-manager.h"
 #include "subscriptions-helper.h"
 #include "../sync-manager.h"
 #include "../../utils/ics/log/ics-log.h"
@@ -197,4 +198,10 @@ bool SubsAppCmdTraffSim::returnStatus()
     return m_resultStatus;
 }
 
+void SubsAppCmdTraffSim::Encode(int nodeId, AppCommandBatch& batch)
+{
+    AppMessageManager::EncodeNodeStatus(batch.GetStorage(), CMD_APP_CMD_TRAFF_SIM, m_resultStatus, nodeId);
+    batch.EndCommand(CMD_APP_CMD_TRAFF_SIM);
+}
+
 } // end namespace ics
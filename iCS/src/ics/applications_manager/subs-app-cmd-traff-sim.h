@@ -72,6 +72,9 @@ public:
     */
     bool returnStatus();
 
+    /// @brief Appends CMD_APP_CMD_TRAFF_SIM with the result of the command.
+    void Encode(int nodeId, AppCommandBatch& batch);
+
     /**
     * @brief Deletes the subscription according to the input parameters.
     * @param[in] subscriptions Collection of subscriptions to delete
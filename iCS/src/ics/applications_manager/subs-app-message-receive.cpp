@@ -23,6 +23,7 @@
 #include <algorithm>
 
 #include "subs-app-message-receive.h"
+#include "app-message-manager.h"
 
 #include "subs-app-message-send.h"
 #include "subscriptions-type-constants.h"
@@ -390,24 +391,18 @@ Circle getCircleFromArea(Area2D* area);
 
 //===================================================================
 
-int
-SubsAppMessageReceive::InformApp(AppMessageManager* messageManager)
+void
+SubsAppMessageReceive::Encode(int nodeId, AppCommandBatch& batch)
 {
     if (m_appMsgReceived == false) {
-        IcsLog::LogLevel("InformApp() No information about SubsAppMessageReceive will be sent to app.",kLogLevelInfo);
-        return EXIT_SUCCESS;
+        IcsLog::LogLevel("Encode() No information about SubsAppMessageReceive will be sent to app.",kLogLevelInfo);
+        return;
     }
 
-    else {// At least one message has been received for the application
-    	if (messageManager->CommandSendSubscriptionAppMessageReceive(receivedData) == EXIT_FAILURE) {
-#ifdef LOG_ON
-          IcsLog::LogLevel("iCS --> ProcessReceivedAppMessage() InformAPP - could not send the result of the subscription", kLogLevelError);
-#endif
-    	  return EXIT_FAILURE;
-    	}
-    	m_appMsgReceived = false;
-    	return EXIT_SUCCESS;
-    }
- }
+    // At least one message has been received for the application
+    AppMessageManager::EncodeAppMessageReceive(batch.GetStorage(), receivedData);
+    batch.EndCommand(CMD_APP_MSG_RECEIVE);
+    m_appMsgReceived = false;
+}
 
 }
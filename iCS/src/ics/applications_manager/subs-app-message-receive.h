@@ -125,11 +125,8 @@ public:
     /// @brief Areas for the geocast protocols.
     std::vector<TArea> m_areas;
 
-    /**
-     * @brief Called by the Application Handler to know if a subscription has anything to transmit to an Application
-     * @return True if an message is waiting. False otherwise
-     */
-    int InformApp(AppMessageManager* messageManager);
+    /// @brief Appends CMD_APP_MSG_RECEIVE, if an application message was received since the last timestep.
+    void Encode(int nodeId, AppCommandBatch& batch);
 
     /**
      * @brief Process Application Messages = cross-check if an application asked for the message
@@ -23,6 +23,7 @@
 #include <cstring>
 
 #include "subs-app-message-send.h"
+#include "app-message-manager.h"
 #include "subscriptions-type-constants.h"
 #include "subscriptions-helper.h"
 #include "../sync-manager.h"
@@ -327,6 +328,12 @@ bool SubsAppMessageSend::returnStatus()
     return m_schedulingStatus;
 }
 
+void SubsAppMessageSend::Encode(int nodeId, AppCommandBatch& batch)
+{
+    AppMessageManager::EncodeNodeStatus(batch.GetStorage(), CMD_APP_MSG_SEND, m_schedulingStatus, nodeId);
+    batch.EndCommand(CMD_APP_MSG_SEND);
+}
+
 //===================================================================
 
 
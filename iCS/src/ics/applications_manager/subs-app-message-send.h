@@ -70,6 +70,9 @@ public:
     */
     bool returnStatus();
 
+    /// @brief Appends CMD_APP_MSG_SEND with the scheduling status.
+    void Encode(int nodeId, AppCommandBatch& batch);
+
     /**
      * @brief Returns the application message type.
      */
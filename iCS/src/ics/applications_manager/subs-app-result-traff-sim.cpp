@@ -22,6 +22,7 @@
 #include <cstring>
 
 #include "subs-app-result-traff-sim.h"
+#include "app-message-manager.h"
 #include "subscriptions-helper.h"
 #include "../sync-manager.h"
 #include "../../utils/ics/log/ics-log.h"
@@ -168,4 +169,18 @@ SubsAppResultTraffSim::pull(SyncManager* syncManager)
     std::cout << "[DEB] - The message was correctly sent!!!" << std::endl;
 }
 
+int
+SubsAppResultTraffSim::Collect(SyncManager* syncManager)
+{
+    m_data = pull(syncManager);
+    return EXIT_SUCCESS;
+}
+
+void
+SubsAppResultTraffSim::Encode(int nodeId, AppCommandBatch& batch)
+{
+    AppMessageManager::EncodeNodeData(batch.GetStorage(), CMD_APP_RESULT_TRAFF_SIM, m_data, nodeId);
+    batch.EndCommand(CMD_APP_RESULT_TRAFF_SIM);
+}
+
 } // end namespace ics
@@ -66,6 +66,12 @@ public:
     */
     std::vector<unsigned char> pull(SyncManager* syncManager);
 
+    /// @brief Pulls the subscribed data from the traffic simulator.
+    int Collect(SyncManager* syncManager);
+
+    /// @brief Appends CMD_APP_RESULT_TRAFF_SIM.
+    void Encode(int nodeId, AppCommandBatch& batch);
+
     /**
     * @brief Deletes the subscription according to the input parameters.
     * @param[in] subscriptions Collection of subscriptions to delete
@@ -81,6 +87,9 @@ private:
 #define VALUE_GET_ROUTE_VARIABLE	 	0x04
 
     tcpip::Storage             m_msg;
+
+    /// @brief The data found by Collect().
+    std::vector<unsigned char> m_data;
 };
 
 }
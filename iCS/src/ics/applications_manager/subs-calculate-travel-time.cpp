@@ -67,36 +67,20 @@ SubsCalculateTravelTime::Stop(stationID_t stationId)
     m_endingStationId = stationId;
 }
 
-int
-SubsCalculateTravelTime::InformApp(AppMessageManager* messageManager)
+void
+SubsCalculateTravelTime::Encode(int nodeId, AppCommandBatch& batch)
 {
     if (m_startCommandReceived == false && m_stopCommandReceived == false) {
-        IcsLog::LogLevel("InformApp() No information about SubsCalculateTravelTime will be sent to app.",kLogLevelInfo);
-    }
-
-    // The vehicle go through the starting TTE RSU
-    if (m_startCommandReceived == true && m_stopCommandReceived == false) {
-        if (messageManager->CommandSendSubcriptionCalculateTravelTimeFlags(m_nodeId, m_startingStationId, -1) == EXIT_FAILURE) {
-            return EXIT_FAILURE;
-        }
-    }
-
-    // The vehicle go through the starting TTE RSU and the stop TTE RSU
-    // The App should calculate the TTE
-    if (m_startCommandReceived == true && m_stopCommandReceived == true) {
-        if (messageManager->CommandSendSubcriptionCalculateTravelTimeFlags(m_nodeId, m_startingStationId, m_endingStationId) == EXIT_FAILURE) {
-            return EXIT_FAILURE;
-        }
-    }
-
-    // The vehicle go through the stop TTE RSU but NOT the start TTE RSU
-    if (m_startCommandReceived == false && m_stopCommandReceived == true) {
-        if (messageManager->CommandSendSubcriptionCalculateTravelTimeFlags(m_nodeId, -1, m_endingStationId) == EXIT_FAILURE) {
-            return EXIT_FAILURE;
-        }
+        IcsLog::LogLevel("Encode() No information about SubsCalculateTravelTime will be sent to app.",kLogLevelInfo);
+        return;
     }
 
-    return EXIT_SUCCESS;
+    // The vehicle go through the starting TTE RSU, the stop TTE RSU or both
+    // If it went through both, the App should calculate the TTE
+    int startStation = m_startCommandReceived ? m_startingStationId : -1;
+    int stopStation = m_stopCommandReceived ? m_endingStationId : -1;
+    AppMessageManager::EncodeTravelTimeFlags(batch.GetStorage(), m_nodeId, startStation, stopStation);
+    batch.EndCommand(CMD_TRAVEL_TIME_ESTIMATION);
 }
 
 
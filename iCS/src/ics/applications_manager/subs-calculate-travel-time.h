@@ -65,8 +65,8 @@ public:
     /// @todo To be commented.
     void Stop(ics_types::stationID_t stationId);
 
-    /// @todo To be commented.
-    int InformApp(AppMessageManager* messageManager);
+    /// @brief Appends CMD_TRAVEL_TIME_ESTIMATION once the vehicle went through a starting or an ending TTE RSU.
+    void Encode(int nodeId, AppCommandBatch& batch);
 
     /// @todo To be commented
     int ProcessReceivedGeobroadcastMessage(ScheduledGeobroadcastMessageData message, SyncManager* syncManager);
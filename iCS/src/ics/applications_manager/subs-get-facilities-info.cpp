@@ -21,6 +21,7 @@
 #include <typeinfo>
 
 #include "subs-get-facilities-info.h"
+#include "app-message-manager.h"
 #include "../sync-manager.h"
 #include "../../utils/ics/log/ics-log.h"
 #include "subscriptions-helper.h"
@@ -246,4 +247,23 @@ short int SubsGetFacilitiesInfo::getNumberOfSubscribedFields()
     return (short int) m_subscribedInformation.size();
 }
 
+int
+SubsGetFacilitiesInfo::Collect(SyncManager* syncManager)
+{
+    m_facilitiesInfo = getFacilitiesInformation();
+    return EXIT_SUCCESS;
+}
+
+void
+SubsGetFacilitiesInfo::Encode(int nodeId, AppCommandBatch& batch)
+{
+    if (IcsLog::IsEnabled(kLogLevelInfo)) {
+        stringstream log;
+        log << "Encode() Node " << nodeId << " will be updated about " << getNumberOfSubscribedFields() << " location related fields.";
+        IcsLog::LogLevel((log.str()).c_str(), kLogLevelInfo);
+    }
+    AppMessageManager::EncodeNodeData(batch.GetStorage(), CMD_FACILITIES_INFORMATION, m_facilitiesInfo, nodeId);
+    batch.EndCommand(CMD_FACILITIES_INFORMATION);
+}
+
 }
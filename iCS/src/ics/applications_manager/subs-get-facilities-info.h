@@ -59,6 +59,12 @@ public:
     */
     std::vector<unsigned char> getFacilitiesInformation();
 
+    /// @brief Gets the facilities information of the station in the timestep.
+    int Collect(SyncManager* syncManager);
+
+    /// @brief Appends CMD_FACILITIES_INFORMATION.
+    void Encode(int nodeId, AppCommandBatch& batch);
+
     /**
     * @brief Deletes the subscription according to the input parameters.
     * @param[in] subscriptions Collection of subscriptions to delete
@@ -88,6 +94,9 @@ private:
 
     std::vector<unsigned char> m_subscribedInformation;
 
+    /// @brief The information found by Collect().
+    std::vector<unsigned char> m_facilitiesInfo;
+
     void getTopologicalInformation(unsigned int startPos, unsigned short numFields, std::vector<unsigned char>* info);
     void getReceivedCamInformation(unsigned int startPos, unsigned short numFields, std::vector<unsigned char>* info);
 
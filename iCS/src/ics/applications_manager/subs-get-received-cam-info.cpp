@@ -21,6 +21,7 @@
 #include <typeinfo>
 
 #include "subs-get-received-cam-info.h"
+#include "app-message-manager.h"
 #include "../sync-manager.h"
 #include "../../utils/ics/log/ics-log.h"
 
@@ -86,5 +87,32 @@ SubsGetReceivedCamInfo::getInformationFromLastReceivedCAMs()
     return info;
 }
 
+int
+SubsGetReceivedCamInfo::Collect(SyncManager* syncManager)
+{
+    std::vector<ics_types::TCamInformation>* camInfo = getInformationFromLastReceivedCAMs();
+    if (camInfo == NULL) {
+        IcsLog::LogLevel("Collect() received CAMs are NULL.", kLogLevelError);
+        return EXIT_FAILURE;
+    }
+    m_camInfo.swap(*camInfo);
+    delete camInfo;
+    return EXIT_SUCCESS;
+}
+
+void
+SubsGetReceivedCamInfo::Encode(int nodeId, AppCommandBatch& batch)
+{
+    if (IcsLog::IsEnabled(kLogLevelInfo)) {
+        stringstream log;
+        log << "Encode() Node " << nodeId << " received " << m_camInfo.size() << " CAM messages in the last time step.";
+        IcsLog::LogLevel((log.str()).c_str(), kLogLevelInfo);
+    }
+    if (m_camInfo.empty())
+        return;
+    AppMessageManager::EncodeReceivedCamInfo(batch.GetStorage(), m_camInfo, nodeId);
+    batch.EndCommand(CMD_RECEIVED_CAM_INFO);
+    m_camInfo.clear();
+}
 
 }
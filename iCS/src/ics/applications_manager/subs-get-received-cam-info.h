@@ -55,6 +55,12 @@ public:
     */
     std::vector<ics_types::TCamInformation>* getInformationFromLastReceivedCAMs();
 
+    /// @brief Gets the information of the CAMs received in the last timestep.
+    int Collect(SyncManager* syncManager);
+
+    /// @brief Appends CMD_RECEIVED_CAM_INFO, if the station received any CAM.
+    void Encode(int nodeId, AppCommandBatch& batch);
+
     /**
     * @brief Deletes the subscription according to the input parameters.
     * @param[in] subscriptions Collection of subscriptions to delete
@@ -62,6 +68,10 @@ public:
     */
     static int Delete(ics_types::stationID_t stationID, std::vector<Subscription*>* subscriptions);
 
+private:
+
+    /// @brief The information of the CAMs found by Collect().
+    std::vector<ics_types::TCamInformation> m_camInfo;
 };
 
 }
@@ -28,10 +28,12 @@
 #include <math.h>
 
 #include "subs-return-cars-zone.h"
+#include "app-message-manager.h"
 #include "../itetris-node.h"
 #include "../vehicle-node.h"
 #include "../ics.h"
 #include "../sync-manager.h"
+#include "../node-position-index.h"
 #include "../../utils/ics/log/ics-log.h"
 #include "../../utils/ics/geometric/Circle.h"
 
@@ -88,64 +90,51 @@ SubsReturnsCarInZone::SubsReturnsCarInZone(int appId, stationID_t stationId, flo
 SubsReturnsCarInZone::~SubsReturnsCarInZone() { }
 
 vector<VehicleNode*>*
-SubsReturnsCarInZone::GetCarsInZone(vector<VehicleNode*>* vehicles)
+SubsReturnsCarInZone::GetCarsInZone(const NodePositionIndex& index)
 {
-    if (vehicles == NULL) {
-        cout << "[GetCarsInZone] [ERROR] Input parameter is NULL" << endl;
-        return NULL;
-    }
-
     // Container to return the nodes in zone
     vector<VehicleNode*>* nodesInZone = new vector<VehicleNode*>();
 
-    // Get the IDs of the nodes in area from the facilities
-    Point2D point(m_baseX, m_baseY);
-    Circle area(point, m_radius);
-    vector<stationID_t>* nodesInArea = SyncManager::m_facilitiesManager->getMobileStationsIDsInArea(area);
-    if (nodesInArea->size() == 0) {
-
-        stringstream log;
-        log << "[INFO] GetCarsInZone() There are 0 nodes of total " << vehicles->size()  << " vehicles in the area according to the Facilities";
-        IcsLog::LogLevel((log.str()).c_str(), kLogLevelInfo);
-
-        delete nodesInArea;
-        return nodesInZone;
+    vector<ITetrisNode*> nodesInArea;
+    index.GetNodesInCircle(m_baseX, m_baseY, m_radius, nodesInArea);
+    for (vector<ITetrisNode*>::iterator nodeIt = nodesInArea.begin(); nodeIt != nodesInArea.end(); nodeIt++) {
+        ITetrisNode& node = *(*nodeIt);
+        if (typeid(node) == typeid(VehicleNode)) {
+            nodesInZone->push_back(static_cast<VehicleNode*>(*nodeIt));
+        }
     }
 
-    else {
+    if (IcsLog::IsEnabled(kLogLevelInfo)) {
         stringstream log;
-        log << "[INFO] GetCarsInZone() There are in area nodes " << nodesInArea->size();
+        log << "[INFO] GetCarsInZone() There are " << nodesInZone->size() << " vehicles of "
+            << index.Size() << " stations in the area";
         IcsLog::LogLevel((log.str()).c_str(), kLogLevelInfo);
     }
 
-     stringstream log1;
-     log1 << "[INFO] GetCarsInZone() Starting the Lookup ";
-     IcsLog::LogLevel((log1.str()).c_str(), kLogLevelInfo);
-    // Process to get the pointer to the vehicle
-    // Loop all the vehicles in iTETRIS
-    for (vector<VehicleNode*>::iterator nodeIt=vehicles->begin() ; nodeIt < vehicles->end() ; nodeIt++) {
-        VehicleNode* vehicle = *nodeIt;
-        stringstream log1;
-	log1 << "[INFO] GetCarsInZone() Full Vehicle List: Vehicle ID " << vehicle->m_icsId;
-	IcsLog::LogLevel((log1.str()).c_str(), kLogLevelInfo);
-        // Loop the IDs of the vehicles in the area
-        for (vector<stationID_t>::iterator areaNodesIt=nodesInArea->begin() ; areaNodesIt < nodesInArea->end() ; areaNodesIt++) {
-            stationID_t nodeInAreaID = *areaNodesIt;
-            stringstream log2;
-	    log2 << "[INFO] GetCarsInZone() Nodes in Area: Vehicle ID " << nodeInAreaID;
-	    IcsLog::LogLevel((log2.str()).c_str(), kLogLevelInfo);
-            if (nodeInAreaID ==  vehicle->m_icsId) { // If the IDs match, include the pointer in the collection to return
-	    stringstream log3;
-	    log3 << "[INFO] GetCarsInZone() Logging node " << nodeInAreaID;
-	    IcsLog::LogLevel((log3.str()).c_str(), kLogLevelInfo);
-                nodesInZone->push_back(vehicle);
-            }
-        }
-    }
-    delete nodesInArea;
     return nodesInZone;
 }
 
+int
+SubsReturnsCarInZone::Collect(SyncManager* syncManager)
+{
+    vector<VehicleNode*>* carsInZone = GetCarsInZone(syncManager->GetNodePositionIndex());
+    m_carsInZone.swap(*carsInZone);
+    delete carsInZone;
+    return EXIT_SUCCESS;
+}
+
+void
+SubsReturnsCarInZone::Encode(int nodeId, AppCommandBatch& batch)
+{
+    if (m_carsInZone.empty()) {
+        IcsLog::LogLevel("Encode() Cars in zone are 0.", kLogLevelInfo);
+        return;
+    }
+    AppMessageManager::EncodeCarsInZone(batch.GetStorage(), m_carsInZone, nodeId);
+    batch.EndCommand(CMD_CARS_IN_ZONE);
+    m_carsInZone.clear();
+}
+
 int
 SubsReturnsCarInZone::ProcessReceivedGeobroadcastMessage(ScheduledGeobroadcastMessageData message, SyncManager* syncManager)
 {
@@ -31,6 +31,7 @@ namespace ics
 // class declarations
 // ===========================================================================
 class VehicleNode;
+class NodePositionIndex;
 
 // ===========================================================================
 // class definitions
@@ -58,10 +59,16 @@ public:
 
     /**
     * @brief Identifies the existing vehicles in a certain zone.
-    * @param[in] vehicles Collection of vehicles in a certain zone.
+    * @param[in] index Positions of the stations in the current timestep.
     * @return Collection of vehicles in a certain zone.
     */
-    std::vector<VehicleNode*>* GetCarsInZone(std::vector<VehicleNode*>* vehicles);
+    std::vector<VehicleNode*>* GetCarsInZone(const NodePositionIndex& index);
+
+    /// @brief Looks up the vehicles in the zone, with the positions indexed for the timestep.
+    int Collect(SyncManager* syncManager);
+
+    /// @brief Appends CMD_CARS_IN_ZONE, if there are vehicles in the zone.
+    void Encode(int nodeId, AppCommandBatch& batch);
 
     /**
     * @brief Deletes the subscription according to the input parameters.
@@ -89,6 +96,9 @@ private:
 
     /// @brief The radious value of the base point.
     float m_radius;
+
+    /// @brief The vehicles in the zone found by Collect().
+    std::vector<VehicleNode*> m_carsInZone;
 };
 
 }
@@ -20,6 +20,8 @@
 
 #include <typeinfo>
 #include <math.h>
+#include <algorithm>
+#include <iterator>
 
 #include "subs-set-cam-area.h"
 #include "app-commands-subscriptions-constants.h"
@@ -27,6 +29,7 @@
 #include "../ics.h"
 #include "../../utils/ics/geometric/Circle.h"
 #include "../sync-manager.h"
+#include "../node-position-index.h"
 #include "../../utils/ics/iCStypes.h"
 #include "../../utils/ics/log/ics-log.h"
 
@@ -238,40 +241,23 @@ SubsSetCamArea::GetFrequency()
 void
 SubsSetCamArea::RemoveNodeFromVector(ITetrisNode* node)
 {
-    vector<ITetrisNode*>::iterator nodeIt;
-    for (nodeIt=m_nodesInArea->begin() ; nodeIt < m_nodesInArea->end() ; nodeIt++) {
-
-        if ((*nodeIt)==node) {
-            m_nodesInArea->erase(nodeIt);
-            break;
-        }
-    }
+    vector<ITetrisNode*>::iterator nodeIt = lower_bound(m_nodesInArea->begin(), m_nodesInArea->end(), node);
+    if (nodeIt != m_nodesInArea->end() && *nodeIt == node)
+        m_nodesInArea->erase(nodeIt);
 }
 
 void
 SubsSetCamArea::AddNodeToVector(ITetrisNode* node)
 {
-    bool alreadyPresent = false;
-    vector<ITetrisNode*>::iterator nodeIt;
-    for (nodeIt=m_nodesInArea->begin() ; nodeIt < m_nodesInArea->end() ; nodeIt++) {
-        if ((*nodeIt)==node) {
-            alreadyPresent = true;
-            break;
-        }
-    }
-    if (!alreadyPresent)
-        m_nodesInArea->push_back(node);
+    vector<ITetrisNode*>::iterator nodeIt = lower_bound(m_nodesInArea->begin(), m_nodesInArea->end(), node);
+    if (nodeIt == m_nodesInArea->end() || *nodeIt != node)
+        m_nodesInArea->insert(nodeIt, node);
 }
 
 bool
 SubsSetCamArea::IsNodeInVector(ITetrisNode* node)
 {
-    vector<ITetrisNode*>::iterator nodeIt;
-    for (nodeIt=m_nodesInArea->begin() ; nodeIt < m_nodesInArea->end() ; nodeIt++) {
-        if ((*nodeIt)==node)
-            return true;
-    }
-    return false;
+    return binary_search(m_nodesInArea->begin(), m_nodesInArea->end(), node);
 }
 
 int
@@ -315,6 +301,23 @@ SubsSetCamArea::checkNodeStatus(ITetrisNode* node)
     return UnknownStatus;   // Rises an error!
 }
 
+const vector<ITetrisNode*>&
+SubsSetCamArea::UpdateNodesInArea(const NodePositionIndex& index, vector<ITetrisNode*>* arrived, vector<ITetrisNode*>* left)
+{
+    vector<ITetrisNode*> nodesNowInArea;
+    index.GetNodesInCircle(m_baseX, m_baseY, m_radius, nodesNowInArea);
+    sort(nodesNowInArea.begin(), nodesNowInArea.end());
+
+    // Both vectors are sorted: the transitions are their differences
+    if (arrived != NULL)
+        set_difference(nodesNowInArea.begin(), nodesNowInArea.end(), m_nodesInArea->begin(), m_nodesInArea->end(), back_inserter(*arrived));
+    if (left != NULL)
+        set_difference(m_nodesInArea->begin(), m_nodesInArea->end(), nodesNowInArea.begin(), nodesNowInArea.end(), back_inserter(*left));
+
+    m_nodesInArea->swap(nodesNowInArea);
+    return *m_nodesInArea;
+}
+
 std::vector<ITetrisNode*>*
 SubsSetCamArea::getNodesInArea()
 {
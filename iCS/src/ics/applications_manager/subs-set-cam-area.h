@@ -39,6 +39,7 @@ namespace ics
 // ===========================================================================
 class ITetrisNode;
 class SyncManager;
+class NodePositionIndex;
 
 // ===========================================================================
 // enum definitions
@@ -150,6 +151,15 @@ public:
      */
     nodeStatusInArea_t checkNodeStatus(ITetrisNode* node);
 
+    /**
+     * @brief      Updates the nodes in the area with the positions of the current timestep.
+     * @param[in]  index Positions of the stations in the current timestep.
+     * @param[out] arrived If not NULL, the nodes that just arrived in the area are appended.
+     * @param[out] left If not NULL, the nodes that just left the area are appended.
+     * @return     The nodes now in the area.
+     */
+    const std::vector<ITetrisNode*>& UpdateNodesInArea(const NodePositionIndex& index, std::vector<ITetrisNode*>* arrived, std::vector<ITetrisNode*>* left);
+
     /**
      * @brief      Returns the nodes in the area
      * @param[out] m_nodesInArea.
@@ -216,7 +226,7 @@ public:
 
 private:
 
-    /// @brief Nodes that are currently in the area.
+    /// @brief Nodes that are currently in the area, sorted by address.
     std::vector<ITetrisNode*>* m_nodesInArea;
 
     /// @brief The X value of the base point.
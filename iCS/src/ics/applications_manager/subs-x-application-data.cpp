@@ -24,6 +24,7 @@
 #include "app-result-generic.h"
 #include "subscriptions-type-constants.h"
 #include "app-commands-subscriptions-constants.h"
+#include "app-message-manager.h"
 #include "../itetris-node.h"
 #include "../sync-manager.h"
 #include "../../utils/ics/log/ics-log.h"
@@ -145,6 +146,11 @@ std::vector<unsigned char> SubsXApplicationData::returnStatus() {
     return m_data;
 }
 
+void SubsXApplicationData::Encode(int nodeId, AppCommandBatch& batch) {
+    AppMessageManager::EncodeNodeData(batch.GetStorage(), CMD_X_APPLICATION_DATA, m_data, nodeId);
+    batch.EndCommand(CMD_X_APPLICATION_DATA);
+}
+
 SubsXApplicationData::~SubsXApplicationData() { }
 
 
@@ -66,6 +66,9 @@ public:
     */
     std::vector<unsigned char> returnStatus();
 
+    /// @brief Appends CMD_X_APPLICATION_DATA with the data set by the other applications.
+    void Encode(int nodeId, AppCommandBatch& batch);
+
     /**
     * @brief Deletes the subscription according to the input parameters.
     * @param[in] subscriptions Collection of subscriptions to delete
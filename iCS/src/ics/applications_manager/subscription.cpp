@@ -55,4 +55,13 @@ Subscription::ProcessReceivedUnicastMessage(ScheduledUnicastMessageData message)
     return EXIT_FAILURE;
 }
 
+int
+Subscription::Collect(SyncManager* syncManager)
+{
+    return EXIT_SUCCESS;
+}
+
+void
+Subscription::Encode(int nodeId, AppCommandBatch& batch) { }
+
 }
@@ -31,6 +31,11 @@
 namespace ics
 {
 
+// ===========================================================================
+// class declarations
+// ===========================================================================
+class AppCommandBatch;
+
 // ===========================================================================
 // class definitions
 // ===========================================================================
@@ -57,6 +62,21 @@ public:
     /// @todo To be commented
     virtual int ProcessReceivedUnicastMessage(ScheduledUnicastMessageData message);
 
+    /**
+    * @brief Gathers the data the subscription reports to the application in the current timestep.
+    * @param[in] syncManager Gives access to the state of the simulation.
+    * @return EXIT_SUCCESS if the data was gathered, EXIT_FAILURE otherwise.
+    */
+    virtual int Collect(SyncManager* syncManager);
+
+    /**
+    * @brief Appends the commands carrying the data gathered by Collect() to the batch of the node.
+    * Subscriptions with nothing to report append nothing, which is the default.
+    * @param[in] nodeId The identifier of the node the data is sent for.
+    * @param[in,out] batch The commands sent to the application that owns the subscription.
+    */
+    virtual void Encode(int nodeId, AppCommandBatch& batch);
+
     /// @brief Stores the amount of subscription in the simulator.
     static int m_subscriptionCounter;
 
@@ -0,0 +1,167 @@
+/****************************************************************************/
+/// @file    checkpoint.cpp
+/// @author  iTETRIS
+/// @date
+/// @version $Id:
+///
+/****************************************************************************/
+// iTETRIS, see http://www.ict-itetris.eu
+// Copyright © 2008 iTetris Project Consortium - All rights reserved
+/****************************************************************************/
+
+// ===========================================================================
+// included modules
+// ===========================================================================
+#ifdef _MSC_VER
+#include <windows_config.h>
+#else
+#include <config.h>
+#endif
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+
+#include <foreign/tcpip/storage.h>
+#include "checkpoint.h"
+
+// ===========================================================================
+// used namespaces
+// ===========================================================================
+using namespace std;
+using namespace tcpip;
+using namespace ics_types;
+
+namespace ics
+{
+
+// ===========================================================================
+// constants
+// ===========================================================================
+static const char* CHECKPOINT_FORMAT = "iCS checkpoint";
+static const int CHECKPOINT_VERSION = 1;
+
+// ===========================================================================
+// member method definitions
+// ===========================================================================
+Checkpoint::Checkpoint()
+{
+    m_step = -1;
+    m_idCounter = -1;
+}
+
+bool
+Checkpoint::Write(const string& path) const
+{
+    Storage out;
+    out.writeString(CHECKPOINT_FORMAT);
+    out.writeInt(CHECKPOINT_VERSION);
+    out.writeInt(m_step);
+    out.writeInt(m_idCounter);
+    out.writeInt(m_preAssignedIds.size());
+    for (set<stationID_t>::const_iterator it = m_preAssignedIds.begin(); it != m_preAssignedIds.end(); ++it)
+        out.writeInt(*it);
+
+    out.writeInt(m_vehicles.size());
+    for (vector<CheckpointVehicle>::const_iterator it = m_vehicles.begin(); it != m_vehicles.end(); ++it) {
+        out.writeString(it->tsId);
+        out.writeInt(it->icsId);
+        out.writeFloat(it->x);
+        out.writeFloat(it->y);
+        out.writeFloat(it->speed);
+        out.writeFloat(it->acceleration);
+        out.writeFloat(it->direction);
+        out.writeFloat(it->length);
+        out.writeFloat(it->width);
+        out.writeFloat(it->height);
+        out.writeUnsignedByte(it->exteriorLights ? 1 : 0);
+        out.writeString(it->lane);
+        out.writeInt(it->rats.size());
+        for (vector<pair<RATID, bool> >::const_iterator rat = it->rats.begin(); rat != it->rats.end(); ++rat) {
+            out.writeUnsignedByte(rat->first);
+            out.writeUnsignedByte(rat->second ? 1 : 0);
+        }
+        out.writeInt(it->applications.size());
+        for (vector<int>::const_iterator app = it->applications.begin(); app != it->applications.end(); ++app)
+            out.writeInt(*app);
+    }
+
+    ofstream file(path.c_str(), ios::out | ios::binary | ios::trunc);
+    if (!file.good()) {
+        cout << "iCS --> [ERROR] Could not create the checkpoint " << path << endl;
+        return false;
+    }
+    file.write((const char*) &*out.begin(), out.size());
+    return file.good();
+}
+
+bool
+Checkpoint::Read(const string& path)
+{
+    ifstream file(path.c_str(), ios::in | ios::binary);
+    if (!file.good()) {
+        cout << "iCS --> [ERROR] Could not open the checkpoint " << path << endl;
+        return false;
+    }
+    vector<unsigned char> buffer((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+
+    try {
+        if (buffer.empty())
+            throw std::invalid_argument("empty file");
+        Storage in(&buffer[0], buffer.size());
+        if (in.readString() != CHECKPOINT_FORMAT)
+            throw std::invalid_argument("not a checkpoint");
+        int version = in.readInt();
+        if (version != CHECKPOINT_VERSION) {
+            cout << "iCS --> [ERROR] Version " << version << " of the checkpoint " << path << " is not supported" << endl;
+            return false;
+        }
+        m_step = in.readInt();
+        m_idCounter = in.readInt();
+        m_preAssignedIds.clear();
+        int count = in.readInt();
+        for (int i = 0; i < count; ++i)
+            m_preAssignedIds.insert(in.readInt());
+
+        m_vehicles.clear();
+        count = in.readInt();
+        for (int i = 0; i < count; ++i) {
+            CheckpointVehicle vehicle;
+            vehicle.tsId = in.readString();
+            vehicle.icsId = in.readInt();
+            vehicle.x = in.readFloat();
+            vehicle.y = in.readFloat();
+            vehicle.speed = in.readFloat();
+            vehicle.acceleration = in.readFloat();
+            vehicle.direction = in.readFloat();
+            vehicle.length = in.readFloat();
+            vehicle.width = in.readFloat();
+            vehicle.height = in.readFloat();
+            vehicle.exteriorLights = in.readUnsignedByte() != 0;
+            vehicle.lane = in.readString();
+            int rats = in.readInt();
+            for (int j = 0; j < rats; ++j) {
+                RATID rat = (RATID) in.readUnsignedByte();
+                bool active = in.readUnsignedByte() != 0;
+                vehicle.rats.push_back(make_pair(rat, active));
+            }
+            int applications = in.readInt();
+            for (int j = 0; j < applications; ++j)
+                vehicle.applications.push_back(in.readInt());
+            m_vehicles.push_back(vehicle);
+        }
+    } catch (std::invalid_argument& e) {
+        cout << "iCS --> [ERROR] " << path << " is not a valid checkpoint: " << e.what() << endl;
+        return false;
+    }
+    return true;
+}
+
+string
+Checkpoint::TrafficStateFile(const string& path)
+{
+    return path + ".sumo.xml";
+}
+
+}
@@ -0,0 +1,109 @@
+/****************************************************************************/
+/// @file    checkpoint.h
+/// @author  iTETRIS
+/// @date
+/// @version $Id:
+///
+/****************************************************************************/
+// iTETRIS, see http://www.ict-itetris.eu
+// Copyright © 2008 iTetris Project Consortium - All rights reserved
+/****************************************************************************/
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+// ===========================================================================
+// included modules
+// ===========================================================================
+#ifdef _MSC_VER
+#include <windows_config.h>
+#else
+#include <config.h>
+#endif
+
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../utils/ics/iCStypes.h"
+
+namespace ics
+{
+
+// ===========================================================================
+// struct definitions
+// ===========================================================================
+/**
+* @struct CheckpointVehicle
+* @brief A vehicle of the iCS at the checkpoint.
+*/
+struct CheckpointVehicle {
+    std::string tsId;
+    ics_types::stationID_t icsId;
+    float x;
+    float y;
+    float speed;
+    float acceleration;
+    float direction;
+    float length;
+    float width;
+    float height;
+    bool exteriorLights;
+    std::string lane;
+
+    /// @brief Technologies of the station, with true for the active ones.
+    std::vector<std::pair<ics_types::RATID, bool> > rats;
+
+    /// @brief IDs of the installed applications.
+    std::vector<int> applications;
+};
+
+// ===========================================================================
+// class definitions
+// ===========================================================================
+/**
+* @class Checkpoint
+* @brief State of the iCS at the end of a timestep, to start other simulations from it.
+*
+* The file has the vehicles of the iCS with their facilities information, technologies and
+* applications, and the state of the iCS ID assignment. SUMO writes its own state to
+* TrafficStateFile(), which is loaded when it is launched again. ns-3 is not saved: the
+* vehicles are created again in a new ns-3 when the checkpoint is restored.
+* The LDM, the subscriptions and the scheduled messages are not saved, so the iCS only
+* writes a checkpoint when they are all empty.
+*/
+class Checkpoint
+{
+public:
+    Checkpoint();
+
+    /**
+    * @brief Writes the checkpoint.
+    * @return False: If the file cannot be written.
+    */
+    bool Write(const std::string& path) const;
+
+    /**
+    * @brief Reads a checkpoint.
+    * @return False: If the file cannot be read or it is not a checkpoint.
+    */
+    bool Read(const std::string& path);
+
+    /// @brief File SUMO saves its state to for the checkpoint in path.
+    static std::string TrafficStateFile(const std::string& path);
+
+    /// @brief Last timestep run before the checkpoint.
+    ics_types::icstime_t m_step;
+
+    /// @brief See ITetrisNode::GetIdCounter().
+    int m_idCounter;
+
+    /// @brief See ITetrisNode::GetPreAssignedIds().
+    std::set<ics_types::stationID_t> m_preAssignedIds;
+
+    std::vector<CheckpointVehicle> m_vehicles;
+};
+
+}
+
+#endif
@@ -24,6 +24,7 @@
 
 #include "SUMOdigital-map.h"
 #include "../../../utils/common/TplConvert.h"
+#include <cstdio>
 
 #ifdef SUMO_ON
 
@@ -41,11 +42,13 @@ void tokenize(const string&, vector<string>&, const string&);
  */
 SUMODigitalMap::SUMODigitalMap() {
     readLines = 0;
+    loadedFromCache = false;
 }
 
 SUMODigitalMap::SUMODigitalMap(string filename) {
     NETfilename = filename;
     readLines = 0;
+    loadedFromCache = false;
 }
 
 SUMODigitalMap::~SUMODigitalMap() {
@@ -64,9 +67,27 @@ bool SUMODigitalMap::loadMap(string filename) {
 
 /*! \fn bool SUMODigitalMap::loadMap()
  \brief Load the data stored in the NETfilename variable.
+ The parsed map is stored in a binary cache next to the net file (NETfilename + SUMOMAPCACHE_EXTENSION).
+ Later loads of the same net file read the cache instead of parsing the XML; the cache is keyed by
+ a hash of the net file contents and is rebuilt automatically when the net file changes.
  \param[out] true if the loading process succeeded, false otherwise (i.e. file not found).
  */
 bool SUMODigitalMap::loadMap() {
+    loadedFromCache = false;
+    unsigned long long sourceHash = 0;
+    if (!hashFile(NETfilename, sourceHash)) {
+        cerr << NETfilename << " not found. Map loading terminated." << endl;
+        return false;
+    }
+    string cacheFilename = NETfilename + SUMOMAPCACHE_EXTENSION;
+    if (loadCache(cacheFilename, sourceHash)) {
+        loadedFromCache = true;
+        indexSUMOLanes();
+        connectSUMOLanes();
+        createTrafficLightList();
+        return true;
+    }
+
     ifstream infile;
     infile.open(NETfilename.c_str());
     if (!infile.is_open()) {
@@ -107,11 +128,19 @@ bool SUMODigitalMap::loadMap() {
         } // end "if (!line.empty())"
     } // end "while (getline(infile, line))"
 
+    if (!saveCache(cacheFilename, sourceHash))
+        cerr << "[WARNING] Could not write the map cache " << cacheFilename << endl;
+
+    indexSUMOLanes();
     connectSUMOLanes();
     createTrafficLightList();
     return true;
 }
 
+bool SUMODigitalMap::isLoadedFromCache() const {
+    return loadedFromCache;
+}
+
 void SUMODigitalMap::readSUMOLocation(string line, SUMOLocation *loc) {
     vector<string> fields;
 
@@ -601,14 +630,22 @@ void SUMODigitalMap::createTrafficLightList() {
 
 
 SUMOLane* SUMODigitalMap::findSUMOLane(string laneId) {
-    SUMOLane *targetSUMOLane = NULL;
-    map<string, SUMOEdge>::iterator it;
-    for (it=edges.begin(); it != edges.end(); it++) {
-        targetSUMOLane = (*it).second.getSUMOLane(laneId);
-        if (targetSUMOLane != NULL)
-            return targetSUMOLane;
+    map<string, SUMOLane*>::iterator it = laneIndex.find(laneId);
+    if (it != laneIndex.end())
+        return it->second;
+    return NULL;
+}
+
+
+void SUMODigitalMap::indexSUMOLanes() {
+    laneIndex.clear();
+    map<string, SUMOEdge>::iterator itEdge;
+    for (itEdge=edges.begin(); itEdge != edges.end(); itEdge++) {
+        map<string, SUMOLane>::iterator itLane;
+        for (itLane=(*itEdge).second.lanes.begin(); itLane != (*itEdge).second.lanes.end(); itLane++)
+            laneIndex.insert(pair<string, SUMOLane*> ((*itLane).first, &((*itLane).second)));
     }
-    return targetSUMOLane;
+    return;
 }
 
 
@@ -648,6 +685,328 @@ bool SUMOJunction::isIntSUMOLane(string laneId) {
     return false;
 }
 
+
+/*
+ *
+ * Binary cache
+ *
+ * Layout (native byte order, the cache is a local artifact and never shipped):
+ *   magic "ICSMAP", version, hash of the net file, location, edges (with their lanes),
+ *   junctions, traffic light logics, succs.
+ * The lane pointers (next/prev lanes, traffic lights) are not stored: they are rebuilt by
+ * connectSUMOLanes() and createTrafficLightList() after loading.
+ *
+ */
+static const char cacheMagic[] = "ICSMAP";
+
+static void writeUInt(ofstream& out, unsigned int value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static void writeFloat(ofstream& out, float value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static void writeString(ofstream& out, const string& value) {
+    writeUInt(out, (unsigned int) value.size());
+    out.write(value.data(), value.size());
+}
+
+static void writePoint(ofstream& out, const Point2D& value) {
+    writeFloat(out, value.x());
+    writeFloat(out, value.y());
+}
+
+static void writeShape(ofstream& out, const vector<Point2D>& shape) {
+    writeUInt(out, (unsigned int) shape.size());
+    for (unsigned int i=0; i<shape.size(); i++)
+        writePoint(out, shape[i]);
+}
+
+static void writeStringList(ofstream& out, const vector<string>& list) {
+    writeUInt(out, (unsigned int) list.size());
+    for (unsigned int i=0; i<list.size(); i++)
+        writeString(out, list[i]);
+}
+
+static bool readUInt(ifstream& in, unsigned int& value) {
+    in.read(reinterpret_cast<char*>(&value), sizeof(value));
+    return in.good();
+}
+
+static bool readFloat(ifstream& in, float& value) {
+    in.read(reinterpret_cast<char*>(&value), sizeof(value));
+    return in.good();
+}
+
+static bool readString(ifstream& in, string& value) {
+    unsigned int size;
+    if (!readUInt(in, size))
+        return false;
+    value.resize(size);
+    if (size > 0)
+        in.read(&value[0], size);
+    return in.good();
+}
+
+static bool readPoint(ifstream& in, Point2D& value) {
+    float x, y;
+    if (!readFloat(in, x) || !readFloat(in, y))
+        return false;
+    value.set(x, y);
+    return true;
+}
+
+static bool readShape(ifstream& in, vector<Point2D>& shape) {
+    unsigned int size;
+    if (!readUInt(in, size))
+        return false;
+    shape.resize(size);
+    for (unsigned int i=0; i<size; i++)
+        if (!readPoint(in, shape[i]))
+            return false;
+    return true;
+}
+
+static bool readStringList(ifstream& in, vector<string>& list) {
+    unsigned int size;
+    if (!readUInt(in, size))
+        return false;
+    list.resize(size);
+    for (unsigned int i=0; i<size; i++)
+        if (!readString(in, list[i]))
+            return false;
+    return true;
+}
+
+/*! \fn bool SUMODigitalMap::hashFile(const string& filename, unsigned long long& hash)
+ \brief Compute the 64-bit FNV-1a hash of the contents of a file.
+ \param[in] filename name of the file.
+ \param[out] hash hash of the contents.
+ \param[out] true if the file could be read, false otherwise.
+ */
+bool SUMODigitalMap::hashFile(const string& filename, unsigned long long& hash) {
+    ifstream in(filename.c_str(), ios::in | ios::binary);
+    if (!in.is_open())
+        return false;
+    hash = 14695981039346656037ULL;
+    char buffer[65536];
+    while (in) {
+        in.read(buffer, sizeof(buffer));
+        streamsize readBytes = in.gcount();
+        for (streamsize i=0; i<readBytes; i++) {
+            hash ^= (unsigned char) buffer[i];
+            hash *= 1099511628211ULL;
+        }
+    }
+    return true;
+}
+
+/*! \fn bool SUMODigitalMap::saveCache(const string& cacheFilename, unsigned long long sourceHash) const
+ \brief Write the parsed map to the binary cache.
+ \param[in] cacheFilename name of the cache file.
+ \param[in] sourceHash hash of the net file the map was parsed from.
+ \param[out] true if the cache was written, false otherwise.
+ */
+bool SUMODigitalMap::saveCache(const string& cacheFilename, unsigned long long sourceHash) const {
+    // Write to a temporary file first so that a crash never leaves a truncated cache behind
+    string tmpFilename = cacheFilename + ".tmp";
+    ofstream out(tmpFilename.c_str(), ios::out | ios::binary | ios::trunc);
+    if (!out.is_open())
+        return false;
+
+    out.write(cacheMagic, sizeof(cacheMagic));
+    writeUInt(out, SUMOMAPCACHE_VERSION);
+    out.write(reinterpret_cast<const char*>(&sourceHash), sizeof(sourceHash));
+
+    writePoint(out, location.netOffset);
+    writePoint(out, location.convBoundaryMin);
+    writePoint(out, location.convBoundaryMax);
+    writePoint(out, location.origBoundaryMin);
+    writePoint(out, location.origBoundaryMax);
+    out.put(location.projParameter);
+
+    writeUInt(out, (unsigned int) edges.size());
+    for (map<string, SUMOEdge>::const_iterator itEdge=edges.begin(); itEdge != edges.end(); itEdge++) {
+        const SUMOEdge& edge = (*itEdge).second;
+        writeString(out, edge.id);
+        writeString(out, edge.stringFrom);
+        writeString(out, edge.stringTo);
+        writeString(out, edge.funct);
+        writeString(out, edge.inner);
+        writeUInt(out, (unsigned int) edge.lanes.size());
+        for (map<string, SUMOLane>::const_iterator itLane=edge.lanes.begin(); itLane != edge.lanes.end(); itLane++) {
+            const SUMOLane& lane = (*itLane).second;
+            writeString(out, lane.id);
+            writeFloat(out, lane.depart);
+            writeFloat(out, lane.maxspeed);
+            writeFloat(out, lane.length);
+            writeShape(out, lane.shape);
+        }
+    }
+
+    writeUInt(out, (unsigned int) junctions.size());
+    for (map<string, SUMOJunction>::const_iterator itJun=junctions.begin(); itJun != junctions.end(); itJun++) {
+        const SUMOJunction& junction = (*itJun).second;
+        writeString(out, junction.id);
+        writeString(out, junction.type);
+        writePoint(out, junction.center);
+        writeStringList(out, junction.stringIncSUMOLanes);
+        writeStringList(out, junction.stringIntSUMOLanes);
+        writeShape(out, junction.shape);
+    }
+
+    writeUInt(out, (unsigned int) tllogics.size());
+    for (map<string, SUMOTLlogic>::const_iterator itTL=tllogics.begin(); itTL != tllogics.end(); itTL++) {
+        const SUMOTLlogic& tl = (*itTL).second;
+        writeString(out, tl.id);
+        writeString(out, tl.type);
+        writeString(out, tl.programID);
+        writeUInt(out, (unsigned int) tl.phases.size());
+        for (unsigned int i=0; i<tl.phases.size(); i++) {
+            writeUInt(out, (unsigned int) tl.phases[i].duration);
+            writeString(out, tl.phases[i].state);
+        }
+    }
+
+    writeUInt(out, (unsigned int) succs.size());
+    for (unsigned int i=0; i<succs.size(); i++) {
+        writeString(out, succs[i].edge);
+        writeString(out, succs[i].lane);
+        writeString(out, succs[i].junction);
+        writeUInt(out, (unsigned int) succs[i].SUMOSUMOSucclanes.size());
+        for (unsigned int j=0; j<succs[i].SUMOSUMOSucclanes.size(); j++) {
+            const SUMOSUMOSucclane& succlane = succs[i].SUMOSUMOSucclanes[j];
+            writeString(out, succlane.lane);
+            writeString(out, succlane.via);
+            writeString(out, succlane.tl);
+            writeUInt(out, (unsigned int) succlane.linkIndex);
+            out.put(succlane.yield ? 1 : 0);
+            out.put(succlane.dir);
+            out.put(succlane.state);
+            out.put(succlane.int_end);
+        }
+    }
+
+    out.close();
+    if (out.fail()) {
+        remove(tmpFilename.c_str());
+        return false;
+    }
+    remove(cacheFilename.c_str());
+    return rename(tmpFilename.c_str(), cacheFilename.c_str()) == 0;
+}
+
+/*! \fn bool SUMODigitalMap::loadCache(const string& cacheFilename, unsigned long long sourceHash)
+ \brief Read the map from the binary cache.
+ \param[in] cacheFilename name of the cache file.
+ \param[in] sourceHash hash of the current net file; the cache is discarded if it was built from another one.
+ \param[out] true if the map was read from the cache, false if the cache is missing, stale or corrupted.
+ */
+bool SUMODigitalMap::loadCache(const string& cacheFilename, unsigned long long sourceHash) {
+    ifstream in(cacheFilename.c_str(), ios::in | ios::binary);
+    if (!in.is_open())
+        return false;
+
+    char magic[sizeof(cacheMagic)];
+    unsigned int version;
+    unsigned long long hash;
+    in.read(magic, sizeof(magic));
+    if (!in.good() || string(magic, sizeof(magic)) != string(cacheMagic, sizeof(cacheMagic)))
+        return false;
+    if (!readUInt(in, version) || version != SUMOMAPCACHE_VERSION)
+        return false;
+    in.read(reinterpret_cast<char*>(&hash), sizeof(hash));
+    if (!in.good() || hash != sourceHash)
+        return false;
+
+    bool ok = readPoint(in, location.netOffset)
+              && readPoint(in, location.convBoundaryMin)
+              && readPoint(in, location.convBoundaryMax)
+              && readPoint(in, location.origBoundaryMin)
+              && readPoint(in, location.origBoundaryMax);
+    location.projParameter = (char) in.get();
+
+    unsigned int count = 0;
+    ok = ok && readUInt(in, count);
+    for (unsigned int n=0; ok && n<count; n++) {
+        SUMOEdge edge;
+        unsigned int laneCount = 0;
+        ok = readString(in, edge.id) && readString(in, edge.stringFrom) && readString(in, edge.stringTo)
+             && readString(in, edge.funct) && readString(in, edge.inner) && readUInt(in, laneCount);
+        for (unsigned int l=0; ok && l<laneCount; l++) {
+            SUMOLane lane;
+            ok = readString(in, lane.id) && readFloat(in, lane.depart) && readFloat(in, lane.maxspeed)
+                 && readFloat(in, lane.length) && readShape(in, lane.shape);
+            if (ok)
+                edge.lanes.insert(pair<string, SUMOLane> (lane.id, lane));
+        }
+        if (ok)
+            edges.insert(pair<string, SUMOEdge> (edge.id, edge));
+    }
+
+    ok = ok && readUInt(in, count);
+    for (unsigned int n=0; ok && n<count; n++) {
+        SUMOJunction junction;
+        ok = readString(in, junction.id) && readString(in, junction.type) && readPoint(in, junction.center)
+             && readStringList(in, junction.stringIncSUMOLanes) && readStringList(in, junction.stringIntSUMOLanes)
+             && readShape(in, junction.shape);
+        if (ok)
+            junctions.insert(pair<string, SUMOJunction> (junction.id, junction));
+    }
+
+    ok = ok && readUInt(in, count);
+    for (unsigned int n=0; ok && n<count; n++) {
+        SUMOTLlogic tl;
+        unsigned int phaseCount = 0;
+        ok = readString(in, tl.id) && readString(in, tl.type) && readString(in, tl.programID) && readUInt(in, phaseCount);
+        for (unsigned int p=0; ok && p<phaseCount; p++) {
+            SUMOPhase phase;
+            unsigned int duration;
+            ok = readUInt(in, duration) && readString(in, phase.state);
+            phase.duration = (short) duration;
+            tl.phases.push_back(phase);
+        }
+        if (ok)
+            tllogics.insert(pair<string, SUMOTLlogic> (tl.id, tl));
+    }
+
+    ok = ok && readUInt(in, count);
+    for (unsigned int n=0; ok && n<count; n++) {
+        SUMOSucc succ;
+        unsigned int succlaneCount = 0;
+        ok = readString(in, succ.edge) && readString(in, succ.lane) && readString(in, succ.junction)
+             && readUInt(in, succlaneCount);
+        for (unsigned int l=0; ok && l<succlaneCount; l++) {
+            SUMOSUMOSucclane succlane;
+            unsigned int linkIndex;
+            ok = readString(in, succlane.lane) && readString(in, succlane.via) && readString(in, succlane.tl)
+                 && readUInt(in, linkIndex);
+            succlane.linkIndex = (short) linkIndex;
+            succlane.yield = in.get() == 1;
+            succlane.dir = (char) in.get();
+            succlane.state = (char) in.get();
+            succlane.int_end = (char) in.get();
+            ok = ok && in.good();
+            succ.SUMOSUMOSucclanes.push_back(succlane);
+        }
+        if (ok)
+            succs.push_back(succ);
+    }
+
+    if (!ok) {
+        // Corrupted cache: drop whatever was read and fall back to the net file
+        cerr << "[WARNING] The map cache " << cacheFilename << " is corrupted and will be rebuilt." << endl;
+        edges.clear();
+        junctions.clear();
+        tllogics.clear();
+        succs.clear();
+        location = SUMOLocation();
+        return false;
+    }
+    return true;
+}
+
 /*! \fn void tokenize(const string& , vector<string>&, const string&)
  \brief Create a vector of strings from a single string.
  \param[in] str input string to split in chunks.
@@ -38,6 +38,8 @@ using namespace std;
 #include "../../../utils/ics/geometric/Point2D.h"
 
 #define LANEWIDTH 3.2                                /**< width of a lane [m]. */
+#define SUMOMAPCACHE_EXTENSION ".icscache"           /**< suffix appended to the net file name to build the name of the binary cache. */
+#define SUMOMAPCACHE_VERSION 1                       /**< version of the binary cache layout; bump it whenever the layout changes. */
 
 /*! \namespace sumo_map
  \brief Namespace for the DigitalMap block
@@ -287,6 +289,7 @@ public:
     bool loadMap(string filename);                 /**< load the topology map contained in the file 'filename'. */
     const string getNETfilename() const;           /**< get the file name of the net file. */
     SUMOLane *findSUMOLane(string);                /**< returns the pointer to the SUMOLane object given the lane id. */
+    bool isLoadedFromCache() const;                /**< true if the last loadMap() call was served by the binary cache. */
     const string getSUMOJunctionFromSUMOEdge(string) const; /**< get the id of the junction that contains the internal edge (an empty string otherwise). */
 
 private:
@@ -294,6 +297,8 @@ private:
     string NETfilename;
     unsigned int readLines;                        /**< number of lines of the topology file that have been read. */
     ifstream infile;
+    map<string, SUMOLane*> laneIndex;              /**< index of all the lanes by id, built once the edges are loaded. */
+    bool loadedFromCache;                          /**< true if the map was read from the binary cache. */
 
     // Private methods
     void readSUMOLocation(string, SUMOLocation*);  /**< read the "Location" line. */
@@ -308,6 +313,12 @@ private:
 
     void connectSUMOLanes();
     void createTrafficLightList();
+    void indexSUMOLanes();                         /**< fill laneIndex from the loaded edges. */
+
+    // Binary cache of the parsed net file
+    bool loadCache(const string& cacheFilename, unsigned long long sourceHash);  /**< read the binary cache, false if missing or stale. */
+    bool saveCache(const string& cacheFilename, unsigned long long sourceHash) const;  /**< write the binary cache of the loaded map. */
+    static bool hashFile(const string& filename, unsigned long long& hash);  /**< FNV-1a hash of the contents of a file. */
 };
 
 }
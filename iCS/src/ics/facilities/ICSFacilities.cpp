@@ -112,6 +112,13 @@ const Lane* ICSFacilities::convertPoint2Map(Point2D& pos) const {
     abort();
 }
 
+const roadElementID_t& ICSFacilities::getInternedRoadElementID(roadElementIndex_t index) const {
+    if (mapFac != NULL)
+        return mapFac->getInternedRoadElementID(index);
+    cerr << "[facilities] ERROR: Map not allocated by the ICSFacilities" << endl;
+    abort();
+}
+
 const Junction* ICSFacilities::getClosestJunction(Point2D pos) const {
     if (mapFac != NULL)
         return mapFac->getClosestJunction(pos);
@@ -543,6 +550,13 @@ void ICSFacilities::updateClock(icstime_t newSimTime) {
     abort();
 }
 
+bool ICSFacilities::isLDMEmpty() const {
+    if (LDMtable != NULL)
+        return LDMtable->isEmpty();
+    cerr << "[facilities] ERROR: LDM not allocated by the ICSFacilities" << endl;
+    abort();
+}
+
 bool ICSFacilities::hasStationEverSentMessages(stationID_t stationID) {
     if (LDMtable != NULL)
         return LDMtable->hasStationEverSentMessages(stationID);
@@ -67,6 +67,7 @@ public:
     const Junction* getJunctionFromLane(roadElementID_t laneID) const;
 
     const Lane* convertPoint2Map(Point2D& pos) const;
+    const roadElementID_t& getInternedRoadElementID(roadElementIndex_t index) const;
     const Junction* getClosestJunction(Point2D pos) const;
     const vector<roadElementID_t> getNeighboringJunctions(roadElementID_t junctionID) const;
     vector<const Edge*>* getEdgesFromJunction(roadElementID_t junctionID_A, roadElementID_t junctionID_B);
@@ -161,6 +162,7 @@ public:
     void clearRelevantArea();
 
     void updateClock(icstime_t newSimTime);
+    bool isLDMEmpty() const;
     bool hasStationEverSentMessages(stationID_t stationID);
     seqNo_t getLastSeqNoForStation(stationID_t stationID);
     icstime_t getReceivedMessageDeletionTimeFromTable(actionID_t actionID);
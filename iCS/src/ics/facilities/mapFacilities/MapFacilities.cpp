@@ -36,6 +36,7 @@ MapFacilities::MapFacilities() {
     originLatitude	= 0;
     originLongitude	= 0;
     originAltitude	= 0;
+    internRoadElementID("");
 }
 
 MapFacilities::~MapFacilities() {
@@ -116,6 +117,48 @@ const Junction* MapFacilities::getJunctionFromLane(roadElementID_t laneID) const
     return NULL;
 }
 
+roadElementIndex_t MapFacilities::internRoadElementID(const roadElementID_t& ID) {
+    map<roadElementID_t, roadElementIndex_t>::const_iterator it = internedIndexes.find(ID);
+    if (it != internedIndexes.end())
+        return it->second;
+    roadElementIndex_t index = internedIDs.size();
+    internedIDs.push_back(ID);
+    internedIndexes[ID] = index;
+    return index;
+}
+
+const roadElementID_t& MapFacilities::getInternedRoadElementID(roadElementIndex_t index) const {
+    if (index < 0 || index >= (roadElementIndex_t) internedIDs.size())
+        return internedIDs[0];
+    return internedIDs[index];
+}
+
+TRoadLocation MapFacilities::getLaneLocation(const roadElementID_t& laneID) {
+    map<roadElementID_t, TRoadLocation>::const_iterator itLoc = laneLocations.find(laneID);
+    if (itLoc != laneLocations.end())
+        return itLoc->second;
+
+    TRoadLocation location;
+    map<roadElementID_t, Lane>::const_iterator itLane = lanes.find(laneID);
+    if (itLane == lanes.end()) {
+        // Not cached: the lane may be known once the map is loaded
+        location.lane = -1;
+        location.edge = 0;
+        location.junction = 0;
+        return location;
+    }
+    location.lane = internRoadElementID(laneID);
+    location.edge = internRoadElementID(itLane->second.getEdgeID());
+    location.junction = internRoadElementID(itLane->second.getJunctionID());
+    laneLocations[laneID] = location;
+    return location;
+}
+
+TRoadLocation MapFacilities::getPointLocation(Point2D& pos) {
+    const Lane* lane = convertPoint2Map(pos);
+    return getLaneLocation(lane->getID());
+}
+
 Lane* MapFacilities::convertPoint2Map(Point2D &pos) {
     float minDistance = HUGE_VAL;
     float newDistance = HUGE_VAL;
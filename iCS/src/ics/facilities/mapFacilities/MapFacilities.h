@@ -102,6 +102,34 @@ public:
     */
     const Junction* getJunctionFromLane(roadElementID_t laneID) const;
 
+    /**
+    * @brief Returns the integer identifying a road element ID; the same ID always gets the same index.
+    * @param[in] ID of the lane, edge or junction. The empty ID is index 0.
+    * @return Index of the ID.
+    */
+    roadElementIndex_t internRoadElementID(const roadElementID_t& ID);
+
+    /**
+    * @brief Returns the road element ID of an index returned by internRoadElementID().
+    * @param[in] index Index of the ID.
+    * @return Reference to the ID.
+    */
+    const roadElementID_t& getInternedRoadElementID(roadElementIndex_t index) const;
+
+    /**
+    * @brief Returns the lane, edge and junction of a lane as interned IDs. The result is cached per lane.
+    * @param[in] laneID ID of the lane.
+    * @return The location; its lane is negative if the lane is not in the map.
+    */
+    TRoadLocation getLaneLocation(const roadElementID_t& laneID);
+
+    /**
+    * @brief Returns the lane, edge and junction of the lane that is the closest to a point, as interned IDs.
+    * @param[in] pos X-Y point.
+    * @return The location.
+    */
+    TRoadLocation getPointLocation(Point2D& pos);
+
 
     /**
     * @brief Returns the pointer to the lane that is the closest to a point.
@@ -230,6 +258,15 @@ private:
     /// @brief Vector containing the TrafficLight objects.
     map<trafficLightID_t, TrafficLight> trafficLights;
 
+    /// @brief Road element IDs by index, see internRoadElementID().
+    vector<roadElementID_t> internedIDs;
+
+    /// @brief Indexes of the interned road element IDs.
+    map<roadElementID_t, roadElementIndex_t> internedIndexes;
+
+    /// @brief Cache of getLaneLocation().
+    map<roadElementID_t, TRoadLocation> laneLocations;
+
 
     /// @brief Latitude of the origin coordinate.
     latitude_t originLatitude;
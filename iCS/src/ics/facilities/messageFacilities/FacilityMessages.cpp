@@ -140,12 +140,11 @@ void CAMPayloadGeneral::setNodeAltitude(float altitude) {
 
 void CAMPayloadGeneral::setPosition(Point2D pos, double localLat, double localLon, double localAlt) {
     this->nodePosition = pos;
-    vector <double> geoPos = LocToGeoConvert(pos.x(), pos.y(), 0, localLat, localLon, localAlt);
-    setNodeLatitude(geoPos[0]);
-    setNodeLongitude(geoPos[1]);
     this->localLat = localLat;
     this->localLon = localLon;
     this->localAlt = localAlt;
+    // Most CAMs are never asked for their geodetic position: convert on demand
+    this->geoPositionValid = false;
 }
 
 void CAMPayloadGeneral::setPosition(Point2D pos) {
@@ -153,6 +152,20 @@ void CAMPayloadGeneral::setPosition(Point2D pos) {
     this->localLat = -1.0;
     this->localLon = -1.0;
     this->localAlt = -1.0;
+    this->geoPositionValid = true;
+}
+
+void CAMPayloadGeneral::updateGeoPosition() const {
+    if (geoPositionValid)
+        return;
+    vector <double> geoPos = LocToGeoConvert(nodePosition.x(), nodePosition.y(), 0, localLat, localLon, localAlt);
+    nodeLatitude = geoPos[0];
+    nodeLongitude = geoPos[1];
+    geoPositionValid = true;
+}
+
+void CAMPayloadGeneral::setRoadLocation(const TRoadLocation& location) {
+    this->roadLocation = location;
 }
 
 stationType_t CAMPayloadGeneral::getStationType() const {
@@ -172,10 +185,12 @@ messageType_t CAMPayloadGeneral::getMessageType() const {
 }
 
 latitude_t CAMPayloadGeneral::getNodeLatitude() const {
+    updateGeoPosition();
     return nodeLatitude;
 }
 
 longitude_t CAMPayloadGeneral::getNodeLongitude() const {
+    updateGeoPosition();
     return nodeLongitude;
 }
 
@@ -187,6 +202,10 @@ Point2D CAMPayloadGeneral::getPosition() const {
     return nodePosition;
 }
 
+const TRoadLocation& CAMPayloadGeneral::getRoadLocation() const {
+    return roadLocation;
+}
+
 
 
 // ========== CAMPayloadBasicVehicleProfile
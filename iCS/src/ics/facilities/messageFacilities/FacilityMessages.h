@@ -23,6 +23,7 @@
 
 #include "../stationFacilities/Station.h"
 #include "../../../utils/ics/geometric/Ellipse.h"
+#include "../../../utils/ics/iCSObjectPool.h"
 
 #include <vector>
 
@@ -101,7 +102,11 @@ protected:
 */
 class CAMPayloadGeneral: public ics_facilities::FacilityMessagePayload {
 public:
-    CAMPayloadGeneral() {};
+    CAMPayloadGeneral() : geoPositionValid(true) {
+        roadLocation.lane = -1;
+        roadLocation.edge = 0;
+        roadLocation.junction = 0;
+    };
     virtual ~CAMPayloadGeneral() {};
 
     void setSenderID(stationID_t senderID);
@@ -111,6 +116,7 @@ public:
     void setStationType(stationType_t stationType);
     void setPosition(Point2D pos, double localLat, double localLon, double localAlt);
     void setPosition(Point2D pos);
+    void setRoadLocation(const TRoadLocation& location);
 
     stationType_t getStationType() const;
     stationID_t getSenderID() const;
@@ -121,14 +127,17 @@ public:
     longitude_t getNodeLongitude() const;
     altitude_t getNodeAltitude() const;
     Point2D getPosition() const;
+    const TRoadLocation& getRoadLocation() const;
 
 protected:
     stationType_t stationType;
+    TRoadLocation roadLocation;  /// @brief  Lane, edge and junction of the sender, negative lane if not set.
 
     Point2D nodePosition;       /// @brief  Cartesian (x,y) position of the node.
-    latitude_t nodeLatitude;
-    longitude_t nodeLongitude;
+    mutable latitude_t nodeLatitude;
+    mutable longitude_t nodeLongitude;
     altitude_t nodeAltitude;
+    mutable bool geoPositionValid;  /// @brief  False until the geodetic position is computed from nodePosition.
     latitude_t localLat;        /// @brief  Latitude of the origin (0,0,0).
     longitude_t localLon;       /// @brief  Longitude of the origin (0,0,0).
     altitude_t localAlt;        /// @brief  Altitude of the origin (0,0,0).
@@ -136,13 +145,17 @@ protected:
     void setNodeLatitude(float latitude);
     void setNodeLongitude(float longitude);
     void setNodeAltitude(float altitude);
+
+    /// @brief Converts nodePosition to latitude and longitude the first time they are needed.
+    void updateGeoPosition() const;
 };
 
 /**
 * @class CAMPayloadBasicVehicleProfile
 * @brief Basic profile of CAM messages for vehicles.
 */
-class CAMPayloadBasicVehicleProfile: public ics_facilities::CAMPayloadGeneral {
+class CAMPayloadBasicVehicleProfile: public ics_facilities::CAMPayloadGeneral,
+    public ics::PooledObject<CAMPayloadBasicVehicleProfile> {
 public:
     CAMPayloadBasicVehicleProfile() {};
     virtual ~CAMPayloadBasicVehicleProfile() {};
@@ -177,7 +190,8 @@ protected:
 * @class CAMPayloadBasicRSU
 * @brief Basic profile of CAM messages for RSUs.
 */
-class CAMPayloadBasicRSU: public ics_facilities::CAMPayloadGeneral {
+class CAMPayloadBasicRSU: public ics_facilities::CAMPayloadGeneral,
+    public ics::PooledObject<CAMPayloadBasicRSU> {
 public:
     CAMPayloadBasicRSU() {};
     virtual ~CAMPayloadBasicRSU() {};
@@ -329,13 +343,15 @@ protected:
  */
 
 /**
-* @class
-* @brief .
+* @class ReceivedMessage
+* @brief Entry of the iFPT/iFMT tables. It owns its payload.
 */
-class ReceivedMessage {
+class ReceivedMessage: public ics::PooledObject<ReceivedMessage> {
 public:
-    ReceivedMessage() {};
-    virtual ~ReceivedMessage() {};
+    ReceivedMessage() : payload(NULL) {};
+    virtual ~ReceivedMessage() {
+        delete payload;
+    };
 
     messageType_t getMessageType() const;
     actionID_t getActionID() const;
@@ -540,6 +540,10 @@ void LDMLogic::updateClock(icstime_t newSimTime) {
     launchIFMTCleanupManager(simTime);
 }
 
+bool LDMLogic::isEmpty() const {
+    return iFMT.empty() && iFPT.empty();
+}
+
 bool LDMLogic::hasStationEverSentMessages(stationID_t stationID) {
     map<stationID_t, seqNo_t>::iterator it = stationsSeqNoRecord.find(stationID);
     if (it != stationsSeqNoRecord.end())
@@ -579,11 +583,10 @@ actionID_t LDMLogic::createCAMpayload(stationID_t stationID) {
         return NULL;
     }
     if (sta->getType() == STATION_MOBILE) {
-        MobileStation* msta = dynamic_cast<MobileStation*>(sta);
-        if (msta == NULL) return NULL;
+        // The station type is checked above, no need for a dynamic_cast
+        MobileStation* msta = static_cast<MobileStation*>(sta);
 
         CAMPayloadBasicVehicleProfile* cam = new CAMPayloadBasicVehicleProfile();
-        if (cam == NULL) return NULL;
 
         cam->setStationProfile(111);         // TODO: LDMLogic::createCAMmessage - setStationProfile()
         cam->setVehicleSpeed(msta->getSpeed());
@@ -600,11 +603,18 @@ actionID_t LDMLogic::createCAMpayload(stationID_t stationID) {
         cam->setMessageType(CAM);
 //        cam->setStationType(sta->);                     // TODO: LDMLogic::createCAMmessage - setStationType()
 
+        // The lane comes from the traffic simulator, map matching only if the map does not know it
+        TRoadLocation location = mapFac->getLaneLocation(msta->getLaneID());
+        if (location.lane < 0) {
+            Point2D pos = sta->getPosition();
+            location = mapFac->getPointLocation(pos);
+        }
+        cam->setRoadLocation(location);
+
         if (!storePayload(actionID, cam, CAM))
             cerr << "[facilities] Warning: the payload of the message with actionID " << actionID << " was created but it was either already stored in the table, or not stored at all." << endl;
     } else {
         CAMPayloadBasicRSU* cam = new CAMPayloadBasicRSU();
-        if (cam == NULL) return NULL;
 
 //        cam->setVersion(1);
         cam->setSenderID(stationID);
@@ -613,6 +623,14 @@ actionID_t LDMLogic::createCAMpayload(stationID_t stationID) {
         cam->setMessageType(CAM);
 //        cam->setStationType(sta->);                     // TODO: LDMLogic::createCAMmessage - setStationType()
 
+        // Fixed stations do not move: match them to the map only once
+        map<stationID_t, TRoadLocation>::const_iterator itLoc = fixedStationLocations.find(stationID);
+        if (itLoc == fixedStationLocations.end()) {
+            Point2D pos = sta->getPosition();
+            itLoc = fixedStationLocations.insert(make_pair(stationID, mapFac->getPointLocation(pos))).first;
+        }
+        cam->setRoadLocation(itLoc->second);
+
         if (!storePayload(actionID, cam, CAM)) {
             stringstream log;
             log << "[facilities] Warning: the payload of the message with actionID "
@@ -621,10 +639,12 @@ actionID_t LDMLogic::createCAMpayload(stationID_t stationID) {
         }
     }
 
-    stringstream log;
-    log << "[facilities] - createCAMpayload() - station: " << stationID
-        <<" | actionID: " << actionID;
-    ics::IcsLog::LogLevel((log.str()).c_str(), ics::kLogLevelInfo);
+    if (ics::IcsLog::IsEnabled(ics::kLogLevelInfo)) {
+        stringstream log;
+        log << "[facilities] - createCAMpayload() - station: " << stationID
+            <<" | actionID: " << actionID;
+        ics::IcsLog::LogLevel((log.str()).c_str(), ics::kLogLevelInfo);
+    }
 
     return actionID;
 }
@@ -655,10 +675,12 @@ actionID_t LDMLogic::createDENMpayload(stationID_t stationID,
     if (!storePayload(actionID, denm, DENM))
         cerr << "[facilities] Warning: the payload of the message with actionID " << actionID << " was created but it was either already stored in the table, or not stored at all." << endl;
 
-    stringstream log;
-    log << "[facilities] createDENMpayload - station: " << stationID
-        << " | actionID: " << actionID;
-    ics::IcsLog::LogLevel((log.str()).c_str(), ics::kLogLevelInfo);
+    if (ics::IcsLog::IsEnabled(ics::kLogLevelInfo)) {
+        stringstream log;
+        log << "[facilities] createDENMpayload - station: " << stationID
+            << " | actionID: " << actionID;
+        ics::IcsLog::LogLevel((log.str()).c_str(), ics::kLogLevelInfo);
+    }
 
     return actionID;
 }
@@ -694,10 +716,12 @@ actionID_t LDMLogic::createApplicationMessagePayload(
     if (!storePayload(actionID, payload, comType))
         cerr << "[facilities] Warning: the payload of the message with actionID " << actionID << " was created but it was either already stored in the table, or not stored at all." << endl;
 
-    stringstream log;
-    log << "iCS -> facilities: createApplicationMessagePayload - station: " << stationID
-        << " | actionID: " << actionID;
-    ics::IcsLog::LogLevel((log.str()).c_str(), ics::kLogLevelInfo);
+    if (ics::IcsLog::IsEnabled(ics::kLogLevelInfo)) {
+        stringstream log;
+        log << "iCS -> facilities: createApplicationMessagePayload - station: " << stationID
+            << " | actionID: " << actionID;
+        ics::IcsLog::LogLevel((log.str()).c_str(), ics::kLogLevelInfo);
+    }
 
     return actionID;
 
@@ -740,6 +764,7 @@ bool LDMLogic::storeMessage(actionID_t actionID, vector<stationID_t> receivers)
 
     // Check the relevance of the payload type if it is in the iFPT
     if (entry_found_in_iFPT && !isMessageRelevant(*it_iFPT->second)) {
+        delete it_iFPT->second;
         iFPT.erase(it_iFPT);
         return false;
     }
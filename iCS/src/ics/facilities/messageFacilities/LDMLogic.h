@@ -108,6 +108,7 @@ public:
 
     //**** Miscellaneous ****
     void updateClock(icstime_t newSimTime);
+    bool isEmpty() const;
     bool hasStationEverSentMessages(stationID_t stationID);
     seqNo_t getLastSeqNoForStation(stationID_t stationID);
     icstime_t getReceivedMessageDeletionTimeFromTable(actionID_t actionID);
@@ -171,6 +172,9 @@ private:
     /// @brief Pointer to the stationsFacilities.
     StationFacilities* staFac;
 
+    /// @brief Location on the map of the fixed stations that sent a CAM.
+    map<stationID_t, TRoadLocation> fixedStationLocations;
+
     //***********************
     //**** Time related variables ****
     //***********************
@@ -63,6 +63,25 @@ ITetrisNode::~ITetrisNode()
     IcsLog::LogLevel((log.str()).c_str(), kLogLevelInfo);
 }
 
+int
+ITetrisNode::GetIdCounter()
+{
+    return m_idCounter;
+}
+
+const set<stationID_t>&
+ITetrisNode::GetPreAssignedIds()
+{
+    return m_preAssignedIds;
+}
+
+void
+ITetrisNode::RestoreIds(int idCounter, const set<stationID_t>& preAssignedIds)
+{
+    m_idCounter = idCounter;
+    m_preAssignedIds = preAssignedIds;
+}
+
 float
 ITetrisNode::GetPositionX()
 {
@@ -103,6 +103,19 @@ public:
     */
     std::string GetLane();
 
+    /// @brief Last iCS ID given by the counter.
+    static int GetIdCounter();
+
+    /// @brief IDs assigned by the user.
+    static const std::set<ics_types::stationID_t>& GetPreAssignedIds();
+
+    /**
+    * @brief Restores the assignment of iCS IDs, so that the nodes created after a checkpoint get the same IDs.
+    * @param[in] idCounter The value given by GetIdCounter().
+    * @param[in] preAssignedIds The value given by GetPreAssignedIds().
+    */
+    static void RestoreIds(int idCounter, const std::set<ics_types::stationID_t>& preAssignedIds);
+
 protected:
     /// @brief A counter to assign iCS node ID
     static int m_idCounter;
@@ -43,6 +43,12 @@ namespace ics
 // ===========================================================================
 float ITetrisSimulationConfig::m_simulatedVehiclesPenetrationRate;
 int ITetrisSimulationConfig::m_scheduleMessageCleanUp = -1;
+std::string ITetrisSimulationConfig::m_stepStatisticsFile;
+std::string ITetrisSimulationConfig::m_trafficTraceRecordFile;
+std::string ITetrisSimulationConfig::m_trafficTraceReplayFile;
+int ITetrisSimulationConfig::m_checkpointStep = -1;
+std::string ITetrisSimulationConfig::m_checkpointFile;
+std::string ITetrisSimulationConfig::m_restoreCheckpointFile;
 
 // ===========================================================================
 // member method definitions
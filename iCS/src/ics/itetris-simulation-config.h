@@ -21,6 +21,8 @@
 #include <config.h>
 #endif
 
+#include <string>
+
 #define CONFIG_11P	0
 #define CONFIG_UMTS	1
 #define CONFIG_WIMAX	2
@@ -70,6 +72,28 @@ public:
 
     /// @brief Time in seconds to assume the message will not be received.
     static int m_scheduleMessageCleanUp;
+
+    /// @brief File the per step statistics are written to (CSV, or JSON for a ".json" file). Empty to disable them.
+    static std::string m_stepStatisticsFile;
+
+    /// @brief File the traffic simulation is recorded to. Empty to disable the recording.
+    static std::string m_trafficTraceRecordFile;
+
+    /// @brief Traffic trace replayed instead of running the traffic simulator. Empty to run it.
+    static std::string m_trafficTraceReplayFile;
+
+    /**
+     * @brief Timestep at the end of which a checkpoint is written. -1 for none.
+     * The LDM of the facilities, the subscriptions and the scheduled messages are not saved:
+     * the checkpoint fails if any of them is not empty at that timestep.
+     */
+    static int m_checkpointStep;
+
+    /// @brief File the checkpoint is written to.
+    static std::string m_checkpointFile;
+
+    /// @brief Checkpoint the simulation starts from. Empty to start from the beginning.
+    static std::string m_restoreCheckpointFile;
 };
 
 }
@@ -0,0 +1,151 @@
+/****************************************************************************/
+/// @file    node-position-index.cpp
+/// @author  iTETRIS
+/// @date
+/// @version $Id:
+///
+/****************************************************************************/
+// iTETRIS, see http://www.ict-itetris.eu
+// Copyright © 2008 iTetris Project Consortium - All rights reserved
+/****************************************************************************/
+
+// ===========================================================================
+// included modules
+// ===========================================================================
+#ifdef _MSC_VER
+#include <windows_config.h>
+#else
+#include <config.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+
+#include "node-position-index.h"
+#include "itetris-node.h"
+
+using namespace std;
+
+namespace ics
+{
+
+// ===========================================================================
+// member method definitions
+// ===========================================================================
+NodePositionIndex::NodePositionIndex(float cellSize)
+{
+    m_cellSize = (cellSize > 0) ? cellSize : 100;
+    m_minCellX = m_maxCellX = m_minCellY = m_maxCellY = 0;
+    m_built = false;
+}
+
+NodePositionIndex::~NodePositionIndex() { }
+
+void
+NodePositionIndex::Build(const vector<ITetrisNode*>& nodes)
+{
+    m_entries.clear();
+    m_entries.reserve(nodes.size());
+    unsigned int order = 0;
+    for (vector<ITetrisNode*>::const_iterator it = nodes.begin(); it != nodes.end(); ++it, ++order) {
+        ITetrisNode* node = *it;
+        if (node->m_icsId == 0) // Skip TMC node
+            continue;
+        Entry entry;
+        entry.x = node->GetPositionX();
+        entry.y = node->GetPositionY();
+        int cellX = CellCoordinate(entry.x);
+        int cellY = CellCoordinate(entry.y);
+        entry.cell = CellKey(cellX, cellY);
+        entry.order = order;
+        entry.node = node;
+        if (m_entries.empty()) {
+            m_minCellX = m_maxCellX = cellX;
+            m_minCellY = m_maxCellY = cellY;
+        } else {
+            m_minCellX = min(m_minCellX, cellX);
+            m_maxCellX = max(m_maxCellX, cellX);
+            m_minCellY = min(m_minCellY, cellY);
+            m_maxCellY = max(m_maxCellY, cellY);
+        }
+        m_entries.push_back(entry);
+    }
+    sort(m_entries.begin(), m_entries.end());
+    m_built = true;
+}
+
+void
+NodePositionIndex::Clear()
+{
+    m_entries.clear();
+    m_built = false;
+}
+
+bool
+NodePositionIndex::IsBuilt() const
+{
+    return m_built;
+}
+
+unsigned int
+NodePositionIndex::Size() const
+{
+    return m_entries.size();
+}
+
+void
+NodePositionIndex::GetNodesInCircle(float x, float y, float radius, vector<ITetrisNode*>& nodes) const
+{
+    if (m_entries.empty() || radius < 0)
+        return;
+
+    int firstX = max(CellCoordinate(x - radius), m_minCellX);
+    int lastX = min(CellCoordinate(x + radius), m_maxCellX);
+    int firstY = max(CellCoordinate(y - radius), m_minCellY);
+    int lastY = min(CellCoordinate(y + radius), m_maxCellY);
+    if (firstX > lastX || firstY > lastY)
+        return;
+
+    // Same test as Circle::isInternal()
+    double radius2 = (double) radius * radius;
+    vector<Entry> found;
+    Entry bound;
+    bound.order = 0;
+    for (int cellY = firstY; cellY <= lastY; ++cellY) {
+        bound.cell = CellKey(firstX, cellY);
+        vector<Entry>::const_iterator it = lower_bound(m_entries.begin(), m_entries.end(), bound);
+        long long lastCell = CellKey(lastX, cellY);
+        for (; it != m_entries.end() && it->cell <= lastCell; ++it) {
+            double dx = it->x - x;
+            double dy = it->y - y;
+            if (dx * dx + dy * dy <= radius2)
+                found.push_back(*it);
+        }
+    }
+
+    // Give the nodes back in the order of the node collection, as a linear scan would
+    sort(found.begin(), found.end(), EntryOrderLess);
+    for (vector<Entry>::const_iterator it = found.begin(); it != found.end(); ++it)
+        nodes.push_back(it->node);
+}
+
+int
+NodePositionIndex::CellCoordinate(float value) const
+{
+    return (int) floor(value / m_cellSize);
+}
+
+long long
+NodePositionIndex::CellKey(int cellX, int cellY)
+{
+    // Rows of cells are contiguous and sorted by X
+    return (long long) cellY * 4294967296LL + ((long long) cellX + 2147483648LL);
+}
+
+bool
+NodePositionIndex::EntryOrderLess(const Entry& a, const Entry& b)
+{
+    return a.order < b.order;
+}
+
+}
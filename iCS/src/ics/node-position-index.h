@@ -0,0 +1,111 @@
+/****************************************************************************/
+/// @file    node-position-index.h
+/// @author  iTETRIS
+/// @date
+/// @version $Id:
+///
+/****************************************************************************/
+// iTETRIS, see http://www.ict-itetris.eu
+// Copyright © 2008 iTetris Project Consortium - All rights reserved
+/****************************************************************************/
+#ifndef NODE_POSITION_INDEX_H
+#define NODE_POSITION_INDEX_H
+
+// ===========================================================================
+// included modules
+// ===========================================================================
+#ifdef _MSC_VER
+#include <windows_config.h>
+#else
+#include <config.h>
+#endif
+
+#include <vector>
+
+namespace ics
+{
+
+// ===========================================================================
+// class declarations
+// ===========================================================================
+class ITetrisNode;
+
+// ===========================================================================
+// class definitions
+// ===========================================================================
+/**
+* @class NodePositionIndex
+* @brief Uniform grid of the positions of the stations in the current timestep.
+*
+* The index is built once per timestep and then answers all the zone queries of
+* the subscriptions, instead of testing every station against every zone.
+* The nodes are stored sorted by cell, so that the nodes of a row of cells are contiguous.
+*/
+class NodePositionIndex
+{
+public:
+    /**
+    * @brief Constructor.
+    * @param[in] cellSize Side of the square cells in meters.
+    */
+    NodePositionIndex(float cellSize = 100);
+
+    /// @brief Destructor.
+    ~NodePositionIndex();
+
+    /**
+    * @brief Indexes the current position of the stations. The TMC (iCS ID 0) is skipped.
+    * @param[in] nodes The collection of stations of the simulation.
+    */
+    void Build(const std::vector<ITetrisNode*>& nodes);
+
+    /// @brief Forgets the indexed nodes, e.g. because they moved or left the simulation.
+    void Clear();
+
+    /// @brief True if Build() was called after the last Clear().
+    bool IsBuilt() const;
+
+    /**
+    * @brief Gets the stations inside a circle (border included).
+    * @param[in] x The X value of the center of the circle.
+    * @param[in] y The Y value of the center of the circle.
+    * @param[in] radius The radius of the circle.
+    * @param[out] nodes The stations in the circle are appended, in the order of the indexed collection.
+    */
+    void GetNodesInCircle(float x, float y, float radius, std::vector<ITetrisNode*>& nodes) const;
+
+    /// @brief Number of indexed stations.
+    unsigned int Size() const;
+
+private:
+    struct Entry {
+        long long cell;
+        unsigned int order;
+        float x;
+        float y;
+        ITetrisNode* node;
+
+        bool operator<(const Entry& other) const {
+            return cell < other.cell || (cell == other.cell && order < other.order);
+        }
+    };
+
+    int CellCoordinate(float value) const;
+    static long long CellKey(int cellX, int cellY);
+    static bool EntryOrderLess(const Entry& a, const Entry& b);
+
+    /// @brief Side of the cells.
+    float m_cellSize;
+
+    /// @brief Indexed nodes, sorted by cell and then by position in the node collection.
+    std::vector<Entry> m_entries;
+
+    /// @brief Bounding box of the occupied cells, to clamp the queries of big zones.
+    int m_minCellX, m_maxCellX, m_minCellY, m_maxCellY;
+
+    bool m_built;
+};
+
+}
+
+#endif
@@ -0,0 +1,261 @@
+/****************************************************************************/
+/// @file    step-statistics.cpp
+/// @author  iTETRIS
+/// @date
+/// @version $Id:
+///
+/****************************************************************************/
+// iTETRIS, see http://www.ict-itetris.eu
+// Copyright © 2008 iTetris Project Consortium - All rights reserved
+/****************************************************************************/
+
+// ===========================================================================
+// included modules
+// ===========================================================================
+#ifdef _MSC_VER
+#include <windows_config.h>
+#else
+#include <config.h>
+#endif
+
+#include <cctype>
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+#include "step-statistics.h"
+
+using namespace std;
+
+namespace ics
+{
+
+// ===========================================================================
+// member method definitions
+// ===========================================================================
+StepStatistics::StepStatistics()
+{
+    m_open = false;
+    m_json = false;
+    m_started = false;
+    m_peerIndex = 0;
+    m_nodes = m_subscriptions = m_receivedMessages = m_scheduledMessages = 0;
+    for (int i = 0; i < PHASE_COUNT; ++i) {
+        m_phaseStart[i] = 0;
+        m_phaseTime[i] = 0;
+    }
+}
+
+StepStatistics::~StepStatistics()
+{
+    Close();
+}
+
+bool
+StepStatistics::Open(const string& path)
+{
+    Close();
+    m_out.open(path.c_str());
+    if (!m_out.good()) {
+        cout << "iCS --> [ERROR] Could not create the step statistics file " << path << endl;
+        return false;
+    }
+    m_json = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+    m_open = true;
+    m_started = false;
+    m_peers.clear();
+    m_peerIndex = 0;
+    return true;
+}
+
+void
+StepStatistics::Close()
+{
+    if (!m_open)
+        return;
+    if (m_json)
+        m_out << (m_started ? "\n]\n" : "[]\n");
+    m_out.close();
+    m_open = false;
+}
+
+void
+StepStatistics::StartPhase(Phase phase)
+{
+    if (m_open)
+        m_phaseStart[phase] = Now();
+}
+
+void
+StepStatistics::EndPhase(Phase phase)
+{
+    if (m_open)
+        m_phaseTime[phase] += Now() - m_phaseStart[phase];
+}
+
+void
+StepStatistics::SetPeer(const string& name, unsigned long long sentBytes, unsigned long long receivedBytes, unsigned long roundTrips)
+{
+    if (!m_open)
+        return;
+
+    if (m_peerIndex == m_peers.size()) {
+        // The columns are fixed by the first step, later peers are ignored
+        if (m_started)
+            return;
+        Peer peer;
+        // Names are used as CSV columns and JSON keys
+        peer.name = name;
+        for (string::iterator it = peer.name.begin(); it != peer.name.end(); ++it) {
+            if (!isalnum(*it) && *it != '-')
+                *it = '_';
+        }
+        peer.lastSentBytes = peer.lastReceivedBytes = 0;
+        peer.lastRoundTrips = 0;
+        m_peers.push_back(peer);
+    }
+
+    Peer& peer = m_peers[m_peerIndex++];
+    peer.sentBytes = sentBytes;
+    peer.receivedBytes = receivedBytes;
+    peer.roundTrips = roundTrips;
+}
+
+void
+StepStatistics::SetCounters(unsigned int nodes, unsigned int subscriptions, unsigned int receivedMessages, unsigned int scheduledMessages)
+{
+    m_nodes = nodes;
+    m_subscriptions = subscriptions;
+    m_receivedMessages = receivedMessages;
+    m_scheduledMessages = scheduledMessages;
+}
+
+void
+StepStatistics::EndStep(ics_types::icstime_t step)
+{
+    if (!m_open)
+        return;
+
+    // Peers not set in this step exchanged nothing
+    for (; m_peerIndex < m_peers.size(); ++m_peerIndex) {
+        Peer& peer = m_peers[m_peerIndex];
+        peer.sentBytes = peer.lastSentBytes;
+        peer.receivedBytes = peer.lastReceivedBytes;
+        peer.roundTrips = peer.lastRoundTrips;
+    }
+
+    if (m_json) {
+        WriteJson(step);
+    } else {
+        if (!m_started)
+            WriteHeader();
+        WriteCsv(step);
+    }
+    m_out.flush();
+    m_started = true;
+
+    for (int i = 0; i < PHASE_COUNT; ++i)
+        m_phaseTime[i] = 0;
+    for (vector<Peer>::iterator it = m_peers.begin(); it != m_peers.end(); ++it) {
+        it->lastSentBytes = it->sentBytes;
+        it->lastReceivedBytes = it->receivedBytes;
+        it->lastRoundTrips = it->roundTrips;
+    }
+    m_peerIndex = 0;
+    m_nodes = m_subscriptions = m_receivedMessages = m_scheduledMessages = 0;
+}
+
+void
+StepStatistics::WriteHeader()
+{
+    m_out << "step";
+    for (int i = 0; i < PHASE_COUNT; ++i)
+        m_out << "," << PhaseName((Phase) i) << "_ms";
+    m_out << ",total_ms,nodes,subscriptions,received_messages,scheduled_messages";
+    for (vector<Peer>::iterator it = m_peers.begin(); it != m_peers.end(); ++it)
+        m_out << "," << it->name << "_sent_bytes," << it->name << "_received_bytes," << it->name << "_round_trips";
+    m_out << "\n";
+}
+
+void
+StepStatistics::WriteCsv(ics_types::icstime_t step)
+{
+    long long total = 0;
+    m_out << step;
+    for (int i = 0; i < PHASE_COUNT; ++i) {
+        m_out << "," << m_phaseTime[i] / 1000.0;
+        total += m_phaseTime[i];
+    }
+    m_out << "," << total / 1000.0 << "," << m_nodes << "," << m_subscriptions
+          << "," << m_receivedMessages << "," << m_scheduledMessages;
+    for (vector<Peer>::iterator it = m_peers.begin(); it != m_peers.end(); ++it) {
+        m_out << "," << it->sentBytes - it->lastSentBytes << "," << it->receivedBytes - it->lastReceivedBytes
+              << "," << it->roundTrips - it->lastRoundTrips;
+    }
+    m_out << "\n";
+}
+
+void
+StepStatistics::WriteJson(ics_types::icstime_t step)
+{
+    long long total = 0;
+    m_out << (m_started ? ",\n" : "[\n");
+    m_out << "{\"step\":" << step << ",\"phases_ms\":{";
+    for (int i = 0; i < PHASE_COUNT; ++i) {
+        m_out << (i == 0 ? "" : ",") << "\"" << PhaseName((Phase) i) << "\":" << m_phaseTime[i] / 1000.0;
+        total += m_phaseTime[i];
+    }
+    m_out << "},\"total_ms\":" << total / 1000.0 << ",\"nodes\":" << m_nodes << ",\"subscriptions\":" << m_subscriptions
+          << ",\"received_messages\":" << m_receivedMessages << ",\"scheduled_messages\":" << m_scheduledMessages
+          << ",\"peers\":{";
+    for (vector<Peer>::iterator it = m_peers.begin(); it != m_peers.end(); ++it) {
+        m_out << (it == m_peers.begin() ? "" : ",") << "\"" << it->name << "\":{\"sent_bytes\":" << it->sentBytes - it->lastSentBytes
+              << ",\"received_bytes\":" << it->receivedBytes - it->lastReceivedBytes
+              << ",\"round_trips\":" << it->roundTrips - it->lastRoundTrips << "}";
+    }
+    m_out << "}}";
+}
+
+long long
+StepStatistics::Now()
+{
+#ifndef _WIN32
+    timeval current;
+    gettimeofday(&current, 0);
+    return (long long) current.tv_sec * 1000000LL + current.tv_usec;
+#else
+    LARGE_INTEGER counter, frequency;
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+    return (long long)(counter.QuadPart * 1000000 / frequency.QuadPart);
+#endif
+}
+
+const char*
+StepStatistics::PhaseName(Phase phase)
+{
+    switch (phase) {
+    case PHASE_NS3_STEP:
+        return "ns3_step";
+    case PHASE_NS3_DATA:
+        return "ns3_data";
+    case PHASE_SUMO_STEP:
+        return "sumo_step";
+    case PHASE_APPLICATIONS:
+        return "applications";
+    case PHASE_RESULTS:
+        return "results";
+    case PHASE_SCHEDULE_MESSAGES:
+        return "schedule_messages";
+    case PHASE_UPDATE_POSITIONS:
+        return "update_positions";
+    default:
+        return "unknown";
+    }
+}
+
+}
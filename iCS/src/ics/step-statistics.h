@@ -0,0 +1,159 @@
+/****************************************************************************/
+/// @file    step-statistics.h
+/// @author  iTETRIS
+/// @date
+/// @version $Id:
+///
+/****************************************************************************/
+// iTETRIS, see http://www.ict-itetris.eu
+// Copyright © 2008 iTetris Project Consortium - All rights reserved
+/****************************************************************************/
+#ifndef STEP_STATISTICS_H
+#define STEP_STATISTICS_H
+
+// ===========================================================================
+// included modules
+// ===========================================================================
+#ifdef _MSC_VER
+#include <windows_config.h>
+#else
+#include <config.h>
+#endif
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "../utils/ics/iCStypes.h"
+
+namespace ics
+{
+
+// ===========================================================================
+// class definitions
+// ===========================================================================
+/**
+* @class StepStatistics
+* @brief Time series of the cost of each timestep of the iCS.
+*
+* For every timestep it records the wall time of each phase of SyncManager::Run(),
+* the traffic exchanged with each peer (ns-3, SUMO and the applications) and the
+* number of nodes, subscriptions and messages. A row is written at the end of the step,
+* as CSV or, if the file name ends with ".json", as a JSON array of objects.
+* Nothing is measured while the output is not open.
+*/
+class StepStatistics
+{
+public:
+
+    /// @brief The phases of a timestep, in the order they run.
+    enum Phase {
+        PHASE_NS3_STEP,
+        PHASE_NS3_DATA,
+        PHASE_SUMO_STEP,
+        PHASE_APPLICATIONS,
+        PHASE_RESULTS,
+        PHASE_SCHEDULE_MESSAGES,
+        PHASE_UPDATE_POSITIONS,
+        PHASE_COUNT
+    };
+
+    StepStatistics();
+
+    /// @brief Destructor, closes the output.
+    ~StepStatistics();
+
+    /**
+    * @brief Opens the output file.
+    * @param[in] path The file. JSON is written if the name ends with ".json", CSV otherwise.
+    * @return False: If the file cannot be created.
+    */
+    bool Open(const std::string& path);
+
+    /// @brief Ends the JSON array and closes the file.
+    void Close();
+
+    /// @brief True if the statistics are recorded.
+    bool IsOpen() const {
+        return m_open;
+    }
+
+    /// @brief Starts timing a phase.
+    void StartPhase(Phase phase);
+
+    /// @brief Stops timing a phase, the time is added to the current step.
+    void EndPhase(Phase phase);
+
+    /**
+    * @brief Sets the traffic counters of a peer. The peers must be set in the same order every step.
+    * @param[in] name Name of the peer, used in the header of the output.
+    * @param[in] sentBytes Bytes sent to the peer since the connection.
+    * @param[in] receivedBytes Bytes received from the peer since the connection.
+    * @param[in] roundTrips Replies received from the peer since the connection.
+    */
+    void SetPeer(const std::string& name, unsigned long long sentBytes, unsigned long long receivedBytes, unsigned long roundTrips);
+
+    /**
+    * @brief Sets the counters of the simulation at the end of the step.
+    * @param[in] nodes Stations in the simulation.
+    * @param[in] subscriptions Subscriptions of the stations.
+    * @param[in] receivedMessages Messages received in ns-3 during the step.
+    * @param[in] scheduledMessages Messages waiting in the scheduled message tables.
+    */
+    void SetCounters(unsigned int nodes, unsigned int subscriptions, unsigned int receivedMessages, unsigned int scheduledMessages);
+
+    /// @brief Writes the row of the step and resets the counters for the next one.
+    void EndStep(ics_types::icstime_t step);
+
+private:
+
+    struct Peer {
+        std::string name;
+        unsigned long long sentBytes;
+        unsigned long long receivedBytes;
+        unsigned long roundTrips;
+        // values at the end of the previous step
+        unsigned long long lastSentBytes;
+        unsigned long long lastReceivedBytes;
+        unsigned long lastRoundTrips;
+    };
+
+    /// @brief Wall clock in microseconds.
+    static long long Now();
+
+    static const char* PhaseName(Phase phase);
+
+    void WriteHeader();
+
+    void WriteCsv(ics_types::icstime_t step);
+
+    void WriteJson(ics_types::icstime_t step);
+
+    std::ofstream m_out;
+
+    bool m_open;
+
+    bool m_json;
+
+    /// @brief True once the first row (and the CSV header) is written.
+    bool m_started;
+
+    long long m_phaseStart[PHASE_COUNT];
+
+    /// @brief Accumulated time of each phase in the current step, in microseconds.
+    long long m_phaseTime[PHASE_COUNT];
+
+    std::vector<Peer> m_peers;
+
+    /// @brief Next peer to be set in the current step.
+    unsigned int m_peerIndex;
+
+    unsigned int m_nodes;
+    unsigned int m_subscriptions;
+    unsigned int m_receivedMessages;
+    unsigned int m_scheduledMessages;
+};
+
+}
+
+#endif
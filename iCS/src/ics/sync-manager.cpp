@@ -31,6 +31,8 @@
 #include "tmc-node.h"
 #include "wirelesscom_sim_communicator/ns3-client.h"
 #include "traffic_sim_communicator/traci-client.h"
+#include "traffic_sim_communicator/trace-recording-client.h"
+#include "traffic_sim_communicator/trace-replay-client.h"
 #include "wirelesscom_sim_message_tracker/V2X-message-manager.h"
 #include "wirelesscom_sim_message_tracker/V2X-cam-area.h"
 #include "wirelesscom_sim_message_tracker/V2X-geobroadcast-area.h"
@@ -51,6 +53,7 @@
 #include "applications_manager/app-result-generic.h"
 #include "FacilitiesManager.h"
 #include "ics.h"
+#include "checkpoint.h"
 #include "../utils/ics/log/ics-log.h"
 #include "../utils/ics/iCSGeoUtils.cpp"
 #include <cmath>
@@ -112,8 +115,10 @@ V2xMessageManager* SyncManager::m_v2xMessageTracker;
 // member method definitions
 // ===========================================================================
 SyncManager::SyncManager(int ns3Port, int sumoPort, string sumoHost, string ns3Host, int beginTime, int endTime)
-        : m_firstTimeStep(beginTime), m_lastTimeStep(endTime)
+        : m_firstTimeStep(beginTime), m_lastTimeStep(endTime), m_trafficLightIdsLoaded(false)
 {
+    m_stepReceivedMessages = 0;
+
     m_ns3Client.m_port = ns3Port;
     m_ns3Client.m_host = ns3Host;
     m_wirelessComSimCommunicator = &m_ns3Client;
@@ -121,6 +126,11 @@ SyncManager::SyncManager(int ns3Port, int sumoPort, string sumoHost, string ns3H
     m_traci.m_port = sumoPort;
     m_traci.m_host = sumoHost;
     m_trafficSimCommunicator = &m_traci;
+    if (!ITetrisSimulationConfig::m_trafficTraceReplayFile.empty()) {
+        m_trafficSimCommunicator = new TraceReplayClient(ITetrisSimulationConfig::m_trafficTraceReplayFile);
+    } else if (!ITetrisSimulationConfig::m_trafficTraceRecordFile.empty()) {
+        m_trafficSimCommunicator = new TraceRecordingClient(m_traci, ITetrisSimulationConfig::m_trafficTraceRecordFile);
+    }
 
     m_lastTimeStep = endTime;
     if (m_firstTimeStep >= m_lastTimeStep) {
@@ -153,6 +163,20 @@ int SyncManager::Run(bool interactive)
 {
     m_simStep = 0;
 
+    if (!ITetrisSimulationConfig::m_restoreCheckpointFile.empty()) {
+        if (RestoreCheckpoint(ITetrisSimulationConfig::m_restoreCheckpointFile) == EXIT_FAILURE) {
+            cout << "iCS --> [ERROR] RestoreCheckpoint()" << endl;
+            return EXIT_FAILURE;
+        }
+        // Go on with the timestep after the checkpoint
+        m_simStep++;
+        m_facilitiesManager->updateClock(m_simStep);
+    }
+
+    if (!ITetrisSimulationConfig::m_stepStatisticsFile.empty()) {
+        m_stepStatistics.Open(ITetrisSimulationConfig::m_stepStatisticsFile);
+    }
+
     cout << "\t\tiCS --> Global simulation timestep is: " << m_simStep << "; last step is: " << m_lastTimeStep << endl;
     cout << "\t\t============================================================" << endl;
 
@@ -177,21 +201,23 @@ int SyncManager::Run(bool interactive)
             cout << "[SUMO] WAITING." << endl;
             utils::Conversion::Wait("Press <Enter> to continue...");
             cout << endl;
-        } else {
-            cout << "STEP 5 - SIMULATION PHASE - Tics = " << m_simStep << endl;
         }
 
 #ifdef NS3_ON
         if (m_simStep >= m_firstTimeStep) {
+            m_stepStatistics.StartPhase(StepStatistics::PHASE_NS3_STEP);
             if (RunOneNs3TimeStep() == EXIT_FAILURE) {
                 utils::Conversion::Wait("iCS --> [ERROR] RunOneNs3TimeStep()");
                 return EXIT_FAILURE;
             }
+            m_stepStatistics.EndPhase(StepStatistics::PHASE_NS3_STEP);
 
+            m_stepStatistics.StartPhase(StepStatistics::PHASE_NS3_DATA);
             if (GetDataFromNs3() == EXIT_FAILURE) {
                 utils::Conversion::Wait("iCS --> [ERROR] GetDataFromNs3()");
                 return EXIT_FAILURE;
             }
+            m_stepStatistics.EndPhase(StepStatistics::PHASE_NS3_DATA);
         }
 #endif
 
@@ -207,15 +233,15 @@ int SyncManager::Run(bool interactive)
             cout << "[SUMO] EXECUTING EVENTS = Tics" << endl;
             utils::Conversion::Wait("Press <Enter> to continue...");
             cout << endl;
-        } else {
-            cout << "STEP 6 - SIMULATION PHASE - Tics = " << m_simStep << endl;
         }
 
 #ifdef SUMO_ON
+        m_stepStatistics.StartPhase(StepStatistics::PHASE_SUMO_STEP);
         if (RunOneSumoTimeStep() == EXIT_FAILURE) {
             utils::Conversion::Wait("iCS --> [ERROR] RunOneSumoTimeStep()");
             return EXIT_FAILURE;
         }
+        m_stepStatistics.EndPhase(StepStatistics::PHASE_SUMO_STEP);
 #endif
 
         if (interactive) {
@@ -229,16 +255,16 @@ int SyncManager::Run(bool interactive)
             cout << "[SUMO] WAITING" << endl;
             utils::Conversion::Wait("Press <Enter> to continue...");
             cout << endl;
-        } else {
-            cout << "STEP 7 - SIMULATION PHASE - Tics = " << m_simStep << endl;
         }
 
 #ifdef APPLICATIONS_ON
         if (m_simStep >= m_firstTimeStep) {
+            m_stepStatistics.StartPhase(StepStatistics::PHASE_APPLICATIONS);
             if (RunApplicationLogic() == EXIT_FAILURE) {
                 utils::Conversion::Wait("iCS --> [ERROR] RunApplicationLogic()");
                 return EXIT_FAILURE;
             }
+            m_stepStatistics.EndPhase(StepStatistics::PHASE_APPLICATIONS);
         }
 #endif
 
@@ -253,21 +279,17 @@ int SyncManager::Run(bool interactive)
             cout << "[SUMO] WAITING" << endl;
             utils::Conversion::Wait("Press <Enter> to continue...");
             cout << endl;
-        } else {
-            cout << "STEP 8 - SIMULATION PHASE - Tics = " << m_simStep << endl;
         }
-	  if (m_iTetrisNodeCollection !=NULL)
-	  cout<<"iCS hhhhhhhhhhhhhhhhhhhhh"<<m_iTetrisNodeCollection->size()<<endl;
-	  else
-	    cout<<"NULLLLLLLLLLLLL"<<endl;
+
 #ifdef APPLICATIONS_ON
         if (m_simStep >= m_firstTimeStep) {
-
+            m_stepStatistics.StartPhase(StepStatistics::PHASE_RESULTS);
             if (ProcessApplicationResults() == EXIT_FAILURE) {
 //                 utils::Conversion::Wait(
                     cout<< "iCS --> [ERROR] ProcessApplicationResults()"<<endl/*)*/;
                 return EXIT_FAILURE;
             }
+            m_stepStatistics.EndPhase(StepStatistics::PHASE_RESULTS);
         }
 #endif
 
@@ -283,26 +305,40 @@ int SyncManager::Run(bool interactive)
             cout << "[SUMO] WAITING." << endl;
             utils::Conversion::Wait("Press <Enter> to continue...");
             cout << endl;
-        } else {
-            cout << "STEP 9 - SIMULATION PHASE - Tics = " << m_simStep << endl;
         }
 
 #ifdef NS3_ON
         if (m_simStep >= m_firstTimeStep) {
+            m_stepStatistics.StartPhase(StepStatistics::PHASE_SCHEDULE_MESSAGES);
             if (ScheduleV2xMessages() == EXIT_FAILURE) {
                 utils::Conversion::Wait("iCS --> [ERROR] ScheduleV2xMessages()");
                 return EXIT_FAILURE;
             }
+            m_stepStatistics.EndPhase(StepStatistics::PHASE_SCHEDULE_MESSAGES);
         }
 
+        m_stepStatistics.StartPhase(StepStatistics::PHASE_UPDATE_POSITIONS);
         if (UpdatePositionsInNs3() == EXIT_FAILURE) {
             utils::Conversion::Wait("iCS --> [ERROR] UpdatePositionsInNs3()");
             return EXIT_FAILURE;
         }
+        m_stepStatistics.EndPhase(StepStatistics::PHASE_UPDATE_POSITIONS);
 
         //TestInciPrimitives ();
 #endif
 
+        if (m_stepStatistics.IsOpen()) {
+            RecordStepStatistics();
+        }
+        m_stepReceivedMessages = 0;
+
+        if (m_simStep == ITetrisSimulationConfig::m_checkpointStep) {
+            if (SaveCheckpoint(ITetrisSimulationConfig::m_checkpointFile) == EXIT_FAILURE) {
+                cout << "iCS --> [ERROR] SaveCheckpoint()" << endl;
+                return EXIT_FAILURE;
+            }
+        }
+
         //Increase global time simulation counter
         m_simStep++;
 
@@ -310,7 +346,7 @@ int SyncManager::Run(bool interactive)
         m_facilitiesManager->updateClock(m_simStep);
 
         // To not display the last time step header
-        if (m_lastTimeStep >= m_simStep) {
+        if (interactive && m_lastTimeStep >= m_simStep) {
             cout << "\t\tiCS --> Global simulation timestep is: " << m_simStep
                  << "; last step is: " << m_lastTimeStep << endl;
             cout
@@ -319,6 +355,8 @@ int SyncManager::Run(bool interactive)
         }
     }
 
+    m_stepStatistics.Close();
+
 #ifdef LOG_ON
     stringstream log;
     log << "[Run] The runtime is over. Last time step reached [LastTimeStep] ["
@@ -329,6 +367,37 @@ int SyncManager::Run(bool interactive)
     return EXIT_SUCCESS;
 }
 
+void
+SyncManager::RecordStepStatistics()
+{
+    unsigned long long sentBytes = 0;
+    unsigned long long receivedBytes = 0;
+    unsigned long roundTrips = 0;
+
+    if (m_wirelessComSimCommunicator->GetChannelStatistics(sentBytes, receivedBytes, roundTrips)) {
+        m_stepStatistics.SetPeer("ns3", sentBytes, receivedBytes, roundTrips);
+    }
+    if (m_trafficSimCommunicator->GetChannelStatistics(sentBytes, receivedBytes, roundTrips)) {
+        m_stepStatistics.SetPeer("sumo", sentBytes, receivedBytes, roundTrips);
+    }
+    for (vector<ApplicationHandler*>::iterator appIt = m_applicationHandlerCollection->begin(); appIt < m_applicationHandlerCollection->end(); appIt++) {
+        tcpip::Socket* socket = (*appIt)->m_appMessageManager->m_socket;
+        if (socket != NULL) {
+            m_stepStatistics.SetPeer("app_" + (*appIt)->m_name, socket->sentBytes(), socket->receivedBytes(), socket->receivedMessages());
+        }
+    }
+
+    unsigned int subscriptions = 0;
+    for (vector<ITetrisNode*>::iterator nodeIt = m_iTetrisNodeCollection->begin(); nodeIt < m_iTetrisNodeCollection->end(); nodeIt++) {
+        subscriptions += (*nodeIt)->m_subscriptionCollection->size();
+    }
+    unsigned int scheduledMessages = ScheduledCamMessageTable.size() + ScheduledUnicastMessageTable.size()
+                                     + ScheduledGeobroadcastMessageTable.size() + ScheduledTopobroadcastMessageTable.size();
+
+    m_stepStatistics.SetCounters(m_iTetrisNodeCollection->size(), subscriptions, m_stepReceivedMessages, scheduledMessages);
+    m_stepStatistics.EndStep(m_simStep);
+}
+
 int SyncManager::Stop()
 {
     bool success = true;
@@ -367,6 +436,10 @@ SyncManager::RunOneSumoTimeStep()
 {
     std::vector<std::string> departed;
     std::vector<std::string> arrived;
+
+    // The stations move, enter and leave: the index is rebuilt when needed
+    m_nodePositionIndex.Clear();
+
     if (m_trafficSimCommunicator->CommandSimulationStep((double) m_simStep, departed, arrived) == EXIT_FAILURE) {
         IcsLog::LogLevel("RunOneSumoTimeStep() Error trying to command simulation step in traffic simulator.", kLogLevelError);
         return EXIT_FAILURE;
@@ -447,55 +520,8 @@ SyncManager::RunOneSumoTimeStep()
             m_facilitiesManager->updateMobileStationDynamicInformation(vehicle->m_icsId, info);
 
             AssignApplication(vehicle);
-            vector<RATID>* rats = m_facilitiesManager->getStationActiveRATs(vehicle->m_icsId);
-            vector<string> techList;
-            if (rats->size() == 0) {
-                cout << "[ERROR] getStationActiveRATs returned 0 size" << endl;
+            if (CreateVehicleInNs3(vehicle, nodesToActivateInNs3) == EXIT_FAILURE)
                 return EXIT_FAILURE;
-            } else {
-                for (vector<RATID>::iterator it = rats->begin(); it!= rats->end(); it++) {
-                    switch (*it) {
-                    case WAVE: {
-                        techList.push_back("WaveVehicle");
-                        vehicle->m_rats.insert("WaveVehicle");
-                        break;
-                    }
-                    case UMTS: {
-                        techList.push_back("UmtsVehicle");
-                        vehicle->m_rats.insert("UmtsVehicle");
-                        break;
-                    }
-                    case WiMAX: {
-                        techList.push_back("WimaxVehicle");
-                        vehicle->m_rats.insert("WimaxVehicle");
-                      //  utils::Conversion::Wait("iCS --> Wimax not implemented yet.");
-                        return EXIT_FAILURE;
-                        break;
-                    }
-                    case DVBH: {
-                        techList.push_back("DvbhVehicle");
-                        vehicle->m_rats.insert("DvbhVehicle");
-                        break;
-                    }
-                    default: {
-                        cout << "[ERROR] RunOneSumoTimeStep() There is no match for the type of RAT" << endl;
-                        delete rats;
-                        return EXIT_FAILURE;
-                    }
-                    }
-                }
-            }
-            delete rats;
-
-            // Create the node in ns-3
-#ifdef NS3_ON
-            int32_t id = m_wirelessComSimCommunicator->CommandCreateNode2(vehicle->GetPositionX(), vehicle->GetPositionY(), vehicle->GetSpeed(), vehicle->GetHeading(), vehicle->GetLane(), techList);
-#else
-            int32_t id = 1;
-#endif
-            vehicle->m_nsId = id; // Assign the ns-3 node ID returned by ns-3
-            m_iTetrisNodeCollection->push_back(vehicle);
-            nodesToActivateInNs3.push_back(utils::Conversion::int2String(vehicle->m_nsId));  // Add vehicle to activate
         }
     }
 
@@ -535,20 +561,31 @@ SyncManager::RunOneSumoTimeStep()
         m_facilitiesManager->updateMobileStationDynamicInformation(vehicle->m_icsId, info);
     }
 
-    // Update traffic lights
-    std::vector<ics_types::trafficLightID_t> trafficLigthIds;
-    if (m_trafficSimCommunicator->GetTrafficLights(trafficLigthIds) == EXIT_FAILURE) {
-        return EXIT_FAILURE;
+    // Update traffic lights. The set of traffic lights does not change during the
+    // simulation, so the list is only retrieved once.
+    if (!m_trafficLightIdsLoaded) {
+        if (m_trafficSimCommunicator->GetTrafficLights(m_trafficLightIds) == EXIT_FAILURE) {
+            return EXIT_FAILURE;
+        }
+        m_trafficLightIdsLoaded = true;
     }
 
     bool hadProblems = false;
-    for (std::vector<ics_types::trafficLightID_t>::iterator i=trafficLigthIds.begin(); i!=trafficLigthIds.end(); ++i) {
+    for (std::vector<ics_types::trafficLightID_t>::iterator i=m_trafficLightIds.begin(); i!=m_trafficLightIds.end(); ++i) {
         std::string state;
         if (m_trafficSimCommunicator->GetTrafficLightStatus(*i, state) == EXIT_FAILURE) {
             hadProblems = true;
 
         } else {
+            // Only the signals that switched since the last step are forwarded to the facilities
+            std::string& lastState = m_trafficLightStates[*i];
+            if (state == lastState) {
+                continue;
+            }
             for (unsigned int j=0; j<state.length(); ++j) {
+                if (j < lastState.length() && lastState[j] == state[j]) {
+                    continue;
+                }
             	TrafficLightDynamicInfo tti;
                 tti.active = true;
                 switch (state[j]) {
@@ -570,6 +607,7 @@ SyncManager::RunOneSumoTimeStep()
                 m_facilitiesManager->updateTrafficLightDynamicInformation(*i, j, tti);
               //  cout<< " In RUN Simulation STEP 6" << endl;
             }
+            lastState = state;
         }
     }
     if (hadProblems) {
@@ -596,6 +634,15 @@ int SyncManager::RunApplicationLogic()
 {
     bool success = true;
 
+    // Applications supporting multi-node batches get the commands of each phase in one message
+    bool multiNode = !m_applicationHandlerCollection->empty();
+    for (vector<ApplicationHandler*>::iterator appIt = m_applicationHandlerCollection->begin(); appIt < m_applicationHandlerCollection->end(); appIt++) {
+        multiNode = multiNode && (*appIt)->UsesMultiNodeBatches();
+    }
+    if (multiNode) {
+        return RunApplicationLogicMultiNode();
+    }
+
     vector<ITetrisNode*>::iterator nodeIt;
 
     // Loop all the nodes
@@ -631,13 +678,68 @@ int SyncManager::RunApplicationLogic()
     }
 
     if (success) {
-        cout << endl;
         return EXIT_SUCCESS;
     } else {
         return EXIT_FAILURE;
     }
 }
 
+int SyncManager::RunApplicationLogicMultiNode()
+{
+    // The nodes each application is installed in
+    vector<vector<ITetrisNode*> > appNodes(m_applicationHandlerCollection->size());
+    for (vector<ITetrisNode*>::iterator nodeIt = m_iTetrisNodeCollection->begin(); nodeIt < m_iTetrisNodeCollection->end(); nodeIt++) {
+        vector<ApplicationHandler*>* installed = (*nodeIt)->m_applicationHandlerInstalled;
+        for (unsigned int i = 0; i < m_applicationHandlerCollection->size(); i++) {
+            if (find(installed->begin(), installed->end(), (*m_applicationHandlerCollection)[i]) != installed->end()) {
+                appNodes[i].push_back(*nodeIt);
+            }
+        }
+    }
+
+    // Same phases as the per node loop, each one for all the nodes of the application at once
+    vector<vector<Subscription*> > newSubs;
+    for (unsigned int i = 0; i < appNodes.size(); i++) {
+        if (!(*m_applicationHandlerCollection)[i]->AskForNewSubscriptions(appNodes[i], newSubs)) {
+            cout << "iCS --> [ERROR] RunApplicationLogic() in NewSubscriptions." << endl;
+            return EXIT_FAILURE;
+        }
+        for (unsigned int j = 0; j < appNodes[i].size(); j++) {
+            AddNewSubscriptions(appNodes[i][j], newSubs[j]);
+        }
+    }
+
+    for (unsigned int i = 0; i < appNodes.size(); i++) {
+        if (!(*m_applicationHandlerCollection)[i]->AskForUnsubscriptions(appNodes[i])) {
+            cout << "iCS --> [ERROR] RunApplicationLogic() in DropSubscriptions." << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    for (unsigned int i = 0; i < appNodes.size(); i++) {
+        if ((*m_applicationHandlerCollection)[i]->SendSubscribedData(appNodes[i]) == EXIT_FAILURE) {
+            cout << "iCS --> [ERROR] RunApplicationLogic() in ForwardSubscribedDataToApplication." << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    for (unsigned int i = 0; i < appNodes.size(); i++) {
+        if ((*m_applicationHandlerCollection)[i]->SendMessageStatus(appNodes[i]) == EXIT_FAILURE) {
+            cout << "iCS --> [ERROR] RunApplicationLogic() in DeliverMessageStatus." << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    for (unsigned int i = 0; i < appNodes.size(); i++) {
+        if (!(*m_applicationHandlerCollection)[i]->ExecuteApplication(appNodes[i])) {
+            cout << "iCS --> [ERROR] RunApplicationLogic() in ExecuteApplicationMainFunction." << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
 int SyncManager::ConnectNs3()
 {
     if (m_wirelessComSimCommunicator->Connect())
@@ -867,23 +969,26 @@ SyncManager::ForwardSubscribedDataToApplication(ITetrisNode *node)
         return EXIT_SUCCESS;
     }
 
-    // Loop the subscriptions of the node
-    for (vector<Subscription*>::iterator subIt = node->m_subscriptionCollection->begin(); subIt < node->m_subscriptionCollection->end(); subIt++) {
-        Subscription* subscription = (*subIt);
-        vector<ApplicationHandler*>* apps = node->m_applicationHandlerInstalled;
-
-        // Loop the applications the node has installled
-        for (vector<ApplicationHandler*>::iterator appIt = apps->begin(); appIt < apps->end(); appIt++) {
-            ApplicationHandler* app = (*appIt);
-            if (app->m_id == subscription->m_appId) { // Check if the subscription was created by the application
-                int nodeId = node->m_icsId;
-
-                if (app->SendSubscribedData(nodeId, subscription, m_iTetrisNodeCollection) == EXIT_FAILURE) {
-                    cout << "iCS --> [ERROR] ForwardSubscribedDataToApplication() Error sending subscribed data." << endl;
-                    return EXIT_FAILURE;
-                }
+    // Loop the applications the node has installed, each one gets the data of its subscriptions in one batch
+    vector<ApplicationHandler*>* apps = node->m_applicationHandlerInstalled;
+    vector<Subscription*> appSubscriptions;
+    for (vector<ApplicationHandler*>::iterator appIt = apps->begin(); appIt < apps->end(); appIt++) {
+        ApplicationHandler* app = (*appIt);
+
+        appSubscriptions.clear();
+        for (vector<Subscription*>::iterator subIt = node->m_subscriptionCollection->begin(); subIt < node->m_subscriptionCollection->end(); subIt++) {
+            if ((*subIt)->m_appId == app->m_id) { // Check if the subscription was created by the application
+                appSubscriptions.push_back(*subIt);
             }
         }
+        if (appSubscriptions.empty()) {
+            continue;
+        }
+
+        if (app->SendSubscribedData(node->m_icsId, appSubscriptions) == EXIT_FAILURE) {
+            cout << "iCS --> [ERROR] ForwardSubscribedDataToApplication() Error sending subscribed data." << endl;
+            return EXIT_FAILURE;
+        }
     }
 
     return EXIT_SUCCESS;
@@ -903,50 +1008,250 @@ bool SyncManager::AssignApplication(ITetrisNode *node)
 
         // Decide if the application will be assigned based on the penetration rates
         if (ITetrisSimulationConfig::AssignApplication(appHand->m_rate, appHand->m_seed)) {
-            node->m_applicationHandlerInstalled->push_back(appHand);
+            if (!InstallApplication(node, appHand))
+                return false;
+        }
+    }
+
+    return true;
+}
 
-            switch (appHand->m_resultType) {
-            case OUTPUT_SET_SPEED_ADVICE_DEMO:
-            case OUTPUT_SET_VEHICLE_MAX_SPEED: {
-                ResultSetMaximumSpeed* result = new ResultSetMaximumSpeed(node->m_icsId, appHand->m_id);
-                node->m_resultContainerCollection->push_back(result);
+bool SyncManager::InstallApplication(ITetrisNode *node, ApplicationHandler* appHand)
+{
+    node->m_applicationHandlerInstalled->push_back(appHand);
+
+    switch (appHand->m_resultType) {
+    case OUTPUT_SET_SPEED_ADVICE_DEMO:
+    case OUTPUT_SET_VEHICLE_MAX_SPEED: {
+        ResultSetMaximumSpeed* result = new ResultSetMaximumSpeed(node->m_icsId, appHand->m_id);
+        node->m_resultContainerCollection->push_back(result);
+        break;
+    }
+    case OUTPUT_TRAVEL_TIME_ESTIMATION: {
+        ResultTravelTime* result = new ResultTravelTime(node->m_icsId, appHand->m_id);
+        node->m_resultContainerCollection->push_back(result);
+        break;
+    }
+    case OUTPUT_TRAFFIC_JAM_DETECTION: {
+        ResultTrafficJamDetection* result = new ResultTrafficJamDetection(
+            node->m_icsId, appHand->m_id);
+        node->m_resultContainerCollection->push_back(result);
+        break;
+    }
+    case OUTPUT_OPEN_BUSLANES: {
+        ResultOpenBuslanes* result = new ResultOpenBuslanes(
+            node->m_icsId, appHand->m_id);
+        node->m_resultContainerCollection->push_back(result);
+        break;
+    }
+    case OUTPUT_VOID: {
+        ResultVoid* result = new ResultVoid(node->m_icsId, appHand->m_id);
+        node->m_resultContainerCollection->push_back(result);
+        break;
+    }
+    case OUTPUT_GENERIC: {
+        ResultGeneric* result = new ResultGeneric(node->m_icsId, appHand->m_id);
+        node->m_resultContainerCollection->push_back(result);
+        break;
+    }
+    default:
+        cout << "iCS --> Result type is not registered. Please contact Application scientist. " << endl;
+        return false;
+    }
+
+    return true;
+}
+
+int
+SyncManager::CreateVehicleInNs3(VehicleNode* vehicle, vector<string>& nodesToActivateInNs3)
+{
+    vector<RATID>* rats = m_facilitiesManager->getStationActiveRATs(vehicle->m_icsId);
+    vector<string> techList;
+    if (rats->size() == 0) {
+        cout << "[ERROR] getStationActiveRATs returned 0 size" << endl;
+        return EXIT_FAILURE;
+    } else {
+        for (vector<RATID>::iterator it = rats->begin(); it!= rats->end(); it++) {
+            switch (*it) {
+            case WAVE: {
+                techList.push_back("WaveVehicle");
+                vehicle->m_rats.insert("WaveVehicle");
                 break;
             }
-            case OUTPUT_TRAVEL_TIME_ESTIMATION: {
-                ResultTravelTime* result = new ResultTravelTime(node->m_icsId, appHand->m_id);
-                node->m_resultContainerCollection->push_back(result);
+            case UMTS: {
+                techList.push_back("UmtsVehicle");
+                vehicle->m_rats.insert("UmtsVehicle");
                 break;
             }
-            case OUTPUT_TRAFFIC_JAM_DETECTION: {
-                ResultTrafficJamDetection* result = new ResultTrafficJamDetection(
-                    node->m_icsId, appHand->m_id);
-                node->m_resultContainerCollection->push_back(result);
+            case WiMAX: {
+                techList.push_back("WimaxVehicle");
+                vehicle->m_rats.insert("WimaxVehicle");
+              //  utils::Conversion::Wait("iCS --> Wimax not implemented yet.");
+                return EXIT_FAILURE;
                 break;
             }
-            case OUTPUT_OPEN_BUSLANES: {
-                ResultOpenBuslanes* result = new ResultOpenBuslanes(
-                    node->m_icsId, appHand->m_id);
-                node->m_resultContainerCollection->push_back(result);
+            case DVBH: {
+                techList.push_back("DvbhVehicle");
+                vehicle->m_rats.insert("DvbhVehicle");
                 break;
             }
-            case OUTPUT_VOID: {
-            	ResultVoid* result = new ResultVoid(node->m_icsId, appHand->m_id);
-            	node->m_resultContainerCollection->push_back(result);
-            	break;
+            default: {
+                cout << "[ERROR] RunOneSumoTimeStep() There is no match for the type of RAT" << endl;
+                delete rats;
+                return EXIT_FAILURE;
             }
-            case OUTPUT_GENERIC: {
-            	ResultGeneric* result = new ResultGeneric(node->m_icsId, appHand->m_id);
-            	node->m_resultContainerCollection->push_back(result);
-            	break;
             }
-            default:
-                cout << "iCS --> Result type is not registered. Please contact Application scientist. " << endl;
-                return false;
+        }
+    }
+    delete rats;
+
+    // Create the node in ns-3
+#ifdef NS3_ON
+    int32_t id = m_wirelessComSimCommunicator->CommandCreateNode2(vehicle->GetPositionX(), vehicle->GetPositionY(), vehicle->GetSpeed(), vehicle->GetHeading(), vehicle->GetLane(), techList);
+#else
+    int32_t id = 1;
+#endif
+    vehicle->m_nsId = id; // Assign the ns-3 node ID returned by ns-3
+    m_iTetrisNodeCollection->push_back(vehicle);
+    nodesToActivateInNs3.push_back(utils::Conversion::int2String(vehicle->m_nsId));  // Add vehicle to activate
+    return EXIT_SUCCESS;
+}
+
+int
+SyncManager::SaveCheckpoint(const string& path)
+{
+    Checkpoint checkpoint;
+    checkpoint.m_step = m_simStep;
+    checkpoint.m_idCounter = ITetrisNode::GetIdCounter();
+    checkpoint.m_preAssignedIds = ITetrisNode::GetPreAssignedIds();
+
+    // The LDM, the subscriptions and the scheduled messages are not saved, refuse to lose them
+    if (!m_facilitiesManager->isLDMEmpty()) {
+        cout << "iCS --> [ERROR] SaveCheckpoint() The LDM of the facilities is not empty." << endl;
+        return EXIT_FAILURE;
+    }
+    bool subscriptions = !m_subscriptionCollection->empty();
+    for (vector<ITetrisNode*>::iterator it = m_iTetrisNodeCollection->begin(); it != m_iTetrisNodeCollection->end(); ++it) {
+        if (!(*it)->m_subscriptionCollection->empty())
+            subscriptions = true;
+    }
+    if (subscriptions) {
+        cout << "iCS --> [ERROR] SaveCheckpoint() There are active subscriptions." << endl;
+        return EXIT_FAILURE;
+    }
+    if (!ScheduledCamMessageTable.empty() || !ScheduledUnicastMessageTable.empty()
+            || !ScheduledGeobroadcastMessageTable.empty() || !ScheduledTopobroadcastMessageTable.empty()) {
+        cout << "iCS --> [ERROR] SaveCheckpoint() There are scheduled messages." << endl;
+        return EXIT_FAILURE;
+    }
+
+#ifdef SUMO_ON
+    if (m_trafficSimCommunicator->CommandSaveState(Checkpoint::TrafficStateFile(path)) == EXIT_FAILURE) {
+        cout << "iCS --> [ERROR] SaveCheckpoint() The traffic simulator could not save its state." << endl;
+        return EXIT_FAILURE;
+    }
+#endif
+
+    // The fixed stations and the TMC are created again from the configuration
+    for (vector<ITetrisNode*>::iterator it = m_iTetrisNodeCollection->begin(); it != m_iTetrisNodeCollection->end(); ++it) {
+        VehicleNode* vehicle = dynamic_cast<VehicleNode*>(*it);
+        if (vehicle == NULL)
+            continue;
+
+        CheckpointVehicle saved;
+        stationID_t id = vehicle->m_icsId;
+        saved.tsId = vehicle->m_tsId;
+        saved.icsId = id;
+        saved.x = m_facilitiesManager->getStationPosition(id).x();
+        saved.y = m_facilitiesManager->getStationPosition(id).y();
+        saved.speed = m_facilitiesManager->getMobileStationSpeed(id);
+        saved.acceleration = m_facilitiesManager->getMobileStationAcceleration(id);
+        saved.direction = m_facilitiesManager->getMobileStationDirection(id);
+        saved.length = m_facilitiesManager->getMobileStationVehicleLegth(id);
+        saved.width = m_facilitiesManager->getMobileStationVehicleWidth(id);
+        saved.height = m_facilitiesManager->getMobileStationVehicleHeight(id);
+        saved.exteriorLights = m_facilitiesManager->getMobileStationExteriorLights(id);
+        saved.lane = m_facilitiesManager->getMobileStationLaneID(id);
+
+        vector<RATID>* rats = m_facilitiesManager->getStationRATs(id);
+        for (vector<RATID>::iterator rat = rats->begin(); rat != rats->end(); ++rat)
+            saved.rats.push_back(make_pair(*rat, m_facilitiesManager->isRATactiveInStation(id, *rat)));
+        delete rats;
+
+        for (vector<ApplicationHandler*>::iterator app = vehicle->m_applicationHandlerInstalled->begin(); app != vehicle->m_applicationHandlerInstalled->end(); ++app)
+            saved.applications.push_back((*app)->m_id);
+
+        checkpoint.m_vehicles.push_back(saved);
+    }
+
+    if (!checkpoint.Write(path))
+        return EXIT_FAILURE;
+
+    cout << "iCS --> Checkpoint of timestep " << m_simStep << " saved to " << path << endl;
+    return EXIT_SUCCESS;
+}
+
+int
+SyncManager::RestoreCheckpoint(const string& path)
+{
+    Checkpoint checkpoint;
+    if (!checkpoint.Read(path))
+        return EXIT_FAILURE;
+
+    m_simStep = checkpoint.m_step;
+    m_facilitiesManager->updateClock(m_simStep);
+
+    vector<string> nodesToActivateInNs3;
+    for (vector<CheckpointVehicle>::const_iterator it = checkpoint.m_vehicles.begin(); it != checkpoint.m_vehicles.end(); ++it) {
+        VehicleNode* vehicle = new VehicleNode(it->tsId, it->icsId);
+        vehicle->ChangeSpeed(it->speed);
+
+        TMobileStationDynamicInfo info;
+        info.speed = it->speed;
+        info.acceleration = it->acceleration;
+        info.direction = it->direction;
+        info.exteriorLights = it->exteriorLights;
+        info.positionX = it->x;
+        info.positionY = it->y;
+        info.length = it->length;
+        info.width = it->width;
+        info.height = it->height;
+        info.lane = it->lane;
+        info.timeStep = m_simStep;
+        m_facilitiesManager->updateMobileStationDynamicInformation(vehicle->m_icsId, info);
+        // The station got random technologies when it was created
+        m_facilitiesManager->setStationRATs(vehicle->m_icsId, it->rats);
+
+        for (vector<int>::const_iterator app = it->applications.begin(); app != it->applications.end(); ++app) {
+            ApplicationHandler* appHand = NULL;
+            for (vector<ApplicationHandler*>::iterator handler = m_applicationHandlerCollection->begin(); handler != m_applicationHandlerCollection->end(); ++handler) {
+                if ((*handler)->m_id == *app)
+                    appHand = *handler;
+            }
+            if (appHand == NULL) {
+                cout << "iCS --> [ERROR] RestoreCheckpoint() The application " << *app << " is not configured." << endl;
+                delete vehicle;
+                return EXIT_FAILURE;
+            }
+            if (!InstallApplication(vehicle, appHand)) {
+                delete vehicle;
+                return EXIT_FAILURE;
             }
         }
+
+        if (CreateVehicleInNs3(vehicle, nodesToActivateInNs3) == EXIT_FAILURE)
+            return EXIT_FAILURE;
     }
 
-    return true;
+#ifdef NS3_ON
+    m_wirelessComSimCommunicator->CommandActivateNode(nodesToActivateInNs3);
+#endif
+
+    // The restored vehicles must not change the IDs given to the next ones
+    ITetrisNode::RestoreIds(checkpoint.m_idCounter, checkpoint.m_preAssignedIds);
+
+    cout << "iCS --> Restored " << checkpoint.m_vehicles.size() << " vehicles of timestep " << m_simStep << " from " << path << endl;
+    return EXIT_SUCCESS;
 }
 
 int
@@ -964,32 +1269,40 @@ SyncManager::NewSubscriptions(ITetrisNode *node)
     vector<ApplicationHandler*>::iterator appsIt;
     vector<ApplicationHandler*>* apps = node->m_applicationHandlerInstalled;
 
-    vector<Subscription*>* newSubs = new vector<Subscription*> ();
+    vector<Subscription*> newSubs;
 
     // Loop the applications installed to ask for subscriptions
     for (appsIt = apps->begin(); appsIt < apps->end(); appsIt++) {
         ApplicationHandler* appHandler = (*appsIt);
         bool success = true;
-        success = appHandler->AskForNewSubscriptions(node->m_icsId, newSubs);
+        success = appHandler->AskForNewSubscriptions(node->m_icsId, &newSubs);
         if (!success) {
             cout << "iCS --> Error occurred when asking for new subscriptions (node " << node->m_icsId << ")" << endl;
             return EXIT_FAILURE;
         }
     }
 
-    if (newSubs->size() == 0) {
+    AddNewSubscriptions(node, newSubs);
+
+    return EXIT_SUCCESS;
+}
+
+void
+SyncManager::AddNewSubscriptions(ITetrisNode *node, vector<Subscription*>& newSubs)
+{
+    if (newSubs.size() == 0) {
 
 #ifdef LOG_ON
         stringstream log;
         log << "iCS --> NewSubscriptions() The node " << node->m_icsId << " requested 0 subscriptions";
         IcsLog::LogLevel((log.str()).c_str(), kLogLevelInfo);
 #endif
-        return EXIT_SUCCESS;
+        return;
     }
 
     // Loop the new subscription, linked them and process if needed (for example, creating CAM areas)
     vector<Subscription*>::iterator subIt;
-    for (subIt = newSubs->begin(); subIt < newSubs->end(); subIt++) {
+    for (subIt = newSubs.begin(); subIt < newSubs.end(); subIt++) {
 
         Subscription* subscription = *subIt;
         node->m_subscriptionCollection->push_back(subscription);
@@ -1010,8 +1323,6 @@ SyncManager::NewSubscriptions(ITetrisNode *node)
             m_v2xMessageTracker->CreateV2xCamArea(subSetCamArea->m_id, subSetCamArea->GetFrequency(), payloadLength);
         }
     }
-
-    return EXIT_SUCCESS;
 }
 
 int
@@ -1181,6 +1492,14 @@ SyncManager::RemoveNodeInTheArea(ITetrisNode* node)
     }
 }
 
+const NodePositionIndex&
+SyncManager::GetNodePositionIndex()
+{
+    if (!m_nodePositionIndex.IsBuilt())
+        m_nodePositionIndex.Build(*m_iTetrisNodeCollection);
+    return m_nodePositionIndex;
+}
+
 int SyncManager::ScheduleV2xMessages()
 {
     if (ScheduleV2xCamAreaMessages() == EXIT_FAILURE) {
@@ -1246,6 +1565,7 @@ SyncManager::GetDataFromNs3()
             log << "GetDataFromNs3() Node " << node->m_icsId << " received " << receivedMessages->size() << " messages";
             IcsLog::LogLevel((log.str()).c_str(),kLogLevelInfo);
 #endif
+            m_stepReceivedMessages += receivedMessages->size();
 
             // Loop received messages
             for (vector<ReceivedMessage>::iterator receivedIterator = receivedMessages->begin(); receivedIterator != receivedMessages->end(); receivedIterator++) {
@@ -1638,81 +1958,59 @@ int SyncManager::ScheduleV2xCamAreaMessages()
     vector<string> idNodesToStop;
     vector<string> idNodesToStart;
 
-    // Loop on each station
-    for (vector<ITetrisNode*>::iterator nodeIt = m_iTetrisNodeCollection->begin(); nodeIt != m_iTetrisNodeCollection->end(); ++nodeIt) {
-
-        if ((*nodeIt)->m_icsId == 0)  // Skip TMC node
-            continue;
-
-        // Flag to know if the current node is inside at least one CAM area.
-        bool isNodeInAnyArea = false;
-        // Initialize the frequency to send CAM messages, if necessary.
-        float maxFrequency = 0.0;
-        // Initialize the payload length of the CAM messages to be sent, if necessary.
-        unsigned int maxPayloadLength = 0;
+    // Evaluate every CAM area once against the positions of this timestep. For each node inside
+    // at least one area keep the maximum frequency and payload length of the areas it is in.
+    map<ITetrisNode*, pair<float, unsigned int> > nodesInAreas;
+    if (!camAreas->empty()) {
+        map<int, Subscription*> subscriptionsById;
+        for (vector<Subscription*>::iterator subIt = m_subscriptionCollection->begin(); subIt < m_subscriptionCollection->end(); subIt++) {
+            subscriptionsById[(*subIt)->m_id] = *subIt;
+        }
+        const NodePositionIndex& index = GetNodePositionIndex();
 
         // Loop CAM areas
         for (vector<V2xCamArea*>::iterator camAreasIt = camAreas->begin(); camAreasIt < camAreas->end(); camAreasIt++) {
 
-            // Get the subscriptionId of to the current V2xcamArea
-            V2xCamArea* camArea = *camAreasIt;
-            int subscriptionId = camArea->m_subscriptionId;
-            Subscription* subscription = NULL;
-
             // Find the subscription that created the CAM area
-            for (vector<Subscription*>::iterator subIt = m_subscriptionCollection->begin(); subIt < m_subscriptionCollection->end(); subIt++) {
-                subscription = *subIt;
-                if (subscriptionId == subscription->m_id) {
-                    break;
-                }
-            }
-            if (subscription == NULL) {
+            V2xCamArea* camArea = *camAreasIt;
+            map<int, Subscription*>::iterator subIt = subscriptionsById.find(camArea->m_subscriptionId);
+            if (subIt == subscriptionsById.end()) {
                 cout << "iCS --> [ScheduleV2xCamAreaMessages] ERROR The CAM area was not created by a subscription." << endl;
                 return EXIT_FAILURE;
-            } else {
-
-                // Cast subscription to the SubsSetCamArea type
-                SubsSetCamArea* subSetCamArea = static_cast<SubsSetCamArea*>(subscription);
-
-                nodeStatusInArea_t nodeStatus = subSetCamArea->checkNodeStatus(*nodeIt);
-
-                switch (nodeStatus) {
-                case((int) JustArrivedInArea): {
-                    subSetCamArea->AddNodeToVector((*nodeIt));
-                    if (maxFrequency < subSetCamArea->GetFrequency())
-                        maxFrequency = subSetCamArea->GetFrequency();
+            }
 
-                    if (maxPayloadLength < camArea->m_payloadLength)
-                        maxPayloadLength = camArea->m_payloadLength;
+            // Cast subscription to the SubsSetCamArea type
+            SubsSetCamArea* subSetCamArea = static_cast<SubsSetCamArea*>(subIt->second);
 
-                    isNodeInAnyArea = true;
-                    break;
-                }
-                case((int) JustLeftArea): {
-                    subSetCamArea->RemoveNodeFromVector((*nodeIt));
-                    break;
+            // Nodes that just arrived or are still inside; the ones that left are dropped by the update
+            const vector<ITetrisNode*>& nodesInArea = subSetCamArea->UpdateNodesInArea(index, NULL, NULL);
+            for (vector<ITetrisNode*>::const_iterator nodeIt = nodesInArea.begin(); nodeIt != nodesInArea.end(); ++nodeIt) {
+                map<ITetrisNode*, pair<float, unsigned int> >::iterator demand = nodesInAreas.find(*nodeIt);
+                if (demand == nodesInAreas.end()) {
+                    demand = nodesInAreas.insert(make_pair(*nodeIt, make_pair(0.0f, 0u))).first;
                 }
-                case((int) StillInsideArea): {
-                    isNodeInAnyArea = true;
-                    if (maxFrequency < subSetCamArea->GetFrequency())
-                        maxFrequency = subSetCamArea->GetFrequency();
+                if (demand->second.first < subSetCamArea->GetFrequency())
+                    demand->second.first = subSetCamArea->GetFrequency();
 
-                    if (maxPayloadLength < camArea->m_payloadLength)
-                        maxPayloadLength = camArea->m_payloadLength;
-
-                    break;
-                }
-                case((int) StillOutsideArea): {
-                    break;
-                }
-                default: {
-                    cout << "iCS --> [ScheduleV2xCamAreaMessages] ERROR It is not possible to determine the status of node " << (*nodeIt)->m_icsId;
-                    cout << " within the current V2X-cam-area." << endl;
-                    return EXIT_FAILURE;
-                }
-                }
+                if (demand->second.second < camArea->m_payloadLength)
+                    demand->second.second = camArea->m_payloadLength;
             }
         }
+    }
+
+    // Loop on each station
+    for (vector<ITetrisNode*>::iterator nodeIt = m_iTetrisNodeCollection->begin(); nodeIt != m_iTetrisNodeCollection->end(); ++nodeIt) {
+
+        if ((*nodeIt)->m_icsId == 0)  // Skip TMC node
+            continue;
+
+        map<ITetrisNode*, pair<float, unsigned int> >::const_iterator demand = nodesInAreas.find(*nodeIt);
+        // Flag to know if the current node is inside at least one CAM area.
+        bool isNodeInAnyArea = (demand != nodesInAreas.end());
+        // The frequency to send CAM messages, if necessary.
+        float maxFrequency = isNodeInAnyArea ? demand->second.first : 0.0;
+        // The payload length of the CAM messages to be sent, if necessary.
+        unsigned int maxPayloadLength = isNodeInAnyArea ? demand->second.second : 0;
 
         if (SubsSetCamArea::isNodeInGeneralCamSubscriptionVector((*nodeIt))) {
             if (isNodeInAnyArea &&
@@ -23,6 +23,7 @@
 
 #include <iostream>
 #include <vector>
+#include <map>
 
 #include "utilities.h"
 #include "itetris-simulation-config.h"
@@ -31,6 +32,8 @@
 #include "utils/ics/iCStypes.h"
 #include "wirelesscom_sim_message_tracker/V2X-message-manager.h"
 #include "FacilitiesManager.h"
+#include "node-position-index.h"
+#include "step-statistics.h"
 
 namespace ics
 {
@@ -104,7 +107,8 @@ public:
     /**
     * @brief Abstract connector to the traffic road simulator.
     * This member is used as a generic link. The real implementation
-    * is in the TraCI connector member.
+    * is in the TraCI connector member, or a trace recorder wrapping it,
+    * or a trace replayer instead of SUMO.
     */
     static TrafficSimulatorCommunicator* m_trafficSimCommunicator;
 
@@ -210,6 +214,30 @@ public:
     */
     bool AssignApplication(ITetrisNode *node);
 
+    /**
+    * @brief Installs a given application on a node
+    * @param[in] node A node object
+    * @param[in] appHand The application
+    * @return False: If the result type of the application is unknown
+    */
+    bool InstallApplication(ITetrisNode *node, ApplicationHandler* appHand);
+
+    /**
+    * @brief Saves the state of the simulation at the end of the current timestep.
+    * SUMO saves its own state to Checkpoint::TrafficStateFile(path).
+    * @param[in] path The checkpoint file
+    * @return EXIT_SUCCESS if the checkpoint was written, EXIT_FAILURE otherwise
+    */
+    int SaveCheckpoint(const std::string& path);
+
+    /**
+    * @brief Creates the vehicles of a checkpoint in the iCS and in ns-3.
+    * SUMO must have been launched with the state saved for the checkpoint.
+    * @param[in] path The checkpoint file
+    * @return EXIT_SUCCESS if the checkpoint was restored, EXIT_FAILURE otherwise
+    */
+    int RestoreCheckpoint(const std::string& path);
+
     /**
     * @brief Adds an element in the application handler
     * @param[in] appHandler Element to insert
@@ -344,8 +372,26 @@ public:
     */
     void RemoveNodeInTheArea(ITetrisNode* node);
 
+    /**
+    * @brief Returns the positions of the stations in the current timestep.
+    * The index is built the first time it is asked for in a timestep.
+    */
+    const NodePositionIndex& GetNodePositionIndex();
+
 private:
 
+    /// @brief Spatial index of the stations, shared by all the zone subscriptions of a timestep.
+    NodePositionIndex m_nodePositionIndex;
+
+    /// @brief Per step time series written if ITetrisSimulationConfig::m_stepStatisticsFile is set.
+    StepStatistics m_stepStatistics;
+
+    /// @brief Messages received from ns-3 in the current timestep.
+    unsigned int m_stepReceivedMessages;
+
+    /// @brief Collects the counters of the timestep and writes them to the step statistics.
+    void RecordStepStatistics();
+
     /// @brief The timestep in which the simulation will end.
     int m_lastTimeStep;
 
@@ -365,6 +411,14 @@ private:
      */
     int RunOneSumoTimeStep();
 
+    /**
+     * @brief Sets the technologies of a vehicle from the facilities and creates it in ns-3.
+     * @param[in] vehicle The vehicle, added to the node collection.
+     * @param[out] nodesToActivateInNs3 The ns-3 ID of the vehicle is appended.
+     * @return EXIT_SUCCESS if the vehicle was created, EXIT_FAILURE otherwise
+     */
+    int CreateVehicleInNs3(VehicleNode* vehicle, std::vector<std::string>& nodesToActivateInNs3);
+
     /**
      * @brief Executes the logic of ns-3 for the next timestep.
      * @return 0 if timestep was correctly executed.
@@ -416,6 +470,21 @@ private:
     */
     int ExecuteApplicationMainFunction(ITetrisNode* node);
 
+    /**
+    * @brief Links new subscriptions to the node and to the simulation, and processes them if needed
+    * (for example, creating CAM areas).
+    * @param[in] node The node the subscriptions belong to.
+    * @param[in] newSubs The subscriptions requested by the applications of the node.
+    */
+    void AddNewSubscriptions(ITetrisNode* node, std::vector<Subscription*>& newSubs);
+
+    /**
+    * @brief Runs the application logic phase by phase, sending each application the commands of all
+    * its nodes in one message per phase. Used when all the applications negotiated multi-node batches.
+    * @return EXIT_SUCCESS if all the phases finish successfully, EXIT_FAILURE otherwise.
+    */
+    int RunApplicationLogicMultiNode();
+
     /**
     * @brief Returns the node corresponding to the ns-3 ID
     * @param[in] nodeID The ID of the node in ns-3 simulator
@@ -477,6 +546,15 @@ private:
     /// @brief Vehicles that left the simulation that are going to tell wireless simulator to deactivate.
     std::vector<std::string> m_vehiclesToBeDeactivated;
 
+    /// @brief Identifiers of the traffic lights in the traffic simulator, retrieved once.
+    std::vector<ics_types::trafficLightID_t> m_trafficLightIds;
+
+    /// @brief Whether m_trafficLightIds has already been retrieved from the traffic simulator.
+    bool m_trafficLightIdsLoaded;
+
+    /// @brief Last known signal state string of each traffic light, used to forward only the changes to the facilities.
+    std::map<ics_types::trafficLightID_t, std::string> m_trafficLightStates;
+
     /// @brief Testing purposes only.
     void TestInciPrimitives();
 };
@@ -0,0 +1,314 @@
+/****************************************************************************/
+/// @file    trace-recording-client.cpp
+/// @author  iTETRIS
+/// @date
+/// @version $Id:
+///
+/****************************************************************************/
+// iTETRIS, see http://www.ict-itetris.eu
+// Copyright © 2008 iTetris Project Consortium - All rights reserved
+/****************************************************************************/
+
+// ===========================================================================
+// included modules
+// ===========================================================================
+#ifdef _MSC_VER
+#include <windows_config.h>
+#else
+#include <config.h>
+#endif
+
+#include <cstdlib>
+
+#include "trace-recording-client.h"
+#include "../itetris-node.h"
+
+// ===========================================================================
+// used namespaces
+// ===========================================================================
+using namespace std;
+using namespace ics_types;
+
+namespace ics
+{
+
+// ===========================================================================
+// member method definitions
+// ===========================================================================
+TraceRecordingClient::TraceRecordingClient(TrafficSimulatorCommunicator& trafficSim, const string& path)
+        : m_trafficSim(trafficSim), m_path(path), m_stepOpen(false) {}
+
+TraceRecordingClient::~TraceRecordingClient()
+{
+    FlushStep();
+}
+
+bool
+TraceRecordingClient::Connect()
+{
+    if (!m_writer.Open(m_path))
+        return false;
+    return m_trafficSim.Connect();
+}
+
+int
+TraceRecordingClient::Close()
+{
+    FlushStep();
+    m_writer.Close();
+    return m_trafficSim.Close();
+}
+
+int
+TraceRecordingClient::CommandSimulationStep(double time, vector<string> &departed, vector<string> &arrived)
+{
+    FlushStep();
+    int result = m_trafficSim.CommandSimulationStep(time, departed, arrived);
+    if (result == EXIT_SUCCESS) {
+        m_step.time = time;
+        m_step.departed = departed;
+        m_step.arrived = arrived;
+        m_stepOpen = true;
+    }
+    return result;
+}
+
+int
+TraceRecordingClient::CommandClose()
+{
+    return m_trafficSim.CommandClose();
+}
+
+int
+TraceRecordingClient::CommandSetMaximumSpeed(const ITetrisNode &node, float maxSpeed)
+{
+    return m_trafficSim.CommandSetMaximumSpeed(node, maxSpeed);
+}
+
+int
+TraceRecordingClient::CommandSlowDown(const ITetrisNode &node, float speed, int duration)
+{
+    return m_trafficSim.CommandSlowDown(node, speed, duration);
+}
+
+int
+TraceRecordingClient::CommandSetColor(const ITetrisNode &node, unsigned char red, unsigned char green, unsigned char blue, unsigned char alpha)
+{
+    return m_trafficSim.CommandSetColor(node, red, green, blue, alpha);
+}
+
+float
+TraceRecordingClient::GetSpeed(const ITetrisNode &node)
+{
+    float speed = m_trafficSim.GetSpeed(node);
+    if (m_stepOpen) {
+        TrafficTraceVehicle& vehicle = Vehicle(node);
+        vehicle.speed = speed;
+        vehicle.fields |= TrafficTraceVehicle::FIELD_SPEED;
+    }
+    return speed;
+}
+
+float
+TraceRecordingClient::GetDirection(const ITetrisNode &node)
+{
+    float direction = m_trafficSim.GetDirection(node);
+    if (m_stepOpen) {
+        TrafficTraceVehicle& vehicle = Vehicle(node);
+        vehicle.direction = direction;
+        vehicle.fields |= TrafficTraceVehicle::FIELD_DIRECTION;
+    }
+    return direction;
+}
+
+float
+TraceRecordingClient::GetVehicleLength(const ITetrisNode &node)
+{
+    float length = m_trafficSim.GetVehicleLength(node);
+    if (m_stepOpen) {
+        TrafficTraceVehicle& vehicle = Vehicle(node);
+        vehicle.length = length;
+        vehicle.fields |= TrafficTraceVehicle::FIELD_LENGTH;
+    }
+    return length;
+}
+
+float
+TraceRecordingClient::GetVehicleWidth(const ITetrisNode &node)
+{
+    float width = m_trafficSim.GetVehicleWidth(node);
+    if (m_stepOpen) {
+        TrafficTraceVehicle& vehicle = Vehicle(node);
+        vehicle.width = width;
+        vehicle.fields |= TrafficTraceVehicle::FIELD_WIDTH;
+    }
+    return width;
+}
+
+pair<float,float>
+TraceRecordingClient::GetPosition(const ITetrisNode &node)
+{
+    pair<float,float> position = m_trafficSim.GetPosition(node);
+    if (m_stepOpen) {
+        TrafficTraceVehicle& vehicle = Vehicle(node);
+        vehicle.x = position.first;
+        vehicle.y = position.second;
+        vehicle.fields |= TrafficTraceVehicle::FIELD_POSITION;
+    }
+    return position;
+}
+
+bool
+TraceRecordingClient::GetExteriorLights(const ITetrisNode &node)
+{
+    bool lights = m_trafficSim.GetExteriorLights(node);
+    if (m_stepOpen) {
+        TrafficTraceVehicle& vehicle = Vehicle(node);
+        vehicle.lights = lights;
+        vehicle.fields |= TrafficTraceVehicle::FIELD_LIGHTS;
+    }
+    return lights;
+}
+
+string
+TraceRecordingClient::GetLane(const ITetrisNode &node)
+{
+    string lane = m_trafficSim.GetLane(node);
+    if (m_stepOpen) {
+        TrafficTraceVehicle& vehicle = Vehicle(node);
+        vehicle.lane = lane;
+        vehicle.fields |= TrafficTraceVehicle::FIELD_LANE;
+    }
+    return lane;
+}
+
+string
+TraceRecordingClient::GetVehicleType(const ITetrisNode &node)
+{
+    string type = m_trafficSim.GetVehicleType(node);
+    if (m_stepOpen) {
+        TrafficTraceVehicle& vehicle = Vehicle(node);
+        vehicle.type = type;
+        vehicle.fields |= TrafficTraceVehicle::FIELD_TYPE;
+    }
+    return type;
+}
+
+int
+TraceRecordingClient::SetVehicleToRunInLane(const ITetrisNode &node, string laneId)
+{
+    return m_trafficSim.SetVehicleToRunInLane(node, laneId);
+}
+
+int
+TraceRecordingClient::SetVehicleToRunInLane(string laneId)
+{
+    return m_trafficSim.SetVehicleToRunInLane(laneId);
+}
+
+bool
+TraceRecordingClient::ReRoute(const ITetrisNode &node, vector<string> route)
+{
+    return m_trafficSim.ReRoute(node, route);
+}
+
+bool
+TraceRecordingClient::ReRoute(const ITetrisNode &node)
+{
+    return m_trafficSim.ReRoute(node);
+}
+
+bool
+TraceRecordingClient::ChangeTrafficLightStatus(string trafficLightId, string lightStates)
+{
+    return m_trafficSim.ChangeTrafficLightStatus(trafficLightId, lightStates);
+}
+
+bool
+TraceRecordingClient::ChangeEdgeWeight(const ITetrisNode &node, string edgeId, float weight)
+{
+    return m_trafficSim.ChangeEdgeWeight(node, edgeId, weight);
+}
+
+bool
+TraceRecordingClient::SetEdgeWeight(string edgeId, float weight)
+{
+    return m_trafficSim.SetEdgeWeight(edgeId, weight);
+}
+
+float
+TraceRecordingClient::GetEdgeWeight(string edgeId)
+{
+    float weight = m_trafficSim.GetEdgeWeight(edgeId);
+    if (m_stepOpen)
+        m_step.edgeWeights[edgeId] = weight;
+    return weight;
+}
+
+vector<string>
+TraceRecordingClient::GetRouteEdges(const ITetrisNode &node)
+{
+    vector<string> edges = m_trafficSim.GetRouteEdges(node);
+    if (m_stepOpen)
+        m_step.vehicleRoutes[node.m_tsId] = edges;
+    return edges;
+}
+
+vector<string>
+TraceRecordingClient::GetRouteEdges(string routeID)
+{
+    vector<string> edges = m_trafficSim.GetRouteEdges(routeID);
+    if (m_stepOpen)
+        m_step.routes[routeID] = edges;
+    return edges;
+}
+
+int
+TraceRecordingClient::GetTrafficLights(vector<trafficLightID_t>& trafficLigthIds)
+{
+    int result = m_trafficSim.GetTrafficLights(trafficLigthIds);
+    if (m_stepOpen && result == EXIT_SUCCESS) {
+        m_step.trafficLights = trafficLigthIds;
+        m_step.hasTrafficLights = true;
+    }
+    return result;
+}
+
+int
+TraceRecordingClient::GetTrafficLightStatus(trafficLightID_t trafficLightId, string &state)
+{
+    int result = m_trafficSim.GetTrafficLightStatus(trafficLightId, state);
+    if (m_stepOpen && result == EXIT_SUCCESS)
+        m_step.trafficLightStates[trafficLightId] = state;
+    return result;
+}
+
+bool
+TraceRecordingClient::GetChannelStatistics(unsigned long long& sentBytes, unsigned long long& receivedBytes, unsigned long& roundTrips) const
+{
+    return m_trafficSim.GetChannelStatistics(sentBytes, receivedBytes, roundTrips);
+}
+
+int
+TraceRecordingClient::CommandSaveState(const string& file)
+{
+    return m_trafficSim.CommandSaveState(file);
+}
+
+void
+TraceRecordingClient::FlushStep()
+{
+    if (!m_stepOpen)
+        return;
+    m_writer.Write(m_step);
+    m_step.Clear();
+    m_stepOpen = false;
+}
+
+TrafficTraceVehicle&
+TraceRecordingClient::Vehicle(const ITetrisNode &node)
+{
+    return m_step.vehicles[node.m_tsId];
+}
+
+}
@@ -0,0 +1,138 @@
+/****************************************************************************/
+/// @file    trace-recording-client.h
+/// @author  iTETRIS
+/// @date
+/// @version $Id:
+///
+/****************************************************************************/
+// iTETRIS, see http://www.ict-itetris.eu
+// Copyright © 2008 iTetris Project Consortium - All rights reserved
+/****************************************************************************/
+#ifndef TRACE_RECORDING_CLIENT_H
+#define TRACE_RECORDING_CLIENT_H
+
+// ===========================================================================
+// included modules
+// ===========================================================================
+#ifdef _MSC_VER
+#include <windows_config.h>
+#else
+#include <config.h>
+#endif
+
+#include <string>
+#include <vector>
+
+#include "traffic-simulator-communicator.h"
+#include "traffic-trace.h"
+
+namespace ics
+{
+
+// ===========================================================================
+// class definitions
+// ===========================================================================
+/**
+* @class TraceRecordingClient
+* @brief Forwards the commands to the traffic simulator and records the answers in a trace.
+*
+* Everything the iCS gets from the traffic simulator after a simulation step is kept and
+* written to the trace when the next step starts, so that TraceReplayClient can give the
+* same answers without running the traffic simulator.
+*/
+class TraceRecordingClient : public TrafficSimulatorCommunicator
+{
+public:
+    /**
+    * @brief Constructor.
+    * @param[in] trafficSim The connection to the traffic simulator. It is not owned.
+    * @param[in] path File the trace is written to.
+    */
+    TraceRecordingClient(TrafficSimulatorCommunicator& trafficSim, const std::string& path);
+
+    /// @brief Destructor.
+    ~TraceRecordingClient();
+
+    /// @brief Creates the trace and connects to the traffic simulator.
+    bool Connect();
+
+    /// @brief Writes the last step, closes the trace and the connection.
+    int Close();
+
+    int CommandSimulationStep(double time, std::vector<std::string> &departed, std::vector<std::string> &arrived);
+
+    int CommandClose();
+
+    int CommandSetMaximumSpeed(const ITetrisNode &node, float maxSpeed);
+
+    int CommandSlowDown(const ITetrisNode &node, float speed, int duration);
+
+    int CommandSetColor(const ITetrisNode &node, unsigned char red, unsigned char green, unsigned char blue, unsigned char alpha);
+
+    float GetSpeed(const ITetrisNode &node);
+
+    float GetDirection(const ITetrisNode &node);
+
+    float GetVehicleLength(const ITetrisNode &node);
+
+    float GetVehicleWidth(const ITetrisNode &node);
+
+    std::pair<float,float> GetPosition(const ITetrisNode &node);
+
+    bool GetExteriorLights(const ITetrisNode &node);
+
+    std::string GetLane(const ITetrisNode &node);
+
+    std::string GetVehicleType(const ITetrisNode &node);
+
+    int SetVehicleToRunInLane(const ITetrisNode &node, std::string laneId);
+
+    int SetVehicleToRunInLane(std::string laneId);
+
+    bool ReRoute(const ITetrisNode &node, std::vector<std::string> route);
+
+    bool ReRoute(const ITetrisNode &node);
+
+    bool ChangeTrafficLightStatus(std::string trafficLightId, std::string lightStates);
+
+    bool ChangeEdgeWeight(const ITetrisNode &node, std::string edgeId, float weight);
+
+    bool SetEdgeWeight(std::string edgeId, float weight);
+
+    float GetEdgeWeight(std::string edgeId);
+
+    std::vector<std::string> GetRouteEdges(const ITetrisNode &node);
+
+    std::vector<std::string> GetRouteEdges(std::string routeID);
+
+    int GetTrafficLights(std::vector<ics_types::trafficLightID_t>& trafficLigthIds);
+
+    int GetTrafficLightStatus(ics_types::trafficLightID_t trafficLightId, std::string &state);
+
+    bool GetChannelStatistics(unsigned long long& sentBytes, unsigned long long& receivedBytes, unsigned long& roundTrips) const;
+
+    int CommandSaveState(const std::string& file);
+
+private:
+    /// @brief Writes the current step to the trace, if there is one.
+    void FlushStep();
+
+    /// @brief Entry of the vehicle in the current step.
+    TrafficTraceVehicle& Vehicle(const ITetrisNode &node);
+
+    TrafficSimulatorCommunicator& m_trafficSim;
+
+    std::string m_path;
+
+    TrafficTraceWriter m_writer;
+
+    /// @brief Answers of the traffic simulator since the last simulation step.
+    TrafficTraceStep m_step;
+
+    /// @brief True once a simulation step was run. The answers before the first step are not recorded.
+    bool m_stepOpen;
+};
+
+}
+
+#endif
@@ -0,0 +1,313 @@
+/****************************************************************************/
+/// @file    trace-replay-client.cpp
+/// @author  iTETRIS
+/// @date
+/// @version $Id:
+///
+/****************************************************************************/
+// iTETRIS, see http://www.ict-itetris.eu
+// Copyright © 2008 iTetris Project Consortium - All rights reserved
+/****************************************************************************/
+
+// ===========================================================================
+// included modules
+// ===========================================================================
+#ifdef _MSC_VER
+#include <windows_config.h>
+#else
+#include <config.h>
+#endif
+
+#include <cstdlib>
+#include <iostream>
+
+#include "trace-replay-client.h"
+#include "../itetris-node.h"
+#include "../../utils/ics/log/ics-log.h"
+
+// ===========================================================================
+// used namespaces
+// ===========================================================================
+using namespace std;
+using namespace ics_types;
+
+namespace ics
+{
+
+// ===========================================================================
+// member method definitions
+// ===========================================================================
+TraceReplayClient::TraceReplayClient(const string& path)
+        : m_path(path), m_hasTrafficLights(false) {}
+
+TraceReplayClient::~TraceReplayClient() { }
+
+bool
+TraceReplayClient::Connect()
+{
+    if (!m_reader.Open(m_path))
+        return false;
+    cout << "iCS --> Replaying the traffic trace " << m_path << endl;
+    return true;
+}
+
+int
+TraceReplayClient::Close()
+{
+    m_reader.Close();
+    return EXIT_SUCCESS;
+}
+
+int
+TraceReplayClient::CommandSimulationStep(double time, vector<string> &departed, vector<string> &arrived)
+{
+    TrafficTraceStep step;
+    if (!m_reader.Read(step)) {
+        cout << "iCS --> [ERROR] The traffic trace ends before time " << time << endl;
+        return EXIT_FAILURE;
+    }
+    if (step.time != time) {
+        cout << "iCS --> [ERROR] The traffic trace has time " << step.time << " instead of " << time
+             << ". Replay with the same begin time and timestep it was recorded with." << endl;
+        return EXIT_FAILURE;
+    }
+
+    for (map<string, TrafficTraceVehicle>::const_iterator it = step.vehicles.begin(); it != step.vehicles.end(); ++it)
+        m_vehicles[it->first].Merge(it->second);
+    for (vector<string>::const_iterator it = step.arrived.begin(); it != step.arrived.end(); ++it) {
+        m_vehicles.erase(*it);
+        m_vehicleRoutes.erase(*it);
+    }
+
+    if (step.hasTrafficLights) {
+        m_trafficLights = step.trafficLights;
+        m_hasTrafficLights = true;
+    }
+    for (map<trafficLightID_t, string>::const_iterator it = step.trafficLightStates.begin(); it != step.trafficLightStates.end(); ++it)
+        m_trafficLightStates[it->first] = it->second;
+    for (map<string, float>::const_iterator it = step.edgeWeights.begin(); it != step.edgeWeights.end(); ++it)
+        m_edgeWeights[it->first] = it->second;
+    for (map<string, vector<string> >::const_iterator it = step.vehicleRoutes.begin(); it != step.vehicleRoutes.end(); ++it)
+        m_vehicleRoutes[it->first] = it->second;
+    for (map<string, vector<string> >::const_iterator it = step.routes.begin(); it != step.routes.end(); ++it)
+        m_routes[it->first] = it->second;
+
+    departed.swap(step.departed);
+    arrived.swap(step.arrived);
+    return EXIT_SUCCESS;
+}
+
+int
+TraceReplayClient::CommandClose()
+{
+    return EXIT_SUCCESS;
+}
+
+int
+TraceReplayClient::CommandSetMaximumSpeed(const ITetrisNode &node, float maxSpeed)
+{
+    Unsupported("CommandSetMaximumSpeed");
+    return EXIT_FAILURE;
+}
+
+int
+TraceReplayClient::CommandSlowDown(const ITetrisNode &node, float speed, int duration)
+{
+    Unsupported("CommandSlowDown");
+    return EXIT_FAILURE;
+}
+
+int
+TraceReplayClient::CommandSetColor(const ITetrisNode &node, unsigned char red, unsigned char green, unsigned char blue, unsigned char alpha)
+{
+    Unsupported("CommandSetColor");
+    return EXIT_FAILURE;
+}
+
+float
+TraceReplayClient::GetSpeed(const ITetrisNode &node)
+{
+    return Vehicle(node, TrafficTraceVehicle::FIELD_SPEED).speed;
+}
+
+float
+TraceReplayClient::GetDirection(const ITetrisNode &node)
+{
+    return Vehicle(node, TrafficTraceVehicle::FIELD_DIRECTION).direction;
+}
+
+float
+TraceReplayClient::GetVehicleLength(const ITetrisNode &node)
+{
+    return Vehicle(node, TrafficTraceVehicle::FIELD_LENGTH).length;
+}
+
+float
+TraceReplayClient::GetVehicleWidth(const ITetrisNode &node)
+{
+    return Vehicle(node, TrafficTraceVehicle::FIELD_WIDTH).width;
+}
+
+pair<float,float>
+TraceReplayClient::GetPosition(const ITetrisNode &node)
+{
+    const TrafficTraceVehicle& vehicle = Vehicle(node, TrafficTraceVehicle::FIELD_POSITION);
+    return make_pair(vehicle.x, vehicle.y);
+}
+
+bool
+TraceReplayClient::GetExteriorLights(const ITetrisNode &node)
+{
+    return Vehicle(node, TrafficTraceVehicle::FIELD_LIGHTS).lights;
+}
+
+string
+TraceReplayClient::GetLane(const ITetrisNode &node)
+{
+    return Vehicle(node, TrafficTraceVehicle::FIELD_LANE).lane;
+}
+
+string
+TraceReplayClient::GetVehicleType(const ITetrisNode &node)
+{
+    return Vehicle(node, TrafficTraceVehicle::FIELD_TYPE).type;
+}
+
+int
+TraceReplayClient::SetVehicleToRunInLane(const ITetrisNode &node, string laneId)
+{
+    Unsupported("SetVehicleToRunInLane");
+    return EXIT_FAILURE;
+}
+
+int
+TraceReplayClient::SetVehicleToRunInLane(string laneId)
+{
+    Unsupported("SetVehicleToRunInLane");
+    return EXIT_FAILURE;
+}
+
+bool
+TraceReplayClient::ReRoute(const ITetrisNode &node, vector<string> route)
+{
+    Unsupported("ReRoute");
+    return false;
+}
+
+bool
+TraceReplayClient::ReRoute(const ITetrisNode &node)
+{
+    Unsupported("ReRoute");
+    return false;
+}
+
+bool
+TraceReplayClient::ChangeTrafficLightStatus(string trafficLightId, string lightStates)
+{
+    Unsupported("ChangeTrafficLightStatus");
+    return false;
+}
+
+bool
+TraceReplayClient::ChangeEdgeWeight(const ITetrisNode &node, string edgeId, float weight)
+{
+    Unsupported("ChangeEdgeWeight");
+    return false;
+}
+
+bool
+TraceReplayClient::SetEdgeWeight(string edgeId, float weight)
+{
+    Unsupported("SetEdgeWeight");
+    return false;
+}
+
+float
+TraceReplayClient::GetEdgeWeight(string edgeId)
+{
+    map<string, float>::const_iterator it = m_edgeWeights.find(edgeId);
+    if (it == m_edgeWeights.end()) {
+        Missing("edge weight", edgeId);
+        return 0;
+    }
+    return it->second;
+}
+
+vector<string>
+TraceReplayClient::GetRouteEdges(const ITetrisNode &node)
+{
+    map<string, vector<string> >::const_iterator it = m_vehicleRoutes.find(node.m_tsId);
+    if (it == m_vehicleRoutes.end()) {
+        Missing("route of vehicle", node.m_tsId);
+        return vector<string>();
+    }
+    return it->second;
+}
+
+vector<string>
+TraceReplayClient::GetRouteEdges(string routeID)
+{
+    map<string, vector<string> >::const_iterator it = m_routes.find(routeID);
+    if (it == m_routes.end()) {
+        Missing("route", routeID);
+        return vector<string>();
+    }
+    return it->second;
+}
+
+int
+TraceReplayClient::GetTrafficLights(vector<trafficLightID_t>& trafficLigthIds)
+{
+    if (!m_hasTrafficLights) {
+        Missing("list of traffic lights", "");
+        return EXIT_FAILURE;
+    }
+    trafficLigthIds = m_trafficLights;
+    return EXIT_SUCCESS;
+}
+
+int
+TraceReplayClient::GetTrafficLightStatus(trafficLightID_t trafficLightId, string &state)
+{
+    map<trafficLightID_t, string>::const_iterator it = m_trafficLightStates.find(trafficLightId);
+    if (it == m_trafficLightStates.end()) {
+        Missing("state of traffic light", trafficLightId);
+        return EXIT_FAILURE;
+    }
+    state = it->second;
+    return EXIT_SUCCESS;
+}
+
+const TrafficTraceVehicle&
+TraceReplayClient::Vehicle(const ITetrisNode &node, TrafficTraceVehicle::Field field)
+{
+    static const TrafficTraceVehicle empty;
+    map<string, TrafficTraceVehicle>::const_iterator it = m_vehicles.find(node.m_tsId);
+    if (it == m_vehicles.end() || (it->second.fields & field) == 0) {
+        Missing("value of vehicle", node.m_tsId);
+        return empty;
+    }
+    return it->second;
+}
+
+void
+TraceReplayClient::Unsupported(const string& command)
+{
+    if (!m_warnings.insert(command).second)
+        return;
+    cout << "iCS --> [WARNING] " << command << " is ignored, the traffic cannot be changed while replaying a trace." << endl;
+#ifdef LOG_ON
+    IcsLog::LogLevel((command + " is ignored, the traffic cannot be changed while replaying a trace.").c_str(), kLogLevelWarning);
+#endif
+}
+
+void
+TraceReplayClient::Missing(const string& what, const string& id)
+{
+    if (!m_warnings.insert(what).second)
+        return;
+    cout << "iCS --> [WARNING] The traffic trace has no " << what << " " << id
+         << ". It was recorded with a different configuration." << endl;
+}
+
+}
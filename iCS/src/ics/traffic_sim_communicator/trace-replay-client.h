@@ -0,0 +1,147 @@
+/****************************************************************************/
+/// @file    trace-replay-client.h
+/// @author  iTETRIS
+/// @date
+/// @version $Id:
+///
+/****************************************************************************/
+// iTETRIS, see http://www.ict-itetris.eu
+// Copyright © 2008 iTetris Project Consortium - All rights reserved
+/****************************************************************************/
+#ifndef TRACE_REPLAY_CLIENT_H
+#define TRACE_REPLAY_CLIENT_H
+
+// ===========================================================================
+// included modules
+// ===========================================================================
+#ifdef _MSC_VER
+#include <windows_config.h>
+#else
+#include <config.h>
+#endif
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "traffic-simulator-communicator.h"
+#include "traffic-trace.h"
+
+namespace ics
+{
+
+// ===========================================================================
+// class definitions
+// ===========================================================================
+/**
+* @class TraceReplayClient
+* @brief Replays a trace written by TraceRecordingClient in place of the traffic simulator.
+*
+* Each simulation step reads the next step of the trace, which must have been recorded
+* for the same time. The values are those of the last step that recorded them.
+* The traffic cannot be changed: the commands that act on the vehicles, the traffic lights
+* or the edges fail, so the replay is only valid when the applications do not use them.
+*/
+class TraceReplayClient : public TrafficSimulatorCommunicator
+{
+public:
+    /**
+    * @brief Constructor.
+    * @param[in] path The trace file.
+    */
+    TraceReplayClient(const std::string& path);
+
+    /// @brief Destructor.
+    ~TraceReplayClient();
+
+    /// @brief Opens the trace.
+    bool Connect();
+
+    int Close();
+
+    int CommandSimulationStep(double time, std::vector<std::string> &departed, std::vector<std::string> &arrived);
+
+    int CommandClose();
+
+    int CommandSetMaximumSpeed(const ITetrisNode &node, float maxSpeed);
+
+    int CommandSlowDown(const ITetrisNode &node, float speed, int duration);
+
+    int CommandSetColor(const ITetrisNode &node, unsigned char red, unsigned char green, unsigned char blue, unsigned char alpha);
+
+    float GetSpeed(const ITetrisNode &node);
+
+    float GetDirection(const ITetrisNode &node);
+
+    float GetVehicleLength(const ITetrisNode &node);
+
+    float GetVehicleWidth(const ITetrisNode &node);
+
+    std::pair<float,float> GetPosition(const ITetrisNode &node);
+
+    bool GetExteriorLights(const ITetrisNode &node);
+
+    std::string GetLane(const ITetrisNode &node);
+
+    std::string GetVehicleType(const ITetrisNode &node);
+
+    int SetVehicleToRunInLane(const ITetrisNode &node, std::string laneId);
+
+    int SetVehicleToRunInLane(std::string laneId);
+
+    bool ReRoute(const ITetrisNode &node, std::vector<std::string> route);
+
+    bool ReRoute(const ITetrisNode &node);
+
+    bool ChangeTrafficLightStatus(std::string trafficLightId, std::string lightStates);
+
+    bool ChangeEdgeWeight(const ITetrisNode &node, std::string edgeId, float weight);
+
+    bool SetEdgeWeight(std::string edgeId, float weight);
+
+    float GetEdgeWeight(std::string edgeId);
+
+    std::vector<std::string> GetRouteEdges(const ITetrisNode &node);
+
+    std::vector<std::string> GetRouteEdges(std::string routeID);
+
+    int GetTrafficLights(std::vector<ics_types::trafficLightID_t>& trafficLigthIds);
+
+    int GetTrafficLightStatus(ics_types::trafficLightID_t trafficLightId, std::string &state);
+
+private:
+    /**
+    * @brief Gets the last recorded values of a vehicle.
+    * @param[in] field The value that is asked.
+    * @return The vehicle, or an empty one if the value was never recorded.
+    */
+    const TrafficTraceVehicle& Vehicle(const ITetrisNode &node, TrafficTraceVehicle::Field field);
+
+    /// @brief Warns, once per command, that the traffic cannot be changed.
+    void Unsupported(const std::string& command);
+
+    /// @brief Warns, once per kind of value, that the trace does not have a value.
+    void Missing(const std::string& what, const std::string& id);
+
+    std::string m_path;
+
+    TrafficTraceReader m_reader;
+
+    /// @brief Last recorded values of the vehicles in the simulation.
+    std::map<std::string, TrafficTraceVehicle> m_vehicles;
+
+    bool m_hasTrafficLights;
+    std::vector<ics_types::trafficLightID_t> m_trafficLights;
+    std::map<ics_types::trafficLightID_t, std::string> m_trafficLightStates;
+    std::map<std::string, float> m_edgeWeights;
+    std::map<std::string, std::vector<std::string> > m_vehicleRoutes;
+    std::map<std::string, std::vector<std::string> > m_routes;
+
+    /// @brief Warnings already given.
+    std::set<std::string> m_warnings;
+};
+
+}
+
+#endif
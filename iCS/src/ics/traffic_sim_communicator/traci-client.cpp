@@ -310,6 +310,60 @@ TraCIClient::CommandClose()
     return EXIT_SUCCESS;
 }
 
+bool
+TraCIClient::GetChannelStatistics(unsigned long long& sentBytes, unsigned long long& receivedBytes, unsigned long& roundTrips) const
+{
+    if (m_socket == NULL)
+        return false;
+
+    sentBytes = m_socket->sentBytes();
+    receivedBytes = m_socket->receivedBytes();
+    roundTrips = m_socket->receivedMessages();
+    return true;
+}
+
+int
+TraCIClient::CommandSaveState(const std::string& file)
+{
+    if (m_socket == 0) {
+        cout << "iCS --> [ERROR] Socket is NULL" << endl;
+        return EXIT_FAILURE;
+    }
+
+    Storage outMsg, inMsg, tmpMsg;
+    tmpMsg.writeUnsignedByte(CMD_SET_SIM_VARIABLE);// command id
+    tmpMsg.writeUnsignedByte(CMD_SAVE_SIMSTATE);// variable id
+    tmpMsg.writeString("");// object id
+    tmpMsg.writeUnsignedByte(TYPE_STRING); //data type
+    tmpMsg.writeString(file);// value
+
+    outMsg.writeUnsignedByte(0); // command length -> extended
+    outMsg.writeInt(1 + 4 + tmpMsg.size());
+    outMsg.writeStorage(tmpMsg);
+
+    try {
+        m_socket->sendExact(outMsg);
+    } catch (SocketException e) {
+        cout << "iCS --> Error while sending command: " << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    // receive answer message
+    try {
+        m_socket->receiveExact(inMsg);
+    } catch (SocketException e) {
+        cout << "iCS --> #Error while receiving command: " << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    // validate result state
+    if (!ReportResultState(inMsg, CMD_SET_SIM_VARIABLE)) {
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
 
 
 ////////////////////////////////////////////////
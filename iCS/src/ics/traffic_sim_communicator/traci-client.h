@@ -107,6 +107,12 @@ public:
     */
     int CommandClose();
 
+    /// @brief Gets the traffic exchanged with SUMO through the socket.
+    bool GetChannelStatistics(unsigned long long& sentBytes, unsigned long long& receivedBytes, unsigned long& roundTrips) const;
+
+    /// @brief Makes SUMO save its state (the file is relative to the working directory of SUMO).
+    int CommandSaveState(const std::string& file);
+
     /**
     * @brief Sends a message to SUMO in order to establish the value of the maximum speed for a certain vehicle. 
     * @param[in,out] &node The node to establish its maximum speed value.
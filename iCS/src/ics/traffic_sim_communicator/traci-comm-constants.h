@@ -635,6 +635,9 @@
 // ids of arrived vehicles (get: simulation)
 #define VAR_ARRIVED_VEHICLES_IDS 0x7a
 
+// save the simulation state to a file (set: simulation)
+#define CMD_SAVE_SIMSTATE 0x95
+
 
 
 
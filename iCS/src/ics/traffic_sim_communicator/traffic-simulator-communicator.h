@@ -20,6 +20,8 @@
 #include <config.h>
 #endif
 
+#include <cstdlib>
+#include <string>
 #include <utility>
 
 #include "../../utils/ics/iCStypes.h"
@@ -217,6 +219,26 @@ public:
 
     /// @todo To be commented
     virtual int GetTrafficLightStatus(ics_types::trafficLightID_t trafficLightId, std::string &state) = 0;
+
+    /**
+    * @brief Gets the traffic exchanged with the traffic simulator since the connection.
+    * @param[out] sentBytes Bytes sent.
+    * @param[out] receivedBytes Bytes received.
+    * @param[out] roundTrips Replies received, one for each command.
+    * @return False if the communicator does not count the traffic.
+    */
+    virtual bool GetChannelStatistics(unsigned long long& sentBytes, unsigned long long& receivedBytes, unsigned long& roundTrips) const {
+        return false;
+    }
+
+    /**
+    * @brief Makes the traffic simulator save its state, to be loaded when it is launched again.
+    * @param[in] file The file the traffic simulator writes the state to.
+    * @return EXIT_SUCCESS if the state was saved, EXIT_FAILURE otherwise or if the simulator cannot save its state.
+    */
+    virtual int CommandSaveState(const std::string& file) {
+        return EXIT_FAILURE;
+    }
 };
 
 }
@@ -0,0 +1,366 @@
+/****************************************************************************/
+/// @file    traffic-trace.cpp
+/// @author  iTETRIS
+/// @date
+/// @version $Id:
+///
+/****************************************************************************/
+// iTETRIS, see http://www.ict-itetris.eu
+// Copyright © 2008 iTetris Project Consortium - All rights reserved
+/****************************************************************************/
+
+// ===========================================================================
+// included modules
+// ===========================================================================
+#ifdef _MSC_VER
+#include <windows_config.h>
+#else
+#include <config.h>
+#endif
+
+#include <iostream>
+#include <stdexcept>
+
+#include "traffic-trace.h"
+
+// ===========================================================================
+// used namespaces
+// ===========================================================================
+using namespace std;
+using namespace tcpip;
+
+namespace ics
+{
+
+// ===========================================================================
+// constants
+// ===========================================================================
+static const char* TRACE_FORMAT = "iCS traffic trace";
+static const int TRACE_VERSION = 1;
+
+// ===========================================================================
+// member method definitions
+// ===========================================================================
+void
+TrafficTraceVehicle::Merge(const TrafficTraceVehicle& other)
+{
+    if (other.fields & FIELD_POSITION) {
+        x = other.x;
+        y = other.y;
+    }
+    if (other.fields & FIELD_SPEED)
+        speed = other.speed;
+    if (other.fields & FIELD_DIRECTION)
+        direction = other.direction;
+    if (other.fields & FIELD_LENGTH)
+        length = other.length;
+    if (other.fields & FIELD_WIDTH)
+        width = other.width;
+    if (other.fields & FIELD_LIGHTS)
+        lights = other.lights;
+    if (other.fields & FIELD_LANE)
+        lane = other.lane;
+    if (other.fields & FIELD_TYPE)
+        type = other.type;
+    fields |= other.fields;
+}
+
+void
+TrafficTraceStep::Clear()
+{
+    time = 0;
+    departed.clear();
+    arrived.clear();
+    vehicles.clear();
+    hasTrafficLights = false;
+    trafficLights.clear();
+    trafficLightStates.clear();
+    edgeWeights.clear();
+    vehicleRoutes.clear();
+    routes.clear();
+}
+
+TrafficTraceWriter::TrafficTraceWriter() { }
+
+TrafficTraceWriter::~TrafficTraceWriter()
+{
+    Close();
+}
+
+bool
+TrafficTraceWriter::Open(const string& path)
+{
+    Close();
+    m_out.open(path.c_str(), ios::out | ios::binary | ios::trunc);
+    if (!m_out.good()) {
+        cout << "iCS --> [ERROR] Could not create the traffic trace " << path << endl;
+        return false;
+    }
+    m_strings.clear();
+
+    Storage header;
+    header.writeString(TRACE_FORMAT);
+    header.writeInt(TRACE_VERSION);
+    WriteRecord(header);
+    return true;
+}
+
+void
+TrafficTraceWriter::Close()
+{
+    if (m_out.is_open())
+        m_out.close();
+}
+
+void
+TrafficTraceWriter::Write(const TrafficTraceStep& step)
+{
+    if (!m_out.is_open())
+        return;
+
+    Storage record;
+    record.writeDouble(step.time);
+    WriteStringList(record, step.departed);
+    WriteStringList(record, step.arrived);
+
+    record.writeInt(step.vehicles.size());
+    for (map<string, TrafficTraceVehicle>::const_iterator it = step.vehicles.begin(); it != step.vehicles.end(); ++it) {
+        const TrafficTraceVehicle& vehicle = it->second;
+        WriteString(record, it->first);
+        record.writeUnsignedByte(vehicle.fields);
+        if (vehicle.fields & TrafficTraceVehicle::FIELD_POSITION) {
+            record.writeFloat(vehicle.x);
+            record.writeFloat(vehicle.y);
+        }
+        if (vehicle.fields & TrafficTraceVehicle::FIELD_SPEED)
+            record.writeFloat(vehicle.speed);
+        if (vehicle.fields & TrafficTraceVehicle::FIELD_DIRECTION)
+            record.writeFloat(vehicle.direction);
+        if (vehicle.fields & TrafficTraceVehicle::FIELD_LENGTH)
+            record.writeFloat(vehicle.length);
+        if (vehicle.fields & TrafficTraceVehicle::FIELD_WIDTH)
+            record.writeFloat(vehicle.width);
+        if (vehicle.fields & TrafficTraceVehicle::FIELD_LIGHTS)
+            record.writeUnsignedByte(vehicle.lights ? 1 : 0);
+        if (vehicle.fields & TrafficTraceVehicle::FIELD_LANE)
+            WriteString(record, vehicle.lane);
+        if (vehicle.fields & TrafficTraceVehicle::FIELD_TYPE)
+            WriteString(record, vehicle.type);
+    }
+
+    // -1 if the list of traffic lights was not asked in the step
+    if (step.hasTrafficLights) {
+        WriteStringList(record, step.trafficLights);
+    } else {
+        record.writeInt(-1);
+    }
+
+    record.writeInt(step.trafficLightStates.size());
+    for (map<ics_types::trafficLightID_t, string>::const_iterator it = step.trafficLightStates.begin(); it != step.trafficLightStates.end(); ++it) {
+        WriteString(record, it->first);
+        WriteString(record, it->second);
+    }
+
+    record.writeInt(step.edgeWeights.size());
+    for (map<string, float>::const_iterator it = step.edgeWeights.begin(); it != step.edgeWeights.end(); ++it) {
+        WriteString(record, it->first);
+        record.writeFloat(it->second);
+    }
+
+    record.writeInt(step.vehicleRoutes.size());
+    for (map<string, vector<string> >::const_iterator it = step.vehicleRoutes.begin(); it != step.vehicleRoutes.end(); ++it) {
+        WriteString(record, it->first);
+        WriteStringList(record, it->second);
+    }
+
+    record.writeInt(step.routes.size());
+    for (map<string, vector<string> >::const_iterator it = step.routes.begin(); it != step.routes.end(); ++it) {
+        WriteString(record, it->first);
+        WriteStringList(record, it->second);
+    }
+
+    WriteRecord(record);
+}
+
+void
+TrafficTraceWriter::WriteRecord(const Storage& record)
+{
+    Storage size;
+    size.writeInt(record.size());
+    m_out.write((const char*) &*size.begin(), size.size());
+    if (record.size() > 0)
+        m_out.write((const char*) &*record.begin(), record.size());
+}
+
+void
+TrafficTraceWriter::WriteString(Storage& record, const string& value)
+{
+    map<string, int>::iterator it = m_strings.find(value);
+    if (it != m_strings.end()) {
+        record.writeInt(it->second);
+        return;
+    }
+    // A new string is written after its index
+    int index = m_strings.size();
+    m_strings[value] = index;
+    record.writeInt(index);
+    record.writeString(value);
+}
+
+void
+TrafficTraceWriter::WriteStringList(Storage& record, const vector<string>& values)
+{
+    record.writeInt(values.size());
+    for (vector<string>::const_iterator it = values.begin(); it != values.end(); ++it)
+        WriteString(record, *it);
+}
+
+TrafficTraceReader::TrafficTraceReader() { }
+
+TrafficTraceReader::~TrafficTraceReader()
+{
+    Close();
+}
+
+bool
+TrafficTraceReader::Open(const string& path)
+{
+    Close();
+    m_in.open(path.c_str(), ios::in | ios::binary);
+    if (!m_in.good()) {
+        cout << "iCS --> [ERROR] Could not open the traffic trace " << path << endl;
+        return false;
+    }
+    m_strings.clear();
+
+    vector<unsigned char> buffer;
+    try {
+        if (ReadRecord(buffer)) {
+            Storage header(&buffer[0], buffer.size());
+            if (header.readString() == TRACE_FORMAT) {
+                int version = header.readInt();
+                if (version == TRACE_VERSION)
+                    return true;
+                cout << "iCS --> [ERROR] Version " << version << " of the traffic trace " << path << " is not supported" << endl;
+                Close();
+                return false;
+            }
+        }
+    } catch (std::invalid_argument& e) {
+    }
+    cout << "iCS --> [ERROR] " << path << " is not a traffic trace" << endl;
+    Close();
+    return false;
+}
+
+void
+TrafficTraceReader::Close()
+{
+    if (m_in.is_open())
+        m_in.close();
+}
+
+bool
+TrafficTraceReader::Read(TrafficTraceStep& step)
+{
+    step.Clear();
+    vector<unsigned char> buffer;
+    if (!m_in.is_open() || !ReadRecord(buffer))
+        return false;
+
+    try {
+        Storage record(&buffer[0], buffer.size());
+        step.time = record.readDouble();
+        ReadStringList(record, step.departed);
+        ReadStringList(record, step.arrived);
+
+        int count = record.readInt();
+        for (int i = 0; i < count; ++i) {
+            TrafficTraceVehicle& vehicle = step.vehicles[ReadString(record)];
+            vehicle.fields = record.readUnsignedByte();
+            if (vehicle.fields & TrafficTraceVehicle::FIELD_POSITION) {
+                vehicle.x = record.readFloat();
+                vehicle.y = record.readFloat();
+            }
+            if (vehicle.fields & TrafficTraceVehicle::FIELD_SPEED)
+                vehicle.speed = record.readFloat();
+            if (vehicle.fields & TrafficTraceVehicle::FIELD_DIRECTION)
+                vehicle.direction = record.readFloat();
+            if (vehicle.fields & TrafficTraceVehicle::FIELD_LENGTH)
+                vehicle.length = record.readFloat();
+            if (vehicle.fields & TrafficTraceVehicle::FIELD_WIDTH)
+                vehicle.width = record.readFloat();
+            if (vehicle.fields & TrafficTraceVehicle::FIELD_LIGHTS)
+                vehicle.lights = record.readUnsignedByte() != 0;
+            if (vehicle.fields & TrafficTraceVehicle::FIELD_LANE)
+                vehicle.lane = ReadString(record);
+            if (vehicle.fields & TrafficTraceVehicle::FIELD_TYPE)
+                vehicle.type = ReadString(record);
+        }
+
+        count = record.readInt();
+        step.hasTrafficLights = count >= 0;
+        for (int i = 0; i < count; ++i)
+            step.trafficLights.push_back(ReadString(record));
+
+        count = record.readInt();
+        for (int i = 0; i < count; ++i) {
+            string id = ReadString(record);
+            step.trafficLightStates[id] = ReadString(record);
+        }
+
+        count = record.readInt();
+        for (int i = 0; i < count; ++i) {
+            string id = ReadString(record);
+            step.edgeWeights[id] = record.readFloat();
+        }
+
+        count = record.readInt();
+        for (int i = 0; i < count; ++i)
+            ReadStringList(record, step.vehicleRoutes[ReadString(record)]);
+
+        count = record.readInt();
+        for (int i = 0; i < count; ++i)
+            ReadStringList(record, step.routes[ReadString(record)]);
+    } catch (std::invalid_argument& e) {
+        cout << "iCS --> [ERROR] Corrupted record in the traffic trace: " << e.what() << endl;
+        return false;
+    }
+    return true;
+}
+
+bool
+TrafficTraceReader::ReadRecord(vector<unsigned char>& buffer)
+{
+    unsigned char size[4];
+    if (!m_in.read((char*) size, 4))
+        return false;
+    int length = Storage(size, 4).readInt();
+    if (length <= 0)
+        return false;
+    buffer.resize(length);
+    return (bool) m_in.read((char*) &buffer[0], length);
+}
+
+string
+TrafficTraceReader::ReadString(Storage& record)
+{
+    int index = record.readInt();
+    if (index >= 0 && index < (int) m_strings.size())
+        return m_strings[index];
+    if (index != (int) m_strings.size())
+        throw std::invalid_argument("unknown string index");
+    m_strings.push_back(record.readString());
+    return m_strings.back();
+}
+
+void
+TrafficTraceReader::ReadStringList(Storage& record, vector<string>& values)
+{
+    values.clear();
+    int count = record.readInt();
+    for (int i = 0; i < count; ++i)
+        values.push_back(ReadString(record));
+}
+
+}
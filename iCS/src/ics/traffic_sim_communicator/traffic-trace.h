@@ -0,0 +1,192 @@
+/****************************************************************************/
+/// @file    traffic-trace.h
+/// @author  iTETRIS
+/// @date
+/// @version $Id:
+///
+/****************************************************************************/
+// iTETRIS, see http://www.ict-itetris.eu
+// Copyright © 2008 iTetris Project Consortium - All rights reserved
+/****************************************************************************/
+#ifndef TRAFFIC_TRACE_H
+#define TRAFFIC_TRACE_H
+
+// ===========================================================================
+// included modules
+// ===========================================================================
+#ifdef _MSC_VER
+#include <windows_config.h>
+#else
+#include <config.h>
+#endif
+
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <foreign/tcpip/storage.h>
+#include "../../utils/ics/iCStypes.h"
+
+namespace ics
+{
+
+// ===========================================================================
+// struct definitions
+// ===========================================================================
+/**
+* @struct TrafficTraceVehicle
+* @brief Values of a vehicle asked to the traffic simulator during a timestep.
+*/
+struct TrafficTraceVehicle {
+    /// @brief Bits of the values that were asked.
+    enum Field {
+        FIELD_POSITION = 0x01,
+        FIELD_SPEED = 0x02,
+        FIELD_DIRECTION = 0x04,
+        FIELD_LENGTH = 0x08,
+        FIELD_WIDTH = 0x10,
+        FIELD_LIGHTS = 0x20,
+        FIELD_LANE = 0x40,
+        FIELD_TYPE = 0x80
+    };
+
+    TrafficTraceVehicle() : fields(0), x(0), y(0), speed(0), direction(0), length(0), width(0), lights(false) {}
+
+    /// @brief Copies the values of the other vehicle that are set.
+    void Merge(const TrafficTraceVehicle& other);
+
+    unsigned char fields;
+    float x;
+    float y;
+    float speed;
+    float direction;
+    float length;
+    float width;
+    bool lights;
+    std::string lane;
+    std::string type;
+};
+
+/**
+* @struct TrafficTraceStep
+* @brief Everything the iCS got from the traffic simulator in a timestep.
+*/
+struct TrafficTraceStep {
+    TrafficTraceStep() : time(0), hasTrafficLights(false) {}
+
+    void Clear();
+
+    /// @brief Time of the simulation step.
+    double time;
+
+    std::vector<std::string> departed;
+    std::vector<std::string> arrived;
+
+    /// @brief Vehicles by traffic simulator ID.
+    std::map<std::string, TrafficTraceVehicle> vehicles;
+
+    /// @brief True if the list of traffic lights was asked in the step.
+    bool hasTrafficLights;
+    std::vector<ics_types::trafficLightID_t> trafficLights;
+    std::map<ics_types::trafficLightID_t, std::string> trafficLightStates;
+
+    std::map<std::string, float> edgeWeights;
+
+    /// @brief Route edges by vehicle ID.
+    std::map<std::string, std::vector<std::string> > vehicleRoutes;
+
+    /// @brief Route edges by route ID.
+    std::map<std::string, std::vector<std::string> > routes;
+};
+
+// ===========================================================================
+// class definitions
+// ===========================================================================
+/**
+* @class TrafficTraceWriter
+* @brief Writes the timesteps of the traffic simulation to a binary trace.
+*
+* The trace is a sequence of records, each one an integer with its size followed by
+* a tcpip::Storage. The first record holds the format name and version. The strings
+* (vehicle, lane and edge IDs) are written once and then referred to by their index.
+*/
+class TrafficTraceWriter
+{
+public:
+    TrafficTraceWriter();
+
+    /// @brief Destructor, closes the file.
+    ~TrafficTraceWriter();
+
+    /**
+    * @brief Creates the trace file and writes the header.
+    * @return False: If the file cannot be created.
+    */
+    bool Open(const std::string& path);
+
+    void Close();
+
+    bool IsOpen() const {
+        return m_out.is_open();
+    }
+
+    /// @brief Appends a timestep to the trace.
+    void Write(const TrafficTraceStep& step);
+
+private:
+    void WriteRecord(const tcpip::Storage& record);
+
+    void WriteString(tcpip::Storage& record, const std::string& value);
+
+    void WriteStringList(tcpip::Storage& record, const std::vector<std::string>& values);
+
+    std::ofstream m_out;
+
+    /// @brief Index of the strings already written.
+    std::map<std::string, int> m_strings;
+};
+
+/**
+* @class TrafficTraceReader
+* @brief Reads the timesteps of a trace written by TrafficTraceWriter.
+*/
+class TrafficTraceReader
+{
+public:
+    TrafficTraceReader();
+
+    /// @brief Destructor, closes the file.
+    ~TrafficTraceReader();
+
+    /**
+    * @brief Opens the trace file and checks the header.
+    * @return False: If the file cannot be read or it is not a trace.
+    */
+    bool Open(const std::string& path);
+
+    void Close();
+
+    /**
+    * @brief Reads the next timestep.
+    * @param[out] step The timestep.
+    * @return False: At the end of the trace or if the record is not valid.
+    */
+    bool Read(TrafficTraceStep& step);
+
+private:
+    bool ReadRecord(std::vector<unsigned char>& buffer);
+
+    std::string ReadString(tcpip::Storage& record);
+
+    void ReadStringList(tcpip::Storage& record, std::vector<std::string>& values);
+
+    std::ifstream m_in;
+
+    /// @brief Strings read so far, by index.
+    std::vector<std::string> m_strings;
+};
+
+}
+
+#endif
@@ -52,7 +52,11 @@ string Ns3Client::DENM_TYPE = "1";
 // ===========================================================================
 // member method definitions
 // ===========================================================================
-Ns3Client::Ns3Client() {}
+Ns3Client::Ns3Client() :
+    m_socket(0),
+    m_protocolVersion(INCI_PROTOCOL_VERSION_STRINGS),
+    m_lastStepEvents(0),
+    m_lastStepWallTime(0) {}
 
 Ns3Client::~Ns3Client()
 {
@@ -64,18 +68,34 @@ Ns3Client::Connect()
 {
     m_socket = new SocketNs3(m_host, m_port);
 
-    for (int i=0; i<10; ++i) {
+    bool connected = false;
+    for (int i=0; i<10 && !connected; ++i) {
         try {
             cout << "iCS --> Trying " << i << " to connect ns-3 on port " << m_port << " and Host "<<m_host<<"..." << endl;
             m_socket->connect();
-            return true;
+            connected = true;
         } catch (SocketException e) {
             cout << "iCS --> No connection to ns-3; waiting..." << endl;
             Sleep(3000);
         }
     }
 
-    return false;
+    if (!connected) {
+        return false;
+    }
+
+    // Negotiated once connected: retrying the connection would not fix a malformed answer
+    try {
+        if (!CommandSetProtocolVersion(INCI_PROTOCOL_VERSION_BINARY)) {
+            cout << "iCS --> ns-3 does not support the binary encoding, using the string encoding" << endl;
+        }
+    } catch (std::exception& e) {
+        cout << "iCS --> [ERROR] Connect() Negotiating the protocol version with ns-3: " << e.what() << endl;
+        Close();
+        return false;
+    }
+
+    return true;
 }
 
 int
@@ -129,6 +149,20 @@ Ns3Client::CommandSimulationStep(int time)
         return false;
     }
 
+    if (m_protocolVersion >= INCI_PROTOCOL_VERSION_BINARY) {
+        // length
+        inMsg.readInt();
+        // command id
+        inMsg.readUnsignedByte();
+        m_lastStepEvents = inMsg.readInt();
+        m_lastStepWallTime = inMsg.readDouble();
+#ifdef LOG_ON
+        stringstream log;
+        log << "iCS --> [CommandSimulationStep] ns-3 processed " << m_lastStepEvents << " events in " << m_lastStepWallTime << " ms";
+        IcsLog::LogLevel((log.str()).c_str(), kLogLevelInfo);
+#endif
+    }
+
     return true;
 
 }
@@ -382,26 +416,13 @@ Ns3Client::CommandStartSendingCam(vector<string> sendersId, unsigned int payload
         return false;
     }
 
-    // 4 bytes for the length of the string list
-    // 4 bytes for the length each member of the list
-    int stringSize = 4 + (sendersId.size() * 4);
-
-    int totalAmountOfCharacters = 0;
-    vector<string>::iterator it;
-    for (it = sendersId.begin() ; it < sendersId.end() ; it++) {
-        string chain = *it;
-        size_t chainSize = chain.length();
-        totalAmountOfCharacters += chainSize;
-    }
-
-    // Finally one byte per character
-    stringSize = stringSize + totalAmountOfCharacters;
+    int stringSize = NodeIdListByteSize(sendersId);
 
     outMsg.writeInt(4 + 1 + stringSize + 4 + 4);
     // command id
     outMsg.writeUnsignedByte(CMD_START_CAM);
     // ns-3 ids of the nodes that has to start sending CAM
-    outMsg.writeStringList(sendersId);
+    WriteNodeIdList(outMsg, sendersId);
     // the length of information the CAM message transmits  --> TODO: the value shall not be hard coded!
     outMsg.writeInt(20);
     // the frequency in which the message will be sent
@@ -442,27 +463,14 @@ Ns3Client::CommandStopSendingCam(vector<string> sendersId)
         return false;
     }
 
-    // 4 bytes for the length of the string list
-    // 4 bytes for the length each member of the list
-    int stringSize = 4 + (sendersId.size() * 4);
-
-    int totalAmountOfCharacters = 0;
-    vector<string>::iterator it;
-    for (it = sendersId.begin() ; it < sendersId.end() ; it++) {
-        string chain = *it;
-        size_t chainSize = chain.length();
-        totalAmountOfCharacters += chainSize;
-    }
-
-    // Finally one byte per character
-    stringSize = stringSize + totalAmountOfCharacters;
+    int stringSize = NodeIdListByteSize(sendersId);
 
     // command length
     outMsg.writeInt(4 + 1 + stringSize);
     // command id
     outMsg.writeUnsignedByte(CMD_STOP_CAM);
     // ns-3 ids of the nodes that has to start sending CAM
-    outMsg.writeStringList(sendersId);
+    WriteNodeIdList(outMsg, sendersId);
 
 
     // send request message
@@ -535,6 +543,41 @@ Ns3Client::CommandGetReceivedMessages(int nodeId, vector<ReceivedMessage>* recei
     // command id
     inMsg.readUnsignedByte();
 
+    if (m_protocolVersion >= INCI_PROTOCOL_VERSION_BINARY) {
+        // Table of the message types, referenced by index from each message
+        vector<string> types = inMsg.readStringList();
+        vector<messageType_t> messageTypes(types.size(), CAM);
+        for (size_t i = 0; i < types.size(); i++) {
+            if (!ParseMessageType(types[i], messageTypes[i])) {
+                cout << "iCS --> #Error, unknown message type " << types[i] << endl;
+            }
+        }
+
+        int nMessages = inMsg.readInt();
+        if (nMessages == 0) {
+            stringstream log;
+            log << "iCS --> [CommandGetReceivedMessages] 0 messages were received";
+            IcsLog::LogLevel((log.str()).c_str(), kLogLevelInfo);
+            return true;
+        }
+
+        receivedMessages->reserve(receivedMessages->size() + nMessages);
+        for (int i = 0; i < nMessages; i++) {
+            unsigned int typeIndex = inMsg.readUnsignedByte();
+            if (typeIndex >= messageTypes.size()) {
+                cout << "iCS --> #Error, the returned message type index is out of range" << endl;
+                return false;
+            }
+            ReceivedMessage receivedMessage;
+            receivedMessage.messageType = messageTypes[typeIndex];
+            receivedMessage.senderId = inMsg.readInt();
+            receivedMessage.timeStep = inMsg.readInt();
+            receivedMessage.sequenceNumber = inMsg.readInt();
+            receivedMessages->push_back(receivedMessage);
+        }
+        return true;
+    }
+
     vector<string> receivedNodes = inMsg.readStringList();
     vector<string> types = inMsg.readStringList();
     vector<string> sentTimesteps = inMsg.readStringList();
@@ -563,28 +606,7 @@ Ns3Client::CommandGetReceivedMessages(int nodeId, vector<ReceivedMessage>* recei
 
             ReceivedMessage receivedMessage;
             receivedMessage.senderId = utils::Conversion::string2Int(senderId);
-            if (type =="CAM" /*CAM_TYPE*/) {
-                //receivedMessage.messageType = 0;
-                receivedMessage.messageType = CAM;
-            } else {
-                if (type == DENM_TYPE) {
-                    //receivedMessage.messageType = 1;
-                    receivedMessage.messageType = DENM;
-                } else {
-                    if (type == "serviceIdUnicast") {
-                        receivedMessage.messageType = UNICAST;
-                    } else {
-                        if (type == "serviceIdGeobroadcast") {
-                            receivedMessage.messageType = GEOBROADCAST;
-                        } else {
-                            if (type == "serviceIdTopobroadcast") {
-                                receivedMessage.messageType = TOPOBROADCAST;
-                            }
-                        }
-                    }
-                }
-            }
-
+            ParseMessageType(type, receivedMessage.messageType);
             receivedMessage.timeStep =  utils::Conversion::string2Int(timestep);
             receivedMessage.sequenceNumber = utils::Conversion::string2Int(seqNum);
             receivedMessages->push_back(receivedMessage);
@@ -596,6 +618,25 @@ Ns3Client::CommandGetReceivedMessages(int nodeId, vector<ReceivedMessage>* recei
     return true;
 }
 
+bool
+Ns3Client::ParseMessageType(const string& type, messageType_t& messageType)
+{
+    if (type == "CAM" /*CAM_TYPE*/) {
+        messageType = CAM;
+    } else if (type == DENM_TYPE) {
+        messageType = DENM;
+    } else if (type == "serviceIdUnicast") {
+        messageType = UNICAST;
+    } else if (type == "serviceIdGeobroadcast") {
+        messageType = GEOBROADCAST;
+    } else if (type == "serviceIdTopobroadcast") {
+        messageType = TOPOBROADCAST;
+    } else {
+        return false;
+    }
+    return true;
+}
+
 bool
 Ns3Client::CommandStartTopoTxon(std::vector<std::string> sendersId, std::string serviceId, unsigned char commProfile, std::vector<std::string> technologyList, float frequency, unsigned int payloadLength, float msgRegenerationTime, unsigned int msgLifetime, unsigned int numHops)
 {
@@ -608,7 +649,7 @@ Ns3Client::CommandStartTopoTxon(std::vector<std::string> sendersId, std::string
         return false;
     }
 
-    int stringSize = CalculateStringListByteSize(sendersId);
+    int stringSize = NodeIdListByteSize(sendersId);
     int stringSize2 = CalculateStringListByteSize(technologyList);
 
     ////////////////////////////////////////////
@@ -617,7 +658,7 @@ Ns3Client::CommandStartTopoTxon(std::vector<std::string> sendersId, std::string
     outMsg.writeInt(4 + 1 + stringSize + 4 + serviceId.length() + 1 + stringSize2 + 4 + 4 + 4 + 4 + 4); // Not sure if this works // FK : WTF !!
     ////////////////////////////////////////////
     outMsg.writeUnsignedByte(CMD_START_TOPO_TXON);
-    outMsg.writeStringList(sendersId);
+    WriteNodeIdList(outMsg, sendersId);
     outMsg.writeString(serviceId);
     outMsg.writeUnsignedByte(commProfile);
     outMsg.writeStringList(technologyList);
@@ -691,6 +732,18 @@ Ns3Client::CommandClose()
     return EXIT_SUCCESS;
 }
 
+bool
+Ns3Client::GetChannelStatistics(unsigned long long& sentBytes, unsigned long long& receivedBytes, unsigned long& roundTrips) const
+{
+    if (m_socket == NULL)
+        return false;
+
+    sentBytes = m_socket->sentBytes();
+    receivedBytes = m_socket->receivedBytes();
+    roundTrips = m_socket->receivedMessages();
+    return true;
+}
+
 bool
 Ns3Client::ReportResultState(StorageNs3& inMsg, int command)
 {
@@ -745,6 +798,80 @@ Ns3Client::ReportResultState(StorageNs3& inMsg, int command)
     return true;
 }
 
+bool
+Ns3Client::CommandSetProtocolVersion(int version)
+{
+    StorageNs3 outMsg;
+    StorageNs3 inMsg;
+
+    if (m_socket == NULL) {
+        cout << "iCS --> #Error while sending command: no connection to server" ;
+        return false;
+    }
+
+    // Until ns-3 answers, both sides speak the string encoding
+    m_protocolVersion = INCI_PROTOCOL_VERSION_STRINGS;
+
+    outMsg.writeInt(4 + 1 + 4);
+    outMsg.writeUnsignedByte(CMD_SET_PROTOCOL_VERSION);
+    outMsg.writeInt(version);
+
+    // send request message
+    try {
+        m_socket->sendExact(outMsg);
+    } catch (SocketException e) {
+        cout << "iCS --> Error while sending command: " << e.what();
+        return false;
+    }
+
+    // receive answer message
+    try {
+        m_socket->receiveExact(inMsg);
+    } catch (SocketException e) {
+        cout << "iCS --> #Error while receiving command: " << e.what();
+        return false;
+    }
+
+    // validate result state; an ns-3 built before the negotiation answers not implemented
+    if (!ReportResultState(inMsg, CMD_SET_PROTOCOL_VERSION)) {
+        return false;
+    }
+
+    // length
+    inMsg.readInt();
+    // command id
+    inMsg.readUnsignedByte();
+    m_protocolVersion = inMsg.readInt();
+
+#ifdef LOG_ON
+    cout << "iCS --> Using the iNCI protocol version " << m_protocolVersion << " with ns-3" << endl;
+#endif
+    return m_protocolVersion == version;
+}
+
+int
+Ns3Client::NodeIdListByteSize(const vector<string>& nodeIds)
+{
+    if (m_protocolVersion >= INCI_PROTOCOL_VERSION_BINARY) {
+        // 4 bytes for the length of the list and 4 bytes for each id
+        return 4 + 4 * nodeIds.size();
+    }
+    return CalculateStringListByteSize(nodeIds);
+}
+
+void
+Ns3Client::WriteNodeIdList(StorageNs3& outMsg, const vector<string>& nodeIds)
+{
+    if (m_protocolVersion >= INCI_PROTOCOL_VERSION_BINARY) {
+        outMsg.writeInt(nodeIds.size());
+        for (vector<string>::const_iterator it = nodeIds.begin() ; it != nodeIds.end() ; it++) {
+            outMsg.writeInt(atoi(it->c_str()));
+        }
+    } else {
+        outMsg.writeStringList(nodeIds);
+    }
+}
+
 int
 Ns3Client::CalculateStringListByteSize(vector<string> list)
 {
@@ -785,11 +912,11 @@ Ns3Client::CommandStartIpCiuTxon(std::vector<std::string> sendersId, std::string
         return false;
     }
 
-    int stringSize = CalculateStringListByteSize(sendersId);
+    int stringSize = NodeIdListByteSize(sendersId);
 
     outMsg.writeInt(4 + 1 + stringSize + 4 + serviceId.length() + 4 + 4 + 4 + 4);
     outMsg.writeUnsignedByte(CMD_START_IPCIU_TXON);
-    outMsg.writeStringList(sendersId);
+    WriteNodeIdList(outMsg, sendersId);
     outMsg.writeString(serviceId);
     outMsg.writeFloat(frequency);
     outMsg.writeInt(payloadLength);
@@ -831,12 +958,12 @@ Ns3Client::CommandStartIdBasedTxon(std::vector<std::string> sendersId, std::stri
         return false;
     }
 
-    int stringSize = CalculateStringListByteSize(sendersId);
+    int stringSize = NodeIdListByteSize(sendersId);
     int stringSize2 = CalculateStringListByteSize(technologyList);
 
     outMsg.writeInt(4 + 1 + stringSize + 4 + serviceId.length() + 1 + stringSize2 + 4 + 4 + 4  + 4 + 4);
     outMsg.writeUnsignedByte(CMD_START_ID_BASED_TXON);
-    outMsg.writeStringList(sendersId);
+    WriteNodeIdList(outMsg, sendersId);
     outMsg.writeString(serviceId);
     outMsg.writeUnsignedByte(commProfile);
     outMsg.writeStringList(technologyList);
@@ -881,12 +1008,12 @@ Ns3Client::CommandStartMWTxon (std::vector<std::string> sendersId, std::string s
         return false;
     }
 
-    int stringSize = CalculateStringListByteSize(sendersId);
+    int stringSize = NodeIdListByteSize(sendersId);
     int stringSize2 = CalculateStringListByteSize(technologyList);
 
     outMsg.writeInt(4 + 1 + stringSize  + 4 + serviceId.length() + 1 + stringSize2 + 4 + 4 + 4 + 4 + 4 + 4 + 4);
     outMsg.writeUnsignedByte(CMD_START_MW_TXON);
-    outMsg.writeStringList(sendersId);
+    WriteNodeIdList(outMsg, sendersId);
     outMsg.writeString(serviceId);
     outMsg.writeUnsignedByte(commProfile);
     outMsg.writeStringList(technologyList);
@@ -933,11 +1060,11 @@ Ns3Client::CommandStopServiceTxon(std::vector<std::string> sendersId, std::strin
         return false;
     }
 
-    int stringSize = CalculateStringListByteSize(sendersId);
+    int stringSize = NodeIdListByteSize(sendersId);
 
     outMsg.writeInt(4 + 1 + stringSize + 4 + serviceId.length());
     outMsg.writeUnsignedByte(CMD_STOP_SERVICE_TXON);
-    outMsg.writeStringList(sendersId);
+    WriteNodeIdList(outMsg, sendersId);
     outMsg.writeString(serviceId);
 
     // send request message
@@ -975,11 +1102,11 @@ Ns3Client::CommandStopIpCiuServiceTxon(std::vector<std::string> sendersId, std::
         return false;
     }
 
-    int stringSize = CalculateStringListByteSize(sendersId);
+    int stringSize = NodeIdListByteSize(sendersId);
 
     outMsg.writeInt(4 + 1 + stringSize + 4 + serviceId.length());
     outMsg.writeUnsignedByte(CMD_STOP_IPCIU_SERVICE_TXON);
-    outMsg.writeStringList(sendersId);
+    WriteNodeIdList(outMsg, sendersId);
     outMsg.writeString(serviceId);
 
     // send request message
@@ -1017,11 +1144,11 @@ Ns3Client::CommandStopMWServiceTxon(std::vector<std::string> sendersId, std::str
         return false;
     }
 
-    int stringSize = CalculateStringListByteSize(sendersId);
+    int stringSize = NodeIdListByteSize(sendersId);
 
     outMsg.writeInt(4 + 1 + stringSize + 4 + serviceId.length());
     outMsg.writeUnsignedByte(CMD_STOP_MW_SERVICE_TXON);
-    outMsg.writeStringList(sendersId);
+    WriteNodeIdList(outMsg, sendersId);
     outMsg.writeString(serviceId);
 
     // send request message
@@ -1059,12 +1186,12 @@ Ns3Client::StartGeobroadcastTxon(std::vector<std::string> sendersId, std::string
         return false;
     }
 
-    int stringSize = CalculateStringListByteSize(sendersId);
+    int stringSize = NodeIdListByteSize(sendersId);
     int stringSize2 = CalculateStringListByteSize(technList);
 
     outMsg.writeInt(4 + 1 + stringSize + 4 + serviceId.length() + 1 + stringSize2 + 4 + 4 + 4 + 4 + 4 + 4 + 4);
     outMsg.writeUnsignedByte(CMD_START_GEO_BROAD_TXON);
-    outMsg.writeStringList(sendersId);
+    WriteNodeIdList(outMsg, sendersId);
     outMsg.writeString(serviceId);
     outMsg.writeUnsignedByte(commProfile);
     outMsg.writeStringList(technList);
@@ -1113,12 +1240,12 @@ Ns3Client::StartGeoanycastTxon(std::vector<std::string> sendersId, std::string s
         return false;
     }
 
-    int stringSize = CalculateStringListByteSize(sendersId);
+    int stringSize = NodeIdListByteSize(sendersId);
     int stringSize2 = CalculateStringListByteSize(technList);
 
     outMsg.writeInt(4 + 1 + stringSize + 4 + serviceId.length() + 1 + stringSize2 + 4 + 4 + 4 + 4 + 4 + 4 + 4);
     outMsg.writeUnsignedByte(CMD_START_GEO_ANY_TXON);
-    outMsg.writeStringList(sendersId);
+    WriteNodeIdList(outMsg, sendersId);
     outMsg.writeString(serviceId);
     outMsg.writeUnsignedByte(commProfile);
     outMsg.writeStringList(technList);
@@ -1165,20 +1292,7 @@ Ns3Client::CommandActivateNode(vector<string> sendersId)
         return false;
     }
 
-    // 4 bytes for the length of the string list
-    // 4 bytes for the length each member of the list
-    int stringSize = 4 + (sendersId.size() * 4);
-
-    int totalAmountOfCharacters = 0;
-    vector<string>::iterator it;
-    for (it = sendersId.begin() ; it < sendersId.end() ; it++) {
-        string chain = *it;
-        size_t chainSize = chain.length();
-        totalAmountOfCharacters += chainSize;
-    }
-
-    // Finally one byte per character
-    stringSize = stringSize + totalAmountOfCharacters;
+    int stringSize = NodeIdListByteSize(sendersId);
 
     // command length
 //     outMsg.writeUnsignedByte(1 + 1 + stringSize);
@@ -1186,7 +1300,7 @@ Ns3Client::CommandActivateNode(vector<string> sendersId)
     // command id
     outMsg.writeUnsignedByte(CMD_ACTIVATE_NODE);
     // ns-3 ids of the nodes to be activated
-    outMsg.writeStringList(sendersId);
+    WriteNodeIdList(outMsg, sendersId);
 
 
     // send request message
@@ -1224,27 +1338,14 @@ Ns3Client::CommandDeactivateNode(vector<string> sendersId)
         return false;
     }
 
-    // 4 bytes for the length of the string list
-    // 4 bytes for the length each member of the list
-    int stringSize = 4 + (sendersId.size() * 4);
-
-    int totalAmountOfCharacters = 0;
-    vector<string>::iterator it;
-    for (it = sendersId.begin() ; it < sendersId.end() ; it++) {
-        string chain = *it;
-        size_t chainSize = chain.length();
-        totalAmountOfCharacters += chainSize;
-    }
-
-    // Finally one byte per character
-    stringSize = stringSize + totalAmountOfCharacters;
+    int stringSize = NodeIdListByteSize(sendersId);
 
     // command length
     outMsg.writeInt(4 + 1 + stringSize);
     // command id
     outMsg.writeUnsignedByte(CMD_DEACTIVATE_NODE);
     // ns-3 ids of the nodes to be activated
-    outMsg.writeStringList(sendersId);
+    WriteNodeIdList(outMsg, sendersId);
 
 
     // send request message
@@ -78,6 +78,12 @@ public:
     */
     bool CommandSimulationStep(int time);
 
+    /// @brief Number of events ns-3 processed in the last simulation step, 0 if ns-3 does not report it.
+    int GetLastStepEvents() const { return m_lastStepEvents; }
+
+    /// @brief Wall time in milliseconds ns-3 spent in the last simulation step, 0 if ns-3 does not report it.
+    double GetLastStepWallTime() const { return m_lastStepWallTime; }
+
     /**
     * @brief Sends a message to ns-3 with the new values of the node's position.
     * @param[in] nodeID The ns-3 identifier of the node.
@@ -284,6 +290,9 @@ public:
     /// @brief Sends a command close message.
     int CommandClose();
 
+    /// @brief Gets the traffic exchanged with ns-3 through the socket or the shared memory channel.
+    bool GetChannelStatistics(unsigned long long& sentBytes, unsigned long long& receivedBytes, unsigned long& roundTrips) const;
+
     /// @brief Port used for the connection with ns-3.
     int m_port;
 
@@ -311,6 +320,30 @@ private:
 
     /// @todo To be commented.
     int CalculateStringListByteSize(std::vector<std::string> list);
+
+    /**
+    * @brief Negotiates the encoding of the messages exchanged with ns-3.
+    * @param[in] version The protocol version requested by the iCS.
+    * @return True: If ns-3 accepted the requested version.
+    * @return False: If ns-3 fell back to an older version or does not know the command.
+    */
+    bool CommandSetProtocolVersion(int version);
+
+    /// @brief Number of bytes of a node id list in the negotiated encoding.
+    int NodeIdListByteSize(const std::vector<std::string>& nodeIds);
+
+    /// @brief Writes a node id list in the negotiated encoding.
+    void WriteNodeIdList(StorageNs3& outMsg, const std::vector<std::string>& nodeIds);
+
+    /// @brief Maps a message type sent by ns-3 to the iCS type, false if unknown.
+    bool ParseMessageType(const std::string& type, ics_types::messageType_t& messageType);
+
+    /// @brief Protocol version negotiated in Connect().
+    int m_protocolVersion;
+
+    /// @brief Statistics of the last simulation step reported by ns-3.
+    int m_lastStepEvents;
+    double m_lastStepWallTime;
 };
 
 }
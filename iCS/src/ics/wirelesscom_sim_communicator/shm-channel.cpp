@@ -0,0 +1,352 @@
+/****************************************************************************/
+/// @file    shm-channel.cpp
+/// @author  Julen Maneros
+/// @date
+/// @version $Id:
+///
+/****************************************************************************/
+// iTETRIS, see http://www.ict-itetris.eu
+// Copyright 2008 iTetris Project Consortium - All rights reserved
+/****************************************************************************/
+
+// ===========================================================================
+// included modules
+// ===========================================================================
+#ifdef _MSC_VER
+#include <windows_config.h>
+#else
+#include <config.h>
+#endif
+
+#include "shm-channel.h"
+
+#include <cerrno>
+#include <cstring>
+#include <climits>
+#include <sstream>
+
+#ifdef __linux__
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#endif
+
+namespace ics
+{
+
+const char* const ShmChannel::HOST_PREFIX = "shm://";
+
+bool
+ShmChannel::IsShmHost(const std::string &host)
+{
+    return host.compare(0, strlen(HOST_PREFIX), HOST_PREFIX) == 0;
+}
+
+ShmChannel::ShmChannel(const std::string &host, int port)
+        : segment_(0),
+        server_(false)
+{
+    std::string name = IsShmHost(host) ? host.substr(strlen(HOST_PREFIX)) : host;
+    if (name.empty())
+        name = "ics";
+    std::ostringstream oss;
+    oss << "/itetris-" << name << "-" << port;
+    name_ = oss.str();
+}
+
+ShmChannel::~ShmChannel()
+{
+    close();
+}
+
+bool
+ShmChannel::is_open() const
+{
+    return segment_ != 0;
+}
+
+#ifdef __linux__
+
+// Bytes of each ring, must be a power of two
+static const unsigned int SHM_RING_SIZE = 1 << 22;
+static const unsigned int SHM_MAGIC = 0x69435348;
+// Iterations a reader or writer polls the ring before sleeping on the futex
+static const int SHM_SPIN_COUNT = 4000;
+
+enum ShmState {
+    SHM_STATE_LISTENING = 1,
+    SHM_STATE_CONNECTED = 2,
+    SHM_STATE_CLOSED = 3
+};
+
+// The indices are free-running counters; producer and consumer fields live on separate cache lines
+struct ShmRing {
+    volatile unsigned int head;
+    char padHead[60];
+    volatile unsigned int tail;
+    char padTail[60];
+    volatile int seq;
+    volatile int waiters;
+    char padSeq[56];
+    unsigned char data[SHM_RING_SIZE];
+};
+
+struct ShmSegment {
+    volatile unsigned int magic;
+    volatile int state;
+    char pad[56];
+    ShmRing toServer;
+    ShmRing toClient;
+};
+
+static void
+FutexWait(volatile int *address, int value)
+{
+    // Wake up periodically to notice a peer that went away without closing the channel
+    struct timespec timeout;
+    timeout.tv_sec = 0;
+    timeout.tv_nsec = 100000000;
+    syscall(SYS_futex, (int*) address, FUTEX_WAIT, value, &timeout, NULL, 0);
+}
+
+static void
+FutexWake(volatile int *address)
+{
+    syscall(SYS_futex, (int*) address, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+static void
+NotifyRing(ShmRing *ring)
+{
+    __sync_fetch_and_add(&ring->seq, 1);
+    if (ring->waiters > 0)
+        FutexWake(&ring->seq);
+}
+
+static bool
+RingReady(const ShmRing *ring, bool forSpace)
+{
+    unsigned int used = ring->head - ring->tail;
+    return forSpace ? used < SHM_RING_SIZE : used > 0;
+}
+
+// Blocks until the ring has free space (forSpace) or data; fails if the peer closed the channel
+static bool
+WaitRing(ShmSegment *segment, ShmRing *ring, bool forSpace)
+{
+    for (int i = 0; i < SHM_SPIN_COUNT; ++i) {
+        if (RingReady(ring, forSpace))
+            return true;
+    }
+    while (true) {
+        int seq = ring->seq;
+        __sync_synchronize();
+        if (RingReady(ring, forSpace))
+            return true;
+        if (segment->state == SHM_STATE_CLOSED) {
+            errno = EPIPE;
+            return false;
+        }
+        __sync_fetch_and_add(&ring->waiters, 1);
+        if (!RingReady(ring, forSpace))
+            FutexWait(&ring->seq, seq);
+        __sync_fetch_and_sub(&ring->waiters, 1);
+    }
+}
+
+ShmRing*
+ShmChannel::outRing() const
+{
+    return server_ ? &segment_->toClient : &segment_->toServer;
+}
+
+ShmRing*
+ShmChannel::inRing() const
+{
+    return server_ ? &segment_->toServer : &segment_->toClient;
+}
+
+bool
+ShmChannel::map(bool create)
+{
+    int flags = O_RDWR;
+    if (create) {
+        // Remove a segment left behind by a crashed run
+        shm_unlink(name_.c_str());
+        flags |= O_CREAT | O_EXCL;
+    }
+    int fd = shm_open(name_.c_str(), flags, 0600);
+    if (fd < 0)
+        return false;
+
+    if (create) {
+        if (ftruncate(fd, sizeof(ShmSegment)) != 0) {
+            int error = errno;
+            ::close(fd);
+            shm_unlink(name_.c_str());
+            errno = error;
+            return false;
+        }
+    } else {
+        // The server may not have sized the segment yet
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < (off_t) sizeof(ShmSegment)) {
+            ::close(fd);
+            errno = ECONNREFUSED;
+            return false;
+        }
+    }
+
+    void *address = mmap(NULL, sizeof(ShmSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    int error = errno;
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        if (create)
+            shm_unlink(name_.c_str());
+        errno = error;
+        return false;
+    }
+    segment_ = static_cast<ShmSegment*>(address);
+    return true;
+}
+
+bool
+ShmChannel::create()
+{
+    if (segment_ != 0)
+        return true;
+    server_ = true;
+    if (!map(true))
+        return false;
+
+    // ftruncate() zero-fills the segment, only the handshake fields need to be set
+    segment_->state = SHM_STATE_LISTENING;
+    __sync_synchronize();
+    segment_->magic = SHM_MAGIC;
+
+    while (segment_->state == SHM_STATE_LISTENING)
+        FutexWait(&segment_->state, SHM_STATE_LISTENING);
+
+    // Both sides are mapped: the name is not needed any more
+    shm_unlink(name_.c_str());
+    if (segment_->state != SHM_STATE_CONNECTED) {
+        close();
+        errno = ECONNABORTED;
+        return false;
+    }
+    return true;
+}
+
+bool
+ShmChannel::attach()
+{
+    if (segment_ != 0)
+        return true;
+    server_ = false;
+    if (!map(false))
+        return false;
+
+    if (segment_->magic != SHM_MAGIC
+        || !__sync_bool_compare_and_swap(&segment_->state, SHM_STATE_LISTENING, SHM_STATE_CONNECTED))
+    {
+        munmap(segment_, sizeof(ShmSegment));
+        segment_ = 0;
+        errno = ECONNREFUSED;
+        return false;
+    }
+    FutexWake(&segment_->state);
+    return true;
+}
+
+bool
+ShmChannel::write(const unsigned char *buffer, std::size_t len)
+{
+    if (segment_ == 0) {
+        errno = ENOTCONN;
+        return false;
+    }
+    ShmRing *ring = outRing();
+    while (len > 0) {
+        if (!WaitRing(segment_, ring, true))
+            return false;
+        unsigned int head = ring->head;
+        unsigned int space = SHM_RING_SIZE - (head - ring->tail);
+        unsigned int n = len < space ? (unsigned int) len : space;
+        unsigned int offset = head & (SHM_RING_SIZE - 1);
+        unsigned int first = SHM_RING_SIZE - offset < n ? SHM_RING_SIZE - offset : n;
+        memcpy(ring->data + offset, buffer, first);
+        memcpy(ring->data, buffer + first, n - first);
+        // Publish the bytes before the new head
+        __sync_synchronize();
+        ring->head = head + n;
+        NotifyRing(ring);
+        buffer += n;
+        len -= n;
+    }
+    return true;
+}
+
+bool
+ShmChannel::read(unsigned char *buffer, std::size_t len)
+{
+    if (segment_ == 0) {
+        errno = ENOTCONN;
+        return false;
+    }
+    ShmRing *ring = inRing();
+    while (len > 0) {
+        if (!WaitRing(segment_, ring, false))
+            return false;
+        unsigned int tail = ring->tail;
+        unsigned int available = ring->head - tail;
+        __sync_synchronize();
+        unsigned int n = len < available ? (unsigned int) len : available;
+        unsigned int offset = tail & (SHM_RING_SIZE - 1);
+        unsigned int first = SHM_RING_SIZE - offset < n ? SHM_RING_SIZE - offset : n;
+        memcpy(buffer, ring->data + offset, first);
+        memcpy(buffer + first, ring->data, n - first);
+        // Release the space only once the bytes are copied out
+        __sync_synchronize();
+        ring->tail = tail + n;
+        NotifyRing(ring);
+        buffer += n;
+        len -= n;
+    }
+    return true;
+}
+
+void
+ShmChannel::close()
+{
+    if (segment_ == 0)
+        return;
+    segment_->state = SHM_STATE_CLOSED;
+    __sync_synchronize();
+    FutexWake(&segment_->state);
+    NotifyRing(&segment_->toServer);
+    NotifyRing(&segment_->toClient);
+    munmap(segment_, sizeof(ShmSegment));
+    segment_ = 0;
+    if (server_)
+        shm_unlink(name_.c_str());
+}
+
+#else // __linux__
+
+ShmRing* ShmChannel::outRing() const { return 0; }
+ShmRing* ShmChannel::inRing() const { return 0; }
+bool ShmChannel::map(bool) { errno = ENOSYS; return false; }
+bool ShmChannel::create() { errno = ENOSYS; return false; }
+bool ShmChannel::attach() { errno = ENOSYS; return false; }
+bool ShmChannel::write(const unsigned char*, std::size_t) { errno = ENOSYS; return false; }
+bool ShmChannel::read(unsigned char*, std::size_t) { errno = ENOSYS; return false; }
+void ShmChannel::close() {}
+
+#endif // __linux__
+
+}
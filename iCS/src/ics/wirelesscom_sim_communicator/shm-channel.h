@@ -0,0 +1,79 @@
+/****************************************************************************/
+/// @file    shm-channel.h
+/// @author  Julen Maneros
+/// @date
+/// @version $Id:
+///
+/****************************************************************************/
+// iTETRIS, see http://www.ict-itetris.eu
+// Copyright 2008 iTetris Project Consortium - All rights reserved
+/****************************************************************************/
+#ifndef SHM_CHANNEL_H
+#define SHM_CHANNEL_H
+
+// ===========================================================================
+// included modules
+// ===========================================================================
+#include <string>
+#include <cstddef>
+
+namespace ics
+{
+
+// ===========================================================================
+// class declarations
+// ===========================================================================
+struct ShmSegment;
+struct ShmRing;
+
+// ===========================================================================
+// class definitions
+// ===========================================================================
+/**
+ * @class ShmChannel
+ * @brief Byte stream between two processes of the same host over POSIX shared memory.
+ *
+ * The segment holds two single-producer/single-consumer rings, one per direction.
+ * Readers and writers spin briefly and then sleep on a futex, so a message costs
+ * no system call while the peer is actively exchanging data.
+ * The channel is selected with a "shm://<name>" host; the segment is named after
+ * the name and the port, so several co-simulations can run on the same host.
+ * Only available on Linux; elsewhere create() and attach() fail with ENOSYS.
+ */
+class ShmChannel
+{
+public:
+    /// Prefix of the host string that selects the shared memory transport
+    static const char* const HOST_PREFIX;
+
+    /// Returns true if \p host selects the shared memory transport
+    static bool IsShmHost(const std::string &host);
+
+    ShmChannel(const std::string &host, int port);
+    ~ShmChannel();
+
+    /// Server side: create the segment and block until the peer attaches
+    bool create();
+    /// Client side: attach to the segment created by the server
+    bool attach();
+    /// Write \p len bytes, blocking while the ring is full
+    bool write(const unsigned char *buffer, std::size_t len);
+    /// Read exactly \p len bytes, blocking while the ring is empty
+    bool read(unsigned char *buffer, std::size_t len);
+    /// Mark the channel as closed for the peer and unmap the segment
+    void close();
+    bool is_open() const;
+
+private:
+    bool map(bool create);
+    ShmRing* outRing() const;
+    ShmRing* inRing() const;
+
+    std::string name_;
+    ShmSegment *segment_;
+    bool server_;
+};
+
+}
+
+#endif
@@ -11,6 +11,7 @@
 #include <sys/simulation/simulation_controller.h>
 #else
 #include "socket-ns3.h"
+#include "shm-channel.h"
 #endif
 
 #ifdef BUILD_TCPIP
@@ -82,7 +83,11 @@ SocketNs3(std::string host, int port)
         port_(port),
         socket_(-1),
         server_socket_(-1),
-        blocking_(true)
+        blocking_(true),
+        shm_(0),
+        sentBytes_(0),
+        receivedBytes_(0),
+        receivedMessages_(0)
 {
     verbose_ = false;
     init();
@@ -95,7 +100,11 @@ SocketNs3(int port)
         port_(port),
         socket_(-1),
         server_socket_(-1),
-        blocking_(true)
+        blocking_(true),
+        shm_(0),
+        sentBytes_(0),
+        receivedBytes_(0),
+        receivedMessages_(0)
 {
     verbose_ = false;
     init();
@@ -226,9 +235,19 @@ SocketNs3::
 accept()
 throw(SocketException)
 {
-    if (socket_ >= 0)
+    if (socket_ >= 0 || shm_ != 0)
         return;
 
+    if (ShmChannel::IsShmHost(host_)) {
+        shm_ = new ShmChannel(host_, port_);
+        if (!shm_->create()) {
+            delete shm_;
+            shm_ = 0;
+            BailOnSocketError("tcpip::SocketNs3::accept() Unable to create shared memory channel");
+        }
+        return;
+    }
+
     struct sockaddr_in client_addr;
 #ifdef WIN32
     int addrlen = sizeof(client_addr);
@@ -315,6 +334,16 @@ SocketNs3::
 connect()
 throw(SocketException)
 {
+    if (ShmChannel::IsShmHost(host_)) {
+        shm_ = new ShmChannel(host_, port_);
+        if (!shm_->attach()) {
+            delete shm_;
+            shm_ = 0;
+            BailOnSocketError("tcpip::SocketNs3::connect() @ shared memory attach");
+        }
+        return;
+    }
+
     in_addr addr;
     if (!atoaddr(host_.c_str(), addr))
         BailOnSocketError("tcpip::SocketNs3::connect() @ Invalid network address");
@@ -344,6 +373,12 @@ void
 SocketNs3::
 close()
 {
+    if (shm_ != 0) {
+        shm_->close();
+        delete shm_;
+        shm_ = 0;
+    }
+
     // Close client-connection
     if (socket_ >= 0) {
 #ifdef WIN32
@@ -362,7 +397,7 @@ SocketNs3::
 send(std::vector<unsigned char> b)
 throw(SocketException)
 {
-    if (socket_ < 0) return;
+    if (socket_ < 0 && shm_ == 0) return;
 
     size_t numbytes = b.size();
     unsigned char *buf = new unsigned char[numbytes];
@@ -381,6 +416,12 @@ throw(SocketException)
         cerr << "]" << endl;
     }
 
+    if (shm_ != 0) {
+        if (!shm_->write(buf, numbytes))
+            BailOnSocketError("send failed");
+        numbytes = 0;
+    }
+
     while (numbytes > 0) {
 #ifdef WIN32
         int n = ::send(socket_, (const char*)buf, static_cast<int>(numbytes), 0);
@@ -413,6 +454,7 @@ throw(SocketException)
     msg.insert(msg.end(), length_storage.begin(), length_storage.end());
     msg.insert(msg.end(), b.begin(), b.end());
     send(msg);
+    sentBytes_ += msg.size();
 }
 
 
@@ -464,35 +506,17 @@ throw(SocketException)
 {
     /* receive length of vector */
     unsigned char* bufLength = new unsigned char[4];
-    int bytesRead = 0;
-    int readThisTime = 0;
-
-    while (bytesRead<4) {
-        readThisTime = recv(socket_, (char*)(bufLength + bytesRead), 4-bytesRead, 0);
-
-        if (readThisTime <= 0)
-            BailOnSocketError("tcpip::SocketNs3::receive() @ recv");
-
-        bytesRead += readThisTime;
-    }
+    receiveComplete(bufLength, 4);
     StorageNs3 length_storage(bufLength,4);
     int NN = length_storage.readInt() - 4;
 
     /* receive vector */
     unsigned char* buf = new unsigned char[NN];
-    bytesRead = 0;
-    readThisTime = 0;
-
-    while (bytesRead<NN) {
-        readThisTime = recv(socket_, (char*)(buf + bytesRead), NN-bytesRead, 0);
-
-        if (readThisTime <= 0)
-            BailOnSocketError("tcpip::SocketNs3::receive() @ recv");
-
-        bytesRead += readThisTime;
-    }
+    receiveComplete(buf, NN);
     msg.reset();
     msg.writePacket(buf, NN);
+    receivedBytes_ += 4 + NN;
+    ++receivedMessages_;
 
     if (verbose_) {
         cerr << "Rcvd Storage with "  << 4 + NN <<  " bytes via tcpip::SocketNs3: [";
@@ -511,13 +535,36 @@ throw(SocketException)
 }
 
 
+// ----------------------------------------------------------------------
+void
+SocketNs3::
+receiveComplete(unsigned char * const buffer, std::size_t len)
+const throw(SocketException)
+{
+    if (shm_ != 0) {
+        if (!shm_->read(buffer, len))
+            BailOnSocketError("tcpip::SocketNs3::receive() @ shared memory read");
+        return;
+    }
+
+    std::size_t bytesRead = 0;
+    while (bytesRead<len) {
+        int readThisTime = recv(socket_, (char*)(buffer + bytesRead), static_cast<int>(len-bytesRead), 0);
+
+        if (readThisTime <= 0)
+            BailOnSocketError("tcpip::SocketNs3::receive() @ recv");
+
+        bytesRead += readThisTime;
+    }
+}
+
 // ----------------------------------------------------------------------
 bool
 SocketNs3::
 has_client_connection()
 const
 {
-    return socket_ >= 0;
+    return socket_ >= 0 || shm_ != 0;
 }
 
 // ----------------------------------------------------------------------
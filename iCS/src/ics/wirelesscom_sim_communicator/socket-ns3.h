@@ -59,6 +59,7 @@ extern "C" void init_tcpip(shawn::SimulationController&);
 #include <list>
 #include <deque>
 #include <iostream>
+#include <cstddef>
 
 
 struct in_addr;
@@ -66,6 +67,8 @@ struct in_addr;
 namespace ics
 {
 
+class ShmChannel;
+
 class SocketException: public std::exception
 {
 private:
@@ -88,6 +91,7 @@ class SocketNs3
     friend class Response;
 public:
     /// Constructor that prepare to connect to host:port
+    /// A "shm://<name>" host selects the shared memory transport (see ShmChannel)
     SocketNs3(std::string host, int port);
 
     /// Constructor that prepare for accepting a connection on given port
@@ -120,6 +124,19 @@ public:
         verbose_ = newVerbose;
     }
 
+    /// Bytes sent with sendExact(), length prefix included
+    unsigned long long sentBytes() const {
+        return sentBytes_;
+    }
+    /// Bytes received with receiveExact(), length prefix included
+    unsigned long long receivedBytes() const {
+        return receivedBytes_;
+    }
+    /// Messages received with receiveExact(), i.e. request/reply round trips
+    unsigned long receivedMessages() const {
+        return receivedMessages_;
+    }
+
 private:
     void init();
     void BailOnSocketError(std::string) const throw(SocketException);
@@ -128,14 +145,22 @@ private:
 #endif
     bool atoaddr(std::string, struct in_addr& addr);
     bool datawaiting(int sock) const throw();
+    /// Receive exactly \p len bytes from the socket or the shared memory channel
+    void receiveComplete(unsigned char * const buffer, std::size_t len) const throw(SocketException);
 
     std::string host_;
     int port_;
     int socket_;
     int server_socket_;
     bool blocking_;
+    /// Shared memory channel used instead of socket_ for "shm://" hosts
+    ShmChannel* shm_;
 
     bool verbose_;
+
+    unsigned long long sentBytes_;
+    unsigned long long receivedBytes_;
+    unsigned long receivedMessages_;
 #ifdef WIN32
     static bool init_windows_sockets_;
     static bool windows_sockets_initialized_;
@@ -286,6 +286,17 @@ public:
     */
     virtual int CommandClose() = 0;
 
+    /**
+    * @brief Gets the traffic exchanged with the wireless simulator since the connection.
+    * @param[out] sentBytes Bytes sent.
+    * @param[out] receivedBytes Bytes received.
+    * @param[out] roundTrips Replies received, one for each command.
+    * @return False if the communicator does not count the traffic.
+    */
+    virtual bool GetChannelStatistics(unsigned long long& sentBytes, unsigned long long& receivedBytes, unsigned long& roundTrips) const {
+        return false;
+    }
+
 };
 
 }
@@ -0,0 +1,110 @@
+/****************************************************************************/
+/// @file    iCSObjectPool.h
+/// @author  iTETRIS
+/// @date    2010
+/// @version $Id: iCSObjectPool.h $
+///
+//
+/****************************************************************************/
+// iTETRIS, see www.ict-itetris.eu/
+// Copyright
+/****************************************************************************/
+#ifndef iCSObjectPool_h
+#define iCSObjectPool_h
+
+// ===========================================================================
+// included modules
+// ===========================================================================
+#ifdef _MSC_VER
+#include <windows_config.h>
+#else
+#include <config.h>
+#endif
+
+#include <cstddef>
+#include <new>
+
+
+namespace ics
+{
+
+// ===========================================================================
+// class definitions
+// ===========================================================================
+/**
+ * @class PooledObject
+ * @brief Gives the class T a class-specific operator new/delete backed by a free list.
+ *
+ * Objects created and destroyed at every time step (e.g. the payload of each
+ * CAM) reuse the memory of the released ones instead of going to the heap.
+ * The class is used as an additional base: class Foo : public Bar, public PooledObject<Foo>.
+ * Classes derived from T with a different size, and the blocks released while
+ * the free list is full, use the global heap. Not thread safe, as the rest of the iCS.
+ */
+template <class T>
+class PooledObject {
+public:
+
+    static void* operator new(std::size_t size) {
+        if (size != sizeof(T) || freeList_ == 0)
+            return ::operator new(size);
+        FreeBlock* block = freeList_;
+        freeList_ = block->next;
+        --nFree_;
+        return block;
+    }
+
+    /// @brief The size is the one of the dynamic type, since the classes using the pool have a virtual destructor.
+    static void operator delete(void* object, std::size_t size) {
+        if (object == 0)
+            return;
+        if (size != sizeof(T) || sizeof(T) < sizeof(FreeBlock) || nFree_ >= MAX_FREE) {
+            ::operator delete(object);
+            return;
+        }
+        FreeBlock* block = static_cast<FreeBlock*>(object);
+        block->next = freeList_;
+        freeList_ = block;
+        ++nFree_;
+    }
+
+    /// @brief Returns all the pooled blocks to the heap.
+    static void purgePool() {
+        while (freeList_ != 0) {
+            FreeBlock* block = freeList_;
+            freeList_ = block->next;
+            ::operator delete(block);
+        }
+        nFree_ = 0;
+    }
+
+    /// @brief Number of blocks currently kept in the free list.
+    static unsigned int pooledObjects() {
+        return nFree_;
+    }
+
+protected:
+    PooledObject() {}
+    ~PooledObject() {}
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    /// @brief Maximum number of released blocks kept for reuse.
+    static const unsigned int MAX_FREE = 65536;
+
+    static FreeBlock* freeList_;
+    static unsigned int nFree_;
+};
+
+template <class T>
+typename PooledObject<T>::FreeBlock* PooledObject<T>::freeList_ = 0;
+
+template <class T>
+unsigned int PooledObject<T>::nFree_ = 0;
+
+}
+
+#endif
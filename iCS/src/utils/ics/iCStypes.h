@@ -60,6 +60,7 @@ enum tlStatus                   {GREEN,
                                  RED,
                                  UNKNOWN};
 typedef std::string             roadElementID_t;
+typedef int                     roadElementIndex_t;
 typedef std::string             trafficLightID_t;
 typedef float                   latitude_t;
 typedef float                   longitude_t;
@@ -178,6 +179,17 @@ struct Area {
     roadElementID_t roadElementID;
 } typedef TArea;
 
+/**
+ * @struct RoadLocation
+ * @brief Lane, edge and junction of a position, as road element ids interned by the MapFacilities.
+ *        A negative lane means the location is not known.
+ */
+struct RoadLocation {
+    roadElementIndex_t          lane;
+    roadElementIndex_t          edge;
+    roadElementIndex_t          junction;
+} typedef TRoadLocation;
+
 /**
  * @struct CamInformation
  * @brief Structure to pass information contained in CAM to the application.
@@ -97,8 +97,10 @@ bool
 IcsLog::Log(const char* message)
 {
     // check the time step and create a new file if necessary
-    if (timeStepThreshold_ != 0 && SyncManager::m_simStep == nextTimeStepThreshold_ ) {
-	nextTimeStepThreshold_ += timeStepThreshold_;
+    // (the threshold may be passed in a step without messages)
+    if (timeStepThreshold_ > 0 && SyncManager::m_simStep >= nextTimeStepThreshold_ ) {
+	while (SyncManager::m_simStep >= nextTimeStepThreshold_)
+	    nextTimeStepThreshold_ += timeStepThreshold_;
 	instance_->StartNewFile();
     }
 
@@ -138,8 +140,10 @@ bool
 IcsLog::LogLevel(const char* message, ics::LogLevel messageLogLevel)
 {
     // check the time step and create a new file if necessary
-    if (timeStepThreshold_ != 0 && SyncManager::m_simStep == nextTimeStepThreshold_ ) {
-	nextTimeStepThreshold_ += timeStepThreshold_;
+    // (the threshold may be passed in a step without messages)
+    if (timeStepThreshold_ > 0 && SyncManager::m_simStep >= nextTimeStepThreshold_ ) {
+	while (SyncManager::m_simStep >= nextTimeStepThreshold_)
+	    nextTimeStepThreshold_ += timeStepThreshold_;
 	instance_->StartNewFile();
     }
 
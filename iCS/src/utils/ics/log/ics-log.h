@@ -96,6 +96,17 @@ public:
     */
     static bool LogLevel(const char* message, ics::LogLevel messageLogLevel);
 
+    /**
+    * @brief Tells whether a message of the given level would be written.
+    * @param [in] messageLogLevel The level of the message.
+    *
+    * Callers building their message with a stringstream check this first, so that
+    * filtered messages cost nothing.
+    */
+    static bool IsEnabled(ics::LogLevel messageLogLevel) {
+        return instance_ != 0 && messageLogLevel >= logLevel_;
+    }
+
     /**
     * @brief
     * @param [in]
@@ -22,10 +22,32 @@
 #include "ns3/mobility-module.h"
 #include "ns3/contrib-module.h" 
 #include "ns3/inci-utils-module.h" 
+#include "ns3/geo-utils.h"
 #include <exception>
+#include <sstream>
+#include <set>
 
 using namespace ns3;
 
+/**
+ * Read a comma-separated list of ids, e.g. "3,7,12"
+ */
+static std::set<uint32_t>
+ReadIdList (std::string list)
+{
+  std::set<uint32_t> ids;
+  std::istringstream iss (list);
+  std::string id;
+  while (std::getline (iss, id, ','))
+    {
+      if (!id.empty ())
+        {
+          ids.insert (atoi (id.c_str ()));
+        }
+    }
+  return ids;
+}
+
 int main (int argc, char *argv[])
 {
   /**
@@ -37,11 +59,30 @@ int main (int argc, char *argv[])
   std::string fileConfTechnologies = "";
   std::string inciPort = "";
   std::string logFile = "";
+  std::string inciShm = "";
+  std::string profileFile = "";
+  double lazyInstallRange = 0;
+  std::string pcapNgFile = "";
+  std::string pcapNgNodes = "";
+  std::string pcapNgApps = "";
+  // Origin of the local coordinates of the iCS facilities
+  double originLatitude = 43.580573;
+  double originLongitude = 7.121054;
+  double originAltitude = 0.0;
 
   CommandLine cmd;
   cmd.AddValue("fileGeneralParameters", "Path to the configuration file", fileGeneralParameters);
   cmd.AddValue("fileConfTechnologies", "Path to the configuration file", fileConfTechnologies);
   cmd.AddValue("inciPort", "iNCI listening socket port number", inciPort);
+  cmd.AddValue("inciShm", "Shared memory channel name used instead of the iNCI socket (same host only)", inciShm);
+  cmd.AddValue("originLatitude", "Latitude of the origin of the local coordinates, in degrees", originLatitude);
+  cmd.AddValue("originLongitude", "Longitude of the origin of the local coordinates, in degrees", originLongitude);
+  cmd.AddValue("originAltitude", "Altitude of the origin of the local coordinates, in meters", originAltitude);
+  cmd.AddValue("profileFile", "CSV file the per-step profile is written to (needs --enable-profiling)", profileFile);
+  cmd.AddValue("lazyInstallRange", "Install the stacks of a vehicle on its first transmission or when it gets within this distance, in meters, of a transmitting node (0 installs them on departure)", lazyInstallRange);
+  cmd.AddValue("pcapNgFile", "pcapng file the frames of the WiFi devices of the nodes are written to", pcapNgFile);
+  cmd.AddValue("pcapNgNodes", "Comma-separated ns-3 ids of the nodes written to the pcapng file (all of them if empty)", pcapNgNodes);
+  cmd.AddValue("pcapNgApps", "Comma-separated application indexes (AppIndexTag) of the packets written to the pcapng file (all of them if empty)", pcapNgApps);
 
   // logFile could not be set. In this case, do not try to read it.
 //   if (argc > 4 && !inciPort.empty() && !fileConfTechnologies.empty() && !fileGeneralParameters.empty())
@@ -51,6 +92,9 @@ if (argc > 4 /*&& !inciPort.empty() && !fileConfTechnologies.empty() && !fileGen
 
   cmd.Parse (argc, argv);
 
+  SetLocalOrigin (originLatitude, originLongitude, originAltitude);
+  Profiler::SetOutput (profileFile);
+
   LogComponentEnable ("ConfigurationManagerXml",LOG_LEVEL_DEBUG);
   LogComponentEnable ("WaveInstaller",LOG_LEVEL_DEBUG);
   LogComponentEnable ("RsuStaMgnt",LOG_LEVEL_LOGIC);
@@ -83,6 +127,11 @@ if (argc > 4 /*&& !inciPort.empty() && !fileConfTechnologies.empty() && !fileGen
 
   ConfigurationManagerXml confManager (fileConfTechnologies);
   iTETRISNodeManager* nodeManager = new iTETRISNodeManager ();
+  nodeManager->SetLazyInstallRange (lazyInstallRange);
+  if (pcapNgFile != "")
+    {
+      nodeManager->EnablePcapNg (pcapNgFile, ReadIdList (pcapNgApps), ReadIdList (pcapNgNodes));
+    }
   PacketManager* packetManager = new PacketManager (); 
   packetManager->SetNodeManager (nodeManager);
   confManager.ReadFile(nodeManager);
@@ -90,6 +139,8 @@ if (argc > 4 /*&& !inciPort.empty() && !fileConfTechnologies.empty() && !fileGen
   SeedManager::SetRun (confManager.GetRunNumber()); 
 
 
+  ns3::Ns3Server::SetSharedMemoryChannel(inciShm);
+
   try {
     ns3::Ns3Server::processCommandsUntilSimStep(port, logFile, nodeManager, packetManager); 
   } catch (int e)
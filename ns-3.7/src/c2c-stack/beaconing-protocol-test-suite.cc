@@ -0,0 +1,305 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2009-2010, EURECOM, EU FP7 iTETRIS project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/node.h"
+#include "ns3/location-table.h"
+#include "ns3/c2c-common-header.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/enum.h"
+#include "ns3/uinteger.h"
+#include "ns3/nstime.h"
+#include "beaconing-protocol.h"
+#include <vector>
+#include <sstream>
+#include <cstdlib>
+
+using namespace ns3;
+
+// ===========================================================================
+// Base of the test cases: creates nodes beaconing in the ADAPTIVE mode and
+// records the time of their beacons. The first beacon of a node is delayed
+// by its id in ms, so the expected times are relative to it.
+// ===========================================================================
+class AdaptiveBeaconingTestCase : public TestCase
+{
+public:
+  AdaptiveBeaconingTestCase (std::string name);
+  virtual ~AdaptiveBeaconingTestCase ();
+
+protected:
+  virtual void DoTeardown (void);
+
+  Ptr<BeaconingProtocol> CreateBeaconing (Ptr<Node> node);
+  void CheckBeacons (uint32_t index, const double *offsets, uint32_t n);
+  void CheckSlottedBeacons (uint32_t index, const double *times, uint32_t n);
+
+  std::vector<std::vector<Time> > m_beacons;
+
+private:
+  void NotifyBeacon (std::string context, Ptr<const Packet> packet);
+};
+
+AdaptiveBeaconingTestCase::AdaptiveBeaconingTestCase (std::string name)
+  : TestCase (name)
+{
+}
+
+AdaptiveBeaconingTestCase::~AdaptiveBeaconingTestCase ()
+{
+}
+
+void
+AdaptiveBeaconingTestCase::DoTeardown (void)
+{
+  m_beacons.clear ();
+  Simulator::Destroy ();
+}
+
+Ptr<BeaconingProtocol>
+AdaptiveBeaconingTestCase::CreateBeaconing (Ptr<Node> node)
+{
+  Ptr<BeaconingProtocol> beaconing = CreateObject<BeaconingProtocol> ();
+  beaconing->SetAttribute ("Mode", EnumValue (BeaconingProtocol::ADAPTIVE));
+  node->AggregateObject (beaconing);
+  // the context is the index of the node in m_beacons
+  std::ostringstream context;
+  context << m_beacons.size ();
+  beaconing->TraceConnect ("Beacon", context.str (),
+                           MakeCallback (&AdaptiveBeaconingTestCase::NotifyBeacon, this));
+  m_beacons.push_back (std::vector<Time> ());
+  return beaconing;
+}
+
+void
+AdaptiveBeaconingTestCase::NotifyBeacon (std::string context, Ptr<const Packet> packet)
+{
+  m_beacons[atoi (context.c_str ())].push_back (Simulator::Now ());
+}
+
+void
+AdaptiveBeaconingTestCase::CheckBeacons (uint32_t index, const double *offsets, uint32_t n)
+{
+  const std::vector<Time> &beacons = m_beacons[index];
+  NS_TEST_EXPECT_MSG_EQ (beacons.size (), n, "Wrong number of beacons on node " << index);
+  for (uint32_t i = 1; i < n && i < beacons.size (); i++)
+    {
+      Time offset = beacons[i] - beacons[0];
+      NS_TEST_EXPECT_MSG_EQ (offset, Seconds (offsets[i]),
+                             "Beacon " << i << " of node " << index << " sent at " << beacons[i].GetSeconds () << "s");
+    }
+}
+
+void
+AdaptiveBeaconingTestCase::CheckSlottedBeacons (uint32_t index, const double *times, uint32_t n)
+{
+  const std::vector<Time> &beacons = m_beacons[index];
+  NS_TEST_EXPECT_MSG_EQ (beacons.size (), n, "Wrong number of beacons on node " << index);
+  for (uint32_t i = 0; i < n && i < beacons.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (beacons[i], Seconds (times[i]),
+                             "Beacon " << i << " of node " << index << " sent at " << beacons[i].GetSeconds () << "s");
+    }
+}
+
+// ===========================================================================
+// Test case to make sure that the interval between two beacons grows with
+// the channel busy ratio measured since the previous beacon.
+// ===========================================================================
+class AdaptiveBeaconingBusyRatioTestCase : public AdaptiveBeaconingTestCase
+{
+public:
+  AdaptiveBeaconingBusyRatioTestCase ();
+
+private:
+  virtual bool DoRun (void);
+};
+
+AdaptiveBeaconingBusyRatioTestCase::AdaptiveBeaconingBusyRatioTestCase ()
+  : AdaptiveBeaconingTestCase ("Check the widening of the beacon interval with the channel busy ratio")
+{
+}
+
+bool
+AdaptiveBeaconingBusyRatioTestCase::DoRun (void)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<BeaconingProtocol> beaconing = CreateBeaconing (node);
+  beaconing->SetAttribute ("MaxInterval", TimeValue (Seconds (5)));
+
+  // 0.4s busy in the 0.5s after the first beacon, twice the target ratio
+  Simulator::Schedule (Seconds (0.1), &BeaconingProtocol::NotifyChannelBusy, beaconing, Seconds (0.4));
+  Simulator::Stop (Seconds (2.2));
+  Simulator::Run ();
+
+  // the interval is doubled once, and back to BEACON_INTERVAL on an idle channel
+  const double offsets[] = {0, 0.5, 1.5, 2.0};
+  CheckBeacons (0, offsets, 4);
+
+  return GetErrorStatus ();
+}
+
+// ===========================================================================
+// Test case to make sure that the interval between two beacons grows with
+// the number of neighbours above the DensityThreshold.
+// ===========================================================================
+class AdaptiveBeaconingDensityTestCase : public AdaptiveBeaconingTestCase
+{
+public:
+  AdaptiveBeaconingDensityTestCase ();
+
+private:
+  virtual bool DoRun (void);
+};
+
+AdaptiveBeaconingDensityTestCase::AdaptiveBeaconingDensityTestCase ()
+  : AdaptiveBeaconingTestCase ("Check the widening of the beacon interval with the density")
+{
+}
+
+bool
+AdaptiveBeaconingDensityTestCase::DoRun (void)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<LocationTable> table = CreateObject<LocationTable> ();
+  node->AggregateObject (table);
+  Ptr<BeaconingProtocol> beaconing = CreateBeaconing (node);
+  beaconing->SetAttribute ("DensityThreshold", UintegerValue (2));
+
+  // LocationTable::GetNbNeighs () counts one neighbour less than there are
+  // entries received in a header, 4 neighbours for 5 entries
+  for (uint64_t gnAddr = 100; gnAddr < 105; gnAddr++)
+    {
+      c2cCommonHeader header;
+      struct c2cCommonHeader::LongPositionVector vector = c2cCommonHeader::LongPositionVector ();
+      vector.gnAddr = gnAddr;
+      vector.Ts = 0;
+      header.SetSourPosVector (vector);
+      table->AddPosEntry (header);
+    }
+  NS_TEST_EXPECT_MSG_EQ (table->GetNbNeighs (), 4, "Wrong number of neighbours");
+
+  Simulator::Stop (Seconds (2.5));
+  Simulator::Run ();
+
+  // twice the density threshold doubles the interval
+  const double offsets[] = {0, 1.0, 2.0};
+  CheckBeacons (0, offsets, 3);
+
+  return GetErrorStatus ();
+}
+
+// ===========================================================================
+// Test case to make sure that no beacon is sent while the node moved less
+// than PositionThreshold, unless MaxInterval elapsed since the last one.
+// ===========================================================================
+class AdaptiveBeaconingSuppressionTestCase : public AdaptiveBeaconingTestCase
+{
+public:
+  AdaptiveBeaconingSuppressionTestCase ();
+
+private:
+  virtual bool DoRun (void);
+};
+
+AdaptiveBeaconingSuppressionTestCase::AdaptiveBeaconingSuppressionTestCase ()
+  : AdaptiveBeaconingTestCase ("Check the suppression of the beacons of a node that does not move")
+{
+}
+
+bool
+AdaptiveBeaconingSuppressionTestCase::DoRun (void)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+  mobility->SetPosition (Vector (0, 0, 0));
+  node->AggregateObject (mobility);
+  Ptr<BeaconingProtocol> beaconing = CreateBeaconing (node);
+  beaconing->SetAttribute ("MaxInterval", TimeValue (Seconds (1.2)));
+
+  // moved beyond the default PositionThreshold of 4m after the forced beacon
+  Simulator::Schedule (Seconds (1.35), &MobilityModel::SetPosition, mobility, Vector (10, 0, 0));
+  Simulator::Stop (Seconds (2.0));
+  Simulator::Run ();
+
+  // the beacons at 0.5s and 1s are suppressed, the one at 1.2s is forced by
+  // MaxInterval, and the one at 1.7s is sent since the node moved
+  const double offsets[] = {0, 1.2, 1.7};
+  CheckBeacons (0, offsets, 3);
+
+  return GetErrorStatus ();
+}
+
+// ===========================================================================
+// Test case to make sure that the beacons of the nodes scheduled in the same
+// slot are sent together at the start of the slot.
+// ===========================================================================
+class AdaptiveBeaconingSlotTestCase : public AdaptiveBeaconingTestCase
+{
+public:
+  AdaptiveBeaconingSlotTestCase ();
+
+private:
+  virtual bool DoRun (void);
+};
+
+AdaptiveBeaconingSlotTestCase::AdaptiveBeaconingSlotTestCase ()
+  : AdaptiveBeaconingTestCase ("Check the coalescing of the beacons in slots")
+{
+}
+
+bool
+AdaptiveBeaconingSlotTestCase::DoRun (void)
+{
+  // the first node would beacon at 0s, in a slot of its own
+  CreateObject<Node> ();
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Ptr<BeaconingProtocol> beaconing = CreateBeaconing (CreateObject<Node> ());
+      beaconing->SetAttribute ("SlotDuration", TimeValue (Seconds (1)));
+    }
+
+  Simulator::Stop (Seconds (3.5));
+  Simulator::Run ();
+
+  // both nodes start a few ms apart and beacon every 0.5s, rounded up to
+  // the same 1s slots
+  const double times[] = {1.0, 2.0, 3.0};
+  CheckSlottedBeacons (0, times, 3);
+  CheckSlottedBeacons (1, times, 3);
+
+  return GetErrorStatus ();
+}
+
+class BeaconingProtocolTestSuite : public TestSuite
+{
+public:
+  BeaconingProtocolTestSuite ();
+};
+
+BeaconingProtocolTestSuite::BeaconingProtocolTestSuite ()
+  : TestSuite ("beaconing-protocol", UNIT)
+{
+  AddTestCase (new AdaptiveBeaconingBusyRatioTestCase);
+  AddTestCase (new AdaptiveBeaconingDensityTestCase);
+  AddTestCase (new AdaptiveBeaconingSuppressionTestCase);
+  AddTestCase (new AdaptiveBeaconingSlotTestCase);
+}
+
+BeaconingProtocolTestSuite beaconingProtocolTestSuite;
@@ -21,6 +21,15 @@
 #include "ns3/beaconing-protocol.h"
 #include "c2c-l3-protocol.h"
 #include "ns3/geo-broadcast.h"
+#include "ns3/location-table.h"
+#include "ns3/mobility-model.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/wifi-phy.h"
+#include "ns3/enum.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/trace-source-accessor.h"
+#include <algorithm>
 
 NS_LOG_COMPONENT_DEFINE ("BeaconingProtocol");
 
@@ -29,6 +38,35 @@ namespace ns3
 const uint8_t BeaconingProtocol::TRAFFIC_CLASS = 0;
 const float BeaconingProtocol::BEACON_INTERVAL = 0.5;
 
+BeaconingProtocol::SlotMap BeaconingProtocol::m_slots;
+bool BeaconingProtocol::m_slotsClearScheduled = false;
+
+/**
+ * Feeds the busy periods reported by a wifi phy into the channel busy
+ * ratio of the beaconing protocol
+ */
+class BeaconingPhyListener : public WifiPhyListener
+{
+public:
+  BeaconingPhyListener (BeaconingProtocol *beaconing)
+    : m_beaconing (beaconing) {}
+  virtual ~BeaconingPhyListener () {}
+  virtual void NotifyRxStart (Time duration) {
+    m_beaconing->NotifyChannelBusy (duration);
+  }
+  virtual void NotifyRxEndOk (void) {}
+  virtual void NotifyRxEndError (void) {}
+  virtual void NotifyTxStart (Time duration) {
+    m_beaconing->NotifyChannelBusy (duration);
+  }
+  virtual void NotifyMaybeCcaBusyStart (Time duration) {
+    m_beaconing->NotifyChannelBusy (duration);
+  }
+  virtual void NotifySwitchingStart (Time duration) {}
+private:
+  BeaconingProtocol *m_beaconing;
+};
+
 NS_OBJECT_ENSURE_REGISTERED (BeaconingProtocol);
 
 TypeId 
@@ -37,11 +75,53 @@ BeaconingProtocol::GetTypeId (void)
   static TypeId tid = TypeId ("ns3::BeaconingProtocol")
     .SetParent<Object> ()
     .AddConstructor<BeaconingProtocol> ()
+    .AddAttribute ("Mode",
+                   "Fixed beaconing every BEACON_INTERVAL or adaptive (DCC-like) beaconing.",
+                   EnumValue (FIXED),
+                   MakeEnumAccessor (&BeaconingProtocol::m_mode),
+                   MakeEnumChecker (FIXED, "Fixed",
+                                    ADAPTIVE, "Adaptive"))
+    .AddAttribute ("MinInterval",
+                   "Adaptive mode: shortest interval between two beacons.",
+                   TimeValue (Seconds (0.1)),
+                   MakeTimeAccessor (&BeaconingProtocol::m_minInterval),
+                   MakeTimeChecker ())
+    .AddAttribute ("MaxInterval",
+                   "Adaptive mode: longest interval between two beacons.",
+                   TimeValue (Seconds (1.0)),
+                   MakeTimeAccessor (&BeaconingProtocol::m_maxInterval),
+                   MakeTimeChecker ())
+    .AddAttribute ("TargetBusyRatio",
+                   "Adaptive mode: channel busy ratio above which the interval is stretched.",
+                   DoubleValue (0.4),
+                   MakeDoubleAccessor (&BeaconingProtocol::m_targetBusyRatio),
+                   MakeDoubleChecker<double> (0.01, 1.0))
+    .AddAttribute ("PositionThreshold",
+                   "Adaptive mode: distance (m) the node has to move before MaxInterval for a beacon to be sent.",
+                   DoubleValue (4.0),
+                   MakeDoubleAccessor (&BeaconingProtocol::m_positionThreshold),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("DensityThreshold",
+                   "Adaptive mode: number of neighbours in the LocationTable above which the interval is stretched.",
+                   UintegerValue (20),
+                   MakeUintegerAccessor (&BeaconingProtocol::m_densityThreshold),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("SlotDuration",
+                   "Adaptive mode: beacons are aligned on slots of this duration, one simulator event per slot.",
+                   TimeValue (MilliSeconds (10)),
+                   MakeTimeAccessor (&BeaconingProtocol::m_slotDuration),
+                   MakeTimeChecker ())
+    .AddTraceSource ("Beacon", "A beacon is sent, through the c2c layer if the node has one.",
+                     MakeTraceSourceAccessor (&BeaconingProtocol::m_beaconTrace))
     ;
   return tid;
 }
 
 BeaconingProtocol::BeaconingProtocol ()
+  : m_mode (FIXED),
+    m_nDevices (0),
+    m_slotted (false),
+    m_slot (0)
 {
   Simulator::ScheduleNow (&BeaconingProtocol::ScheduleBeaconSending, this);
 }
@@ -49,6 +129,21 @@ BeaconingProtocol::BeaconingProtocol ()
 BeaconingProtocol::~BeaconingProtocol ()
 {
   Simulator::Cancel (m_sendBEvent);
+  RemoveFromSlot ();
+  UnregisterPhyListeners ();
+}
+
+void
+BeaconingProtocol::DoDispose (void)
+{
+  Simulator::Cancel (m_sendBEvent);
+  RemoveFromSlot ();
+  UnregisterPhyListeners ();
+  m_node = 0;
+  m_c2c = 0;
+  m_locationTable = 0;
+  m_mobility = 0;
+  Object::DoDispose ();
 }
 
 void 
@@ -70,6 +165,18 @@ BeaconingProtocol::NotifyNewAggregate ()
           this->SetNode (node);
         }
     }
+  if (m_c2c == 0)
+    {
+      m_c2c = this->GetObject<c2cL3Protocol> ();
+    }
+  if (m_locationTable == 0)
+    {
+      m_locationTable = this->GetObject<LocationTable> ();
+    }
+  if (m_mobility == 0)
+    {
+      m_mobility = this->GetObject<MobilityModel> ();
+    }
   Object::NotifyNewAggregate ();
 }
 
@@ -79,6 +186,14 @@ BeaconingProtocol::ScheduleBeaconSending ()
   double timeb;
 
   timeb = ((double)m_node->GetId ()/1000);
+  if (m_mode == ADAPTIVE)
+    {
+      RegisterPhyListeners ();
+      m_measureStart = Simulator::Now ();
+      m_lastBeacon = Seconds (-m_maxInterval.GetSeconds ());
+      ScheduleInSlot (Seconds (timeb));
+      return;
+    }
   m_sendBEvent = Simulator::Schedule(Seconds (/*1.0 */timeb), 
                                    &BeaconingProtocol::SendBeacon, this);
 }
@@ -90,7 +205,6 @@ BeaconingProtocol::SendBeacon ()
   Ptr<Packet> packet = Create<Packet> ();
 
   // Use Layer 3 protocol to send beacons
-  Ptr<c2cL3Protocol> c2cl3p = m_node->GetObject<c2cL3Protocol> ();
   struct c2cRoutingProtocol::output routeresult;
   routeresult.route = CreateObject<c2cRoute> ();
   c2cCommonHeader::geoAreaPos* p;
@@ -99,13 +213,20 @@ BeaconingProtocol::SendBeacon ()
   add->Set (c2cAddress::BROAD, p);
   routeresult.route->SetGateway (add);
   routeresult.packet = packet;
-  if (c2cl3p != 0)
+  m_beaconTrace (packet);
+  if (m_c2c != 0)
     {
       NS_LOG_LOGIC ("Sending Beacon");
       //---------------- check iTETRIS ----------------------------
       NS_LOG_DEBUG ("BeaconingProtocol: Sending Beacon");
       //---------------- check iTETRIS ----------------------------
-      c2cl3p->Send (routeresult, 0, Node::C2C_BEACON, Node::C2C_GEOBROADCAST_CIRCLE, TRAFFIC_CLASS);
+      m_c2c->Send (routeresult, 0, Node::C2C_BEACON, Node::C2C_GEOBROADCAST_CIRCLE, TRAFFIC_CLASS);
+    }
+
+  if (m_mode == ADAPTIVE)
+    {
+      // The next beacon is scheduled by AdaptiveBeacon ()
+      return;
     }
 
   //Send periodically the beacon (each 0.5 second)
@@ -113,4 +234,196 @@ BeaconingProtocol::SendBeacon ()
                                    &BeaconingProtocol::SendBeacon, this);
 }
 
+void
+BeaconingProtocol::RegisterPhyListeners ()
+{
+  // Devices can be added to the node after the protocol, only the new ones
+  // are looked at
+  if (m_node == 0)
+    {
+      return;
+    }
+  for (; m_nDevices < m_node->GetNDevices (); m_nDevices++)
+    {
+      Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice> (m_node->GetDevice (m_nDevices));
+      if (device != 0 && device->GetPhy () != 0)
+        {
+          BeaconingPhyListener *listener = new BeaconingPhyListener (this);
+          device->GetPhy ()->RegisterListener (listener);
+          m_listeners.push_back (std::make_pair (device->GetPhy (), listener));
+        }
+    }
+}
+
+void
+BeaconingProtocol::UnregisterPhyListeners ()
+{
+  for (PhyListeners::iterator i = m_listeners.begin (); i != m_listeners.end (); ++i)
+    {
+      i->first->UnregisterListener (i->second);
+      delete i->second;
+    }
+  m_listeners.clear ();
+  m_nDevices = 0;
+}
+
+void
+BeaconingProtocol::NotifyChannelBusy (Time duration)
+{
+  // Busy periods of several phys or overlapping reports are only counted once
+  Time now = Simulator::Now ();
+  Time end = now + duration;
+  if (end > m_busyEnd)
+    {
+      m_busyTime += end - std::max (now, m_busyEnd);
+      m_busyEnd = end;
+    }
+}
+
+double
+BeaconingProtocol::GetChannelBusyRatio () const
+{
+  Time window = Simulator::Now () - m_measureStart;
+  if (window <= Seconds (0))
+    {
+      return 0.0;
+    }
+  return std::min (1.0, m_busyTime.GetSeconds () / window.GetSeconds ());
+}
+
+Time
+BeaconingProtocol::ComputeAdaptiveInterval ()
+{
+  double interval = BEACON_INTERVAL;
+
+  double busyRatio = GetChannelBusyRatio ();
+  if (busyRatio > m_targetBusyRatio)
+    {
+      interval *= busyRatio / m_targetBusyRatio;
+    }
+
+  if (m_locationTable != 0)
+    {
+      int neighbours = m_locationTable->GetNbNeighs ();
+      if (neighbours > (int) m_densityThreshold)
+        {
+          interval *= (double) neighbours / m_densityThreshold;
+        }
+    }
+
+  interval = std::max (interval, m_minInterval.GetSeconds ());
+  interval = std::min (interval, m_maxInterval.GetSeconds ());
+  return Seconds (interval);
+}
+
+void
+BeaconingProtocol::AdaptiveBeacon ()
+{
+  Time now = Simulator::Now ();
+  RegisterPhyListeners ();
+  Time interval = ComputeAdaptiveInterval ();
+
+  // Start a new busy ratio measurement window, keeping the part of the
+  // current busy period that lies in the future
+  m_busyTime = m_busyEnd > now ? m_busyEnd - now : Seconds (0);
+  m_measureStart = now;
+
+  bool moved = true;
+  Vector position;
+  if (m_mobility != 0)
+    {
+      position = m_mobility->GetPosition ();
+      moved = CalculateDistance (position, m_lastPosition) >= m_positionThreshold;
+    }
+
+  if (moved || now - m_lastBeacon >= m_maxInterval)
+    {
+      m_lastBeacon = now;
+      m_lastPosition = position;
+      SendBeacon ();
+    }
+  else
+    {
+      NS_LOG_LOGIC ("Beacon suppressed on node " << m_node->GetId ());
+      // Do not wait beyond the moment MaxInterval expires
+      interval = std::min (interval, m_lastBeacon + m_maxInterval - now);
+    }
+  ScheduleInSlot (interval);
+}
+
+void
+BeaconingProtocol::ScheduleInSlot (Time delay)
+{
+  RemoveFromSlot ();
+  int64_t slotSteps = std::max (m_slotDuration.GetTimeStep (), (int64_t) 1);
+  int64_t at = (Simulator::Now () + delay).GetTimeStep ();
+  // Round up so that a beacon is never sent earlier than requested
+  uint64_t slot = (uint64_t) (((at + slotSteps - 1) / slotSteps) * slotSteps);
+
+  if (!m_slotsClearScheduled)
+    {
+      // The pending slot events are dropped by Simulator::Destroy
+      Simulator::ScheduleDestroy (&BeaconingProtocol::ClearSlots);
+      m_slotsClearScheduled = true;
+    }
+  SlotMap::iterator it = m_slots.find (slot);
+  if (it == m_slots.end ())
+    {
+      it = m_slots.insert (std::make_pair (slot, std::vector<BeaconingProtocol *> ())).first;
+      Simulator::Schedule (TimeStep (slot) - Simulator::Now (), &BeaconingProtocol::FireSlot, slot);
+    }
+  it->second.push_back (this);
+  m_slotted = true;
+  m_slot = slot;
+}
+
+void
+BeaconingProtocol::RemoveFromSlot ()
+{
+  if (!m_slotted)
+    {
+      return;
+    }
+  m_slotted = false;
+  SlotMap::iterator it = m_slots.find (m_slot);
+  if (it != m_slots.end ())
+    {
+      std::vector<BeaconingProtocol *>::iterator i = std::find (it->second.begin (), it->second.end (), this);
+      if (i != it->second.end ())
+        {
+          it->second.erase (i);
+        }
+      if (it->second.empty ())
+        {
+          // FireSlot () ignores the slots it does not find
+          m_slots.erase (it);
+        }
+    }
+}
+
+void
+BeaconingProtocol::FireSlot (uint64_t slot)
+{
+  SlotMap::iterator it = m_slots.find (slot);
+  if (it == m_slots.end ())
+    {
+      return;
+    }
+  std::vector<BeaconingProtocol *> beacons;
+  beacons.swap (it->second);
+  m_slots.erase (it);
+  for (std::vector<BeaconingProtocol *>::iterator i = beacons.begin (); i != beacons.end (); ++i)
+    {
+      (*i)->m_slotted = false;
+      (*i)->AdaptiveBeacon ();
+    }
+}
+
+void
+BeaconingProtocol::ClearSlots ()
+{
+  m_slots.clear ();
+  m_slotsClearScheduled = false;
+}
+
 } //namespace
@@ -29,10 +29,21 @@
 #include "ns3/node.h"
 #include "ns3/packet.h"
 #include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+#include <map>
+#include <vector>
+#include <utility>
 
 
 namespace ns3 {
 
+class BeaconingPhyListener;
+class WifiPhy;
+class c2cL3Protocol;
+class LocationTable;
+class MobilityModel;
+
 /**
  * \ingroup c2cStack
  * \defgroup BeaconingProtocol BeaconingProtocol
@@ -46,7 +57,13 @@ namespace ns3 {
  *
  * This class implements the network beaconing protocol.
  *
- *
+ * In the default FIXED mode every node beacons each BEACON_INTERVAL.
+ * In the ADAPTIVE mode (DCC-like) the interval grows with the channel busy
+ * ratio measured on the node's wifi phys and with the number of neighbours
+ * in the LocationTable, bounded by MinInterval and MaxInterval; a beacon is
+ * suppressed while the node moved less than PositionThreshold and MaxInterval
+ * has not elapsed. Adaptive beacons are aligned on slots of SlotDuration and
+ * all the nodes sharing a slot are served by a single simulator event.
  */
 class BeaconingProtocol : public Object
 {
@@ -56,6 +73,12 @@ public:
   static const float BEACON_INTERVAL;
   static const uint8_t TRAFFIC_CLASS;
 
+  enum Mode
+  {
+    FIXED,
+    ADAPTIVE
+  };
+
   BeaconingProtocol ();
   ~BeaconingProtocol ();
 
@@ -67,18 +90,81 @@ public:
   */
   void SendBeacon ();
 
+  /**
+  * Channel busy ratio measured since the last adaptive decision, in [0,1]
+  */
+  double GetChannelBusyRatio () const;
+
+  /**
+  * Account for the channel being busy for the given duration from now on
+  */
+  void NotifyChannelBusy (Time duration);
+
 protected:
 
+  virtual void DoDispose (void);
+
   Ptr<Node> m_node;
 
 private:
 
+  typedef std::map<uint64_t, std::vector<BeaconingProtocol *> > SlotMap;
+
   EventId m_sendBEvent;
 
+  // siblings used for every beacon, found by NotifyNewAggregate
+  Ptr<c2cL3Protocol> m_c2c;
+  Ptr<LocationTable> m_locationTable;
+  Ptr<MobilityModel> m_mobility;
+
+  Mode m_mode;
+  Time m_minInterval;
+  Time m_maxInterval;
+  double m_targetBusyRatio;
+  double m_positionThreshold;
+  uint32_t m_densityThreshold;
+  Time m_slotDuration;
+
+  TracedCallback<Ptr<const Packet> > m_beaconTrace;
+
+  uint32_t m_nDevices;
+  Time m_busyTime;
+  Time m_busyEnd;
+  Time m_measureStart;
+  Time m_lastBeacon;
+  Vector m_lastPosition;
+  bool m_slotted;
+  uint64_t m_slot;
+  /**
+  * Listeners registered on the phys, owned by the protocol. m_nDevices is the
+  * number of node devices already looked at for a wifi phy
+  */
+  typedef std::vector<std::pair<Ptr<WifiPhy>, BeaconingPhyListener *> > PhyListeners;
+  PhyListeners m_listeners;
+
+  /**
+  * Beacons waiting in each slot, keyed by the slot start time step, emptied
+  * on Simulator::Destroy
+  */
+  static SlotMap m_slots;
+  static bool m_slotsClearScheduled;
+
   /**
   * Schedules the transmission of beacons
   */
   void ScheduleBeaconSending ();
+
+  /**
+  * Adaptive mode: decides whether to beacon now and when to check again
+  */
+  void AdaptiveBeacon ();
+  Time ComputeAdaptiveInterval ();
+  void RegisterPhyListeners ();
+  void UnregisterPhyListeners ();
+  void ScheduleInSlot (Time delay);
+  void RemoveFromSlot ();
+  static void FireSlot (uint64_t slot);
+  static void ClearSlots ();
 };
 
 }; // namespace ns3
@@ -20,6 +20,7 @@
 
 #include "ns3/packet.h"
 #include "ns3/log.h"
+#include "ns3/profiler.h"
 #include "ns3/callback.h"
 #include "ns3/c2c-route.h"
 #include "ns3/socketc2c.h"
@@ -129,6 +130,14 @@ c2cL3Protocol::NotifyNewAggregate ()
           this->SetNode (node);
         }
     }
+  if (m_locationTable == 0)
+    {
+      m_locationTable = this->GetObject<LocationTable> ();
+    }
+  if (m_mobility == 0)
+    {
+      m_mobility = this->GetObject<ItetrisMobilityModel> ();
+    }
   Object::NotifyNewAggregate ();
 }
 
@@ -162,6 +171,8 @@ c2cL3Protocol::DoDispose (void)
     }
   m_interfaces.clear ();
   m_node = 0;
+  m_locationTable = 0;
+  m_mobility = 0;
   m_routingProtocol = 0;
   Object::DoDispose ();
 }
@@ -313,6 +324,7 @@ c2cL3Protocol::Receive (Ptr<NetDevice> device, Ptr<const Packet> p,
                         uint16_t protocol, const Address &from,
                         const Address &to, NetDevice::PacketType packetType)
 {
+  NS_PROFILE_SCOPE ("c2c-l3");
   NS_LOG_FUNCTION (this << &device << p << protocol <<  from);
   NS_LOG_LOGIC ("Packet from " << from << " received on node " <<
   m_node->GetId ());
@@ -362,9 +374,8 @@ c2cL3Protocol::Receive (Ptr<NetDevice> device, Ptr<const Packet> p,
 
   InsertNodeIdAddressMap (commonHeader.GetSourPosVector ().gnAddr, from); // Added by Ramon Bauza
 
-  Ptr <LocationTable> ltable = m_node->GetObject<LocationTable> ();
-  if (ltable != 0)
-  ltable ->AddPosEntry (commonHeader);
+  if (m_locationTable != 0)
+  m_locationTable->AddPosEntry (commonHeader);
 
    // Trim any residual frame padding from underlying devices
   if (commonHeader.GetLength() < packet->GetSize ())
@@ -383,12 +394,11 @@ c2cL3Protocol::Receive (Ptr<NetDevice> device, Ptr<const Packet> p,
   //
   c2cCommonHeader::ShortPositionVector m_posvector;
 
-  Ptr<ItetrisMobilityModel> model = m_node->GetObject<ItetrisMobilityModel> ();
   m_posvector.gnAddr = m_node->GetId ();
   //m_posvector.Lat = (uint32_t) model->GetPosition().x;
   //m_posvector.Long = (uint32_t) model->GetPosition().y;
-  m_posvector.Lat = model->GetLatitude();
-  m_posvector.Long = model->GetLongitude();
+  m_posvector.Lat = m_mobility->GetLatitude();
+  m_posvector.Long = m_mobility->GetLongitude();
   ///////////////////////////////////////////////  
   
   NS_ASSERT_MSG (m_routingProtocol != 0, "Need a routing protocol object to process packets");
@@ -405,6 +415,7 @@ c2cL3Protocol::Send (struct c2cRoutingProtocol::output routeresult,
                     uint16_t protocol, uint16_t htype,
                     uint8_t hstype, uint8_t tc)
 {
+  NS_PROFILE_SCOPE ("c2c-l3");
   NS_LOG_FUNCTION (this << routeresult.packet << uint32_t(protocol));
   ChannelTag channel;
   if (routeresult.packet->PeekPacketTag (channel))
@@ -468,6 +479,7 @@ void
 c2cL3Protocol::SendTo (struct c2cRoutingProtocol::output routeresult,
                     const c2cCommonHeader &header, uint8_t lt)
 {
+  NS_PROFILE_SCOPE ("c2c-l3");
   ChannelTag channel;
   if (routeresult.packet->PeekPacketTag (channel))
 	    {
@@ -555,14 +567,13 @@ c2cL3Protocol::BuildCommonHeader (Ptr<c2cAddress> addr, uint16_t protocol,
   //
   // Retrieving position information (latitude, longitude, altitude), heading and speed.
   struct c2cCommonHeader::LongPositionVector vector;
-  Ptr<ItetrisMobilityModel> model = m_node->GetObject<ItetrisMobilityModel> ();
   vector.gnAddr = m_node->GetId ();
   //vector.Lat = (uint32_t) model->GetPosition().x;
   //vector.Long = (uint32_t) model->GetPosition().y;
-  vector.Lat = model->GetLatitude();
-  vector.Long = model->GetLongitude();
+  vector.Lat = m_mobility->GetLatitude();
+  vector.Long = m_mobility->GetLongitude();
   vector.Alt = 0;
-  vector.Speed = (uint16_t) model->GetVelocity().x;
+  vector.Speed = (uint16_t) m_mobility->GetVelocity().x;
   vector.Ts = (static_cast<uint32_t>(Simulator::Now ().GetSeconds()));
   ///////////////////////////////////////////////      
 
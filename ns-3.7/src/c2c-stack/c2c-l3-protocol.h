@@ -47,6 +47,7 @@ class c2cRoute;
 class Node;
 class Socketc2c;
 class c2cL4Protocol;
+class ItetrisMobilityModel;
 
 /**
  * \brief  iTETRIS [WP600] - Implement of the c2c layer.
@@ -207,6 +208,9 @@ private:
   // End addition
 
   Ptr<Node> m_node;
+  // siblings looked up for every packet, found by NotifyNewAggregate
+  Ptr<LocationTable> m_locationTable;
+  Ptr<ItetrisMobilityModel> m_mobility;
   uint32_t m_nInterfaces;
   NetDeviceList m_devInterfaces;
   c2cInterfaceList m_interfaces;
@@ -83,7 +83,7 @@ AsciiWriter::WritePacket (enum Type type, std::string message, Ptr<const Packet>
     }
   NS_LOG_FUNCTION (this << typeString << message);
   *m_writer << typeString << " " << Simulator::Now ().GetSeconds () << " "
-            << message << " " << *packet << std::endl;
+            << message << " " << *packet << "\n";
 }
 
 } // namespace ns3
@@ -18,6 +18,7 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 #include "buffer.h"
+#include "packet-pool.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
 #include "ns3/fatal-error.h"
@@ -93,7 +94,6 @@ struct BufferData {
    */
   uint8_t m_data[1];
 };
-typedef std::vector<struct BufferData*> BufferDataList;
 
 static struct BufferData *BufferAllocate (uint32_t reqSize);
 
@@ -105,49 +105,17 @@ static void BufferDeallocate (struct BufferData *data);
 namespace ns3 {
 
 #ifdef BUFFER_HEURISTICS
-/* The following macros are pretty evil but they are needed to allow us to
- * keep track of 3 possible states for the g_freeList variable:
- *  - uninitialized means that no one has created a buffer yet
- *    so no one has created the associated free list (it is created
- *    on-demand when the first buffer is created)
- *  - initialized means that the free list exists and is valid
- *  - destroyed means that the static destructors of this compilation unit
- *    have run so, the free list has been cleared from its content
- * The key is that in destroyed state, we are careful not re-create it
- * which is a typical weakness of lazy evaluation schemes which use 
- * '0' as a special value to indicate both un-initialized and destroyed.
- * Note that it is important to use '0' as the marker for un-initialized state
- * because the variable holding this state information is initialized to zero
- * which the compiler assigns to zero-memory which is initialized to _zero_
- * before the constructors run so this ensures perfect handling of crazy 
- * constructor orderings.
- */
-#define MAGIC_DESTROYED (~(long) 0)
-#define IS_UNINITIALIZED(x) (x == (BufferDataList*)0)
-#define IS_DESTROYED(x) (x == (BufferDataList*)MAGIC_DESTROYED)
-#define IS_INITIALIZED(x) (!IS_UNINITIALIZED(x) && !IS_DESTROYED(x))
-#define DESTROYED ((BufferDataList*)MAGIC_DESTROYED)
-#define UNINITIALIZED ((BufferDataList*)0)
 static uint32_t g_recommendedStart = 0;
 static uint64_t g_nAddNoRealloc = 0;
 static uint64_t g_nAddRealloc = 0;
-static BufferDataList *g_freeList = 0;
-static uint32_t g_maxSize = 0;
-static uint64_t g_nAllocs = 0;
-static uint64_t g_nCreates = 0;
 #endif /* BUFFER_HEURISTICS */
 
+#ifdef PRINT_STATS
 static struct LocalStaticDestructor {
   LocalStaticDestructor(void)
   {
-#ifdef PRINT_STATS
 #ifdef BUFFER_HEURISTICS
-    double efficiency;
-    efficiency = g_nAllocs;
-    efficiency /= g_nCreates;
-    std::cout <<"buffer free list efficiency="<<efficiency<<" (lower is better)" << std::endl;
-    std::cout <<"buffer free list max size="<<g_maxSize<<std::endl;
-    std::cout <<"buffer free list recommended start="<<g_recommendedStart<<std::endl;
+    std::cout <<"buffer recommended start="<<g_recommendedStart<<std::endl;
     double addEfficiency;
     addEfficiency = g_nAddRealloc;
     addEfficiency /= g_nAddNoRealloc;
@@ -155,19 +123,12 @@ static struct LocalStaticDestructor {
     //std::cout <<"n add reallocs="<< g_nAddRealloc << std::endl;
     //std::cout <<"n add no reallocs="<< g_nAddNoRealloc << std::endl;
 #endif /* BUFFER_HEURISTICS */
-#endif /* PRINT_STATS */
-    if (IS_INITIALIZED(g_freeList))
-      {
-        for (BufferDataList::iterator i = g_freeList->begin ();
-             i != g_freeList->end (); i++)
-          {
-            BufferDeallocate (*i);
-          }
-        delete g_freeList;
-        g_freeList = DESTROYED;
-      }
+    std::cout <<"packet pool ";
+    PacketPool::PrintStats (std::cout);
+    std::cout << std::endl;
   }
 } g_localStaticDestructor;
+#endif /* PRINT_STATS */
 
 struct BufferData *
 BufferAllocate (uint32_t reqSize)
@@ -177,10 +138,13 @@ BufferAllocate (uint32_t reqSize)
       reqSize = 1;
     }
   NS_ASSERT (reqSize >= 1);
+  /* The pool rounds the request up to its size class: the extra
+   * bytes are made available to the buffer. */
   uint32_t size = reqSize - 1 + sizeof (struct BufferData);
-  uint8_t *b = new uint8_t [size];
+  uint32_t capacity;
+  uint8_t *b = static_cast<uint8_t *> (PacketPool::Allocate (size, &capacity));
   struct BufferData *data = reinterpret_cast<struct BufferData*>(b);
-  data->m_size = reqSize;
+  data->m_size = capacity + 1 - sizeof (struct BufferData);
   data->m_count = 1;
   return data;
 }
@@ -189,59 +153,9 @@ void
 BufferDeallocate (struct BufferData *data)
 {
   NS_ASSERT (data->m_count == 0);
-  uint8_t *buf = reinterpret_cast<uint8_t *> (data);
-  delete [] buf;
-}
-#ifdef BUFFER_HEURISTICS
-void
-Buffer::Recycle (struct BufferData *data)
-{
-  NS_ASSERT (data->m_count == 0);
-  NS_ASSERT (!IS_UNINITIALIZED(g_freeList));
-  g_maxSize = std::max (g_maxSize, data->m_size);
-  /* feed into free list */
-  if (data->m_size < g_maxSize ||
-      IS_DESTROYED(g_freeList) ||
-      g_freeList->size () > 1000)
-    {
-      BufferDeallocate (data);
-    }
-  else
-    {
-      NS_ASSERT (IS_INITIALIZED(g_freeList));
-      g_freeList->push_back (data);
-    }
+  PacketPool::Deallocate (data);
 }
 
-BufferData *
-Buffer::Create (uint32_t dataSize)
-{
-  /* try to find a buffer correctly sized. */
-  g_nCreates++;
-  if (IS_UNINITIALIZED(g_freeList))
-    {
-      g_freeList = new BufferDataList ();
-    }
-  else if (IS_INITIALIZED(g_freeList))
-    {
-      while (!g_freeList->empty ()) 
-        {
-          struct BufferData *data = g_freeList->back ();
-          g_freeList->pop_back ();
-          if (data->m_size >= dataSize) 
-            {
-              data->m_count = 1;
-              return data;
-            }
-          BufferDeallocate (data);
-        }
-    }
-  g_nAllocs++;
-  struct BufferData *data = BufferAllocate (dataSize);
-  NS_ASSERT (data->m_count == 1);
-  return data;
-}
-#else
 void
 Buffer::Recycle (struct BufferData *data)
 {
@@ -254,7 +168,6 @@ Buffer::Create (uint32_t size)
 {
   return BufferAllocate (size);
 }
-#endif
 
 Buffer::Buffer ()
 {
@@ -19,6 +19,7 @@
  */
 #include <utility>
 #include <list>
+#include <algorithm>
 #include "ns3/assert.h"
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
@@ -26,6 +27,7 @@
 #include "buffer.h"
 #include "header.h"
 #include "trailer.h"
+#include "packet-pool.h"
 
 NS_LOG_COMPONENT_DEFINE ("PacketMetadata");
 
@@ -36,16 +38,6 @@ bool PacketMetadata::m_enableChecking = false;
 bool PacketMetadata::m_metadataSkipped = false;
 uint32_t PacketMetadata::m_maxSize = 0;
 uint16_t PacketMetadata::m_chunkUid = 0;
-PacketMetadata::DataFreeList PacketMetadata::m_freeList;
-
-PacketMetadata::DataFreeList::~DataFreeList ()
-{
-  for (iterator i = begin (); i != end (); i++)
-    {
-      PacketMetadata::Deallocate (*i);
-    }
-  PacketMetadata::m_enable = false;
-}
 
 void 
 PacketMetadata::Enable (void)
@@ -525,19 +517,6 @@ PacketMetadata::Create (uint32_t size)
     {
       m_maxSize = size;
     }
-  while (!m_freeList.empty ()) 
-    {
-      struct PacketMetadata::Data *data = m_freeList.back ();
-      m_freeList.pop_back ();
-      if (data->m_size >= size) 
-        {
-          NS_LOG_LOGIC ("create found size="<<data->m_size);
-          data->m_count = 1;
-          return data;
-        }
-      PacketMetadata::Deallocate (data);
-      NS_LOG_LOGIC ("create dealloc size="<<data->m_size);
-    }
   NS_LOG_LOGIC ("create alloc size="<<m_maxSize);
   return PacketMetadata::Allocate (m_maxSize);
 }
@@ -545,22 +524,9 @@ PacketMetadata::Create (uint32_t size)
 void
 PacketMetadata::Recycle (struct PacketMetadata::Data *data)
 {
-  if (!m_enable)
-    {
-      PacketMetadata::Deallocate (data);
-      return;
-    } 
-  NS_LOG_LOGIC ("recycle size="<<data->m_size<<", list="<<m_freeList.size ());
+  NS_LOG_LOGIC ("recycle size="<<data->m_size);
   NS_ASSERT (data->m_count == 0);
-  if (m_freeList.size () > 1000 ||
-      data->m_size < m_maxSize) 
-    {
-      PacketMetadata::Deallocate (data);
-    } 
-  else 
-    {
-      m_freeList.push_back (data);
-    }
+  PacketMetadata::Deallocate (data);
 }
 
 struct PacketMetadata::Data *
@@ -572,9 +538,11 @@ PacketMetadata::Allocate (uint32_t n)
       n = 10;
     }
   size += n - 10;
-  uint8_t *buf = new uint8_t [size];
+  uint32_t capacity;
+  uint8_t *buf = static_cast<uint8_t *> (PacketPool::Allocate (size, &capacity));
   struct PacketMetadata::Data *data = (struct PacketMetadata::Data *)buf;
-  data->m_size = n;
+  // Use the whole block the pool handed out, within the 16 bit limit of m_size
+  data->m_size = std::min<uint32_t> (capacity - sizeof (struct Data) + 10, 0xffff);
   data->m_count = 1;
   data->m_dirtyEnd = 0;
   return data;
@@ -582,8 +550,7 @@ PacketMetadata::Allocate (uint32_t n)
 void 
 PacketMetadata::Deallocate (struct PacketMetadata::Data *data)
 {
-  uint8_t *buf = (uint8_t *)data;
-  delete [] buf;
+  PacketPool::Deallocate (data);
 }
 
 
@@ -236,13 +236,6 @@ private:
     uint32_t packetUid;
   };
 
-  class DataFreeList : public std::vector<struct Data *>
-  {
-  public:
-    ~DataFreeList ();
-  };
-
-  friend DataFreeList::~DataFreeList ();
   friend class ItemIterator;
 
   PacketMetadata ();
@@ -276,7 +269,6 @@ private:
   static struct PacketMetadata::Data *Allocate (uint32_t n);
   static void Deallocate (struct PacketMetadata::Data *data);
   
-  static DataFreeList m_freeList;
   static bool m_enable;
   static bool m_enableChecking;
 
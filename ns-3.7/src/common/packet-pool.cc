@@ -0,0 +1,273 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2009-2010, EU FP7 iTETRIS project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "packet-pool.h"
+#include "ns3/core-config.h"
+#include "ns3/assert.h"
+
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif
+
+#if defined (__GNUC__)
+#define PACKET_POOL_THREAD_LOCAL __thread
+#else
+#define PACKET_POOL_THREAD_LOCAL
+#endif
+
+namespace {
+
+/* The smallest size class holds 2^MIN_SHIFT bytes, the biggest one 2^MAX_SHIFT */
+const uint32_t MIN_SHIFT = 4;
+const uint32_t MAX_SHIFT = 13;
+const uint32_t N_CLASSES = MAX_SHIFT - MIN_SHIFT + 1;
+/* Size class recorded in the header of the blocks which bypass the pool */
+const uint32_t HEAP_CLASS = N_CLASSES;
+/* Each free list keeps at most this many bytes, and at least MIN_POOLED blocks */
+const uint32_t MAX_POOLED_BYTES = 1 << 20;
+const uint32_t MIN_POOLED = 64;
+
+/* Prepended to every block. The union keeps the user area aligned. */
+union BlockHeader
+{
+  uint32_t sizeClass;
+  double alignDouble;
+  uint64_t alignInt;
+  void *alignPointer;
+};
+
+struct FreeBlock
+{
+  struct FreeBlock *next;
+};
+
+/* Plain old data only, so that it can live in thread-local storage and
+ * be zero-initialized before any constructor runs. */
+struct PoolState
+{
+  struct FreeBlock *freeList[N_CLASSES];
+  uint32_t nFree[N_CLASSES];
+  struct ns3::PacketPool::Stats stats;
+  /* set once the static destructors of this compilation unit ran, or
+   * once the thread exits: blocks released afterwards go straight back
+   * to the heap. */
+  bool destroyed;
+  /* set once the pool is purged at the exit of the thread */
+  bool purgedAtExit;
+};
+
+PACKET_POOL_THREAD_LOCAL struct PoolState g_pool;
+
+inline uint32_t
+SizeClass (uint32_t size)
+{
+  uint32_t sizeClass = 0;
+  uint32_t classSize = 1 << MIN_SHIFT;
+  while (classSize < size && sizeClass < N_CLASSES)
+    {
+      classSize <<= 1;
+      sizeClass++;
+    }
+  return sizeClass;
+}
+
+inline uint32_t
+ClassSize (uint32_t sizeClass)
+{
+  return 1 << (sizeClass + MIN_SHIFT);
+}
+
+inline uint32_t
+MaxPooled (uint32_t sizeClass)
+{
+  uint32_t n = MAX_POOLED_BYTES / ClassSize (sizeClass);
+  return n < MIN_POOLED ? MIN_POOLED : n;
+}
+
+inline uint8_t *
+HeapAllocate (uint32_t sizeClass, uint32_t size)
+{
+  uint8_t *buffer = new uint8_t [sizeof (union BlockHeader) + size];
+  reinterpret_cast<union BlockHeader *> (buffer)->sizeClass = sizeClass;
+  return buffer;
+}
+
+inline void
+HeapDeallocate (union BlockHeader *header)
+{
+  delete [] reinterpret_cast<uint8_t *> (header);
+}
+
+void
+DestroyPool (void)
+{
+  ns3::PacketPool::Purge ();
+  g_pool.destroyed = true;
+}
+
+/* The static destructor below only runs in the main thread: the pools of
+ * the other threads are purged when they exit. */
+static struct PoolDestructor
+{
+  ~PoolDestructor ()
+  {
+    DestroyPool ();
+  }
+} g_poolDestructor;
+
+#ifdef HAVE_PTHREAD_H
+pthread_key_t g_poolKey;
+pthread_once_t g_poolKeyOnce = PTHREAD_ONCE_INIT;
+
+void
+DestroyThreadPool (void *)
+{
+  DestroyPool ();
+}
+
+void
+CreatePoolKey (void)
+{
+  pthread_key_create (&g_poolKey, &DestroyThreadPool);
+}
+#endif /* HAVE_PTHREAD_H */
+
+/* A thread only pools blocks it allocated from the heap first, so it is
+ * enough to check this on the heap allocations. */
+inline void
+PurgeAtThreadExit (struct PoolState &pool)
+{
+#ifdef HAVE_PTHREAD_H
+  if (!pool.purgedAtExit)
+    {
+      pthread_once (&g_poolKeyOnce, &CreatePoolKey);
+      pthread_setspecific (g_poolKey, &pool);
+      pool.purgedAtExit = true;
+    }
+#endif /* HAVE_PTHREAD_H */
+}
+
+} // anonymous namespace
+
+namespace ns3 {
+
+void *
+PacketPool::Allocate (uint32_t size, uint32_t *capacity)
+{
+  struct PoolState &pool = g_pool;
+  pool.stats.allocations++;
+  uint32_t sizeClass = SizeClass (size);
+  uint8_t *buffer;
+  if (sizeClass == HEAP_CLASS)
+    {
+      buffer = HeapAllocate (HEAP_CLASS, size);
+    }
+  else if (pool.freeList[sizeClass] != 0)
+    {
+      struct FreeBlock *block = pool.freeList[sizeClass];
+      pool.freeList[sizeClass] = block->next;
+      pool.nFree[sizeClass]--;
+      pool.stats.pooledBlocks--;
+      pool.stats.poolHits++;
+      buffer = reinterpret_cast<uint8_t *> (block) - sizeof (union BlockHeader);
+      NS_ASSERT (reinterpret_cast<union BlockHeader *> (buffer)->sizeClass == sizeClass);
+    }
+  else
+    {
+      PurgeAtThreadExit (pool);
+      size = ClassSize (sizeClass);
+      buffer = HeapAllocate (sizeClass, size);
+    }
+  if (capacity != 0)
+    {
+      *capacity = sizeClass == HEAP_CLASS ? size : ClassSize (sizeClass);
+    }
+  return buffer + sizeof (union BlockHeader);
+}
+
+void
+PacketPool::Deallocate (void *block)
+{
+  if (block == 0)
+    {
+      return;
+    }
+  struct PoolState &pool = g_pool;
+  pool.stats.deallocations++;
+  union BlockHeader *header = reinterpret_cast<union BlockHeader *> (static_cast<uint8_t *> (block) - sizeof (union BlockHeader));
+  uint32_t sizeClass = header->sizeClass;
+  NS_ASSERT (sizeClass <= HEAP_CLASS);
+  if (sizeClass == HEAP_CLASS || pool.destroyed || pool.nFree[sizeClass] >= MaxPooled (sizeClass))
+    {
+      pool.stats.heapReleases++;
+      HeapDeallocate (header);
+      return;
+    }
+  struct FreeBlock *freeBlock = static_cast<struct FreeBlock *> (block);
+  freeBlock->next = pool.freeList[sizeClass];
+  pool.freeList[sizeClass] = freeBlock;
+  pool.nFree[sizeClass]++;
+  pool.stats.pooledBlocks++;
+}
+
+struct PacketPool::Stats
+PacketPool::GetStats (void)
+{
+  return g_pool.stats;
+}
+
+void
+PacketPool::ResetStats (void)
+{
+  uint64_t pooledBlocks = g_pool.stats.pooledBlocks;
+  g_pool.stats.allocations = 0;
+  g_pool.stats.poolHits = 0;
+  g_pool.stats.deallocations = 0;
+  g_pool.stats.heapReleases = 0;
+  g_pool.stats.pooledBlocks = pooledBlocks;
+}
+
+void
+PacketPool::PrintStats (std::ostream &os)
+{
+  struct Stats stats = GetStats ();
+  os << "allocations=" << stats.allocations
+     << " pool-hits=" << stats.poolHits
+     << " heap-allocations=" << stats.allocations - stats.poolHits
+     << " deallocations=" << stats.deallocations
+     << " heap-releases=" << stats.heapReleases
+     << " pooled=" << stats.pooledBlocks;
+}
+
+void
+PacketPool::Purge (void)
+{
+  struct PoolState &pool = g_pool;
+  for (uint32_t i = 0; i < N_CLASSES; i++)
+    {
+      while (pool.freeList[i] != 0)
+        {
+          struct FreeBlock *block = pool.freeList[i];
+          pool.freeList[i] = block->next;
+          HeapDeallocate (reinterpret_cast<union BlockHeader *> (reinterpret_cast<uint8_t *> (block) - sizeof (union BlockHeader)));
+        }
+      pool.nFree[i] = 0;
+    }
+  pool.stats.pooledBlocks = 0;
+}
+
+} // namespace ns3
@@ -0,0 +1,91 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2009-2010, EU FP7 iTETRIS project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef PACKET_POOL_H
+#define PACKET_POOL_H
+
+#include <stdint.h>
+#include <ostream>
+
+namespace ns3 {
+
+/**
+ * \ingroup packet
+ *
+ * \brief thread-local pooled allocator for the packet internals
+ *
+ * Buffer::Data, ByteTagList data, PacketTagList nodes and
+ * PacketMetadata items are allocated from here. Requests are rounded
+ * up to a power of two size class and freed blocks are kept in one
+ * free list per size class and per thread, so that copying a packet
+ * for every receiver of a broadcast does not hit the heap once the
+ * pools are warm. Blocks larger than the biggest size class go
+ * directly to the heap.
+ *
+ * A block can be released by any code running in the thread which
+ * allocated it only.
+ *
+ * The pooled blocks of a thread go back to the heap when the thread
+ * exits, and those of the main thread when the program ends.
+ */
+class PacketPool
+{
+public:
+  /**
+   * Allocation counters of the calling thread.
+   */
+  struct Stats
+  {
+    /* number of calls to Allocate */
+    uint64_t allocations;
+    /* number of allocations served from a free list */
+    uint64_t poolHits;
+    /* number of calls to Deallocate */
+    uint64_t deallocations;
+    /* number of blocks returned to the heap */
+    uint64_t heapReleases;
+    /* number of blocks currently sitting in the free lists */
+    uint64_t pooledBlocks;
+  };
+
+  /**
+   * \param size the minimum number of bytes needed
+   * \param capacity if not null, set to the number of usable
+   *        bytes of the returned block, which is at least size
+   * \returns a block of memory suitably aligned for any type
+   */
+  static void *Allocate (uint32_t size, uint32_t *capacity = 0);
+  /**
+   * \param block a block returned by Allocate, or null
+   */
+  static void Deallocate (void *block);
+
+  /**
+   * \returns the allocation counters of the calling thread
+   */
+  static struct Stats GetStats (void);
+  static void ResetStats (void);
+  static void PrintStats (std::ostream &os);
+  /**
+   * Return all the pooled blocks of the calling thread to the heap.
+   */
+  static void Purge (void);
+};
+
+} // namespace ns3
+
+#endif /* PACKET_POOL_H */
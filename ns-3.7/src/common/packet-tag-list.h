@@ -64,9 +64,6 @@ private:
   struct PacketTagList::TagData *AllocData (void) const;
   void FreeData (struct TagData *data) const;
 
-  static struct PacketTagList::TagData *g_free;
-  static uint32_t g_nfree;
-
   struct TagData *m_next;
 };
 
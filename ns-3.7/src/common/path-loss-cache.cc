@@ -0,0 +1,140 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2009-2010, EU FP7 iTETRIS project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "path-loss-cache.h"
+#include "ns3/mobility-model.h"
+#include "ns3/assert.h"
+
+namespace ns3 {
+
+PathLossCache::PathLossCache ()
+{}
+
+PathLossCache::~PathLossCache ()
+{
+  Clear ();
+}
+
+void
+PathLossCache::SetReference (Ptr<MobilityModel> reference)
+{
+  if (reference == m_reference)
+    {
+      return;
+    }
+  if (m_reference != 0)
+    {
+      m_reference->TraceDisconnectWithoutContext ("CourseChange", MakeCallback (&PathLossCache::CourseChanged, this));
+    }
+  m_reference = reference;
+  if (m_reference != 0)
+    {
+      m_reference->TraceConnectWithoutContext ("CourseChange", MakeCallback (&PathLossCache::CourseChanged, this));
+    }
+  for (EntryMap::iterator i = m_entries.begin (); i != m_entries.end (); i++)
+    {
+      Invalidate (i->second);
+    }
+}
+
+bool
+PathLossCache::Lookup (Ptr<MobilityModel> mobility, uint8_t link, double *loss) const
+{
+  NS_ASSERT (link < MAX_LINKS);
+  EntryMap::const_iterator i = m_entries.find (PeekPointer (mobility));
+  if (i == m_entries.end () || !i->second.valid[link])
+    {
+      return false;
+    }
+  *loss = i->second.loss[link];
+  return true;
+}
+
+void
+PathLossCache::Add (Ptr<MobilityModel> mobility, uint8_t link, double loss)
+{
+  NS_ASSERT (link < MAX_LINKS);
+  EntryMap::iterator i = m_entries.find (PeekPointer (mobility));
+  if (i == m_entries.end ())
+    {
+      // the entry keeps the model alive, so that its address is not
+      // reused by another one while it is in the map
+      struct Entry entry;
+      entry.mobility = mobility;
+      Invalidate (entry);
+      i = m_entries.insert (std::make_pair (PeekPointer (mobility), entry)).first;
+      mobility->TraceConnectWithoutContext ("CourseChange", MakeCallback (&PathLossCache::CourseChanged, this));
+    }
+  i->second.valid[link] = true;
+  i->second.loss[link] = loss;
+}
+
+void
+PathLossCache::Remove (Ptr<MobilityModel> mobility)
+{
+  EntryMap::iterator i = m_entries.find (PeekPointer (mobility));
+  if (i != m_entries.end ())
+    {
+      mobility->TraceDisconnectWithoutContext ("CourseChange", MakeCallback (&PathLossCache::CourseChanged, this));
+      m_entries.erase (i);
+    }
+}
+
+void
+PathLossCache::Clear (void)
+{
+  for (EntryMap::iterator i = m_entries.begin (); i != m_entries.end (); i++)
+    {
+      i->second.mobility->TraceDisconnectWithoutContext ("CourseChange", MakeCallback (&PathLossCache::CourseChanged, this));
+    }
+  m_entries.clear ();
+  if (m_reference != 0)
+    {
+      m_reference->TraceDisconnectWithoutContext ("CourseChange", MakeCallback (&PathLossCache::CourseChanged, this));
+      m_reference = 0;
+    }
+}
+
+void
+PathLossCache::CourseChanged (Ptr<const MobilityModel> mobility)
+{
+  if (mobility == m_reference)
+    {
+      for (EntryMap::iterator i = m_entries.begin (); i != m_entries.end (); i++)
+        {
+          Invalidate (i->second);
+        }
+      return;
+    }
+  EntryMap::iterator i = m_entries.find (PeekPointer (mobility));
+  if (i != m_entries.end ())
+    {
+      Invalidate (i->second);
+    }
+}
+
+void
+PathLossCache::Invalidate (struct Entry &entry)
+{
+  for (uint8_t link = 0; link < MAX_LINKS; link++)
+    {
+      entry.valid[link] = false;
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,105 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2009-2010, EU FP7 iTETRIS project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PATH_LOSS_CACHE_H
+#define PATH_LOSS_CACHE_H
+
+#include <stdint.h>
+#include <map>
+#include "ns3/ptr.h"
+
+namespace ns3 {
+
+class MobilityModel;
+
+/**
+ * \brief path loss between a base station and each of its terminals,
+ *        kept until one of them moves
+ *
+ * The losses are stored per mobility model of the terminals, and per
+ * link (e.g., uplink and downlink when they do not use the same
+ * shadowing). The entries of a terminal are invalidated by the
+ * CourseChange trace of its mobility model, and all the entries by the
+ * one of the base station. The mobility models must thus notify all the
+ * changes of position, as ItetrisMobilityModel does whenever iCS
+ * updates a vehicle.
+ *
+ * The other parameters of the loss (frequency, antenna heights, ...)
+ * are assumed to be constant for each terminal.
+ */
+class PathLossCache
+{
+public:
+  enum {
+    MAX_LINKS = 2
+  };
+
+  PathLossCache ();
+  ~PathLossCache ();
+
+  /**
+   * \param reference mobility of the base station
+   *
+   * All the losses are invalidated when the base station changes.
+   */
+  void SetReference (Ptr<MobilityModel> reference);
+
+  /**
+   * \param mobility mobility of the terminal
+   * \param link index of the link, below MAX_LINKS
+   * \param loss the loss, when found
+   * \returns true if the loss is known
+   */
+  bool Lookup (Ptr<MobilityModel> mobility, uint8_t link, double *loss) const;
+
+  /**
+   * \param mobility mobility of the terminal
+   * \param link index of the link, below MAX_LINKS
+   * \param loss loss at the current positions
+   */
+  void Add (Ptr<MobilityModel> mobility, uint8_t link, double loss);
+
+  /**
+   * \param mobility mobility of a terminal leaving the channel
+   */
+  void Remove (Ptr<MobilityModel> mobility);
+
+  /**
+   * Forget all the losses and stop following the mobility models.
+   */
+  void Clear (void);
+
+private:
+  struct Entry
+  {
+    Ptr<MobilityModel> mobility;
+    bool valid[MAX_LINKS];
+    double loss[MAX_LINKS];
+  };
+  typedef std::map<const MobilityModel *, struct Entry> EntryMap;
+
+  void CourseChanged (Ptr<const MobilityModel> mobility);
+  void Invalidate (struct Entry &entry);
+
+  EntryMap m_entries;
+  Ptr<MobilityModel> m_reference;
+};
+
+} // namespace ns3
+
+#endif /* PATH_LOSS_CACHE_H */
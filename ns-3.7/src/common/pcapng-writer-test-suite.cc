@@ -0,0 +1,274 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2009-2010, EU FP7 iTETRIS project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/pcapng-writer.h"
+#include "ns3/packet.h"
+
+using namespace ns3;
+
+// ===========================================================================
+// A pcapng file read back in memory, block by block.
+// ===========================================================================
+class PcapNgReader
+{
+public:
+  bool Load (std::string filename)
+  {
+    FILE *f = fopen (filename.c_str (), "rb");
+    if (f == 0)
+      {
+        return false;
+      }
+    uint8_t buffer[4096];
+    size_t read;
+    while ((read = fread (buffer, 1, sizeof (buffer), f)) > 0)
+      {
+        m_data.insert (m_data.end (), buffer, buffer + read);
+      }
+    fclose (f);
+    m_offset = 0;
+    return true;
+  }
+
+  bool AtEnd (void) const
+  {
+    return m_offset >= m_data.size ();
+  }
+
+  /**
+   * Start the next block: returns its type and leaves its length in
+   * length. The body is read with Read32, Read16 and ReadBytes.
+   */
+  uint32_t StartBlock (uint32_t &length)
+  {
+    m_block = m_offset;
+    uint32_t type = Read32 ();
+    length = Read32 ();
+    return type;
+  }
+
+  /**
+   * \returns the length repeated at the end of the current block, which
+   *          is left.
+   */
+  uint32_t EndBlock (uint32_t length)
+  {
+    m_offset = m_block + length - 4;
+    return Read32 ();
+  }
+
+  uint32_t Read32 (void)
+  {
+    uint32_t value = 0;
+    if (m_offset + 4 <= m_data.size ())
+      {
+        value = m_data[m_offset] | (m_data[m_offset + 1] << 8)
+          | (m_data[m_offset + 2] << 16) | (m_data[m_offset + 3] << 24);
+      }
+    m_offset += 4;
+    return value;
+  }
+
+  uint16_t Read16 (void)
+  {
+    uint16_t value = 0;
+    if (m_offset + 2 <= m_data.size ())
+      {
+        value = m_data[m_offset] | (m_data[m_offset + 1] << 8);
+      }
+    m_offset += 2;
+    return value;
+  }
+
+  std::string ReadBytes (uint32_t size, uint32_t padTo)
+  {
+    std::string value;
+    if (m_offset + size <= m_data.size ())
+      {
+        value.assign ((char const *)&m_data[m_offset], size);
+      }
+    m_offset += size + (padTo - size % padTo) % padTo;
+    return value;
+  }
+
+private:
+  std::vector<uint8_t> m_data;
+  uint32_t m_offset;
+  uint32_t m_block;
+};
+
+// ===========================================================================
+// Test case to make sure that the section header, interface description
+// and enhanced packet blocks of a PcapNgWriter parse back.
+// ===========================================================================
+class PcapNgBlocksTestCase : public TestCase
+{
+public:
+  PcapNgBlocksTestCase ();
+  virtual ~PcapNgBlocksTestCase ();
+
+private:
+  virtual void DoSetup (void);
+  virtual bool DoRun (void);
+  virtual void DoTeardown (void);
+
+  void CheckInterface (PcapNgReader &reader, uint16_t linkType, uint32_t captureSize, std::string name);
+  void CheckPacket (PcapNgReader &reader, uint32_t interface, uint64_t ns, std::string data,
+                    uint32_t size, uint32_t direction);
+
+  std::string m_testFilename;
+};
+
+PcapNgBlocksTestCase::PcapNgBlocksTestCase ()
+  : TestCase ("Check the blocks written by PcapNgWriter")
+{
+}
+
+PcapNgBlocksTestCase::~PcapNgBlocksTestCase ()
+{
+}
+
+void
+PcapNgBlocksTestCase::DoSetup (void)
+{
+  std::stringstream filename;
+  uint32_t n = rand ();
+  filename << n;
+  m_testFilename = GetTempDir () + filename.str () + ".pcapng";
+}
+
+void
+PcapNgBlocksTestCase::DoTeardown (void)
+{
+  remove (m_testFilename.c_str ());
+}
+
+void
+PcapNgBlocksTestCase::CheckInterface (PcapNgReader &reader, uint16_t linkType, uint32_t captureSize, std::string name)
+{
+  uint32_t length;
+  NS_TEST_EXPECT_MSG_EQ (reader.StartBlock (length), 1, "Expected an interface description block");
+  NS_TEST_EXPECT_MSG_EQ (reader.Read16 (), linkType, "Wrong link type");
+  reader.Read16 ();
+  NS_TEST_EXPECT_MSG_EQ (reader.Read32 (), captureSize, "Wrong snap length");
+  // if_name
+  NS_TEST_EXPECT_MSG_EQ (reader.Read16 (), 2, "Expected the if_name option");
+  uint16_t nameLength = reader.Read16 ();
+  NS_TEST_EXPECT_MSG_EQ (reader.ReadBytes (nameLength, 4), name, "Wrong interface name");
+  // if_tsresol
+  NS_TEST_EXPECT_MSG_EQ (reader.Read16 (), 9, "Expected the if_tsresol option");
+  NS_TEST_EXPECT_MSG_EQ (reader.Read16 (), 1, "Wrong if_tsresol length");
+  NS_TEST_EXPECT_MSG_EQ (reader.ReadBytes (1, 4), std::string (1, 9), "The timestamps are not in nanoseconds");
+  // opt_endofopt
+  NS_TEST_EXPECT_MSG_EQ (reader.Read32 (), 0, "Expected the end of the options");
+  NS_TEST_EXPECT_MSG_EQ (reader.EndBlock (length), length, "The block lengths differ");
+}
+
+void
+PcapNgBlocksTestCase::CheckPacket (PcapNgReader &reader, uint32_t interface, uint64_t ns, std::string data,
+                                   uint32_t size, uint32_t direction)
+{
+  uint32_t length;
+  NS_TEST_EXPECT_MSG_EQ (reader.StartBlock (length), 6, "Expected an enhanced packet block");
+  NS_TEST_EXPECT_MSG_EQ (reader.Read32 (), interface, "Wrong interface");
+  uint64_t timestamp = reader.Read32 ();
+  timestamp = (timestamp << 32) | reader.Read32 ();
+  NS_TEST_EXPECT_MSG_EQ (timestamp, ns, "Wrong timestamp");
+  NS_TEST_EXPECT_MSG_EQ (reader.Read32 (), data.size (), "Wrong captured length");
+  NS_TEST_EXPECT_MSG_EQ (reader.Read32 (), size, "Wrong packet length");
+  NS_TEST_EXPECT_MSG_EQ (reader.ReadBytes (data.size (), 4), data, "Wrong packet data");
+  // epb_flags
+  NS_TEST_EXPECT_MSG_EQ (reader.Read16 (), 2, "Expected the epb_flags option");
+  NS_TEST_EXPECT_MSG_EQ (reader.Read16 (), 4, "Wrong epb_flags length");
+  NS_TEST_EXPECT_MSG_EQ (reader.Read32 (), direction, "Wrong direction");
+  NS_TEST_EXPECT_MSG_EQ (reader.Read32 (), 0, "Expected the end of the options");
+  NS_TEST_EXPECT_MSG_EQ (reader.EndBlock (length), length, "The block lengths differ");
+}
+
+static void
+WritePacket (Ptr<PcapNgWriter> writer, uint32_t interface, std::string data, PcapNgWriter::Direction direction)
+{
+  Ptr<Packet> packet = Create<Packet> ((uint8_t const *)data.data (), data.size ());
+  writer->WritePacket (interface, packet, direction);
+}
+
+bool
+PcapNgBlocksTestCase::DoRun (void)
+{
+  Ptr<PcapNgWriter> writer = CreateObject<PcapNgWriter> ();
+  writer->SetAttribute ("BackgroundWriter", BooleanValue (false));
+  writer->SetAttribute ("CaptureSize", UintegerValue (8));
+  // a buffer smaller than a packet hands every block over at once
+  writer->SetAttribute ("BufferSize", UintegerValue (16));
+  writer->Open (m_testFilename);
+  uint32_t cch = writer->AddInterface (PcapNgWriter::LINKTYPE_IEEE802_11, "node0-dev0");
+  uint32_t sch = writer->AddInterface (PcapNgWriter::LINKTYPE_IEEE802_11, "node12-dev1");
+  NS_TEST_EXPECT_MSG_EQ (cch, 0, "Wrong index of the first interface");
+  NS_TEST_EXPECT_MSG_EQ (sch, 1, "Wrong index of the second interface");
+
+  Simulator::Schedule (Seconds (1.5), &WritePacket, writer, cch, std::string ("CAM"), PcapNgWriter::DIRECTION_OUTBOUND);
+  Simulator::Schedule (NanoSeconds (5000000001ULL), &WritePacket, writer, sch, std::string ("0123456789"), PcapNgWriter::DIRECTION_INBOUND);
+  Simulator::Run ();
+  writer->Close ();
+  Simulator::Destroy ();
+
+  PcapNgReader reader;
+  NS_TEST_ASSERT_MSG_EQ (reader.Load (m_testFilename), true, "Cannot read " << m_testFilename);
+
+  // section header block
+  uint32_t length;
+  NS_TEST_EXPECT_MSG_EQ (reader.StartBlock (length), 0x0a0d0d0a, "Expected a section header block");
+  NS_TEST_EXPECT_MSG_EQ (length, 28, "Wrong section header length");
+  NS_TEST_EXPECT_MSG_EQ (reader.Read32 (), 0x1a2b3c4d, "Wrong byte-order magic");
+  NS_TEST_EXPECT_MSG_EQ (reader.Read16 (), 1, "Wrong major version");
+  NS_TEST_EXPECT_MSG_EQ (reader.Read16 (), 0, "Wrong minor version");
+  NS_TEST_EXPECT_MSG_EQ (reader.EndBlock (length), length, "The block lengths differ");
+
+  CheckInterface (reader, 105, 8, "node0-dev0");
+  CheckInterface (reader, 105, 8, "node12-dev1");
+  CheckPacket (reader, 0, 1500000000ULL, "CAM", 3, PcapNgWriter::DIRECTION_OUTBOUND);
+  // truncated to the capture size
+  CheckPacket (reader, 1, 5000000001ULL, "01234567", 10, PcapNgWriter::DIRECTION_INBOUND);
+  NS_TEST_EXPECT_MSG_EQ (reader.AtEnd (), true, "Unexpected data after the last block");
+
+  return GetErrorStatus ();
+}
+
+class PcapNgWriterTestSuite : public TestSuite
+{
+public:
+  PcapNgWriterTestSuite ();
+};
+
+PcapNgWriterTestSuite::PcapNgWriterTestSuite ()
+  : TestSuite ("pcapng-writer", UNIT)
+{
+  AddTestCase (new PcapNgBlocksTestCase);
+}
+
+PcapNgWriterTestSuite pcapNgWriterTestSuite;
@@ -0,0 +1,440 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2009-2010, EU FP7 iTETRIS project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <stdio.h>
+#include <deque>
+
+#include "ns3/core-config.h"
+#include "ns3/common-config.h"
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/abort.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "pcapng-writer.h"
+#include "packet.h"
+
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#include "ns3/system-mutex.h"
+#include "ns3/system-condition.h"
+#endif
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+NS_LOG_COMPONENT_DEFINE ("PcapNgWriter");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (PcapNgWriter);
+
+enum {
+  PCAPNG_SECTION_HEADER_BLOCK = 0x0a0d0d0a,
+  PCAPNG_INTERFACE_DESCRIPTION_BLOCK = 1,
+  PCAPNG_ENHANCED_PACKET_BLOCK = 6,
+  PCAPNG_BYTE_ORDER_MAGIC = 0x1a2b3c4d,
+  PCAPNG_OPT_ENDOFOPT = 0,
+  PCAPNG_OPT_IF_NAME = 2,
+  PCAPNG_OPT_IF_TSRESOL = 9,
+  PCAPNG_OPT_EPB_FLAGS = 2
+};
+
+static uint32_t
+PadTo32 (uint32_t size)
+{
+  return (size + 3) & ~3;
+}
+
+/**
+ * File, or gzip stream, the buffers of a PcapNgWriter go to. With
+ * threads, the buffers are queued and written by a thread of their own
+ * so that the simulation does not wait for the disk or the compression.
+ */
+class PcapNgOutput
+{
+public:
+  PcapNgOutput (std::string const &name, bool compress, bool background);
+  ~PcapNgOutput ();
+
+  /**
+   * Take the content of the buffer, which is left empty.
+   */
+  void Write (std::vector<uint8_t> &buffer);
+
+private:
+  void WriteNow (std::vector<uint8_t> const &buffer);
+
+  FILE *m_file;
+#ifdef HAVE_ZLIB
+  gzFile m_gzFile;
+#endif
+#ifdef HAVE_PTHREAD_H
+  void Run (void);
+
+  // buffers waiting for the thread; the simulation waits beyond this
+  static const uint32_t MAX_PENDING = 8;
+  // the conditions of SystemCondition can be missed, so never wait longer
+  static const uint64_t WAKEUP_NS = 10000000;
+
+  Ptr<SystemThread> m_thread;
+  SystemMutex m_mutex;
+  SystemCondition m_ready;
+  SystemCondition m_drained;
+  std::deque<std::vector<uint8_t> *> m_pending;
+  bool m_stop;
+#endif
+};
+
+PcapNgOutput::PcapNgOutput (std::string const &name, bool compress, bool background)
+  : m_file (0)
+{
+#ifdef HAVE_ZLIB
+  m_gzFile = 0;
+  if (compress)
+    {
+      m_gzFile = gzopen (name.c_str (), "wb");
+      NS_ABORT_MSG_IF (m_gzFile == 0, "PcapNgWriter::Open(): gzopen(" << name << ") failed");
+    }
+  else
+#else
+  NS_ABORT_MSG_IF (compress, "PcapNgWriter::Open(): compression needs ns-3 to be configured with zlib");
+#endif
+    {
+      m_file = fopen (name.c_str (), "wb");
+      NS_ABORT_MSG_IF (m_file == 0, "PcapNgWriter::Open(): fopen(" << name << ") failed");
+    }
+#ifdef HAVE_PTHREAD_H
+  m_stop = false;
+  if (background)
+    {
+      m_thread = Create<SystemThread> (MakeCallback (&PcapNgOutput::Run, this));
+      m_thread->Start ();
+    }
+#endif
+}
+
+PcapNgOutput::~PcapNgOutput ()
+{
+#ifdef HAVE_PTHREAD_H
+  if (m_thread != 0)
+    {
+      m_mutex.Lock ();
+      m_stop = true;
+      m_mutex.Unlock ();
+      m_ready.SetCondition (true);
+      m_ready.Signal ();
+      m_thread->Join ();
+      m_thread = 0;
+    }
+#endif
+#ifdef HAVE_ZLIB
+  if (m_gzFile != 0)
+    {
+      gzclose (m_gzFile);
+    }
+#endif
+  if (m_file != 0)
+    {
+      fclose (m_file);
+    }
+}
+
+void
+PcapNgOutput::Write (std::vector<uint8_t> &buffer)
+{
+#ifdef HAVE_PTHREAD_H
+  if (m_thread != 0)
+    {
+      std::vector<uint8_t> *pending = new std::vector<uint8_t> ();
+      pending->swap (buffer);
+      m_mutex.Lock ();
+      while (m_pending.size () >= MAX_PENDING)
+        {
+          m_mutex.Unlock ();
+          m_drained.TimedWait (WAKEUP_NS);
+          m_mutex.Lock ();
+        }
+      m_pending.push_back (pending);
+      m_mutex.Unlock ();
+      m_ready.SetCondition (true);
+      m_ready.Signal ();
+      return;
+    }
+#endif
+  WriteNow (buffer);
+  buffer.clear ();
+}
+
+void
+PcapNgOutput::WriteNow (std::vector<uint8_t> const &buffer)
+{
+  if (buffer.empty ())
+    {
+      return;
+    }
+#ifdef HAVE_ZLIB
+  if (m_gzFile != 0)
+    {
+      gzwrite (m_gzFile, &buffer[0], buffer.size ());
+      return;
+    }
+#endif
+  fwrite (&buffer[0], 1, buffer.size (), m_file);
+}
+
+#ifdef HAVE_PTHREAD_H
+void
+PcapNgOutput::Run (void)
+{
+  while (true)
+    {
+      std::vector<uint8_t> *buffer = 0;
+      m_mutex.Lock ();
+      if (!m_pending.empty ())
+        {
+          buffer = m_pending.front ();
+          m_pending.pop_front ();
+        }
+      bool stop = m_stop;
+      m_mutex.Unlock ();
+
+      if (buffer != 0)
+        {
+          WriteNow (*buffer);
+          delete buffer;
+          m_drained.SetCondition (true);
+          m_drained.Signal ();
+        }
+      else if (stop)
+        {
+          return;
+        }
+      else
+        {
+          m_ready.TimedWait (WAKEUP_NS);
+        }
+    }
+}
+#endif
+
+TypeId
+PcapNgWriter::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::PcapNgWriter")
+    .SetParent<Object> ()
+    .AddConstructor<PcapNgWriter> ()
+    .AddAttribute ("CaptureSize",
+                   "Number of bytes to capture at the start of each packet written in the pcapng file. Zero means capture all bytes.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&PcapNgWriter::m_captureSize),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("BufferSize",
+                   "Number of bytes kept in memory before they are handed over to the file.",
+                   UintegerValue (1 << 20),
+                   MakeUintegerAccessor (&PcapNgWriter::m_bufferSize),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("Compress",
+                   "Write a gzip-compressed file. Needs ns-3 to be configured with zlib.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PcapNgWriter::m_compress),
+                   MakeBooleanChecker ())
+    .AddAttribute ("BackgroundWriter",
+                   "Write and compress the buffers in a thread of their own, when threads are available.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&PcapNgWriter::m_backgroundWriter),
+                   MakeBooleanChecker ())
+    ;
+  return tid;
+}
+
+PcapNgWriter::PcapNgWriter ()
+  : m_output (0),
+    m_nInterfaces (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+PcapNgWriter::~PcapNgWriter ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+void
+PcapNgWriter::Open (std::string const &name)
+{
+  NS_LOG_FUNCTION (this << name);
+  NS_ABORT_MSG_UNLESS (m_output == 0, "PcapNgWriter::Open(): already open");
+
+  m_output = new PcapNgOutput (name, m_compress, m_backgroundWriter);
+  m_buffer.reserve (m_bufferSize);
+  m_nInterfaces = 0;
+
+  WriteBlockStart (PCAPNG_SECTION_HEADER_BLOCK, 28);
+  Write32 (PCAPNG_BYTE_ORDER_MAGIC);
+  Write16 (1);
+  Write16 (0);
+  // unknown section length
+  Write32 (0xffffffff);
+  Write32 (0xffffffff);
+  Write32 (28);
+}
+
+uint32_t
+PcapNgWriter::AddInterface (enum LinkType linkType, std::string const &name)
+{
+  NS_LOG_FUNCTION (this << linkType << name);
+  NS_ASSERT_MSG (m_output != 0, "PcapNgWriter::AddInterface(): not open");
+
+  uint16_t nameLength = std::min<uint32_t> (name.size (), 0xfff0);
+  uint32_t length = 20 + 4 + PadTo32 (nameLength) + 4 + 4 + 4;
+  WriteBlockStart (PCAPNG_INTERFACE_DESCRIPTION_BLOCK, length);
+  Write16 (linkType);
+  Write16 (0);
+  Write32 (m_captureSize);
+  WriteOption (PCAPNG_OPT_IF_NAME, (uint8_t const *)name.data (), nameLength);
+  // the timestamps are in nanoseconds
+  uint8_t resolution = 9;
+  WriteOption (PCAPNG_OPT_IF_TSRESOL, &resolution, 1);
+  WriteOption (PCAPNG_OPT_ENDOFOPT, 0, 0);
+  Write32 (length);
+  return m_nInterfaces++;
+}
+
+void
+PcapNgWriter::WritePacket (uint32_t interface, Ptr<const Packet> packet, enum Direction direction)
+{
+  if (m_output == 0)
+    {
+      return;
+    }
+  NS_ASSERT (interface < m_nInterfaces);
+
+  uint32_t size = packet->GetSize ();
+  uint32_t captureSize = size;
+  if (m_captureSize != 0)
+    {
+      captureSize = std::min (m_captureSize, size);
+    }
+  uint32_t length = 32 + PadTo32 (captureSize);
+  if (direction != DIRECTION_UNKNOWN)
+    {
+      length += 8 + 4;
+    }
+
+  uint64_t now = Simulator::Now ().GetNanoSeconds ();
+  WriteBlockStart (PCAPNG_ENHANCED_PACKET_BLOCK, length);
+  Write32 (interface);
+  Write32 (now >> 32);
+  Write32 (now & 0xffffffff);
+  Write32 (captureSize);
+  Write32 (size);
+  uint32_t start = m_buffer.size ();
+  m_buffer.resize (start + captureSize);
+  packet->CopyData (&m_buffer[start], captureSize);
+  WritePadding (PadTo32 (captureSize) - captureSize);
+  if (direction != DIRECTION_UNKNOWN)
+    {
+      uint8_t flags[4] = {direction, 0, 0, 0};
+      WriteOption (PCAPNG_OPT_EPB_FLAGS, flags, 4);
+      WriteOption (PCAPNG_OPT_ENDOFOPT, 0, 0);
+    }
+  Write32 (length);
+
+  if (m_buffer.size () >= m_bufferSize)
+    {
+      Flush ();
+    }
+}
+
+void
+PcapNgWriter::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_output != 0)
+    {
+      m_output->Write (m_buffer);
+      m_buffer.reserve (m_bufferSize);
+    }
+}
+
+void
+PcapNgWriter::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_output != 0)
+    {
+      Flush ();
+      delete m_output;
+      m_output = 0;
+    }
+}
+
+void
+PcapNgWriter::WriteBlockStart (uint32_t type, uint32_t length)
+{
+  Write32 (type);
+  Write32 (length);
+}
+
+void
+PcapNgWriter::WriteOption (uint16_t code, uint8_t const *value, uint16_t length)
+{
+  Write16 (code);
+  Write16 (length);
+  WriteData (value, length);
+  WritePadding (PadTo32 (length) - length);
+}
+
+void
+PcapNgWriter::WriteData (uint8_t const *buffer, uint32_t size)
+{
+  m_buffer.insert (m_buffer.end (), buffer, buffer + size);
+}
+
+void
+PcapNgWriter::WritePadding (uint32_t size)
+{
+  m_buffer.insert (m_buffer.end (), size, 0);
+}
+
+// the blocks are written in little endian, as told by the byte-order magic
+void
+PcapNgWriter::Write32 (uint32_t data)
+{
+  uint8_t buffer[4];
+  buffer[0] = (data >> 0) & 0xff;
+  buffer[1] = (data >> 8) & 0xff;
+  buffer[2] = (data >> 16) & 0xff;
+  buffer[3] = (data >> 24) & 0xff;
+  WriteData (buffer, 4);
+}
+
+void
+PcapNgWriter::Write16 (uint16_t data)
+{
+  uint8_t buffer[2];
+  buffer[0] = (data >> 0) & 0xff;
+  buffer[1] = (data >> 8) & 0xff;
+  WriteData (buffer, 2);
+}
+
+} // namespace ns3
@@ -0,0 +1,117 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2009-2010, EU FP7 iTETRIS project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PCAPNG_WRITER_H
+#define PCAPNG_WRITER_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "ns3/object.h"
+
+namespace ns3 {
+
+class Packet;
+class PcapNgOutput;
+
+/**
+ * \ingroup common
+ *
+ * \brief pcapng output of many interfaces to a single file
+ *
+ * Unlike PcapWriter, which needs one file per device, all the traced
+ * devices are interfaces of the same pcapng file (see
+ * http://www.winpcap.org/ntar/draft/PCAP-DumpFileFormat.html). The
+ * blocks are built in memory and written BufferSize bytes at a time,
+ * by a background thread when threads are available, and optionally
+ * gzip-compressed when ns-3 was configured with zlib.
+ */
+class PcapNgWriter : public Object
+{
+public:
+  static TypeId GetTypeId (void);
+  PcapNgWriter ();
+  ~PcapNgWriter ();
+
+  enum LinkType {
+    LINKTYPE_ETHERNET = 1,
+    LINKTYPE_PPP = 9,
+    LINKTYPE_RAW_IP = 101,
+    LINKTYPE_IEEE802_11 = 105
+  };
+
+  enum Direction {
+    DIRECTION_UNKNOWN = 0,
+    DIRECTION_INBOUND = 1,
+    DIRECTION_OUTBOUND = 2
+  };
+
+  /**
+   * \param name the name of the file to store the packets into.
+   *
+   * This method creates the file if it does not exist. If it
+   * exists, the file is emptied.
+   */
+  void Open (std::string const &name);
+
+  /**
+   * \param linkType link layer of the packets of the interface
+   * \param name name of the interface shown by the pcapng readers
+   * \returns the index of the interface, to be given to WritePacket
+   */
+  uint32_t AddInterface (enum LinkType linkType, std::string const &name);
+
+  /**
+   * \param interface index returned by AddInterface
+   * \param packet packet to write to output file
+   * \param direction whether the interface sent or received the packet
+   */
+  void WritePacket (uint32_t interface, Ptr<const Packet> packet, enum Direction direction);
+
+  /**
+   * Hand the buffered blocks over to the output. They reach the file
+   * later when the output has its own thread.
+   */
+  void Flush (void);
+
+  /**
+   * Write all the buffered blocks and close the file. This is also
+   * done by the destructor.
+   */
+  void Close (void);
+
+private:
+  void WriteBlockStart (uint32_t type, uint32_t length);
+  void WriteOption (uint16_t code, uint8_t const *value, uint16_t length);
+  void WriteData (uint8_t const *buffer, uint32_t size);
+  void WritePadding (uint32_t size);
+  void Write32 (uint32_t data);
+  void Write16 (uint16_t data);
+
+  PcapNgOutput *m_output;
+  std::vector<uint8_t> m_buffer;
+  uint32_t m_nInterfaces;
+  uint32_t m_captureSize;
+  uint32_t m_bufferSize;
+  bool m_compress;
+  bool m_backgroundWriter;
+};
+
+} // namespace ns3
+
+#endif /* PCAPNG_WRITER_H */
@@ -0,0 +1,129 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2009-2010, EU FP7 iTETRIS project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <math.h>
+#include <algorithm>
+#include "ns3/assert.h"
+#include "step-table.h"
+
+namespace ns3 {
+
+// bound on the size of the grid, for breakpoints very close to each other
+static const uint32_t MAX_CELLS = 4096;
+
+StepTable::StepTable ()
+  : m_above (0),
+    m_logScale (false),
+    m_start (0),
+    m_cellsPerUnit (0)
+{}
+
+void
+StepTable::Set (const double *x, const double *y, uint32_t n, double above, bool logScale)
+{
+  NS_ASSERT (n > 0);
+  m_x.assign (x, x + n);
+  m_y.assign (y, y + n);
+  m_above = above;
+  m_logScale = logScale;
+
+  std::vector<double> u (n);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      NS_ASSERT (i == 0 || x[i] > x[i - 1]);
+      NS_ASSERT (!logScale || x[i] > 0);
+      u[i] = logScale ? log10 (x[i]) : x[i];
+    }
+  m_start = u[0];
+
+  // cells no wider than the closest breakpoints hold at most one of them
+  uint32_t cells = 1;
+  m_cellsPerUnit = 0;
+  if (n > 1)
+    {
+      double minGap = u[n - 1] - u[0];
+      for (uint32_t i = 1; i < n; i++)
+        {
+          minGap = std::min (minGap, u[i] - u[i - 1]);
+        }
+      cells = (uint32_t) std::min (ceil ((u[n - 1] - u[0]) / minGap), (double) MAX_CELLS);
+      cells = std::max (cells, (uint32_t) 1);
+      m_cellsPerUnit = cells / (u[n - 1] - u[0]);
+    }
+
+  m_first.resize (cells);
+  uint32_t below = 0;
+  for (uint32_t c = 0; c < cells; c++)
+    {
+      double cellStart = m_start + (c > 0 ? c / m_cellsPerUnit : 0);
+      while (below < n && u[below] < cellStart)
+        {
+          below++;
+        }
+      // one breakpoint of slack for the rounding of the cell bounds
+      m_first[c] = below > 0 ? below - 1 : 0;
+    }
+}
+
+uint32_t
+StepTable::FirstCandidate (double x) const
+{
+  double u = x;
+  if (m_logScale)
+    {
+      if (!(x > 0))
+        {
+          return 0;
+        }
+      u = log10 (x);
+    }
+  // also true for NaN, which then ends up above the table as with a scan
+  if (!(u > m_start))
+    {
+      return 0;
+    }
+  double cell = (u - m_start) * m_cellsPerUnit;
+  if (cell >= m_first.size ())
+    {
+      return m_first.back ();
+    }
+  return m_first[(uint32_t) cell];
+}
+
+double
+StepTable::Lookup (double x) const
+{
+  uint32_t n = m_x.size ();
+  uint32_t i = FirstCandidate (x);
+  while (i < n && !(m_x[i] > x))
+    {
+      i++;
+    }
+  return i < n ? m_y[i] : m_above;
+}
+
+void
+StepTable::Lookup (const double *x, double *y, uint32_t n) const
+{
+  for (uint32_t i = 0; i < n; i++)
+    {
+      y[i] = Lookup (x[i]);
+    }
+}
+
+} // namespace ns3
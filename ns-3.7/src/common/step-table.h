@@ -0,0 +1,80 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2009-2010, EU FP7 iTETRIS project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef STEP_TABLE_H
+#define STEP_TABLE_H
+
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup common
+ *
+ * \brief step function of a table, looked up in constant time
+ *
+ * The value at x is y[i] for the first breakpoint x[i] greater than x,
+ * as in the BLER and PER tables of the UMTS and DVB-H models. A uniform
+ * grid over the breakpoints, built once, gives the first candidate
+ * breakpoint of each cell, so that a lookup does not scan the table.
+ */
+class StepTable
+{
+public:
+  StepTable ();
+
+  /**
+   * \param x increasing breakpoints
+   * \param y value of each breakpoint, used below it
+   * \param n number of breakpoints
+   * \param above value at and above the last breakpoint
+   * \param logScale build the grid over log10(x), for breakpoints
+   *        spread over several decades. x must then be positive.
+   */
+  void Set (const double *x, const double *y, uint32_t n, double above, bool logScale);
+
+  /**
+   * \param x position
+   * \returns value of the table at x
+   */
+  double Lookup (double x) const;
+
+  /**
+   * \param x positions
+   * \param y values of the table at the positions
+   * \param n number of positions
+   */
+  void Lookup (const double *x, double *y, uint32_t n) const;
+
+private:
+  uint32_t FirstCandidate (double x) const;
+
+  std::vector<double> m_x;
+  std::vector<double> m_y;
+  double m_above;
+  bool m_logScale;
+  double m_start;
+  double m_cellsPerUnit;
+  // first breakpoint that can be above a position of each cell
+  std::vector<uint32_t> m_first;
+};
+
+} // namespace ns3
+
+#endif /* STEP_TABLE_H */
@@ -41,6 +41,21 @@ namespace ns3 {
 
 NS_OBJECT_ENSURE_REGISTERED (Object);
 
+/**
+ * The results of the recent lookups in an aggregate, a direct-mapped
+ * table indexed by the uid of the TypeId looked up. The uids are
+ * small dense integers so the types looked up in the same aggregate
+ * seldom collide. A null object records a failed lookup.
+ */
+struct Object::LookupCache
+{
+  enum {
+    SIZE = 16
+  };
+  uint16_t uid[SIZE];
+  Object *object[SIZE];
+};
+
 Object::AggregateIterator::AggregateIterator ()
   : m_object (0),
     m_current (0)
@@ -88,6 +103,7 @@ Object::Object ()
     m_getObjectCount (0)
 {
   m_aggregates->n = 1;
+  m_aggregates->cache = 0;
   m_aggregates->buffer[0] = this;
 }
 Object::~Object () 
@@ -105,6 +121,12 @@ Object::~Object ()
           m_aggregates->n--;
         }
     }
+  // the cached lookups could point to this object
+  if (m_aggregates->cache != 0)
+    {
+      free (m_aggregates->cache);
+      m_aggregates->cache = 0;
+    }
   // finally, if all objects have been removed from the list,
   // delete the aggregate list
   if (m_aggregates->n == 0)
@@ -121,6 +143,7 @@ Object::Object (const Object &o)
     m_getObjectCount (0)
 {
   m_aggregates->n = 1;
+  m_aggregates->cache = 0;
   m_aggregates->buffer[0] = this;
 }
 void
@@ -135,6 +158,36 @@ Object::DoGetObject (TypeId tid) const
   NS_ASSERT (CheckLoose ());
 
   uint32_t n = m_aggregates->n;
+  struct LookupCache *cache = m_aggregates->cache;
+  uint16_t uid = tid.GetUid ();
+  uint32_t slot = uid % LookupCache::SIZE;
+  if (cache != 0 && cache->uid[slot] == uid)
+    {
+      Object *cached = cache->object[slot];
+      if (cached != 0)
+        {
+          // keep the access counts, hence the order of the aggregate
+          // GetObject relies on, as if the lookup had walked the array
+          for (uint32_t i = 0; i < n; i++)
+            {
+              if (m_aggregates->buffer[i] == cached)
+                {
+                  cached->m_getObjectCount++;
+                  UpdateSortedArray (m_aggregates, i);
+                  break;
+                }
+            }
+        }
+      return cached;
+    }
+  if (cache == 0 && n > 1)
+    {
+      // the walk below is short enough for a single object
+      cache = (struct LookupCache *)malloc (sizeof (struct LookupCache));
+      memset (cache, 0, sizeof (struct LookupCache));
+      m_aggregates->cache = cache;
+    }
+
   TypeId objectTid = Object::GetTypeId ();
   for (uint32_t i = 0; i < n; i++)
     {
@@ -156,10 +209,21 @@ Object::DoGetObject (TypeId tid) const
           current->m_getObjectCount++;
           // then, update the sort
           UpdateSortedArray (m_aggregates, i);
+          // remember the match for the next lookups of this type
+          if (cache != 0)
+            {
+              cache->uid[slot] = uid;
+              cache->object[slot] = current;
+            }
           // finally, return the match
           return const_cast<Object *> (current);
         }
     }
+  if (cache != 0)
+    {
+      cache->uid[slot] = uid;
+      cache->object[slot] = 0;
+    }
   return 0;
 }
 void
@@ -243,6 +307,8 @@ Object::AggregateObject (Ptr<Object> o)
   struct Aggregates *aggregates = 
     (struct Aggregates *)malloc (sizeof(struct Aggregates)+(total-1)*sizeof(Object*));
   aggregates->n = total;
+  // the lookups cached in the old buffers are not valid anymore
+  aggregates->cache = 0;
 
   // copy our buffer to the new buffer
   memcpy (&aggregates->buffer[0], 
@@ -286,7 +352,9 @@ Object::AggregateObject (Ptr<Object> o)
     }
 
   // Now that we are done with them, we can free our old aggregate buffers
+  free (a->cache);
   free (a);
+  free (b->cache);
   free (b);
 }
 /**
@@ -706,6 +774,57 @@ AggregateObjectTestCase::DoRun (void)
   return GetErrorStatus ();
 }
 
+// ===========================================================================
+// Test case to make sure that the cached lookups follow the aggregations.
+// ===========================================================================
+class CachedGetObjectTestCase : public TestCase
+{
+public:
+  CachedGetObjectTestCase ();
+  virtual ~CachedGetObjectTestCase ();
+
+private:
+  virtual bool DoRun (void);
+};
+
+CachedGetObjectTestCase::CachedGetObjectTestCase ()
+  : TestCase ("Check the cached GetObject lookups")
+{
+}
+
+CachedGetObjectTestCase::~CachedGetObjectTestCase ()
+{
+}
+
+bool
+CachedGetObjectTestCase::DoRun (void)
+{
+  Ptr<BaseA> baseA = CreateObject<BaseA> ();
+  Ptr<BaseB> baseB = CreateObject<BaseB> ();
+  baseA->AggregateObject (baseB);
+
+  //
+  // Look up each type twice, the second lookup hits the cache.
+  //
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<BaseB> (), baseB, "GetObject (through baseA) returns a different BaseB");
+      NS_TEST_ASSERT_MSG_EQ (baseB->GetObject<BaseA> (), baseA, "GetObject (through baseB) returns a different BaseA");
+      NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<DerivedB> (), 0, "Unexpectedly found a DerivedB through baseA");
+    }
+
+  //
+  // The failed lookup of a DerivedB must not hide the one aggregated now.
+  //
+  Ptr<DerivedB> derivedB = CreateObject<DerivedB> ();
+  baseA->AggregateObject (derivedB);
+  NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<DerivedB> (), derivedB, "Cannot GetObject (through baseA) for the new DerivedB");
+  NS_TEST_ASSERT_MSG_EQ (baseB->GetObject<DerivedB> (), derivedB, "Cannot GetObject (through baseB) for the new DerivedB");
+  NS_TEST_ASSERT_MSG_EQ (derivedB->GetObject<BaseA> (), baseA, "GetObject (through derivedB) returns a different BaseA");
+
+  return GetErrorStatus ();
+}
+
 // ===========================================================================
 // Test case to make sure that an Object factory can create Objects
 // ===========================================================================
@@ -794,6 +913,7 @@ ObjectTestSuite::ObjectTestSuite ()
 {
   AddTestCase (new CreateObjectTestCase);
   AddTestCase (new AggregateObjectTestCase);
+  AddTestCase (new CachedGetObjectTestCase);
   AddTestCase (new ObjectFactoryTestCase);
 }
 
@@ -240,9 +240,15 @@ private:
    * chunk of memory than the struct to allow space for a larger
    * variable sized buffer whose size is indicated by the element
    * 'n'
+   *
+   * 'cache' holds the results of the recent lookups of DoGetObject
+   * in the aggregate. It is allocated on the first lookup in an
+   * aggregate of more than one object.
    */
+  struct LookupCache;
   struct Aggregates {
     uint32_t n;
+    struct LookupCache *cache;
     Object *buffer[1];
   };
 
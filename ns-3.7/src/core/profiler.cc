@@ -0,0 +1,157 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2009-2010, EU FP7 iTETRIS project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "profiler.h"
+#include "fatal-error.h"
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include <time.h>
+#include <sys/time.h>
+
+namespace ns3 {
+
+namespace {
+
+std::vector<ProfileCounter *> *
+GetCounters (void)
+{
+  static std::vector<ProfileCounter *> counters;
+  return &counters;
+}
+
+std::ofstream *
+GetOutput (void)
+{
+  static std::ofstream output;
+  return &output;
+}
+
+} // anonymous namespace
+
+ProfileCounter::ProfileCounter (std::string name)
+  : m_name (name),
+    m_calls (0),
+    m_nanoseconds (0)
+{}
+
+std::string
+ProfileCounter::GetName (void) const
+{
+  return m_name;
+}
+
+uint64_t
+ProfileCounter::GetCalls (void) const
+{
+  return m_calls;
+}
+
+uint64_t
+ProfileCounter::GetNanoseconds (void) const
+{
+  return m_nanoseconds;
+}
+
+void
+ProfileCounter::Reset (void)
+{
+  m_calls = 0;
+  m_nanoseconds = 0;
+}
+
+ProfileCounter *
+Profiler::GetCounter (std::string module)
+{
+  std::vector<ProfileCounter *> *counters = GetCounters ();
+  for (std::vector<ProfileCounter *>::const_iterator i = counters->begin (); i != counters->end (); i++)
+    {
+      if ((*i)->GetName () == module)
+        {
+          return *i;
+        }
+    }
+  // never deleted: the call sites keep the pointer in a static variable
+  ProfileCounter *counter = new ProfileCounter (module);
+  counters->push_back (counter);
+  return counter;
+}
+
+uint64_t
+Profiler::Now (void)
+{
+#ifdef CLOCK_MONOTONIC
+  struct timespec now;
+  clock_gettime (CLOCK_MONOTONIC, &now);
+  return now.tv_sec * 1000000000ULL + now.tv_nsec;
+#else
+  struct timeval now;
+  gettimeofday (&now, 0);
+  return now.tv_sec * 1000000000ULL + now.tv_usec * 1000ULL;
+#endif
+}
+
+void
+Profiler::SetOutput (std::string filename)
+{
+  std::ofstream *output = GetOutput ();
+  if (output->is_open ())
+    {
+      output->close ();
+    }
+  if (filename.empty ())
+    {
+      return;
+    }
+#ifndef NS3_PROFILE_ENABLE
+  std::cerr << "Profiler: the profiling hooks are not compiled in, "
+            << "configure with --enable-profiling to fill " << filename << std::endl;
+#endif
+  output->open (filename.c_str ());
+  if (!output->is_open ())
+    {
+      NS_FATAL_ERROR ("Could not open the profiling report " << filename);
+    }
+  *output << "time,module,calls,milliseconds" << std::endl;
+}
+
+void
+Profiler::EndStep (double time)
+{
+  std::ofstream *output = GetOutput ();
+  std::vector<ProfileCounter *> *counters = GetCounters ();
+  for (std::vector<ProfileCounter *>::const_iterator i = counters->begin (); i != counters->end (); i++)
+    {
+      if ((*i)->GetCalls () == 0)
+        {
+          continue;
+        }
+      if (output->is_open ())
+        {
+          *output << time << "," << (*i)->GetName () << "," << (*i)->GetCalls ()
+                  << "," << (*i)->GetNanoseconds () / 1000000.0 << "\n";
+        }
+      (*i)->Reset ();
+    }
+  if (output->is_open ())
+    {
+      output->flush ();
+    }
+}
+
+} // namespace ns3
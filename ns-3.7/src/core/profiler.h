@@ -0,0 +1,190 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2009-2010, EU FP7 iTETRIS project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdint.h>
+#include <string>
+
+/**
+ * \ingroup core
+ * \defgroup profiling Profiling
+ *
+ * Scoped timers and counters for the hot paths of the simulator, added
+ * up per module and reported once per iCS simulation step.
+ *
+ * The hooks are only compiled in when NS3_PROFILE_ENABLE is defined,
+ * i.e., with "./waf configure --enable-profiling". Otherwise all the
+ * NS_PROFILE_* macros expand to nothing.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup profiling
+ * \brief calls and wall clock time spent in one module since the
+ *        last simulation step
+ */
+class ProfileCounter
+{
+public:
+  ProfileCounter (std::string name);
+
+  std::string GetName (void) const;
+  uint64_t GetCalls (void) const;
+  uint64_t GetNanoseconds (void) const;
+
+  /**
+   * \param nanoseconds time spent in one call
+   */
+  void Record (uint64_t nanoseconds)
+  {
+    m_calls++;
+    m_nanoseconds += nanoseconds;
+  }
+  /**
+   * \param n number of events to count, without time
+   */
+  void Count (uint64_t n)
+  {
+    m_calls += n;
+  }
+  void Reset (void);
+
+private:
+  std::string m_name;
+  uint64_t m_calls;
+  uint64_t m_nanoseconds;
+};
+
+/**
+ * \ingroup profiling
+ * \brief time the lifetime of the object into a counter
+ *
+ * The time is inclusive: a scope nested in another one is also
+ * counted by the outer one.
+ */
+class ProfileScope
+{
+public:
+  ProfileScope (ProfileCounter *counter);
+  ~ProfileScope ();
+
+private:
+  ProfileCounter *m_counter;
+  uint64_t m_start;
+};
+
+/**
+ * \ingroup profiling
+ * \brief registry of the counters and per-step CSV report
+ */
+class Profiler
+{
+public:
+  /**
+   * \param module name of the module
+   * \returns the counter of the module, created on first use
+   *
+   * All the calls with the same name share the counter.
+   */
+  static ProfileCounter *GetCounter (std::string module);
+  /**
+   * \returns a monotonic wall clock time, in nanoseconds
+   */
+  static uint64_t Now (void);
+  /**
+   * \param filename file the report is written to
+   *
+   * Without a file, the counters are still reset at the end of each step
+   * but nothing is reported.
+   */
+  static void SetOutput (std::string filename);
+  /**
+   * \param time simulation time of the step that just finished
+   *
+   * Write a "time,module,calls,milliseconds" line for each module used
+   * since the previous step, and reset the counters.
+   */
+  static void EndStep (double time);
+};
+
+inline
+ProfileScope::ProfileScope (ProfileCounter *counter)
+  : m_counter (counter),
+    m_start (Profiler::Now ())
+{}
+
+inline
+ProfileScope::~ProfileScope ()
+{
+  m_counter->Record (Profiler::Now () - m_start);
+}
+
+} // namespace ns3
+
+#define NS_PROFILE_CONCAT2(a, b) a##b
+#define NS_PROFILE_CONCAT(a, b) NS_PROFILE_CONCAT2 (a, b)
+
+#ifdef NS3_PROFILE_ENABLE
+
+/**
+ * \ingroup profiling
+ * \param module name of the module, a string constant
+ *
+ * Time the rest of the enclosing block into the counter of the module.
+ * The counter is looked up only once per call site.
+ */
+#define NS_PROFILE_SCOPE(module)                                        \
+  static ns3::ProfileCounter *NS_PROFILE_CONCAT (ns3_profile_counter_, __LINE__) = \
+    ns3::Profiler::GetCounter (module);                                 \
+  ns3::ProfileScope NS_PROFILE_CONCAT (ns3_profile_scope_, __LINE__)   \
+    (NS_PROFILE_CONCAT (ns3_profile_counter_, __LINE__))
+
+/**
+ * \ingroup profiling
+ * \param module name of the module, a string constant
+ *
+ * Count one event in the counter of the module, without timing it.
+ */
+#define NS_PROFILE_COUNT(module)                                        \
+  do {                                                                  \
+      static ns3::ProfileCounter *ns3_profile_counter =                 \
+        ns3::Profiler::GetCounter (module);                             \
+      ns3_profile_counter->Count (1);                                   \
+  } while (false)
+
+/**
+ * \ingroup profiling
+ * \param time simulation time of the step that just finished
+ *
+ * Report and reset the counters, see Profiler::EndStep.
+ */
+#define NS_PROFILE_STEP(time)                   \
+  ns3::Profiler::EndStep (time)
+
+#else /* NS3_PROFILE_ENABLE */
+
+#define NS_PROFILE_SCOPE(module)
+#define NS_PROFILE_COUNT(module)
+#define NS_PROFILE_STEP(time)
+
+#endif /* NS3_PROFILE_ENABLE */
+
+#endif /* PROFILER_H */
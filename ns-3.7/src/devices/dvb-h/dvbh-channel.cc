@@ -200,6 +200,7 @@ DVBHChannel::RemoveUserEquip (Ptr<DVBHOfdmLayer> node)
         {
           if ((*i)->GetIdentifier () == node->GetIdentifier ())
             {
+              m_pathLoss.Remove ((*i)->GetMobility ());
               m_nodeUEList.erase (i);
             }
         }
@@ -213,8 +214,14 @@ DVBHChannel::CalculateRxPowerFromBaseStation (Ptr<DVBHOfdmLayer> destinationOfdm
 
   txpower = m_ofdmLayer->GetTxPower () + m_ofdmLayer->GetAntennaGain () + destinationOfdmLayer->GetAntennaGain ();
     
-  double loss = ReturnCost231Loss (m_ofdmLayer->GetMobility (),destinationOfdmLayer->GetMobility (),m_ofdmLayer->GetLambda (),m_ofdmLayer->GetShadowing (),m_ofdmLayer->GetMinDistance ()/1000,
-                                   m_ofdmLayer->GetAntennaHeight (),destinationOfdmLayer->GetAntennaHeight ());
+  double loss;
+  m_pathLoss.SetReference (m_ofdmLayer->GetMobility ());
+  if (!m_pathLoss.Lookup (destinationOfdmLayer->GetMobility (), 0, &loss))
+    {
+      loss = ReturnCost231Loss (m_ofdmLayer->GetMobility (),destinationOfdmLayer->GetMobility (),m_ofdmLayer->GetLambda (),m_ofdmLayer->GetShadowing (),m_ofdmLayer->GetMinDistance ()/1000,
+                                m_ofdmLayer->GetAntennaHeight (),destinationOfdmLayer->GetAntennaHeight ());
+      m_pathLoss.Add (destinationOfdmLayer->GetMobility (), 0, loss);
+    }
         
   return txpower + loss+m_ofdmLayer->GetAntennaGain()+destinationOfdmLayer->GetAntennaGain();
 }
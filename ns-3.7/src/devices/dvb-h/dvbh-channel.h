@@ -31,6 +31,7 @@
 #include "dvbh-phy-layer-BaseStation.h"
 #include "ns3/net-device.h"
 #include "ns3/cost231_model.h"
+#include "ns3/path-loss-cache.h"
 
 namespace ns3 {
 
@@ -83,6 +84,8 @@ public:
 
 private:
   Ptr<Cost231Propagation> m_costPropagationModel;
+  // Cost231 losses of the user equipments, until they or the base station move
+  PathLossCache m_pathLoss;
   typedef std::list< Ptr<DVBHOfdmLayer> > UserEquipList;
   UserEquipList m_nodeUEList;
   
@@ -0,0 +1,118 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2009-2010, EU FP7 iTETRIS project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <math.h>
+#include <vector>
+#include "ns3/test.h"
+#include "dvbh-ip-per.h"
+
+using namespace ns3;
+
+// ===========================================================================
+// The table lookups must give the same PER as the linear scans they
+// replaced, including at the Eb/No of the tables themselves.
+// ===========================================================================
+//
+static double
+ScanPer (const double *x, const double *y, int n, double ebno)
+{
+  double per = 0.0001;
+  for (int i = n - 1; i > -1; i--)
+    {
+      if (x[i] > ebno)
+        {
+          per = y[i];
+        }
+    }
+  return per;
+}
+
+class DvbhIpPerTestCase : public TestCase
+{
+public:
+  DvbhIpPerTestCase ();
+  virtual ~DvbhIpPerTestCase ();
+
+private:
+  virtual bool DoRun (void);
+};
+
+DvbhIpPerTestCase::DvbhIpPerTestCase ()
+  : TestCase ("Check that the DVB-H PER table lookups give the PER of the tables")
+{
+}
+
+DvbhIpPerTestCase::~DvbhIpPerTestCase ()
+{
+}
+
+bool
+DvbhIpPerTestCase::DoRun (void)
+{
+  Ptr<DvbhIpPer> per = CreateObject<DvbhIpPer> ();
+
+  NS_TEST_EXPECT_MSG_EQ (per->GetIpPer (5, 0), 0.4, "Got unexpected PER below the table");
+  NS_TEST_EXPECT_MSG_EQ (per->GetIpPer (16, 0), 0.012, "Got unexpected PER at an Eb/No of the table");
+  NS_TEST_EXPECT_MSG_EQ (per->GetIpPer (10.8, 2), 0.75, "Got unexpected PER inside the table");
+  NS_TEST_EXPECT_MSG_EQ (per->GetIpPer (30, 3), 0.0001, "Got unexpected PER above the table");
+  NS_TEST_EXPECT_MSG_EQ (per->GetIpPer (12, 4), 0.0001, "Got unexpected PER of an unknown table");
+
+  const double *x[4] = {DvbhIpPer::QpskTable1_2[0], DvbhIpPer::QpskTable3_4[0], DvbhIpPer::QamTable1_2[0], DvbhIpPer::QamTable3_4[0]};
+  const double *y[4] = {DvbhIpPer::QpskTable1_2[1], DvbhIpPer::QpskTable3_4[1], DvbhIpPer::QamTable1_2[1], DvbhIpPer::QamTable3_4[1]};
+  int n[4] = {11, 11, 14, 15};
+
+  for (uint8_t type = 0; type < 4; type++)
+    {
+      std::vector<double> ebno;
+      for (int i = 0; i < n[type]; i++)
+        {
+          ebno.push_back (x[type][i]);
+          ebno.push_back (nextafter (x[type][i], 0));
+          ebno.push_back (nextafter (x[type][i], 100));
+        }
+      for (double e = -10; e < 40; e += 0.01)
+        {
+          ebno.push_back (e);
+        }
+
+      std::vector<double> result (ebno.size ());
+      per->GetIpPer (&ebno[0], &result[0], ebno.size (), type);
+      for (uint32_t i = 0; i < ebno.size (); i++)
+        {
+          double expected = ScanPer (x[type], y[type], n[type], ebno[i]);
+          NS_TEST_EXPECT_MSG_EQ (per->GetIpPer (ebno[i], type), expected, "Got unexpected PER for Eb/No " << ebno[i] << " in table " << (int) type);
+          NS_TEST_EXPECT_MSG_EQ (result[i], expected, "Got unexpected batched PER for Eb/No " << ebno[i] << " in table " << (int) type);
+        }
+    }
+
+  return GetErrorStatus ();
+}
+
+class DvbhIpPerTestSuite : public TestSuite
+{
+public:
+  DvbhIpPerTestSuite ();
+};
+
+DvbhIpPerTestSuite::DvbhIpPerTestSuite ()
+  : TestSuite ("dvbh-ip-per", UNIT)
+{
+  AddTestCase (new DvbhIpPerTestCase);
+}
+
+DvbhIpPerTestSuite g_dvbhIpPerTestSuite;
@@ -21,6 +21,7 @@
 
 #include "dvbh-ip-per.h"
 #include "ns3/log.h"
+#include <algorithm>
 
 NS_LOG_COMPONENT_DEFINE ("DvbhIpPer");
 
@@ -52,6 +53,10 @@ double DvbhIpPer::QamTable3_4 [2][15] = {
 
 DvbhIpPer::DvbhIpPer()
 {
+  m_tables[0].Set (QpskTable1_2[0], QpskTable1_2[1], 11, 0.0001, false);
+  m_tables[1].Set (QpskTable3_4[0], QpskTable3_4[1], 11, 0.0001, false);
+  m_tables[2].Set (QamTable1_2[0], QamTable1_2[1], 14, 0.0001, false);
+  m_tables[3].Set (QamTable3_4[0], QamTable3_4[1], 15, 0.0001, false);
 }
 
 TypeId
@@ -67,53 +72,22 @@ DvbhIpPer::GetTypeId (void)
 double 
 DvbhIpPer::GetIpPer (double ebno,uint8_t tableType)
 {
-  int i;
-  double bler;
-//   bler = 1e-38; 
-  bler=0.0001;
-     
-  if(tableType==0)
-  {
-    for (i = 10; i > -1; i--)
+  // PER of the first Eb/No of the table above ebno
+  if (tableType > 3)
     {
-      if (QpskTable1_2[0][i] > ebno)
-        {
-          bler = QpskTable1_2[1][i];
-        }
+      return 0.0001;
     }
-  }
-  else if(tableType==1)
-  {
-    for (i = 10; i > -1; i--)
-    {
-      if (QpskTable3_4[0][i] > ebno)
-        {
-          bler = QpskTable3_4[1][i];
-        }
-    }
-  } 
-  else if(tableType==2)
-  {
-    for (i = 13; i > -1; i--)
-    {
-      if (QamTable1_2[0][i] > ebno)
-        {
-          bler = QamTable1_2[1][i];
-        }
-    }
-  } 
-  else if(tableType==3)
-  {
-    for (i = 14; i > -1; i--)
+  return m_tables[tableType].Lookup (ebno);
+}
+
+void
+DvbhIpPer::GetIpPer (const double *ebno, double *per, uint32_t n, uint8_t tableType)
+{
+  if (tableType > 3)
     {
-      if (QamTable3_4[0][i] > ebno)
-        {
-          bler = QamTable3_4[1][i];
-        }
+      std::fill (per, per + n, 0.0001);
+      return;
     }
-  } 
-  
- 
-  return bler;
+  m_tables[tableType].Lookup (ebno, per, n);
 }
 }
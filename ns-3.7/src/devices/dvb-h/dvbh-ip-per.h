@@ -22,6 +22,7 @@
 #ifndef DVBH_IPPER_TABLE_H
 #define DVBH_IPPER_TABLE_H
 #include "ns3/object.h"
+#include "ns3/step-table.h"
 
 
 namespace ns3 {
@@ -32,12 +33,17 @@ class DvbhIpPer : public Object
 public: 
   DvbhIpPer ();
   double GetIpPer (double ebno,uint8_t tableType);
+  // per[i] = GetIpPer (ebno[i], tableType) for n receivers
+  void GetIpPer (const double *ebno, double *per, uint32_t n, uint8_t tableType);
   static TypeId GetTypeId (void);
   static double QpskTable1_2[2][11];            // 1 row: Eb/No
   static double QpskTable3_4[2][11];            // 1 row: Eb/No
   static double QamTable1_2[2][14];            // 1 row: Eb/No
   static double QamTable3_4[2][15];            // 1 row: Eb/No
-  
+
+private:
+  // one per tableType
+  StepTable m_tables[4];
 };
 }
 #endif /* __bler_h__ */
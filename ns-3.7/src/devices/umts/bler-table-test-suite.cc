@@ -0,0 +1,118 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2009-2010, EU FP7 iTETRIS project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <math.h>
+#include <vector>
+#include "ns3/test.h"
+#include "blerTable.h"
+
+using namespace ns3;
+
+// ===========================================================================
+// The table lookups must give the same BLER as the linear scans they
+// replaced, including at the Eb/No of the table themselves.
+// ===========================================================================
+//
+static double
+ScanBler (double ebno)
+{
+  double bler = 1e-38;
+  for (int i = 7; i > -1; i--)
+    {
+      if (BlerTable::table[0][i] > ebno)
+        {
+          bler = BlerTable::table[1][i];
+        }
+      else
+        {
+          return bler;
+        }
+    }
+  return bler;
+}
+
+class BlerTableTestCase : public TestCase
+{
+public:
+  BlerTableTestCase ();
+  virtual ~BlerTableTestCase ();
+
+private:
+  virtual bool DoRun (void);
+};
+
+BlerTableTestCase::BlerTableTestCase ()
+  : TestCase ("Check that the UMTS BLER table lookup gives the BLER of the table")
+{
+}
+
+BlerTableTestCase::~BlerTableTestCase ()
+{
+}
+
+bool
+BlerTableTestCase::DoRun (void)
+{
+  Ptr<BlerTable> table = CreateObject<BlerTable> ();
+
+  NS_TEST_EXPECT_MSG_EQ (table->getbler (0), 0.2, "Got unexpected BLER below the table");
+  NS_TEST_EXPECT_MSG_EQ (table->getbler (10), 0.05, "Got unexpected BLER at an Eb/No of the table");
+  NS_TEST_EXPECT_MSG_EQ (table->getbler (50), 0.001, "Got unexpected BLER inside the table");
+  NS_TEST_EXPECT_MSG_EQ (table->getbler (1e38), 1e-38, "Got unexpected BLER above the table");
+
+  std::vector<double> ebno;
+  for (int i = 0; i < 8; i++)
+    {
+      double x = BlerTable::table[0][i];
+      ebno.push_back (x);
+      ebno.push_back (nextafter (x, 0));
+      ebno.push_back (nextafter (x, 1e300));
+    }
+  for (double x = -1; x < 100; x += 0.01)
+    {
+      ebno.push_back (x);
+    }
+  for (double x = 100; x < 1e12; x *= 1.01)
+    {
+      ebno.push_back (x);
+    }
+
+  std::vector<double> bler (ebno.size ());
+  table->getbler (&ebno[0], &bler[0], ebno.size ());
+  for (uint32_t i = 0; i < ebno.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (table->getbler (ebno[i]), ScanBler (ebno[i]), "Got unexpected BLER for Eb/No " << ebno[i]);
+      NS_TEST_EXPECT_MSG_EQ (bler[i], ScanBler (ebno[i]), "Got unexpected batched BLER for Eb/No " << ebno[i]);
+    }
+
+  return GetErrorStatus ();
+}
+
+class BlerTableTestSuite : public TestSuite
+{
+public:
+  BlerTableTestSuite ();
+};
+
+BlerTableTestSuite::BlerTableTestSuite ()
+  : TestSuite ("umts-bler-table", UNIT)
+{
+  AddTestCase (new BlerTableTestCase);
+}
+
+BlerTableTestSuite g_blerTableTestSuite;
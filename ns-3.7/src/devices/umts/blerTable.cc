@@ -37,6 +37,8 @@ double BlerTable::table[2][8] = {
 
 BlerTable::BlerTable ()
 {
+  // the Eb/No of the table go from 6.31 to 1e9, hence the log scale
+  m_lookup.Set (table[0], table[1], 8, 1e-38, true);
 }
 
 TypeId
@@ -51,20 +53,12 @@ BlerTable::GetTypeId (void)
 
 double BlerTable::getbler (double ebno)
 {
-  int i;
-  double bler;
-  bler = 1e-38;
-  for (i = 7; i > -1; i--)
-    {
-      if (table[0][i] > ebno)
-        {
-          bler = table[1][i];
-        }
-      else
-        {
-          return bler;
-        }
-    }
-  return bler;
+  // BLER of the first Eb/No of the table above ebno
+  return m_lookup.Lookup (ebno);
+}
+
+void BlerTable::getbler (const double *ebno, double *bler, uint32_t n)
+{
+  m_lookup.Lookup (ebno, bler, n);
 }
 }
@@ -22,6 +22,7 @@
 #ifndef BLER_TABLE_H
 #define BLER_TABLE_H
 #include "ns3/object.h"
+#include "ns3/step-table.h"
 
 
 namespace ns3 {
@@ -32,9 +33,13 @@ class BlerTable : public Object
 public:
   BlerTable ();
   double getbler (double ebno);
+  // bler[i] = getbler (ebno[i]) for the n receivers of a TTI
+  void getbler (const double *ebno, double *bler, uint32_t n);
   static TypeId GetTypeId (void);
   static double table[2][8];            // 1 row: Eb/No
   // 2 row: BLER
+private:
+  StepTable m_lookup;
 };
 }
 #endif /* __bler_h__ */
@@ -136,7 +136,13 @@ UMTSChannel::CalculateRxPowerFromNodeB (Ptr<UmtsPhyLayerUE> phy,enum TxType type
 
     }
 
-  double loss = ReturnCost231Loss (m_phyNodeB->GetMobility (),phy->GetMobility (),300000000 / phy->GetTxFrequency (),10,phy->GetMinDistance (),m_phyNodeB->GetAntennaHeight (),phy->GetAntennaHeight ());
+  double loss;
+  m_pathLoss.SetReference (m_phyNodeB->GetMobility ());
+  if (!m_pathLoss.Lookup (phy->GetMobility (), DOWNLINK, &loss))
+    {
+      loss = ReturnCost231Loss (m_phyNodeB->GetMobility (),phy->GetMobility (),300000000 / phy->GetTxFrequency (),10,phy->GetMinDistance (),m_phyNodeB->GetAntennaHeight (),phy->GetAntennaHeight ());
+      m_pathLoss.Add (phy->GetMobility (), DOWNLINK, loss);
+    }
   
 //   std::cout << "Channel // Calculated Path Loss From BS. Pos="<< phy->GetMobility ()->GetPosition().x <<" Loss=" << loss <<" RxPower="<< (loss + txpower) << " WrongRxPower="<< (txpower-loss) <<"\n";
 
@@ -164,8 +170,14 @@ UMTSChannel::CalculateRxPowerFromNodeUE (Ptr<UmtsPhyLayerUE> phy,enum TxType typ
       txpower = phy->GetCommonTxPower () + phy->GetAntennaGain () + m_phyNodeB->GetAntennaGain ();
     }
 
-  double loss = ReturnCost231Loss (phy->GetMobility (),m_phyNodeB->GetMobility (),300000000 / phy->GetTxFrequency (),5,phy->GetMinDistance (),
-                                   m_phyNodeB->GetAntennaHeight (),phy->GetAntennaHeight ());
+  double loss;
+  m_pathLoss.SetReference (m_phyNodeB->GetMobility ());
+  if (!m_pathLoss.Lookup (phy->GetMobility (), UPLINK, &loss))
+    {
+      loss = ReturnCost231Loss (phy->GetMobility (),m_phyNodeB->GetMobility (),300000000 / phy->GetTxFrequency (),5,phy->GetMinDistance (),
+                                m_phyNodeB->GetAntennaHeight (),phy->GetAntennaHeight ());
+      m_pathLoss.Add (phy->GetMobility (), UPLINK, loss);
+    }
   
   NS_LOG_DEBUG("Channel // Calculated Path Loss From Vehicle "<<phy->GetNodeIdentifier()<<"." << loss <<". Rx Power is "<<loss + txpower<<"\n");
 
@@ -233,6 +245,7 @@ UMTSChannel::RemoveNode (Ptr<UmtsPhyLayerUE> phyNodeUE)
     {
       if (phyNodeUE == (*i).phyNodeUE)
         {
+          m_pathLoss.Remove (phyNodeUE->GetMobility ());
           m_PhyList.erase (i);
           m_associatedNodes--;
         }
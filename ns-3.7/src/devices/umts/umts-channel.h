@@ -31,6 +31,7 @@
 #include "umts-manager.h"
 
 #include "cost231_model.h"
+#include "ns3/path-loss-cache.h"
 
 namespace ns3 {
 
@@ -81,7 +82,15 @@ private:
   Ptr<UmtsPhyLayerBS> m_phyNodeB;
   int m_associatedNodes;
   
+  enum PathLossLink
+  {
+    DOWNLINK = 0,
+    UPLINK = 1
+  };
+
   Ptr<Cost231Propagation> m_costPropagationModel;
+  // Cost231 losses of the UEs, until they or the NodeB move
+  PathLossCache m_pathLoss;
   Ptr<UmtsPhyLayerUE> m_phyNodeUEDedicated;
     
 };
@@ -1902,13 +1902,19 @@ void UmtsPhyLayerBS::RemoveResources (uint32_t addr)
 void
 UmtsPhyLayerBS::BlerHandler ()
 {
-  double Eb_No, bler, I = 0;
+  double Eb_No, I = 0;
   double Eb_No2 = 0;
   double internal = 0;
   int i,k, j = 0;
   int interferentes = 0;
   unsigned long error[MAX_NUM_UE];                      // for passing results to MAC
   unsigned long error2[MAX_NUM_UE];                     // for passing results to MAC
+  // common and dedicated Eb/No and BLER of each UE with results
+  double ebNo[2 * MAX_NUM_UE];
+  double bler[2 * MAX_NUM_UE];
+  int ue[MAX_NUM_UE];
+  bool hasCommon[MAX_NUM_UE];
+  bool hasDedicated[MAX_NUM_UE];
   // Restart timer for next time.
   double time=0;
   
@@ -2017,28 +2023,12 @@ UmtsPhyLayerBS::BlerHandler ()
             }
 
 
-          if (m_nodeUEInformation[i].CommonLastRate > 0)
-            {
-              bler = m_blerTable->getbler (Eb_No);                           // consult table (Eb_No)
-              m_nodeUEInformation[i].ul_CommonErrorRate = (int)(1 / bler) + 1;
-            }
-          else
-            {
-              m_nodeUEInformation[i].ul_CommonErrorRate = 1000000000;
-            }
-
-          if (m_nodeUEInformation[i].DedicatedLastRate > 0)
-            {
-              bler = m_blerTable->getbler (Eb_No2);                          // consult table (Eb_No)
-              m_nodeUEInformation[i].ul_DedicatedErrorRate = (int)(1 / bler) + 1;
-            }
-          else
-            {
-              m_nodeUEInformation[i].ul_DedicatedErrorRate = 1000000000;
-            }
-
-          error[j] = m_nodeUEInformation[i].ul_CommonErrorRate;
-          error2[j] = m_nodeUEInformation[i].ul_DedicatedErrorRate;
+          // the table is consulted for all the UEs at once, after the loop
+          ue[j] = i;
+          hasCommon[j] = m_nodeUEInformation[i].CommonLastRate > 0;
+          hasDedicated[j] = m_nodeUEInformation[i].DedicatedLastRate > 0;
+          ebNo[2 * j] = hasCommon[j] ? Eb_No : 1e38;
+          ebNo[2 * j + 1] = hasDedicated[j] ? Eb_No2 : 1e38;
           m_addr[j] = m_nodeUEIdRegistry[i];
 
           j++;
@@ -2058,6 +2048,32 @@ UmtsPhyLayerBS::BlerHandler ()
     }
 
 
+  m_blerTable->getbler (ebNo, bler, 2 * j);                // consult table (Eb_No)
+  for (k = 0; k < j; k++)
+    {
+      i = ue[k];
+      if (hasCommon[k])
+        {
+          m_nodeUEInformation[i].ul_CommonErrorRate = (int)(1 / bler[2 * k]) + 1;
+        }
+      else
+        {
+          m_nodeUEInformation[i].ul_CommonErrorRate = 1000000000;
+        }
+
+      if (hasDedicated[k])
+        {
+          m_nodeUEInformation[i].ul_DedicatedErrorRate = (int)(1 / bler[2 * k + 1]) + 1;
+        }
+      else
+        {
+          m_nodeUEInformation[i].ul_DedicatedErrorRate = 1000000000;
+        }
+
+      error[k] = m_nodeUEInformation[i].ul_CommonErrorRate;
+      error2[k] = m_nodeUEInformation[i].ul_DedicatedErrorRate;
+    }
+
   m_externalInterference = 0;
   // put bounds to the arrays error[] and addr[]
   error[j] = 0;
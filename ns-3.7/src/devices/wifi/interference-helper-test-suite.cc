@@ -0,0 +1,387 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2009-2010, EU FP7 iTETRIS project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <stdlib.h>
+#include <algorithm>
+#include <vector>
+#include <ns3/log.h>
+#include <ns3/test.h>
+#include <ns3/simulator.h>
+#include "interference-helper.h"
+#include "yans-error-rate-model.h"
+#include "wifi-phy.h"
+
+NS_LOG_COMPONENT_DEFINE ("InterferenceHelperTest");
+
+namespace ns3 {
+
+/**
+ * The SNR and PER computation of InterferenceHelper before the power
+ * changes were kept in order: the whole list of events is scanned for
+ * each received frame, and the changes are sorted afterwards.
+ */
+class ReferenceInterference
+{
+public:
+  ReferenceInterference (double noiseFigure, Ptr<ErrorRateModel> errorRateModel);
+
+  void Add (Ptr<InterferenceHelper::Event> event);
+  struct InterferenceHelper::SnrPer CalculateSnrPer (Ptr<InterferenceHelper::Event> event) const;
+
+private:
+  struct NiChange
+  {
+    NiChange (Time time, double delta) : time (time), delta (delta) {}
+    bool operator < (const NiChange &o) const { return time < o.time; }
+    Time time;
+    double delta;
+  };
+  typedef std::vector<NiChange> NiChanges;
+
+  double CalculateNoiseInterferenceW (Ptr<InterferenceHelper::Event> event, NiChanges *ni) const;
+  double CalculateSnr (double signal, double noiseInterference, WifiMode mode) const;
+  double CalculateChunkSuccessRate (double snir, Time duration, WifiMode mode) const;
+  double CalculatePer (Ptr<const InterferenceHelper::Event> event, NiChanges *ni) const;
+
+  double m_noiseFigure;
+  Ptr<ErrorRateModel> m_errorRateModel;
+  std::vector<Ptr<InterferenceHelper::Event> > m_events;
+};
+
+ReferenceInterference::ReferenceInterference (double noiseFigure, Ptr<ErrorRateModel> errorRateModel)
+  : m_noiseFigure (noiseFigure),
+    m_errorRateModel (errorRateModel)
+{}
+
+void
+ReferenceInterference::Add (Ptr<InterferenceHelper::Event> event)
+{
+  m_events.push_back (event);
+}
+
+double
+ReferenceInterference::CalculateNoiseInterferenceW (Ptr<InterferenceHelper::Event> event, NiChanges *ni) const
+{
+  double noiseInterference = 0.0;
+  for (std::vector<Ptr<InterferenceHelper::Event> >::const_iterator i = m_events.begin (); i != m_events.end (); i++)
+    {
+      if (event == (*i))
+        {
+          continue;
+        }
+      if ((*i)->Overlaps (event->GetStartTime ()))
+        {
+          noiseInterference += (*i)->GetRxPowerW ();
+        }
+      else if (event->Overlaps ((*i)->GetStartTime ()))
+        {
+          ni->push_back (NiChange ((*i)->GetStartTime (), (*i)->GetRxPowerW ()));
+        }
+      if (event->Overlaps ((*i)->GetEndTime ()))
+        {
+          ni->push_back (NiChange ((*i)->GetEndTime (), -(*i)->GetRxPowerW ()));
+        }
+    }
+  ni->push_back (NiChange (event->GetStartTime (), noiseInterference));
+  ni->push_back (NiChange (event->GetEndTime (), 0));
+  std::sort (ni->begin (), ni->end ());
+  return noiseInterference;
+}
+
+double
+ReferenceInterference::CalculateSnr (double signal, double noiseInterference, WifiMode mode) const
+{
+  static const double BOLTZMANN = 1.3803e-23;
+  double Nt = BOLTZMANN * 290.0 * mode.GetBandwidth ();
+  return signal / (m_noiseFigure * Nt + noiseInterference);
+}
+
+double
+ReferenceInterference::CalculateChunkSuccessRate (double snir, Time duration, WifiMode mode) const
+{
+  if (duration == NanoSeconds (0))
+    {
+      return 1.0;
+    }
+  uint64_t nbits = (uint64_t)(mode.GetPhyRate () * duration.GetSeconds ());
+  return m_errorRateModel->GetChunkSuccessRate (mode, snir, (uint32_t)nbits);
+}
+
+double
+ReferenceInterference::CalculatePer (Ptr<const InterferenceHelper::Event> event, NiChanges *ni) const
+{
+  double psr = 1.0;
+  NiChanges::iterator j = ni->begin ();
+  Time previous = j->time;
+  WifiMode payloadMode = event->GetPayloadMode ();
+  WifiPreamble preamble = event->GetPreambleType ();
+  WifiMode headerMode = InterferenceHelper::GetPlcpHeaderMode (payloadMode, preamble);
+  Time plcpHeaderStart = j->time + MicroSeconds (InterferenceHelper::GetPlcpPreambleDurationMicroSeconds (payloadMode, preamble));
+  Time plcpPayloadStart = plcpHeaderStart + MicroSeconds (InterferenceHelper::GetPlcpHeaderDurationMicroSeconds (payloadMode, preamble));
+  double noiseInterferenceW = j->delta;
+  double powerW = event->GetRxPowerW ();
+
+  j++;
+  while (ni->end () != j)
+    {
+      Time current = j->time;
+      if (previous >= plcpPayloadStart)
+        {
+          psr *= CalculateChunkSuccessRate (CalculateSnr (powerW, noiseInterferenceW, payloadMode),
+                                            current - previous, payloadMode);
+        }
+      else if (previous >= plcpHeaderStart)
+        {
+          if (current >= plcpPayloadStart)
+            {
+              psr *= CalculateChunkSuccessRate (CalculateSnr (powerW, noiseInterferenceW, headerMode),
+                                                plcpPayloadStart - previous, headerMode);
+              psr *= CalculateChunkSuccessRate (CalculateSnr (powerW, noiseInterferenceW, payloadMode),
+                                                current - plcpPayloadStart, payloadMode);
+            }
+          else
+            {
+              psr *= CalculateChunkSuccessRate (CalculateSnr (powerW, noiseInterferenceW, headerMode),
+                                                current - previous, headerMode);
+            }
+        }
+      else
+        {
+          if (current >= plcpPayloadStart)
+            {
+              psr *= CalculateChunkSuccessRate (CalculateSnr (powerW, noiseInterferenceW, headerMode),
+                                                plcpPayloadStart - plcpHeaderStart, headerMode);
+              psr *= CalculateChunkSuccessRate (CalculateSnr (powerW, noiseInterferenceW, payloadMode),
+                                                current - plcpPayloadStart, payloadMode);
+            }
+          else if (current >= plcpHeaderStart)
+            {
+              psr *= CalculateChunkSuccessRate (CalculateSnr (powerW, noiseInterferenceW, headerMode),
+                                                current - plcpHeaderStart, headerMode);
+            }
+        }
+      noiseInterferenceW += j->delta;
+      previous = j->time;
+      j++;
+    }
+  return 1 - psr;
+}
+
+struct InterferenceHelper::SnrPer
+ReferenceInterference::CalculateSnrPer (Ptr<InterferenceHelper::Event> event) const
+{
+  NiChanges ni;
+  double noiseInterferenceW = CalculateNoiseInterferenceW (event, &ni);
+  struct InterferenceHelper::SnrPer snrPer;
+  snrPer.snr = CalculateSnr (event->GetRxPowerW (), noiseInterferenceW, event->GetPayloadMode ());
+  snrPer.per = CalculatePer (event, &ni);
+  return snrPer;
+}
+
+// ===========================================================================
+// Test case to make sure that InterferenceHelper computes the same SNR and
+// PER as the reference model for overlapping, back-to-back and
+// simultaneous signals.
+// ===========================================================================
+class InterferenceHelperSnrPerTestCase : public TestCase
+{
+public:
+  InterferenceHelperSnrPerTestCase ();
+  virtual ~InterferenceHelperSnrPerTestCase ();
+
+private:
+  virtual void DoSetup (void);
+  virtual bool DoRun (void);
+  virtual void DoTeardown (void);
+
+  /**
+   * Schedule a signal of 'rxPowerW' W on the medium from 'start' for
+   * 'duration' microseconds. As in YansWifiPhy, it is received if no
+   * other frame is being received when it arrives.
+   */
+  void AddSignal (uint32_t start, uint32_t duration, double rxPowerW);
+  void ScheduleArrival (uint32_t duration, double rxPowerW);
+  void Arrive (uint32_t duration, double rxPowerW);
+  void EndReceive (Ptr<InterferenceHelper::Event> event);
+  /**
+   * Replay the signals added since the last call.
+   * \returns the number of received frames.
+   */
+  uint32_t Replay (void);
+
+  InterferenceHelper *m_interference;
+  ReferenceInterference *m_reference;
+  WifiMode m_mode;
+  bool m_rxing;
+  uint32_t m_nReceived;
+};
+
+InterferenceHelperSnrPerTestCase::InterferenceHelperSnrPerTestCase ()
+  : TestCase ("Check the SNR and PER of InterferenceHelper against the reference model"),
+    m_interference (0),
+    m_reference (0)
+{
+}
+
+InterferenceHelperSnrPerTestCase::~InterferenceHelperSnrPerTestCase ()
+{
+}
+
+void
+InterferenceHelperSnrPerTestCase::DoSetup (void)
+{
+  m_mode = WifiPhy::Get12mb10Mhz ();
+}
+
+void
+InterferenceHelperSnrPerTestCase::DoTeardown (void)
+{
+  delete m_interference;
+  delete m_reference;
+  m_interference = 0;
+  m_reference = 0;
+}
+
+void
+InterferenceHelperSnrPerTestCase::AddSignal (uint32_t start, uint32_t duration, double rxPowerW)
+{
+  // The arrival is scheduled again at its time, so that the frames
+  // ending at that time are received first, as the phy does.
+  Simulator::Schedule (MicroSeconds (start), &InterferenceHelperSnrPerTestCase::ScheduleArrival, this, duration, rxPowerW);
+}
+
+void
+InterferenceHelperSnrPerTestCase::ScheduleArrival (uint32_t duration, double rxPowerW)
+{
+  Simulator::ScheduleNow (&InterferenceHelperSnrPerTestCase::Arrive, this, duration, rxPowerW);
+}
+
+void
+InterferenceHelperSnrPerTestCase::Arrive (uint32_t duration, double rxPowerW)
+{
+  Ptr<InterferenceHelper::Event> event = m_interference->Add (100, m_mode, WIFI_PREAMBLE_LONG,
+                                                              MicroSeconds (duration), rxPowerW);
+  m_reference->Add (event);
+  if (!m_rxing)
+    {
+      m_rxing = true;
+      m_interference->NotifyRxStart ();
+      Simulator::Schedule (MicroSeconds (duration), &InterferenceHelperSnrPerTestCase::EndReceive, this, event);
+    }
+}
+
+void
+InterferenceHelperSnrPerTestCase::EndReceive (Ptr<InterferenceHelper::Event> event)
+{
+  struct InterferenceHelper::SnrPer snrPer = m_interference->CalculateSnrPer (event);
+  struct InterferenceHelper::SnrPer expected = m_reference->CalculateSnrPer (event);
+  m_interference->NotifyRxEnd ();
+  m_rxing = false;
+  m_nReceived++;
+
+  double snrTolerance = expected.snr * 1e-9;
+  NS_TEST_EXPECT_MSG_EQ_TOL (snrPer.snr, expected.snr, snrTolerance,
+                             "Wrong SNR of the frame received at " << event->GetStartTime ());
+  NS_TEST_EXPECT_MSG_EQ_TOL (snrPer.per, expected.per, 1e-9,
+                             "Wrong PER of the frame received at " << event->GetStartTime ());
+}
+
+uint32_t
+InterferenceHelperSnrPerTestCase::Replay (void)
+{
+  delete m_interference;
+  delete m_reference;
+  Ptr<ErrorRateModel> errorRateModel = CreateObject<YansErrorRateModel> ();
+  m_interference = new InterferenceHelper ();
+  m_interference->SetNoiseFigure (5.01187);
+  m_interference->SetErrorRateModel (errorRateModel);
+  m_reference = new ReferenceInterference (m_interference->GetNoiseFigure (), errorRateModel);
+  m_rxing = false;
+  m_nReceived = 0;
+  Simulator::Run ();
+  Simulator::Destroy ();
+  return m_nReceived;
+}
+
+bool
+InterferenceHelperSnrPerTestCase::DoRun (void)
+{
+  uint32_t received;
+
+  // overlapping signals: interferers starting and ending within a frame,
+  // and one still on the medium when the next frame is received
+  AddSignal (0, 300, 1e-11);
+  AddSignal (50, 300, 3e-12);
+  AddSignal (100, 100, 2e-12);
+  AddSignal (320, 200, 1e-11);
+  AddSignal (400, 50, 4e-12);
+  received = Replay ();
+  NS_TEST_EXPECT_MSG_EQ (received, 2, "Expected two overlapping receptions");
+
+  // back-to-back frames: each one starts when the previous one ends
+  AddSignal (0, 200, 1e-11);
+  AddSignal (200, 200, 1e-11);
+  AddSignal (400, 200, 5e-12);
+  AddSignal (150, 100, 1e-12);
+  received = Replay ();
+  NS_TEST_EXPECT_MSG_EQ (received, 3, "Expected three back-to-back receptions");
+
+  // same timestamps: signals starting with the received frame, one of
+  // them with its power, and an interferer ending when a frame starts
+  AddSignal (0, 200, 1e-11);
+  AddSignal (0, 200, 2e-12);
+  AddSignal (0, 100, 1e-11);
+  AddSignal (100, 150, 1e-12);
+  AddSignal (500, 100, 3e-12);
+  AddSignal (520, 80, 2e-12);
+  AddSignal (600, 200, 1e-11);
+  AddSignal (600, 50, 2e-12);
+  received = Replay ();
+  NS_TEST_EXPECT_MSG_EQ (received, 3, "Expected three receptions with simultaneous signals");
+
+  // a busy medium, on a coarse grid so that many changes share a time
+  srand (1);
+  for (uint32_t i = 0; i < 500; i++)
+    {
+      uint32_t start = (rand () % 2000) * 10;
+      uint32_t duration = (1 + rand () % 30) * 10;
+      double rxPowerW = (1 + rand () % 100) * 1e-13;
+      AddSignal (start, duration, rxPowerW);
+    }
+  received = Replay ();
+  bool busy = received > 20;
+  NS_TEST_EXPECT_MSG_EQ (busy, true, "Too few receptions on the busy medium");
+
+  return GetErrorStatus ();
+}
+
+class InterferenceHelperTestSuite : public TestSuite
+{
+public:
+  InterferenceHelperTestSuite ();
+};
+
+InterferenceHelperTestSuite::InterferenceHelperTestSuite ()
+  : TestSuite ("devices-wifi-interference", UNIT)
+{
+  AddTestCase (new InterferenceHelperSnrPerTestCase);
+}
+
+InterferenceHelperTestSuite g_interferenceHelperTestSuite;
+
+} // namespace ns3
@@ -22,6 +22,7 @@
 #include "error-rate-model.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
+#include "ns3/profiler.h"
 #include <algorithm>
 
 NS_LOG_COMPONENT_DEFINE ("InterferenceHelper");
@@ -123,8 +124,9 @@ InterferenceHelper::NiChange::operator < (const InterferenceHelper::NiChange& o)
  ****************************************************************/
 
 InterferenceHelper::InterferenceHelper ()
-  : m_maxPacketDuration (Seconds(0)),
-    m_errorRateModel (0)  
+  : m_errorRateModel (0),
+    m_firstPower (0.0),
+    m_rxing (false)
 {}
 InterferenceHelper::~InterferenceHelper ()
 {
@@ -137,6 +139,7 @@ InterferenceHelper::Add (uint32_t size, WifiMode payloadMode,
 			 enum WifiPreamble preamble,
 			 Time duration, double rxPowerW)
 {
+  NS_PROFILE_SCOPE ("wifi-interference");
   Ptr<InterferenceHelper::Event> event;
 
   event = Create<InterferenceHelper::Event> 
@@ -146,17 +149,10 @@ InterferenceHelper::Add (uint32_t size, WifiMode payloadMode,
      duration,
      rxPowerW);
 
-  m_maxPacketDuration = std::max(duration, m_maxPacketDuration);
   AppendEvent (event);
   return event;
 }
 
-Time 
-InterferenceHelper::GetMaxPacketDuration (void) const
-{
-  return m_maxPacketDuration;
-}
-
 void 
 InterferenceHelper::SetNoiseFigure (double value)
 {
@@ -186,21 +182,13 @@ InterferenceHelper::GetEnergyDuration (double energyW)
 {
   Time now = Simulator::Now ();
 
-  // first, we iterate over all events and, each event
-  // which contributes energy to the channel now is 
-  // appended to the noise interference array.
-  Events::const_iterator i = m_events.begin ();
-  double noiseInterferenceW = 0.0;
-  NiChanges ni;
-  while (i != m_events.end ()) 
+  // first, the energy on the channel now. Every signal has
+  // started, so the changes after now are only signal ends.
+  double noiseInterferenceW = m_firstPower;
+  NiChanges::const_iterator i = m_niChanges.begin ();
+  while (i != m_niChanges.end () && i->GetTime () <= now)
     {
-      Ptr<Event> ev = *i;
-      NS_ASSERT (ev->GetStartTime () <= now);
-      if (ev->GetEndTime () > now)
-	{
-          ni.push_back (NiChange (ev->GetEndTime (), -ev->GetRxPowerW ()));
-          noiseInterferenceW += ev->GetRxPowerW ();
-	}
+      noiseInterferenceW += i->GetDelta ();
       i++;
     }
   if (noiseInterferenceW < energyW)
@@ -208,13 +196,9 @@ InterferenceHelper::GetEnergyDuration (double energyW)
       return MicroSeconds (0);
     }
 
-  /* quicksort vector of NI changes by time. 
-   */
-  std::sort (ni.begin (), ni.end (), std::less<NiChange> ());
-
   // Now, we iterate the piecewise linear noise function
   Time end = now;
-  for (NiChanges::const_iterator i = ni.begin (); i != ni.end (); i++) 
+  for (; i != m_niChanges.end (); i++) 
     {
       noiseInterferenceW += i->GetDelta ();
       end = i->GetTime ();
@@ -411,27 +395,43 @@ InterferenceHelper::CalculateTxDuration (uint32_t size, WifiMode payloadMode, Wi
   return MicroSeconds (duration);
 }
 
+InterferenceHelper::NiChanges::iterator
+InterferenceHelper::GetPosition (Time moment)
+{
+  return std::upper_bound (m_niChanges.begin (), m_niChanges.end (), NiChange (moment, 0));
+}
+
+void
+InterferenceHelper::AddNiChangeEvent (NiChange change)
+{
+  m_niChanges.insert (GetPosition (change.GetTime ()), change);
+}
+
 void 
 InterferenceHelper::AppendEvent (Ptr<InterferenceHelper::Event> event)
 {
-  /* attempt to remove the events which are 
-   * not useful anymore. 
-   * i.e.: all events which end _before_
-   *       now - m_maxPacketDuration
+  /* When no packet is being received, the changes before now
+   * are not needed anymore: they are summed in m_firstPower.
+   * The changes at now are kept, because the event may be
+   * received and they contribute to its initial interference.
    */
-  
-  if (Simulator::Now () > GetMaxPacketDuration ())
+  if (!m_rxing)
     {
-      Time end = Simulator::Now () - GetMaxPacketDuration ();
-      Events::iterator i = m_events.begin ();
-      while (i != m_events.end () &&
-             (*i)->GetEndTime () <= end) 
+      NiChanges::iterator now = std::lower_bound (m_niChanges.begin (), m_niChanges.end (), 
+                                                  NiChange (Simulator::Now (), 0));
+      for (NiChanges::iterator i = m_niChanges.begin (); i != now; i++)
         {
-          i++;
+          m_firstPower += i->GetDelta ();
         }
-      EraseEvents (m_events.begin (), i);
-    } 
-  m_events.push_back (event);
+      m_niChanges.erase (m_niChanges.begin (), now);
+      if (m_niChanges.empty ())
+        {
+          // no signal left on the medium: drop the rounding errors of the sum
+          m_firstPower = 0.0;
+        }
+    }
+  AddNiChangeEvent (NiChange (event->GetStartTime (), event->GetRxPowerW ()));
+  AddNiChangeEvent (NiChange (event->GetEndTime (), -event->GetRxPowerW ()));
 }
 
 
@@ -452,35 +452,39 @@ InterferenceHelper::CalculateSnr (double signal, double noiseInterference, WifiM
 double
 InterferenceHelper::CalculateNoiseInterferenceW (Ptr<InterferenceHelper::Event> event, NiChanges *ni) const
 {
-  Events::const_iterator i = m_events.begin ();
-  double noiseInterference = 0.0;
-  while (i != m_events.end ()) 
+  NS_ASSERT (m_rxing);
+  /* The changes are kept since the start of the received event,
+   * so the first ones are at its start.  The signals starting with
+   * the event interfere from its start, the signals ending at its
+   * start interfere with it only at that instant.
+   */
+  double noiseInterference = m_firstPower;
+  bool ownStart = false;
+  ni->push_back (NiChange (event->GetStartTime (), 0));
+  NiChanges::const_iterator i = m_niChanges.begin ();
+  for (; i != m_niChanges.end () && i->GetTime () == event->GetStartTime (); i++)
     {
-      if (event == (*i)) 
+      if (i->GetDelta () < 0)
         {
-          i++;
-          continue;
+          ni->push_back (*i);
         }
-      if ((*i)->Overlaps (event->GetStartTime ())) 
+      else if (!ownStart && i->GetDelta () == event->GetRxPowerW ())
         {
-          noiseInterference += (*i)->GetRxPowerW ();
+          ownStart = true;
         }
-      else if (event->Overlaps ((*i)->GetStartTime ())) 
+      else
         {
-          ni->push_back (NiChange ((*i)->GetStartTime (), (*i)->GetRxPowerW ()));
+          noiseInterference += i->GetDelta ();
         }
-      if (event->Overlaps ((*i)->GetEndTime ())) 
-        {
-          ni->push_back (NiChange ((*i)->GetEndTime (), -(*i)->GetRxPowerW ()));
-        }
-      i++;
     }
-  ni->push_back (NiChange (event->GetStartTime (), noiseInterference));
+  NS_ASSERT (ownStart);
+  (*ni)[0] = NiChange (event->GetStartTime (), noiseInterference);
+  for (; i != m_niChanges.end () && i->GetTime () < event->GetEndTime (); i++)
+    {
+      ni->push_back (*i);
+    }
   ni->push_back (NiChange (event->GetEndTime (), 0));
 
-  /* quicksort vector of NI changes by time. */
-  std::sort (ni->begin (), ni->end (), std::less<NiChange> ());
-
   return noiseInterference;
 }
 
@@ -587,6 +591,7 @@ InterferenceHelper::CalculatePer (Ptr<const InterferenceHelper::Event> event, Ni
 struct InterferenceHelper::SnrPer 
 InterferenceHelper::CalculateSnrPer (Ptr<InterferenceHelper::Event> event)
 {
+  NS_PROFILE_SCOPE ("wifi-interference");
   NiChanges ni;
   double noiseInterferenceW = CalculateNoiseInterferenceW (event, &ni);
   double snr = CalculateSnr (event->GetRxPowerW (),
@@ -605,23 +610,23 @@ InterferenceHelper::CalculateSnrPer (Ptr<InterferenceHelper::Event> event)
 }
 
 void
-InterferenceHelper::EraseEvents (void) 
-{  
-  for (Events::iterator i = m_events.begin (); i != m_events.end (); ++i)
-    {
-      *i = 0;
-    }
-  m_events.clear ();
+InterferenceHelper::NotifyRxStart (void)
+{
+  m_rxing = true;
+}
+
+void
+InterferenceHelper::NotifyRxEnd (void)
+{
+  m_rxing = false;
 }
 
 void
-InterferenceHelper::EraseEvents (Events::iterator start, Events::iterator end) 
+InterferenceHelper::EraseEvents (void) 
 {  
-  for (Events::iterator i = start; i != end; ++i)
-    {
-      *i = 0;
-    }
-  m_events.erase (start, end);
+  m_niChanges.clear ();
+  m_firstPower = 0.0;
+  m_rxing = false;
 }
 
 } // namespace ns3
@@ -22,7 +22,6 @@
 
 #include <stdint.h>
 #include <vector>
-#include <list>
 #include "wifi-mode.h"
 #include "wifi-preamble.h"
 #include "wifi-phy-standard.h"
@@ -95,6 +94,13 @@ public:
 				      Time duration, double rxPower);
 
   struct InterferenceHelper::SnrPer CalculateSnrPer (Ptr<InterferenceHelper::Event> event);
+  /**
+   * The phy synchronized on the last added event. The changes of the
+   * interference are kept from its start until NotifyRxEnd, so that
+   * CalculateSnrPer can be called for it.
+   */
+  void NotifyRxStart (void);
+  void NotifyRxEnd (void);
   void EraseEvents (void); 
 private:
   class NiChange {
@@ -108,23 +114,26 @@ private:
     double m_delta;
   };
   typedef std::vector <NiChange> NiChanges;
-  typedef std::list<Ptr<Event> > Events;
-
-  void EraseEvents (Events::iterator start, Events::iterator end); 
 
   InterferenceHelper (const InterferenceHelper &o);
   InterferenceHelper &operator = (const InterferenceHelper &o);
   void AppendEvent (Ptr<Event> event);
+  NiChanges::iterator GetPosition (Time moment);
+  void AddNiChangeEvent (NiChange change);
   double CalculateNoiseInterferenceW (Ptr<Event> event, NiChanges *ni) const;
   double CalculateSnr (double signal, double noiseInterference, WifiMode mode) const;
   double CalculateChunkSuccessRate (double snir, Time delay, WifiMode mode) const;
   double CalculatePer (Ptr<const Event> event, NiChanges *ni) const;
-  Time GetMaxPacketDuration (void) const;
 
-  Time m_maxPacketDuration;
   double m_noiseFigure; /**< noise figure (linear) */
-  Events m_events;
   Ptr<ErrorRateModel> m_errorRateModel;
+  /**
+   * Power changes of the signals on the medium, ordered by time. The
+   * changes before the first one are summed in m_firstPower.
+   */
+  NiChanges m_niChanges;
+  double m_firstPower;
+  bool m_rxing;
 };
 
 } // namespace ns3
@@ -21,6 +21,7 @@
 #include "ns3/log.h"
 #include "ns3/simulator.h"
 #include "ns3/trace-source-accessor.h"
+#include <algorithm>
 
 NS_LOG_COMPONENT_DEFINE ("WifiPhyStateHelper");
 
@@ -79,6 +80,15 @@ WifiPhyStateHelper::RegisterListener (WifiPhyListener *listener)
 {
   m_listeners.push_back (listener);
 }
+void 
+WifiPhyStateHelper::UnregisterListener (WifiPhyListener *listener)
+{
+  Listeners::iterator i = std::find (m_listeners.begin (), m_listeners.end (), listener);
+  if (i != m_listeners.end ())
+    {
+      m_listeners.erase (i);
+    }
+}
 
 bool 
 WifiPhyStateHelper::IsStateIdle (void)
@@ -37,6 +37,7 @@ public:
   void SetReceiveOkCallback (WifiPhy::RxOkCallback callback);
   void SetReceiveErrorCallback (WifiPhy::RxErrorCallback callback);
   void RegisterListener (WifiPhyListener *listener);
+  void UnregisterListener (WifiPhyListener *listener);
   enum WifiPhy::State GetState (void);
   bool IsStateCcaBusy (void);
   bool IsStateIdle (void);
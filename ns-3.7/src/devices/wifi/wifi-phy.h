@@ -194,6 +194,14 @@ public:
    */
   virtual void RegisterListener (WifiPhyListener *listener) = 0;
 
+  /**
+   * \param listener a listener added by RegisterListener
+   *
+   * Remove the input listener from the list of objects to be notified
+   * of PHY-level events. The listener is not deleted.
+   */
+  virtual void UnregisterListener (WifiPhyListener *listener) = 0;
+
   /**
    * \returns true of the current state of the PHY layer is WifiPhy::IDLE, false otherwise.
    */
@@ -465,6 +465,7 @@ YansWifiPhy::StartReceivePacket (Ptr<Packet> packet,
         // sync to signal
         m_state->SwitchToRx (rxDuration);
         NS_ASSERT (m_endRxEvent.IsExpired ());
+        m_interference.NotifyRxStart ();
         NotifyRxBegin (packet);
         m_endRxEvent = Simulator::Schedule (rxDuration, &YansWifiPhy::EndReceive, this, 
                                             packet,
@@ -511,6 +512,7 @@ YansWifiPhy::SendPacket (Ptr<const Packet> packet, WifiMode txMode, WifiPreamble
   if (m_state->IsStateRx ())
     {
       m_endRxEvent.Cancel ();
+      m_interference.NotifyRxEnd ();
     }
   NotifyTxBegin (packet);
   uint32_t dataRate500KbpsUnits = txMode.GetDataRate () / 500000;   
@@ -641,6 +643,16 @@ YansWifiPhy::RegisterListener (WifiPhyListener *listener)
   m_state->RegisterListener (listener);
 }
 
+void 
+YansWifiPhy::UnregisterListener (WifiPhyListener *listener)
+{
+  // the listeners go away with the state helper when the phy is disposed
+  if (m_state != 0)
+    {
+      m_state->UnregisterListener (listener);
+    }
+}
+
 bool 
 YansWifiPhy::IsStateCcaBusy (void)
 {
@@ -746,6 +758,7 @@ YansWifiPhy::EndReceive (Ptr<Packet> packet, Ptr<InterferenceHelper::Event> even
 
   struct InterferenceHelper::SnrPer snrPer;
   snrPer = m_interference.CalculateSnrPer (event);
+  m_interference.NotifyRxEnd ();
 
   NS_LOG_DEBUG ("mode="<<(event->GetPayloadMode ().GetDataRate ())<<
                 ", snr="<<snrPer.snr<<", per="<<snrPer.per<<", size="<<packet->GetSize ());
@@ -178,12 +178,19 @@
 #include "ns3/geo-routing-helper.h"
 #include "ns3/c2c-list-routing-helper.h"
 #include "ns3/beaconing-protocol.h"
+#include "ns3/boolean.h"
+#include "ns3/global-value.h"
 
 NS_LOG_COMPONENT_DEFINE ("InternetStackHelper");
 
 namespace ns3 {
 
 std::vector<InternetStackHelper::Trace> InternetStackHelper::m_traces;
+
+GlobalValue g_c2cBeaconingEnabled = GlobalValue ("C2cBeaconingEnabled",
+                                                 "Aggregate a ns3::BeaconingProtocol to the nodes with a c2c stack",
+                                                 BooleanValue (false),
+                                                 MakeBooleanChecker ());
 std::string InternetStackHelper::m_pcapBaseFilename;
 
 InternetStackHelper::InternetStackHelper ()
@@ -422,7 +429,12 @@ InternetStackHelper::Install (Ptr<Node> node) const
 
      CreateAndAggregateObjectFromTypeId (node, "ns3::c2cL3Protocol");
      CreateAndAggregateObjectFromTypeId (node, "ns3::c2cTransport");
-//     CreateAndAggregateObjectFromTypeId (node, "ns3::BeaconingProtocol"); // Temporary commented by Ramon Bauza
+     BooleanValue beaconing;
+     g_c2cBeaconingEnabled.GetValue (beaconing);
+     if (beaconing.Get ())
+       {
+         CreateAndAggregateObjectFromTypeId (node, "ns3::BeaconingProtocol");
+       }
      CreateAndAggregateObjectFromTypeId (node, "ns3::LocationTable");
 
      Ptr<c2c> C2C = node->GetObject<c2c> ();
@@ -27,10 +27,13 @@
 #include "ns3/yans-wifi-phy.h"
 #include "ns3/wifi-net-device.h"
 #include "ns3/pcap-writer.h"
+#include "ns3/pcapng-writer.h"
+#include "ns3/app-index-tag.h"
 #include "ns3/ascii-writer.h"
 #include "ns3/simulator.h"
 #include "ns3/config.h"
 #include "ns3/names.h"
+#include <map>
 
 namespace ns3 {
 
@@ -49,6 +52,65 @@ static void PcapSniffRxEvent (Ptr<PcapWriter> writer, Ptr<const Packet> packet,
 }
 
 
+/**
+ * Interface of a device in a pcapng file, and the packets it keeps.
+ */
+class PcapNgSniffer : public SimpleRefCount<PcapNgSniffer>
+{
+public:
+  bool Accept (Ptr<const Packet> packet) const
+  {
+    if (appIndexes.empty ())
+      {
+        return true;
+      }
+    AppIndexTag tag;
+    return packet->PeekPacketTag (tag) && appIndexes.find (tag.Get ()) != appIndexes.end ();
+  }
+
+  Ptr<PcapNgWriter> writer;
+  uint32_t interface;
+  std::set<uint32_t> appIndexes;
+};
+
+/**
+ * Devices already written to a pcapng file, aggregated to its writer so
+ * that the devices installed later on a node can be added.
+ */
+class PcapNgWifiDevices : public Object
+{
+public:
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ns3::PcapNgWifiDevices")
+      .SetParent<Object> ()
+      ;
+    return tid;
+  }
+
+  std::set<uint32_t> appIndexes;
+  // number of devices of each node, by node id, already looked at
+  std::map<uint32_t, uint32_t> nDevices;
+};
+
+static void PcapNgSniffTxEvent (Ptr<PcapNgSniffer> sniffer, Ptr<const Packet> packet, uint16_t channelFreqMhz,  uint16_t channelNumber,
+                                uint32_t rate, bool isShortPreamble)
+{
+  if (sniffer->Accept (packet))
+    {
+      sniffer->writer->WritePacket (sniffer->interface, packet, PcapNgWriter::DIRECTION_OUTBOUND);
+    }
+}
+
+static void PcapNgSniffRxEvent (Ptr<PcapNgSniffer> sniffer, Ptr<const Packet> packet, uint16_t channelFreqMhz,  uint16_t channelNumber,
+                                uint32_t rate, bool isShortPreamble, double signalDbm, double noiseDbm)
+{
+  if (sniffer->Accept (packet))
+    {
+      sniffer->writer->WritePacket (sniffer->interface, packet, PcapNgWriter::DIRECTION_INBOUND);
+    }
+}
+
 static void AsciiPhyTxEvent (Ptr<AsciiWriter> writer, std::string path,
                              Ptr<const Packet> packet,
                              WifiMode mode, WifiPreamble preamble,
@@ -332,6 +394,48 @@ YansWifiPhyHelper::EnablePcapAll (std::string filename)
   EnablePcap (filename, NodeContainer::GetGlobal ());
 }
 
+Ptr<PcapNgWriter>
+YansWifiPhyHelper::EnablePcapNg (std::string filename, NodeContainer n, std::set<uint32_t> appIndexes)
+{
+  Ptr<PcapNgWriter> writer = CreateObject<PcapNgWriter> ();
+  writer->Open (filename);
+  Simulator::ScheduleDestroy (&PcapNgWriter::Close, writer);
+  Ptr<PcapNgWifiDevices> devices = CreateObject<PcapNgWifiDevices> ();
+  devices->appIndexes = appIndexes;
+  writer->AggregateObject (devices);
+
+  for (NodeContainer::Iterator i = n.Begin (); i != n.End (); ++i)
+    {
+      AddNode (writer, *i);
+    }
+  return writer;
+}
+
+void
+YansWifiPhyHelper::AddNode (Ptr<PcapNgWriter> writer, Ptr<Node> node)
+{
+  Ptr<PcapNgWifiDevices> devices = writer->GetObject<PcapNgWifiDevices> ();
+  NS_ASSERT_MSG (devices != 0, "The writer was not returned by YansWifiPhyHelper::EnablePcapNg");
+  uint32_t &traced = devices->nDevices[node->GetId ()];
+  for (uint32_t j = traced; j < node->GetNDevices (); ++j)
+    {
+      Ptr<WifiNetDevice> device = node->GetDevice (j)->GetObject<WifiNetDevice> ();
+      if (device == 0)
+        {
+          continue;
+        }
+      std::ostringstream oss;
+      oss << "node" << node->GetId () << "-dev" << j;
+      Ptr<PcapNgSniffer> sniffer = ns3::Create<PcapNgSniffer> ();
+      sniffer->writer = writer;
+      sniffer->interface = writer->AddInterface (PcapNgWriter::LINKTYPE_IEEE802_11, oss.str ());
+      sniffer->appIndexes = devices->appIndexes;
+      device->GetPhy ()->TraceConnectWithoutContext ("PromiscSnifferTx", MakeBoundCallback (&PcapNgSniffTxEvent, sniffer));
+      device->GetPhy ()->TraceConnectWithoutContext ("PromiscSnifferRx", MakeBoundCallback (&PcapNgSniffRxEvent, sniffer));
+    }
+  traced = node->GetNDevices ();
+}
+
 void 
 YansWifiPhyHelper::EnableAscii (std::ostream &os, uint32_t nodeid, uint32_t deviceid)
 {
@@ -22,11 +22,14 @@
 #ifndef YANS_WIFI_HELPER_H
 #define YANS_WIFI_HELPER_H
 
+#include <set>
 #include "wifi-helper.h"
 #include "ns3/yans-wifi-channel.h"
 
 namespace ns3 {
 
+class PcapNgWriter;
+
 /**
  * \brief manage and create wifi channel objects for the yans model.
  *
@@ -304,6 +307,34 @@ public:
    */
    void EnablePcapAll (std::string filename);
 
+  /**
+   * \param filename name of the pcapng file.
+   * \param n container of nodes.
+   * \param appIndexes if not empty, only the packets tagged with one of
+   *        these application indexes (see ns3::AppIndexTag), e.g., those
+   *        of the CAM or the DENM service, are written.
+   * \returns the writer, whose attributes are set from the defaults
+   *          of ns3::PcapNgWriter.
+   *
+   * Write the link-level data of every ns3::WifiNetDevice of the
+   * input nodes to a single pcapng file, each device being an interface
+   * named "node<nodeid>-dev<deviceid>". The file is closed when the
+   * simulator is destroyed.
+   */
+  static Ptr<PcapNgWriter> EnablePcapNg (std::string filename, NodeContainer n,
+                                          std::set<uint32_t> appIndexes = std::set<uint32_t> ());
+
+  /**
+   * \param writer a writer returned by EnablePcapNg.
+   * \param node the node whose new devices are written.
+   *
+   * Add to the pcapng file the ns3::WifiNetDevice devices installed on
+   * the node since the last call, e.g., those of a node created or
+   * equipped with a new technology while the simulation runs. The devices
+   * already in the file are skipped.
+   */
+  static void AddNode (Ptr<PcapNgWriter> writer, Ptr<Node> node);
+
   /**
    * \param os output stream
    * \param nodeid the id of the node to generate ascii output for.
@@ -41,6 +41,10 @@ class CommModuleInstaller : public Object
     virtual void Install (NodeContainer container) = 0; 
     virtual void Configure (std::string Filename) {};
     virtual void RelateInstaller (Ptr<CommModuleInstaller> installer) {};
+    /**
+     * @brief Whether the installation in a vehicle can wait until its first activity, when the stacks are installed lazily (see iTETRISNodeManager::SetLazyInstallRange)
+     */
+    virtual bool IsDeferrable (void) const { return true; };
     virtual ~CommModuleInstaller();
 };
 
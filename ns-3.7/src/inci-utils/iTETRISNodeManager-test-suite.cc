@@ -0,0 +1,305 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2009-2010, Uwicore Laboratory (www.uwicore.umh.es),
+ *                          University Miguel Hernandez, EU FP7 iTETRIS project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/node.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/vehicle-sta-mgnt.h"
+#include "iTETRISNodeManager.h"
+#include <set>
+
+using namespace ns3;
+
+// ===========================================================================
+// Installer of the mobility model of the vehicles, installed on creation
+// ===========================================================================
+class TestMobilityInstaller : public CommModuleInstaller
+{
+public:
+  virtual void Install (NodeContainer container);
+  virtual bool IsDeferrable (void) const { return false; }
+};
+
+void
+TestMobilityInstaller::Install (NodeContainer container)
+{
+  for (NodeContainer::Iterator it = container.Begin (); it != container.End (); it++)
+    {
+      (*it)->AggregateObject (CreateObject<ConstantPositionMobilityModel> ());
+    }
+}
+
+// ===========================================================================
+// Installer of the station management of the vehicles, which records the
+// nodes it is installed in
+// ===========================================================================
+class TestStationInstaller : public CommModuleInstaller
+{
+public:
+  virtual void Install (NodeContainer container);
+
+  std::set<uint32_t> m_installed;
+};
+
+void
+TestStationInstaller::Install (NodeContainer container)
+{
+  for (NodeContainer::Iterator it = container.Begin (); it != container.End (); it++)
+    {
+      Ptr<VehicleStaMgnt> staMgnt = CreateObject<VehicleStaMgnt> ();
+      staMgnt->SetNode (*it);
+      (*it)->AggregateObject (staMgnt);
+      (*it)->SetMobileNode (true);
+      m_installed.insert ((*it)->GetId ());
+    }
+}
+
+// ===========================================================================
+// Base of the test cases: a node manager creating vehicles with the two
+// installers above as default modules
+// ===========================================================================
+class NodeManagerTestCase : public TestCase
+{
+public:
+  NodeManagerTestCase (std::string name);
+  virtual ~NodeManagerTestCase ();
+
+protected:
+  virtual void DoSetup (void);
+  virtual void DoTeardown (void);
+
+  uint32_t CreateVehicle (double x);
+  void MoveVehicle (uint32_t nodeId, double x);
+  bool IsInstalled (uint32_t nodeId);
+
+  iTETRISNodeManager *m_nodeManager;
+  Ptr<TestStationInstaller> m_stationInstaller;
+};
+
+NodeManagerTestCase::NodeManagerTestCase (std::string name)
+  : TestCase (name),
+    m_nodeManager (0)
+{
+}
+
+NodeManagerTestCase::~NodeManagerTestCase ()
+{
+}
+
+void
+NodeManagerTestCase::DoSetup (void)
+{
+  m_nodeManager = new iTETRISNodeManager ();
+  m_stationInstaller = CreateObject<TestStationInstaller> ();
+  m_nodeManager->AttachInstaller ("Mobility", CreateObject<TestMobilityInstaller> ());
+  m_nodeManager->AttachInstaller ("Station", m_stationInstaller);
+  m_nodeManager->SetDefaultModule ("Mobility");
+  m_nodeManager->SetDefaultModule ("Station");
+}
+
+void
+NodeManagerTestCase::DoTeardown (void)
+{
+  delete m_nodeManager;
+  m_nodeManager = 0;
+  m_stationInstaller = 0;
+  // the ids of the nodes start again from 0 in the next test case
+  Simulator::Destroy ();
+}
+
+uint32_t
+NodeManagerTestCase::CreateVehicle (double x)
+{
+  return m_nodeManager->CreateItetrisNode (Vector (x, 0, 0), 0, 0, "", std::vector<std::string> ());
+}
+
+void
+NodeManagerTestCase::MoveVehicle (uint32_t nodeId, double x)
+{
+  m_nodeManager->UpdateNodePosition (nodeId, Vector (x, 0, 0), 0, 0, "");
+}
+
+bool
+NodeManagerTestCase::IsInstalled (uint32_t nodeId)
+{
+  return m_stationInstaller->m_installed.find (nodeId) != m_stationInstaller->m_installed.end ();
+}
+
+// ===========================================================================
+// Test case to make sure that without a lazy install range the stacks are
+// installed when the vehicles are created, and no transmitter is kept.
+// ===========================================================================
+class NodeManagerNoLazyInstallTestCase : public NodeManagerTestCase
+{
+public:
+  NodeManagerNoLazyInstallTestCase ();
+
+private:
+  virtual bool DoRun (void);
+};
+
+NodeManagerNoLazyInstallTestCase::NodeManagerNoLazyInstallTestCase ()
+  : NodeManagerTestCase ("Check the installation of the stacks on creation without lazy install range")
+{
+}
+
+bool
+NodeManagerNoLazyInstallTestCase::DoRun (void)
+{
+  uint32_t a = CreateVehicle (0);
+  uint32_t b = CreateVehicle (5000);
+  NS_TEST_EXPECT_MSG_EQ (IsInstalled (a), true, "The stacks are installed on creation");
+  NS_TEST_EXPECT_MSG_EQ (IsInstalled (b), true, "The stacks are installed on creation");
+  NS_TEST_EXPECT_MSG_EQ (m_nodeManager->IsNodeActive (a), false, "A new vehicle is not active");
+  NS_TEST_EXPECT_MSG_EQ (m_nodeManager->ActivateNode (a), true, "The vehicle could not be activated");
+  NS_TEST_EXPECT_MSG_EQ (m_nodeManager->IsNodeActive (a), true, "The vehicle was not activated");
+
+  m_nodeManager->NotifyTxon (a, "CAM");
+  NS_TEST_EXPECT_MSG_EQ (m_nodeManager->GetNTransmitters (), 0, "No transmitter is kept without lazy installation");
+
+  return GetErrorStatus ();
+}
+
+// ===========================================================================
+// Test case to make sure that the stacks are installed on the transmission
+// of a vehicle and in the vehicles in its range, and that the transmitters
+// are forgotten once they stop transmitting or are deactivated.
+// ===========================================================================
+class NodeManagerTxonTestCase : public NodeManagerTestCase
+{
+public:
+  NodeManagerTxonTestCase ();
+
+private:
+  virtual bool DoRun (void);
+};
+
+NodeManagerTxonTestCase::NodeManagerTxonTestCase ()
+  : NodeManagerTestCase ("Check the installation of the stacks on transmission and in range")
+{
+}
+
+bool
+NodeManagerTxonTestCase::DoRun (void)
+{
+  m_nodeManager->SetLazyInstallRange (100);
+  uint32_t a = CreateVehicle (0);
+  uint32_t b = CreateVehicle (50);
+  uint32_t c = CreateVehicle (500);
+  NS_TEST_EXPECT_MSG_EQ (m_stationInstaller->m_installed.size (), 0, "The stacks are not installed on creation");
+  NS_TEST_EXPECT_MSG_EQ (m_nodeManager->GetItetrisNode (a)->GetObject<MobilityModel> () != 0, true,
+                         "The modules that are not deferrable are installed on creation");
+
+  m_nodeManager->ActivateNode (a);
+  m_nodeManager->NotifyTxon (a, "CAM");
+  m_nodeManager->NotifyTxon (a, "service");
+  NS_TEST_EXPECT_MSG_EQ (IsInstalled (a), true, "The stacks are installed on the first transmission");
+  NS_TEST_EXPECT_MSG_EQ (IsInstalled (b), true, "The stacks are installed in the range of a transmission");
+  NS_TEST_EXPECT_MSG_EQ (IsInstalled (c), false, "The stacks are not installed out of the range of a transmission");
+  NS_TEST_EXPECT_MSG_EQ (m_nodeManager->GetNTransmitters (), 1, "Expected one transmitter");
+
+  MoveVehicle (c, 80);
+  NS_TEST_EXPECT_MSG_EQ (IsInstalled (c), true, "The stacks are installed when coming in the range of a transmitter");
+
+  // the transmitter is kept while it has a transmission
+  m_nodeManager->NotifyStopTxon (a, "CAM");
+  NS_TEST_EXPECT_MSG_EQ (m_nodeManager->GetNTransmitters (), 1, "The transmitter has still a transmission");
+  uint32_t d = CreateVehicle (20);
+  NS_TEST_EXPECT_MSG_EQ (IsInstalled (d), true, "The stacks are installed when created in the range of a transmitter");
+
+  m_nodeManager->NotifyStopTxon (a, "service");
+  NS_TEST_EXPECT_MSG_EQ (m_nodeManager->GetNTransmitters (), 0, "The transmitter has no transmission left");
+  uint32_t e = CreateVehicle (1000);
+  MoveVehicle (e, 10);
+  NS_TEST_EXPECT_MSG_EQ (IsInstalled (e), false, "A node without transmission does not install the stacks in its range");
+
+  // a deactivated transmitter is forgotten
+  uint32_t f = CreateVehicle (3000);
+  m_nodeManager->ActivateNode (f);
+  m_nodeManager->NotifyTxon (f, "CAM");
+  NS_TEST_EXPECT_MSG_EQ (m_nodeManager->GetNTransmitters (), 1, "Expected one transmitter");
+  m_nodeManager->DeactivateNode (f);
+  NS_TEST_EXPECT_MSG_EQ (m_nodeManager->GetNTransmitters (), 0, "A deactivated node is no longer a transmitter");
+  uint32_t g = CreateVehicle (3010);
+  NS_TEST_EXPECT_MSG_EQ (IsInstalled (g), false, "A deactivated node does not install the stacks in its range");
+
+  return GetErrorStatus ();
+}
+
+// ===========================================================================
+// Test case to make sure that the activation of a vehicle waiting for its
+// stacks is applied to its station management once they are installed.
+// ===========================================================================
+class NodeManagerPendingActivationTestCase : public NodeManagerTestCase
+{
+public:
+  NodeManagerPendingActivationTestCase ();
+
+private:
+  virtual bool DoRun (void);
+};
+
+NodeManagerPendingActivationTestCase::NodeManagerPendingActivationTestCase ()
+  : NodeManagerTestCase ("Check the activation of the vehicles waiting for their stacks")
+{
+}
+
+bool
+NodeManagerPendingActivationTestCase::DoRun (void)
+{
+  m_nodeManager->SetLazyInstallRange (100);
+  uint32_t a = CreateVehicle (0);
+  uint32_t b = CreateVehicle (50);
+
+  NS_TEST_EXPECT_MSG_EQ (m_nodeManager->IsNodeActive (a), false, "A new vehicle is not active");
+  NS_TEST_EXPECT_MSG_EQ (m_nodeManager->ActivateNode (a), true, "A pending vehicle could not be activated");
+  NS_TEST_EXPECT_MSG_EQ (m_nodeManager->IsNodeActive (a), true, "The activation of a pending vehicle was not remembered");
+  m_nodeManager->ActivateNode (b);
+  NS_TEST_EXPECT_MSG_EQ (m_nodeManager->DeactivateNode (b), true, "A pending vehicle could not be deactivated");
+  NS_TEST_EXPECT_MSG_EQ (m_nodeManager->IsNodeActive (b), false, "The deactivation of a pending vehicle was not remembered");
+  NS_TEST_EXPECT_MSG_EQ (IsInstalled (a) || IsInstalled (b), false, "The activation does not install the stacks");
+
+  m_nodeManager->NotifyTxon (a, "CAM");
+  NS_TEST_EXPECT_MSG_EQ (IsInstalled (a), true, "The stacks are installed on the first transmission");
+  NS_TEST_EXPECT_MSG_EQ (IsInstalled (b), true, "The stacks are installed in the range of a transmission");
+  Ptr<VehicleStaMgnt> staMgnt = m_nodeManager->GetItetrisNode (a)->GetObject<VehicleStaMgnt> ();
+  NS_TEST_EXPECT_MSG_EQ (staMgnt->IsNodeActive (), true, "The station management was not activated");
+  NS_TEST_EXPECT_MSG_EQ (m_nodeManager->IsNodeActive (a), true, "The vehicle is no longer active");
+  staMgnt = m_nodeManager->GetItetrisNode (b)->GetObject<VehicleStaMgnt> ();
+  NS_TEST_EXPECT_MSG_EQ (staMgnt->IsNodeActive (), false, "The station management of a deactivated vehicle was activated");
+
+  return GetErrorStatus ();
+}
+
+class NodeManagerTestSuite : public TestSuite
+{
+public:
+  NodeManagerTestSuite ();
+};
+
+NodeManagerTestSuite::NodeManagerTestSuite ()
+  : TestSuite ("itetris-node-manager", UNIT)
+{
+  AddTestCase (new NodeManagerNoLazyInstallTestCase);
+  AddTestCase (new NodeManagerTxonTestCase);
+  AddTestCase (new NodeManagerPendingActivationTestCase);
+}
+
+NodeManagerTestSuite nodeManagerTestSuite;
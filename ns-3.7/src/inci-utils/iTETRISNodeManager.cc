@@ -27,6 +27,7 @@
 #include "ns3/node-container.h"
 #include "ns3/vehicle-sta-mgnt.h"
 #include "ns3/itetris-mobility-model.h" 
+#include "ns3/yans-wifi-helper.h"
 
 using namespace std;
 
@@ -35,7 +36,9 @@ NS_LOG_COMPONENT_DEFINE ("iTETRISNodeManager");
 namespace ns3
 {
     
-iTETRISNodeManager::iTETRISNodeManager(){} 
+iTETRISNodeManager::iTETRISNodeManager()
+  : m_lazyInstallRange (0)
+{} 
 
 uint32_t iTETRISNodeManager::CreateItetrisNode (Vector position)
 {
@@ -65,6 +68,45 @@ uint32_t iTETRISNodeManager::CreateItetrisNode (const Vector &position, const fl
   return node->GetId();	
 }
 
+uint32_t iTETRISNodeManager::CreateItetrisNode (const Vector &position, const float &speed, const float & heading, const std::string &laneId, const std::vector<std::string> &modules)
+{
+  if (m_lazyInstallRange <= 0)
+    {
+      uint32_t nodeId = CreateItetrisNode (position, speed, heading, laneId);
+      for (vector<string>::const_iterator it = modules.begin (); it != modules.end (); it++)
+        {
+          InstallCommunicationModule (*it);
+        }
+      return nodeId;
+    }
+
+  m_iTETRISNodes.Create (1);
+  Ptr<Node> singleNode = m_iTETRISNodes.Get(m_iTETRISNodes.GetN() - 1);
+  NodeContainer singleNodeContainer;
+  singleNodeContainer.Add(singleNode);
+  struct PendingNode pending;
+  vector<Ptr<CommModuleInstaller> >::iterator it;
+  for (it = m_defaultModules.begin(); it < m_defaultModules.end(); it++)
+  {
+    if ((*it)->IsDeferrable ())
+      {
+        pending.defaultModules.push_back (*it);
+      }
+    else
+      {
+        (*it)->Install(singleNodeContainer);
+      }
+  }
+  NotifyInstalled (singleNode);
+  pending.modules = modules;
+  pending.active = false;
+  m_pendingNodes.insert (std::make_pair (singleNode->GetId (), pending));
+
+  UpdateNodePosition (singleNode->GetId (), position, speed, heading, laneId);
+  NS_LOG_DEBUG ( "ns-3 server --> node " << singleNode->GetId () << " created, stacks installed on its first activity" );
+  return singleNode->GetId ();
+}
+
 void iTETRISNodeManager::CreateItetrisNode (void)
 {
   m_iTETRISNodes.Create (1);
@@ -76,6 +118,7 @@ void iTETRISNodeManager::CreateItetrisNode (void)
   {
     (*it)->Install(singleNodeContainer);
   }
+  NotifyInstalled (singleNode);
 }
 
 
@@ -87,10 +130,18 @@ void iTETRISNodeManager::CreateItetrisTMC (void)
   singleNodeContainer.Add(singleNode);
   Ptr<CommModuleInstaller> comInstaller = GetInstaller ("TMC");
   comInstaller->Install(singleNodeContainer);
+  NotifyInstalled (singleNode);
 }
 
 NodeContainer*
 iTETRISNodeManager::InstallCommunicationModule (std::string typeOfModule)
+{
+  InstallCommunicationModule (typeOfModule, m_iTETRISNodes.Get(m_iTETRISNodes.GetN() - 1));
+  return (m_itetrisTechNodes.find(typeOfModule)->second);
+}
+
+void
+iTETRISNodeManager::InstallCommunicationModule (std::string typeOfModule, Ptr<Node> node)
 {
   NodeContainerList::iterator iterCommModule = m_itetrisTechNodes.find(typeOfModule);
   if( iterCommModule != m_itetrisTechNodes.end() ) 
@@ -100,18 +151,16 @@ iTETRISNodeManager::InstallCommunicationModule (std::string typeOfModule)
       if( iterInstaller != m_itetrisInstallers.end() ) 
         {	  
           Ptr<CommModuleInstaller> installer = iterInstaller->second;	 
-          Ptr<Node> singleNode = m_iTETRISNodes.Get(m_iTETRISNodes.GetN() - 1);	  
           NodeContainer singleNodeContainer;
-          singleNodeContainer.Add(singleNode);
+          singleNodeContainer.Add(node);
 	  installer->Install(singleNodeContainer);
-	  container->Add(singleNode);	  	  
-	  return (container);
+	  container->Add(node);	  	  
+	  NotifyInstalled (node);
+	  return;
         }
       NS_FATAL_ERROR ( "Communication module installer not found in iTETRISNodeManager - " << typeOfModule );
-      return (NULL);
     }
   NS_FATAL_ERROR ( "Communication module not found in iTETRISNodeManager - " << typeOfModule );
-  return (NULL);  
 }
 
 void
@@ -163,6 +212,7 @@ iTETRISNodeManager::UpdateNodePosition (uint32_t nodeId, Vector position)
   Ptr<Node> node = m_iTETRISNodes.Get(nodeId);  
   Ptr<MobilityModel> mobModel = node->GetObject<MobilityModel> ();  
   mobModel->SetPosition(position);  
+  CheckPendingNode (nodeId);
 }
 
 void
@@ -174,9 +224,12 @@ iTETRISNodeManager::UpdateNodePosition (uint32_t nodeId, const Vector &position,
     {
       Ptr<MobilityModel> basicMobModel = node->GetObject<MobilityModel> (); 
       basicMobModel->SetPosition (position);
-      return;
     } 
-  itetrisMobModel->SetPositionAndSpeed (position,speed, heading, GetEdgeId (laneId), laneId);  
+  else
+    {
+      itetrisMobModel->SetPositionAndSpeed (position,speed, heading, GetEdgeId (laneId), laneId);  
+    }
+  CheckPendingNode (nodeId);
 }
 
 Ptr<Node> 
@@ -205,6 +258,13 @@ iTETRISNodeManager::GetInstaller (std::string typeOfModule)
 bool
 iTETRISNodeManager::ActivateNode (uint32_t nodeId)
 {
+  PendingNodeList::iterator pending = m_pendingNodes.find (nodeId);
+  if (pending != m_pendingNodes.end ())
+    {
+      // applied to the station management once it is installed
+      pending->second.active = true;
+      return true;
+    }
   Ptr<Node> node = GetItetrisNode (nodeId);
   if (node)
     {
@@ -227,6 +287,14 @@ iTETRISNodeManager::ActivateNode (uint32_t nodeId)
 bool 
 iTETRISNodeManager::DeactivateNode (uint32_t nodeId)
 {
+  // the vehicles leaving the simulation are deactivated
+  m_transmitters.erase (nodeId);
+  PendingNodeList::iterator pending = m_pendingNodes.find (nodeId);
+  if (pending != m_pendingNodes.end ())
+    {
+      pending->second.active = false;
+      return true;
+    }
   Ptr<Node> node = GetItetrisNode (nodeId);
   if (node)
     {
@@ -243,6 +311,11 @@ iTETRISNodeManager::DeactivateNode (uint32_t nodeId)
 
 bool iTETRISNodeManager::IsNodeActive (uint32_t nodeId)
 {
+  PendingNodeList::iterator pending = m_pendingNodes.find (nodeId);
+  if (pending != m_pendingNodes.end ())
+    {
+      return pending->second.active;
+    }
   Ptr<Node> node = GetItetrisNode (nodeId);
   if (node)
     {
@@ -257,6 +330,139 @@ bool iTETRISNodeManager::IsNodeActive (uint32_t nodeId)
   return true; // Fixed nodes are considered to be always active
 }
 
+void
+iTETRISNodeManager::SetLazyInstallRange (double range)
+{
+  m_lazyInstallRange = range;
+}
+
+void
+iTETRISNodeManager::NotifyTxon (uint32_t nodeId, std::string txonId)
+{
+  if (m_lazyInstallRange <= 0)
+    {
+      return;
+    }
+  InstallPendingNode (nodeId);
+  m_transmitters[nodeId].insert (txonId);
+
+  Ptr<Node> node = GetItetrisNode (nodeId);
+  if (node == NULL || node->GetObject<MobilityModel> () == NULL)
+    {
+      return;
+    }
+  Ptr<MobilityModel> txMobility = node->GetObject<MobilityModel> ();
+  vector<uint32_t> inRange;
+  for (PendingNodeList::const_iterator it = m_pendingNodes.begin (); it != m_pendingNodes.end (); it++)
+    {
+      Ptr<MobilityModel> mobility = m_iTETRISNodes.Get (it->first)->GetObject<MobilityModel> ();
+      if (mobility->GetDistanceFrom (txMobility) <= m_lazyInstallRange)
+        {
+          inRange.push_back (it->first);
+        }
+    }
+  for (vector<uint32_t>::const_iterator it = inRange.begin (); it != inRange.end (); it++)
+    {
+      InstallPendingNode (*it);
+    }
+}
+
+void
+iTETRISNodeManager::NotifyStopTxon (uint32_t nodeId, std::string txonId)
+{
+  TransmitterList::iterator it = m_transmitters.find (nodeId);
+  if (it == m_transmitters.end ())
+    {
+      return;
+    }
+  it->second.erase (txonId);
+  if (it->second.empty ())
+    {
+      m_transmitters.erase (it);
+    }
+}
+
+uint32_t
+iTETRISNodeManager::GetNTransmitters (void) const
+{
+  return m_transmitters.size ();
+}
+
+void
+iTETRISNodeManager::InstallPendingNode (uint32_t nodeId)
+{
+  PendingNodeList::iterator it = m_pendingNodes.find (nodeId);
+  if (it == m_pendingNodes.end ())
+    {
+      return;
+    }
+  struct PendingNode pending = it->second;
+  m_pendingNodes.erase (it);
+
+  Ptr<Node> node = m_iTETRISNodes.Get (nodeId);
+  NodeContainer singleNodeContainer;
+  singleNodeContainer.Add (node);
+  for (vector<Ptr<CommModuleInstaller> >::iterator installer = pending.defaultModules.begin (); installer != pending.defaultModules.end (); installer++)
+    {
+      (*installer)->Install (singleNodeContainer);
+    }
+  NotifyInstalled (node);
+  for (vector<string>::const_iterator module = pending.modules.begin (); module != pending.modules.end (); module++)
+    {
+      InstallCommunicationModule (*module, node);
+    }
+  if (pending.active)
+    {
+      ActivateNode (nodeId);
+    }
+  NS_LOG_DEBUG ( "ns-3 server --> stacks of node " << nodeId << " installed, " << m_pendingNodes.size () << " nodes still pending" );
+}
+
+void
+iTETRISNodeManager::EnablePcapNg (std::string filename, std::set<uint32_t> appIndexes, std::set<uint32_t> nodeIds)
+{
+  m_pcapNgNodes = nodeIds;
+  NodeContainer traced;
+  for (NodeContainer::Iterator it = m_iTETRISNodes.Begin (); it != m_iTETRISNodes.End (); it++)
+    {
+      if (m_pcapNgNodes.empty () || m_pcapNgNodes.count ((*it)->GetId ()) > 0)
+        {
+          traced.Add (*it);
+        }
+    }
+  m_pcapNg = YansWifiPhyHelper::EnablePcapNg (filename, traced, appIndexes);
+}
+
+void
+iTETRISNodeManager::NotifyInstalled (Ptr<Node> node)
+{
+  if (m_pcapNg != 0
+      && (m_pcapNgNodes.empty () || m_pcapNgNodes.count (node->GetId ()) > 0))
+    {
+      YansWifiPhyHelper::AddNode (m_pcapNg, node);
+    }
+}
+
+void
+iTETRISNodeManager::CheckPendingNode (uint32_t nodeId)
+{
+  if (m_pendingNodes.find (nodeId) == m_pendingNodes.end ())
+    {
+      return;
+    }
+  Ptr<MobilityModel> mobility = m_iTETRISNodes.Get (nodeId)->GetObject<MobilityModel> ();
+  for (TransmitterList::const_iterator it = m_transmitters.begin (); it != m_transmitters.end (); it++)
+    {
+      Ptr<MobilityModel> txMobility = m_iTETRISNodes.Get (it->first)->GetObject<MobilityModel> ();
+      if (txMobility != NULL && IsNodeActive (it->first)
+          && mobility->GetDistanceFrom (txMobility) <= m_lazyInstallRange)
+        {
+          InstallPendingNode (nodeId);
+          return;
+        }
+    }
+}
+
 std::string 
 iTETRISNodeManager::GetEdgeId (std::string laneId)
 {
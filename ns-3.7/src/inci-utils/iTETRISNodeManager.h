@@ -23,8 +23,10 @@
 #define ITETRISNODEMANAGER_H
 
 #include "ns3/mobility-model.h"
+#include "ns3/pcapng-writer.h"
 #include "comm-module-installer.h"
 #include <map>
+#include <set>
 
 namespace ns3
 {
@@ -47,6 +49,11 @@ class iTETRISNodeManager
     void CreateItetrisNode (void); 
     uint32_t CreateItetrisNode (Vector position); 
     uint32_t CreateItetrisNode (const Vector &position, const float &speed, const float & heading, const std::string &laneId); 
+
+    /**
+     * @brief Create a vehicle with its communication modules. With lazy installation, only the modules that are not deferrable are installed now, and the others on the first activity of the vehicle
+     */
+    uint32_t CreateItetrisNode (const Vector &position, const float &speed, const float & heading, const std::string &laneId, const std::vector<std::string> &modules); 
     void CreateItetrisTMC (void);
 
     /**
@@ -91,10 +98,52 @@ class iTETRISNodeManager
     bool DeactivateNode (uint32_t nodeId);
     bool IsNodeActive (uint32_t nodeId);
 
+    /**
+     * @brief Install the stacks of the vehicles lazily: on their first transmission, or when they get within 'range' meters of a node that has transmitted. A null range (the default) installs them on creation
+     */
+    void SetLazyInstallRange (double range);
+
+    /**
+     * @brief Notify that a node starts the transmission 'txonId' (e.g. a service id), so that it and the vehicles in its range get their stacks installed
+     */
+    void NotifyTxon (uint32_t nodeId, std::string txonId);
+
+    /**
+     * @brief Notify that a node stops the transmission 'txonId'. A node without transmission no longer installs the stacks of the vehicles coming in its range
+     */
+    void NotifyStopTxon (uint32_t nodeId, std::string txonId);
+
+    /**
+     * @brief Get the number of nodes with an ongoing transmission
+     */
+    uint32_t GetNTransmitters (void) const;
+
+    /**
+     * @brief Write the frames of the WiFi devices of all the nodes, including those created or equipped later, to the pcapng file 'filename'. A non-empty 'appIndexes' keeps only the packets of these applications, and a non-empty 'nodeIds' only the devices of these nodes
+     */
+    void EnablePcapNg (std::string filename, std::set<uint32_t> appIndexes = std::set<uint32_t> (), std::set<uint32_t> nodeIds = std::set<uint32_t> ());
+
   private:
 
     std::string GetEdgeId (std::string laneId);
 
+    void InstallCommunicationModule (std::string typeOfModule, Ptr<Node> node);
+
+    /**
+     * @brief Install the deferred modules of a vehicle, if it has any
+     */
+    void InstallPendingNode (uint32_t nodeId);
+
+    /**
+     * @brief Install the deferred modules of a vehicle if it is in the range of a node that has transmitted
+     */
+    void CheckPendingNode (uint32_t nodeId);
+
+    /**
+     * @brief Add the devices just installed on a node to the pcapng file, if any
+     */
+    void NotifyInstalled (Ptr<Node> node);
+
     /**
      * @brief Node container with all the iTETRIS nodes
      */
@@ -114,6 +163,35 @@ class iTETRISNodeManager
     InstallerContainerList m_itetrisInstallers;  
 
     std::vector<Ptr<CommModuleInstaller> > m_defaultModules;
+
+    /**
+     * @brief Modules of a vehicle waiting for its first activity
+     */
+    struct PendingNode
+    {
+      std::vector<Ptr<CommModuleInstaller> > defaultModules;
+      std::vector<std::string> modules;
+      bool active;
+    };
+    typedef std::map<uint32_t, struct PendingNode> PendingNodeList;
+
+    PendingNodeList m_pendingNodes;
+
+    typedef std::map<uint32_t, std::set<std::string> > TransmitterList;
+
+    /**
+     * @brief Ongoing transmissions of the nodes, a node is removed once it has none or it is deactivated
+     */
+    TransmitterList m_transmitters;
+
+    double m_lazyInstallRange;
+
+    Ptr<PcapNgWriter> m_pcapNg;
+
+    /**
+     * @brief Nodes whose devices are written to the pcapng file, all of them if empty
+     */
+    std::set<uint32_t> m_pcapNgNodes;
  
 };
 
@@ -36,6 +36,8 @@ class MobilityModelInstaller : public CommModuleInstaller
     static TypeId GetTypeId (void);
     MobilityModelInstaller();
     void Install (NodeContainer container); 
+    // idle vehicles still have to follow their position updates
+    bool IsDeferrable (void) const { return false; }
 
   private:
 
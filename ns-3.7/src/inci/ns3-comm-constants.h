@@ -96,9 +96,22 @@
 // command: deactivate the MW txon of a service running in the TMC.
 #define CMD_STOP_MW_SERVICE_TXON 0x16
 
+// command: negotiate the encoding of the messages, answered with the accepted version
+#define CMD_SET_PROTOCOL_VERSION 0x17
+
 // command: close
 #define CMD_CLOSE 0x7F
 
+// ****************************************
+// PROTOCOL VERSIONS
+// ****************************************
+
+// node ids and received messages sent as lists of decimal strings
+#define INCI_PROTOCOL_VERSION_STRINGS 1
+// node ids sent as integer arrays, received messages as a type table plus packed records,
+// CMD_SIMSTEP answered with the number of events and the wall time (ms) of the step
+#define INCI_PROTOCOL_VERSION_BINARY 2
+
 // ****************************************
 // RESULT TYPES
 // ****************************************
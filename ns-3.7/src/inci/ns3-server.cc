@@ -24,7 +24,11 @@
 #include "ns3-server.h"
 #include "ns3-commands.h"
 #include "ns3-comm-constants.h"
+#include "ns3/shm-channel.h"
+#include "ns3/profiler.h"
 #include <iostream>
+#include <stdlib.h>
+#include <sys/time.h>
 
 using namespace std;
 using namespace tcpip;
@@ -39,23 +43,37 @@ ofstream Ns3Server::myfile;
 string Ns3Server::CAM_TYPE = "0";
 string Ns3Server::DNEM_TYPE = "1";
 bool Ns3Server::logActive_ = false;
+string Ns3Server::shmChannel_ = "";
+int Ns3Server::protocolVersion_ = INCI_PROTOCOL_VERSION_STRINGS;
 
 Ns3Server::Ns3Server(int port, iTETRISNodeManager *node_manager, PacketManager *packetManager)
 {  
 	myDoingSimStep = false;
 	closeConnection_ = false;
+	// A client that does not negotiate speaks the original string based encoding
+	protocolVersion_ = INCI_PROTOCOL_VERSION_STRINGS;
 	my_nodeManagerPtr= node_manager;
 	my_packetManagerPtr= packetManager;
 
 	try
 	{
-		socket_ = new ServerSocket(port);
+		if (shmChannel_.empty()) {
+			socket_ = new ServerSocket(port);
+		} else {
+			socket_ = new ServerSocket(ShmChannel::HOST_PREFIX + shmChannel_, port);
+		}
 		socket_->accept();
 	} catch(SocketException e) {
 		cout << "ns-3 server --> #Error while creating socket: " << e.what() << endl;
 	}
 } 
 
+void
+Ns3Server::SetSharedMemoryChannel(string name)
+{
+	shmChannel_ = name;
+}
+
 void
 Ns3Server::processCommandsUntilSimStep(int port, string logfile, iTETRISNodeManager *node_manager, PacketManager *packetManager) {
 
@@ -150,9 +168,7 @@ Ns3Server::dispatchCommand()
 
 	stringstream log;
 
-	// dispatch commands
-	switch (commandId) {
-	case CMD_SIMSTEP:
+	if (commandId == CMD_SIMSTEP) {
 #ifdef _DEBUG
 		log <<"ns-3 server --> CMD_SIMSTEP received" << endl; ;
 		Log((log.str()).c_str());
@@ -160,6 +176,13 @@ Ns3Server::dispatchCommand()
 #endif
 		success = RunSimStep (myInputStorage.readInt());
 		return commandId;
+	}
+
+	// the simulation step reports the profile, it is not part of it
+	NS_PROFILE_SCOPE ("inci-server");
+
+	// dispatch commands
+	switch (commandId) {
 	case CMD_UPDATENODE:
 #ifdef _DEBUG
 		log << "ns-3 server --> CMD_UPDATENODE received" << endl;
@@ -293,6 +316,13 @@ Ns3Server::dispatchCommand()
 #endif
 		success = DeactivateNode ();
 		break;
+	case CMD_SET_PROTOCOL_VERSION:
+#ifdef _DEBUG
+		log<< "ns-3 server --> CMD_SET_PROTOCOL_VERSION received" << endl;
+		Log((log.str()).c_str());
+#endif
+		success = SetProtocolVersion ();
+		break;
 	default:
 		writeStatusCmd(commandId, RTYPE_NOTIMPLEMENTED, "Command not implemented in ns3");
 	}
@@ -351,23 +381,35 @@ Ns3Server::RunSimStep(int time)
 	Log((log.str()).c_str());
 #endif
 
-	if ( !(Simulator::IsFinished()) )  // IsFinished == true if no event to be scheduled anymore || Simulator::Stop reached
+	bool running = !(Simulator::IsFinished());  // IsFinished == true if no event to be scheduled anymore || Simulator::Stop reached
+	uint64_t eventCounter = 0;
+	struct timeval start;
+	gettimeofday(&start, 0);
+	if (running)
 	{
-		int eventCounter=0;
-		while ( !(Simulator::IsFinished()) && (Seconds(time) > Simulator::Next ()) )
-		{
-			Simulator::RunOneEvent ();
-			eventCounter++;
-		}
-
-		writeStatusCmd(CMD_SIMSTEP, RTYPE_OK, "RunSimStep()");
-		return true;
+		eventCounter = Simulator::RunUntil (Seconds(time));
 	}
-	else
+	struct timeval end;
+	gettimeofday(&end, 0);
+	double wallTime = (end.tv_sec - start.tv_sec) * 1000.0 + (end.tv_usec - start.tv_usec) / 1000.0;
+	NS_PROFILE_STEP (time);
+
+#ifdef _DEBUG
+	log.str("");
+	log << "[RunSimStep] Processed " << eventCounter << " events in " << wallTime << " ms";
+	Log((log.str()).c_str());
+#endif
+
+	writeStatusCmd(CMD_SIMSTEP, RTYPE_OK, running ? "RunSimStep()" : "RunSimStep(), simulation finishes");
+	if (protocolVersion_ >= INCI_PROTOCOL_VERSION_BINARY)
 	{
-		writeStatusCmd(CMD_SIMSTEP, RTYPE_OK, "RunSimStep(), simulation finishes");
-		return false;
+		// step statistics, for profiling on the iCS side
+		myOutputStorage.writeInt(4 + 1 + 4 + 8);
+		myOutputStorage.writeUnsignedByte(CMD_SIMSTEP);
+		myOutputStorage.writeInt(eventCounter);
+		myOutputStorage.writeDouble(wallTime);
 	}
+	return running;
 }
 
 bool
@@ -386,10 +428,10 @@ Ns3Server::CreateNode (void)
 
 	for (moduleIt = listOfCommModules.begin() ; moduleIt < listOfCommModules.end() ; moduleIt++)
 	{
-		string cadena = *moduleIt;
+		string nodeId = *moduleIt;
 
 #ifdef _DEBUG
-		log<< "ns-3 server --> Nodes IDs: " << cadena << endl;
+		log<< "ns-3 server --> Nodes IDs: " << nodeId << endl;
 		Log((log.str()).c_str());
 #endif
 
@@ -425,7 +467,8 @@ Ns3Server::CreateNode2 (void)
 	vector<string> listOfCommModules = myInputStorage.readStringList();
 	vector<string>::iterator moduleIt;
 
-	int32_t nodeId=my_nodeManagerPtr->CreateItetrisNode (pos, speed, heading, laneId);
+	// with lazy installation, the modules are only installed on the first activity of the vehicle
+	int32_t nodeId=my_nodeManagerPtr->CreateItetrisNode (pos, speed, heading, laneId, listOfCommModules);
 
 #ifdef _DEBUG
 	stringstream log;
@@ -433,14 +476,13 @@ Ns3Server::CreateNode2 (void)
 
 	for (moduleIt = listOfCommModules.begin() ; moduleIt < listOfCommModules.end() ; moduleIt++)
 	{
-		string cadena = *moduleIt;
+		string nodeId = *moduleIt;
 
 #ifdef _DEBUG
-		log<< "ns-3 server --> Nodes IDs: " << cadena << endl;
+		log<< "ns-3 server --> Nodes IDs: " << nodeId << endl;
 		Log((log.str()).c_str());
 #endif
 
-		my_nodeManagerPtr->InstallCommunicationModule (*moduleIt);
 		success = true;
 	}
 
@@ -507,15 +549,11 @@ Ns3Server::UpdateNodePosition2 ()
 bool 
 Ns3Server::ActivateNode (void)
 {
-	vector<string> idCollection = myInputStorage.readStringList();
-	vector<string>::iterator nodeIt;
+	vector<uint32_t> idCollection = ReadNodeIdList ();
+	vector<uint32_t>::const_iterator nodeIt;
 	for (nodeIt = idCollection.begin() ; nodeIt < idCollection.end() ; nodeIt++)
 	{
-		string cadena = *nodeIt;
-		stringstream temp;
-		uint32_t nodeId;
-		temp << cadena;
-		temp >> nodeId;
+		uint32_t nodeId = *nodeIt;
 
 #ifdef _DEBUG
 		stringstream logNode;
@@ -533,15 +571,11 @@ Ns3Server::ActivateNode (void)
 bool 
 Ns3Server::DeactivateNode (void)
 {
-	vector<string> idCollection = myInputStorage.readStringList();
-	vector<string>::iterator nodeIt;
+	vector<uint32_t> idCollection = ReadNodeIdList ();
+	vector<uint32_t>::const_iterator nodeIt;
 	for (nodeIt = idCollection.begin() ; nodeIt < idCollection.end() ; nodeIt++)
 	{
-		string cadena = *nodeIt;
-		stringstream temp;
-		uint32_t nodeId;
-		temp << cadena;
-		temp >> nodeId;
+		uint32_t nodeId = *nodeIt;
 
 #ifdef _DEBUG
 		stringstream logNode;
@@ -559,27 +593,24 @@ Ns3Server::DeactivateNode (void)
 bool
 Ns3Server::StartSendingCam()
 {
-	vector<string> senderIdCollection = myInputStorage.readStringList();
+	vector<uint32_t> senderIdCollection = ReadNodeIdList ();
 	int payloadLength = myInputStorage.readInt();
 	float frequency = myInputStorage.readFloat();
 
 	string ids;
-	vector<string>::iterator senderIt;
+	vector<uint32_t>::const_iterator senderIt;
 	for (senderIt = senderIdCollection.begin() ; senderIt < senderIdCollection.end() ; senderIt++)
 	{
-		string cadena = *senderIt;
+		uint32_t nodeId = *senderIt;
 
 #ifdef _DEBUG
 		stringstream log;
 		log << "[StartSendingCam] Node Starts Sending CAM [ns3-ID|Frequency|Payload Length] [" ;
-		log << cadena << "|" << frequency << "|" << payloadLength << "]";
+		log << nodeId << "|" << frequency << "|" << payloadLength << "]";
 		Log((log.str()).c_str());
 #endif
 
-		stringstream temp;
-		uint32_t nodeId;
-		temp << cadena;
-		temp >> nodeId;
+		my_nodeManagerPtr->NotifyTxon (nodeId, "CAM");
 		my_packetManagerPtr->ActivateCamTxon (nodeId, frequency, payloadLength);
 	}
 
@@ -597,23 +628,19 @@ Ns3Server::StartSendingCam()
 bool
 Ns3Server::StopSendingCam()
 {
-	vector<string> senderIdCollection = myInputStorage.readStringList();
+	vector<uint32_t> senderIdCollection = ReadNodeIdList ();
 
-	vector<string>::iterator senderIt;
+	vector<uint32_t>::const_iterator senderIt;
 	for (senderIt = senderIdCollection.begin() ; senderIt < senderIdCollection.end() ; senderIt++)
 	{
-		string cadena = *senderIt;
+		uint32_t nodeId = *senderIt;
 
 #ifdef _DEBUG
 		stringstream log;
-		log<< "ns-3 server --> Nodes IDs: " << cadena << endl;
+		log<< "ns-3 server --> Nodes IDs: " << nodeId << endl;
 		Log((log.str()).c_str());
 #endif
 
-		stringstream temp;
-		uint32_t nodeId;
-		temp << cadena;
-		temp >> nodeId;
 		stringstream logNode;
 
 #ifdef _DEBUG
@@ -623,6 +650,7 @@ Ns3Server::StopSendingCam()
 #endif
 
 		my_packetManagerPtr->DeactivateCamTxon (nodeId);
+		my_nodeManagerPtr->NotifyStopTxon (nodeId, "CAM");
 	}
 
 	writeStatusCmd(CMD_STOP_CAM, RTYPE_OK, "StopSendingCam()");
@@ -633,11 +661,6 @@ Ns3Server::StopSendingCam()
 bool
 Ns3Server::GetReceivedMessages ()
 {
-	vector<string> sender;
-	vector<string> type;
-	vector<string> sentTimestep;
-	vector<string> sequenceNumber;
-
 	int nodeId = myInputStorage.readInt();
 
 #ifdef _DEBUG
@@ -664,6 +687,59 @@ Ns3Server::GetReceivedMessages ()
 
 	struct InciPacket::ReceivedInciPacket inciPacket;
 
+	if (protocolVersion_ >= INCI_PROTOCOL_VERSION_BINARY)
+	{
+		// Message types are sent once in a table; each message carries the index of its type
+		vector<string> types;
+		// type index, sender, timestep and sequence number of each message
+		vector<uint32_t> records;
+
+		while ( my_packetManagerPtr->GetReceivedPacket(nodeId,inciPacket) )
+		{
+			uint32_t typeIndex = 0;
+			while (typeIndex < types.size() && types[typeIndex] != inciPacket.msgType)
+				typeIndex++;
+			if (typeIndex == types.size())
+				types.push_back(inciPacket.msgType);
+
+			records.push_back(typeIndex);
+			records.push_back(inciPacket.senderId);
+			records.push_back(inciPacket.ts);
+			records.push_back(inciPacket.tsSeqNo);
+
+#ifdef _DEBUG
+			stringstream log;
+			log << "[GetReceivedMessages] Message Info of node [ns3-ID|Sender ns3-ID|MessageType|Sent Timestep|SeqNum] ["
+					<< nodeId << "|" << inciPacket.senderId << "|" << inciPacket.msgType << "|" << inciPacket.ts << "|" << inciPacket.tsSeqNo <<"]";
+			Log((log.str()).c_str());
+#endif
+		}
+
+		writeStatusCmd(CMD_GET_RECEIVED_MESSAGES, RTYPE_OK, "GetReceivedMessages()");
+
+		int nMessages = records.size() / 4;
+		int typesSize = 4;
+		for (vector<string>::const_iterator it = types.begin() ; it != types.end() ; it++)
+			typesSize += 4 + it->length();
+		myOutputStorage.writeInt(4 + 1 + typesSize + 4 + nMessages * (1 + 4 + 4 + 4));
+		myOutputStorage.writeUnsignedByte(CMD_GET_RECEIVED_MESSAGES);
+		myOutputStorage.writeStringList(types);
+		myOutputStorage.writeInt(nMessages);
+		for (vector<uint32_t>::const_iterator it = records.begin() ; it != records.end() ; it += 4)
+		{
+			myOutputStorage.writeUnsignedByte(it[0]);
+			myOutputStorage.writeInt(it[1]);
+			myOutputStorage.writeInt(it[2]);
+			myOutputStorage.writeInt(it[3]);
+		}
+		return true;
+	}
+
+	vector<string> sender;
+	vector<string> type;
+	vector<string> sentTimestep;
+	vector<string> sequenceNumber;
+
 	while ( my_packetManagerPtr->GetReceivedPacket(nodeId,inciPacket) )
 	{
 		sender.push_back(Int2String(inciPacket.senderId));
@@ -692,6 +768,52 @@ Ns3Server::GetReceivedMessages ()
 	return true;
 }
 
+bool
+Ns3Server::SetProtocolVersion (void)
+{
+	int requested = myInputStorage.readInt();
+
+	if (requested < INCI_PROTOCOL_VERSION_STRINGS) {
+		writeStatusCmd(CMD_SET_PROTOCOL_VERSION, RTYPE_ERR, "SetProtocolVersion(), unknown version");
+		return false;
+	}
+	protocolVersion_ = requested < INCI_PROTOCOL_VERSION_BINARY ? requested : INCI_PROTOCOL_VERSION_BINARY;
+
+	stringstream log;
+	log << "[SetProtocolVersion] Requested version " << requested << ", using version " << protocolVersion_;
+	Log((log.str()).c_str());
+
+	writeStatusCmd(CMD_SET_PROTOCOL_VERSION, RTYPE_OK, "SetProtocolVersion()");
+	myOutputStorage.writeInt(4 + 1 + 4);
+	myOutputStorage.writeUnsignedByte(CMD_SET_PROTOCOL_VERSION);
+	myOutputStorage.writeInt(protocolVersion_);
+	return true;
+}
+
+vector<uint32_t>
+Ns3Server::ReadNodeIdList (void)
+{
+	vector<uint32_t> nodeIds;
+	if (protocolVersion_ >= INCI_PROTOCOL_VERSION_BINARY)
+	{
+		int size = myInputStorage.readInt();
+		nodeIds.reserve(size);
+		for (int i = 0; i < size; i++)
+		{
+			nodeIds.push_back(myInputStorage.readInt());
+		}
+		return nodeIds;
+	}
+
+	vector<string> idCollection = myInputStorage.readStringList();
+	nodeIds.reserve(idCollection.size());
+	for (vector<string>::const_iterator it = idCollection.begin() ; it != idCollection.end() ; it++)
+	{
+		nodeIds.push_back(strtoul(it->c_str(), 0, 10));
+	}
+	return nodeIds;
+}
+
 std::string 
 Ns3Server::Int2String (int n)
 {
@@ -771,7 +893,7 @@ Ns3Server::Log(const char* message)
 bool 
 Ns3Server::StartTopoTxon (void)
 {
-	vector<string> senderIdCollection = myInputStorage.readStringList ();
+	vector<uint32_t> senderIdCollection = ReadNodeIdList ();
 	string serviceId = myInputStorage.readString ();
 	int commProfile = myInputStorage.readUnsignedByte (); // commProfile is coded as a byte by the iCS
 	vector<string> technologies = myInputStorage.readStringList ();
@@ -781,22 +903,19 @@ Ns3Server::StartTopoTxon (void)
 	int msgLifetime = myInputStorage.readInt();
 	int numHops = myInputStorage.readInt();
 
-	vector<string>::iterator senderIt;
+	vector<uint32_t>::const_iterator senderIt;
 	for (senderIt = senderIdCollection.begin() ; senderIt < senderIdCollection.end() ; senderIt++)
 	{
-		string cadena = *senderIt;
+		uint32_t nodeId = *senderIt;
 
 #ifdef _DEBUG
 		stringstream log;
 		log << "[ns-3][Ns3Server::StartTopoTxon] Node starts topobroadcast transmission [ns3-ID|ServiceId|Frequency|PayloadLength|MsgRegenerationTime|MsgLifetime|NumHops] [" ;
-		log << cadena << "|" << serviceId << "|" << frequency << "|" << payloadLength << "|" << msgRegenerationTime << "|" << msgLifetime << "|" << numHops << "]";
+		log << nodeId << "|" << serviceId << "|" << frequency << "|" << payloadLength << "|" << msgRegenerationTime << "|" << msgLifetime << "|" << numHops << "]";
 		Log((log.str()).c_str());
 #endif
 
-		stringstream temp;
-		uint32_t nodeId;
-		temp << cadena;
-		temp >> nodeId;
+		my_nodeManagerPtr->NotifyTxon (nodeId, serviceId);
 		my_packetManagerPtr->ActivateTopoBroadcastTxon (nodeId, serviceId, commProfile, technologies, frequency, payloadLength, msgRegenerationTime, msgLifetime, numHops);
 	}
 
@@ -813,7 +932,7 @@ Ns3Server::StartTopoTxon (void)
 bool 
 Ns3Server::StartIdBasedTxon (void)
 {
-	vector<string> senderIdCollection = myInputStorage.readStringList ();
+	vector<uint32_t> senderIdCollection = ReadNodeIdList ();
 	string serviceId = myInputStorage.readString ();
 	int commProfile = myInputStorage.readUnsignedByte(); // commProfile is coded as a byte by the iCS
 	vector<string> technologies = myInputStorage.readStringList ();
@@ -823,15 +942,15 @@ Ns3Server::StartIdBasedTxon (void)
 	float msgRegenerationTime = myInputStorage.readFloat();
 	int msgLifetime = myInputStorage.readInt();
 
-	vector<string>::iterator senderIt;
+	vector<uint32_t>::const_iterator senderIt;
 	for (senderIt = senderIdCollection.begin() ; senderIt < senderIdCollection.end() ; senderIt++)
 	{
-		string cadena = *senderIt;
+		uint32_t nodeId = *senderIt;
 
 #ifdef _DEBUG
 		stringstream log;
 		log << "[ns-3][Ns3Server::StartIdBasedTxon] Node starts ID-based transmission [ns3-ID|ServiceId|Frequency|PayloadLength|Destination|TechnologyList|MsgRegenerationTime|MsgLifetime] [" ;
-		log << cadena << "|" << serviceId << "|" << frequency << "|" << payloadLength << "|" << destination << "|";
+		log << nodeId << "|" << serviceId << "|" << frequency << "|" << payloadLength << "|" << destination << "|";
 		for (vector<string>::iterator techsIt = technologies.begin () ; techsIt < technologies.end () ; techsIt++)
 		{
 			string techTmp = *techsIt;
@@ -845,10 +964,7 @@ Ns3Server::StartIdBasedTxon (void)
 		Log((log.str()).c_str());
 #endif
 
-		stringstream temp;
-		uint32_t nodeId;
-		temp << cadena;
-		temp >> nodeId;
+		my_nodeManagerPtr->NotifyTxon (nodeId, serviceId);
 		my_packetManagerPtr->InitiateIdBasedTxon (nodeId, serviceId, commProfile, technologies, frequency, payloadLength, destination, msgRegenerationTime, msgLifetime);
                 stringstream log1;
 		log1 << "[ns-3][Ns3Server::StartIdBasedTxon] Finished IdBasedTxon";
@@ -868,7 +984,7 @@ Ns3Server::StartIdBasedTxon (void)
 bool 
 Ns3Server::StartMWTxon (void)
 {
-	vector<string> senderIdCollection = myInputStorage.readStringList ();
+	vector<uint32_t> senderIdCollection = ReadNodeIdList ();
 	string serviceId = myInputStorage.readString ();
 	int commProfile = myInputStorage.readUnsignedByte (); // commProfile is coded as a byte by the iCS
 	vector<string> technologies = myInputStorage.readStringList ();
@@ -881,16 +997,16 @@ Ns3Server::StartMWTxon (void)
 	float msgRegenerationTime = myInputStorage.readFloat();
 	int msgLifetime = myInputStorage.readInt();
 
-	vector<string>::iterator senderIt;
+	vector<uint32_t>::const_iterator senderIt;
 	for (senderIt = senderIdCollection.begin() ; senderIt < senderIdCollection.end() ; senderIt++)
 	{
-		string cadena = *senderIt;
-		// TODO add a check on the node ID: It must be a TMC...need a method: isTMC(cadena)
+		uint32_t nodeId = *senderIt;
+		// TODO add a check on the node ID: It must be a TMC...need a method: isTMC(nodeId)
 
 #ifdef _DEBUG
 		stringstream log;
 		log << "[ns-3][Ns3Server::StartMWTxon] Node (TMC) starts MW transmission [ns3-ID|ServiceId|TechnologyList|CenterPointLat|CenterPointLon|AreaSize|Frequency|PayloadLength|MsgRegenerationTime|MsgLifetime] [" ;
-		log << cadena << "|" << serviceId  << "|";
+		log << nodeId << "|" << serviceId  << "|";
 		for (vector<string>::iterator techsIt = technologies.begin () ; techsIt < technologies.end () ; techsIt++)
 		{
 			string techTmp = *techsIt;
@@ -904,10 +1020,7 @@ Ns3Server::StartMWTxon (void)
 		Log((log.str()).c_str());
 #endif
 
-		stringstream temp;
-		uint32_t nodeId;
-		temp << cadena;
-		temp >> nodeId;
+		my_nodeManagerPtr->NotifyTxon (nodeId, serviceId);
 		my_packetManagerPtr->InitiateMWTxon (nodeId, serviceId, commProfile, technologies, destination, frequency, payloadLength, msgRegenerationTime, msgLifetime);
 	}
 
@@ -927,29 +1040,26 @@ Ns3Server::StartMWTxon (void)
 bool
 Ns3Server::StartIpCiuTxon (void)
 {
-	vector<string> senderIdCollection = myInputStorage.readStringList ();
+	vector<uint32_t> senderIdCollection = ReadNodeIdList ();
 	string serviceId = myInputStorage.readString ();
 	float frequency = myInputStorage.readFloat();
 	int payloadLength = myInputStorage.readInt();
 	int destination = myInputStorage.readInt();
 	float msgRegenerationTime = myInputStorage.readFloat();
 
-	vector<string>::iterator senderIt;
+	vector<uint32_t>::const_iterator senderIt;
 	for (senderIt = senderIdCollection.begin() ; senderIt < senderIdCollection.end() ; senderIt++)
 	{
-		string cadena = *senderIt;
+		uint32_t nodeId = *senderIt;
 
 #ifdef _DEBUG
 		stringstream log;
 		log << "[ns-3][Ns3Server::StartIpCiuTxon] CIU node starts IP-based transmission [ns3-ID|ServiceId|Frequency|PayloadLength|Destination|MsgRegenerationTime] [" ;
-		log << cadena << "|" << serviceId << "|" << frequency << "|" << payloadLength << "|" << destination << "|" << msgRegenerationTime << "]";
+		log << nodeId << "|" << serviceId << "|" << frequency << "|" << payloadLength << "|" << destination << "|" << msgRegenerationTime << "]";
 		Log((log.str()).c_str());
 #endif
 
-		stringstream temp;
-		uint32_t nodeId;
-		temp << cadena;
-		temp >> nodeId;
+		my_nodeManagerPtr->NotifyTxon (nodeId, serviceId);
 		my_packetManagerPtr->InitiateIPCIUTxon (nodeId, serviceId, frequency, payloadLength, destination, msgRegenerationTime);
 
 	}
@@ -967,24 +1077,21 @@ Ns3Server::StartIpCiuTxon (void)
 bool 
 Ns3Server::StopServiceTxon (void)
 {
-	vector<string> senderIdCollection = myInputStorage.readStringList();
-	vector<string>::iterator senderIt;
+	vector<uint32_t> senderIdCollection = ReadNodeIdList ();
+	vector<uint32_t>::const_iterator senderIt;
 	string serviceId = myInputStorage.readString ();
 	for (senderIt = senderIdCollection.begin() ; senderIt < senderIdCollection.end() ; senderIt++)
 	{
-		string cadena = *senderIt;
+		uint32_t nodeId = *senderIt;
 
 #ifdef _DEBUG
 		stringstream log;
-		log << "[ns-3][Ns3Server::StopServiceTxon] Nodes IDs: " << cadena << endl;
+		log << "[ns-3][Ns3Server::StopServiceTxon] Nodes IDs: " << nodeId << endl;
 		Log((log.str()).c_str());
 #endif
 
-		stringstream temp;
-		uint32_t nodeId;
-		temp << cadena;
-		temp >> nodeId;
 		my_packetManagerPtr->DeactivateServiceTxon (nodeId, serviceId);
+		my_nodeManagerPtr->NotifyStopTxon (nodeId, serviceId);
 	}
 	writeStatusCmd(CMD_STOP_SERVICE_TXON, RTYPE_OK, "StopServiceTxon()");
 	return true; ;
@@ -993,25 +1100,22 @@ Ns3Server::StopServiceTxon (void)
 bool 
 Ns3Server::StopMWServiceTxon (void)
 {
-	vector<string> senderIdCollection = myInputStorage.readStringList();
-	vector<string>::iterator senderIt;
+	vector<uint32_t> senderIdCollection = ReadNodeIdList ();
+	vector<uint32_t>::const_iterator senderIt;
 	string serviceId = myInputStorage.readString ();
 	for (senderIt = senderIdCollection.begin() ; senderIt < senderIdCollection.end() ; senderIt++)
 	{
-		string cadena = *senderIt;
-		// TODO add a check that nodeID (cadena) is a TMC - method isTMC(cadena) required
+		uint32_t nodeId = *senderIt;
+		// TODO add a check that nodeID (nodeId) is a TMC - method isTMC(nodeId) required
 
 #ifdef _DEBUG
 		stringstream log;
-		log << "[ns-3][Ns3Server::StopMWServiceTxon] Nodes IDs: " << cadena << endl;
+		log << "[ns-3][Ns3Server::StopMWServiceTxon] Nodes IDs: " << nodeId << endl;
 		Log((log.str()).c_str());
 #endif
 
-		stringstream temp;
-		uint32_t nodeId;
-		temp << cadena;
-		temp >> nodeId;
 		my_packetManagerPtr->DeactivateMWServiceTxon (nodeId, serviceId);
+		my_nodeManagerPtr->NotifyStopTxon (nodeId, serviceId);
 	}
 
 	if (senderIdCollection.size() == 0) {
@@ -1030,24 +1134,21 @@ Ns3Server::StopMWServiceTxon (void)
 bool
 Ns3Server::StopIpCiuServiceTxon (void)
 {
-	vector<string> senderIdCollection = myInputStorage.readStringList();
-	vector<string>::iterator senderIt;
+	vector<uint32_t> senderIdCollection = ReadNodeIdList ();
+	vector<uint32_t>::const_iterator senderIt;
 	string serviceId = myInputStorage.readString ();
 	for (senderIt = senderIdCollection.begin() ; senderIt < senderIdCollection.end() ; senderIt++)
 	{
-		string cadena = *senderIt;
+		uint32_t nodeId = *senderIt;
 
 #ifdef _DEBUG
 		stringstream log;
-		log<< "[ns-3][Ns3Server::StopIpCiuServiceTxon] Nodes IDs: " << cadena << endl;
+		log<< "[ns-3][Ns3Server::StopIpCiuServiceTxon] Nodes IDs: " << nodeId << endl;
 		Log((log.str()).c_str());
 #endif
 
-		stringstream temp;
-		uint32_t nodeId;
-		temp << cadena;
-		temp >> nodeId;
 		my_packetManagerPtr->DeactivateIPCIUServiceTxon (nodeId, serviceId);
+		my_nodeManagerPtr->NotifyStopTxon (nodeId, serviceId);
 	}
 	writeStatusCmd(CMD_STOP_IPCIU_SERVICE_TXON, RTYPE_OK, "StopIpCiuServiceTxon()");
 	return true; ;
@@ -1056,7 +1157,7 @@ Ns3Server::StopIpCiuServiceTxon (void)
 bool 
 Ns3Server::StartGeobroadcastTxon (void)
 {
-	vector<string> senderIdCollection = myInputStorage.readStringList ();
+	vector<uint32_t> senderIdCollection = ReadNodeIdList ();
 	string serviceId = myInputStorage.readString ();
 	int commProfile = myInputStorage.readUnsignedByte (); // commProfile is coded as a byte by the iCS
 	vector<string> technologies = myInputStorage.readStringList ();
@@ -1069,25 +1170,22 @@ Ns3Server::StartGeobroadcastTxon (void)
 	float msgRegenerationTime = myInputStorage.readFloat();
 	int msgLifetime = myInputStorage.readInt();
 
-	vector<string>::iterator senderIt;
+	vector<uint32_t>::const_iterator senderIt;
 	for (senderIt = senderIdCollection.begin() ; senderIt < senderIdCollection.end() ; senderIt++)
 	{
-		string cadena = *senderIt;
+		uint32_t nodeId = *senderIt;
 
 #ifdef _DEBUG
 		stringstream log;
 		log << "[ns-3][Ns3Server::StartGeobroadcastTxon] Node starts geobroadcast transmission "
 				"[ns3-ID|ServiceId|CenterPointLat|CenterPointLon|AreaSize|Frequency|PayloadLength|MsgRegenerationTime|MsgLifetime] ["
-				<< cadena << "|" << serviceId << "|" << destination.lat << "|" << destination.lat << "|" << destination.lon
+				<< nodeId << "|" << serviceId << "|" << destination.lat << "|" << destination.lat << "|" << destination.lon
 				<< "|" << destination.areaSize << "|" << frequency << "|" << payloadLength << "|" << msgRegenerationTime
 				<< "|" << msgLifetime << "]";
 		Log((log.str()).c_str());
 #endif
 
-		stringstream temp;
-		uint32_t nodeId;
-		temp << cadena;
-		temp >> nodeId;
+		my_nodeManagerPtr->NotifyTxon (nodeId, serviceId);
 		my_packetManagerPtr->InitiateGeoBroadcastTxon (nodeId, serviceId, commProfile, technologies, destination, frequency, payloadLength, msgRegenerationTime, msgLifetime);
 	}
 
@@ -1104,7 +1202,7 @@ Ns3Server::StartGeobroadcastTxon (void)
 bool 
 Ns3Server::StartGeoanycastTxon (void)
 {
-	vector<string> senderIdCollection = myInputStorage.readStringList ();
+	vector<uint32_t> senderIdCollection = ReadNodeIdList ();
 	string serviceId = myInputStorage.readString ();
 	int commProfile = myInputStorage.readUnsignedByte(); // commProfile is coded as a byte by the iCS
 	vector<string> technologies = myInputStorage.readStringList ();
@@ -1117,22 +1215,19 @@ Ns3Server::StartGeoanycastTxon (void)
 	float msgRegenerationTime = myInputStorage.readFloat();
 	int msgLifetime = myInputStorage.readInt();
 
-	vector<string>::iterator senderIt;
+	vector<uint32_t>::const_iterator senderIt;
 	for (senderIt = senderIdCollection.begin() ; senderIt < senderIdCollection.end() ; senderIt++)
 	{
-		string cadena = *senderIt;
+		uint32_t nodeId = *senderIt;
 
 #ifdef _DEBUG
 		stringstream log;
 		log << "[ns-3][Ns3Server::StartGeoanycastTxon] Node starts geoanycast transmission [ns3-ID|ServiceId|CenterPointLat|CenterPointLon|AreaSize|Frequency|PayloadLength|MsgRegenerationTime|MsgLifetime] [" ;
-		log << cadena << "|" << serviceId << "|" << destination.lat << "|" << destination.lat << "|" << destination.lon << "|" << destination.areaSize << "|" << frequency << "|" << payloadLength << "|" << msgRegenerationTime << "|" << msgLifetime << "]";
+		log << nodeId << "|" << serviceId << "|" << destination.lat << "|" << destination.lat << "|" << destination.lon << "|" << destination.areaSize << "|" << frequency << "|" << payloadLength << "|" << msgRegenerationTime << "|" << msgLifetime << "]";
 		Log((log.str()).c_str());
 #endif
 
-		stringstream temp;
-		uint32_t nodeId;
-		temp << cadena;
-		temp >> nodeId;
+		my_nodeManagerPtr->NotifyTxon (nodeId, serviceId);
 		my_packetManagerPtr->InitiateGeoAnycastTxon (nodeId, serviceId, commProfile, technologies, destination, frequency, payloadLength, msgRegenerationTime, msgLifetime);
 	}
 
@@ -64,6 +64,18 @@ class Ns3Server
     static int targetTime_;
     static bool Log(const char* message);
     static bool logActive_;
+
+    /**
+     * @brief Use the shared memory channel <name> instead of a TCP socket to talk to the iCS.
+     * Must be called before processCommandsUntilSimStep(); an empty name selects TCP.
+     */
+    static void SetSharedMemoryChannel(std::string name);
+    static std::string shmChannel_;
+
+    /**
+     * @brief Encoding of the messages exchanged with the iCS, see CMD_SET_PROTOCOL_VERSION
+     */
+    static int protocolVersion_;
     
   private:
     static std::string CAM_TYPE; 
@@ -164,6 +176,16 @@ class Ns3Server
      */
     bool DeactivateNode (void);
 
+    /** 
+     * @brief Agree with the iCS on the version of the protocol used for the rest of the connection
+     */
+    bool SetProtocolVersion (void);
+
+    /** 
+     * @brief Read a list of ns-3 node ids in the encoding of the negotiated protocol version
+     */
+    std::vector<uint32_t> ReadNodeIdList (void);
+
     /** 
      * @brief Pointer to iTETRISNodeManager object which is responsible for the creation, the initial placement, and the position updates of the nodes in ns-3
      */
@@ -11,6 +11,7 @@
 	#include <sys/simulation/simulation_controller.h>
 #else
 	#include "server-socket.h"
+	#include "shm-channel.h"
 #endif
 
 #ifdef BUILD_TCPIP
@@ -72,7 +73,8 @@ namespace tcpip
 		port_( port ),
 		socket_(-1),
 		server_socket_(-1),
-		blocking_(true)
+		blocking_(true),
+		shm_(0)
 	{
 		verbose_ = false;
 		init();
@@ -85,7 +87,8 @@ namespace tcpip
 		port_( port ),
 		socket_(-1),
 		server_socket_(-1),
-		blocking_(true)
+		blocking_(true),
+		shm_(0)
 	{
 		verbose_ = false;
 		init();
@@ -219,9 +222,21 @@ namespace tcpip
 		accept()
 		throw( SocketException )
 	{
-		if( socket_ >= 0 )
+		if( socket_ >= 0 || shm_ != 0 )
 			return;
 
+		if( ShmChannel::IsShmHost(host_) )
+		{
+			shm_ = new ShmChannel(host_, port_);
+			if( !shm_->create() )
+			{
+				delete shm_;
+				shm_ = 0;
+				BailOnSocketError("tcpip::ServerSocket::accept() Unable to create shared memory channel");
+			}
+			return;
+		}
+
 		struct sockaddr_in client_addr;
 #ifdef WIN32
 		int addrlen = sizeof(client_addr);
@@ -312,6 +327,18 @@ namespace tcpip
 		connect()
 		throw( SocketException )
 	{
+		if( ShmChannel::IsShmHost(host_) )
+		{
+			shm_ = new ShmChannel(host_, port_);
+			if( !shm_->attach() )
+			{
+				delete shm_;
+				shm_ = 0;
+				BailOnSocketError("tcpip::ServerSocket::connect() @ shared memory attach");
+			}
+			return;
+		}
+
 		in_addr addr;
 		if( !atoaddr( host_.c_str(), addr) )
 			BailOnSocketError("tcpip::ServerSocket::connect() @ Invalid network address");
@@ -342,6 +369,13 @@ namespace tcpip
 		ServerSocket::
 		close()
 	{
+		if( shm_ != 0 )
+		{
+			shm_->close();
+			delete shm_;
+			shm_ = 0;
+		}
+
 		// Close client-connection 
 		if( socket_ >= 0 )
 		{
@@ -361,7 +395,7 @@ namespace tcpip
 		send( std::vector<unsigned char> b) 
 		throw( SocketException )
 	{
-		if( socket_ < 0 ) return;
+		if( socket_ < 0 && shm_ == 0 ) return;
 
 		size_t numbytes = b.size();
 		unsigned char *buf = new unsigned char[numbytes];
@@ -383,6 +417,13 @@ namespace tcpip
 			cerr << "]" << endl;
 		}
 
+		if( shm_ != 0 )
+		{
+			if( !shm_->write(buf, numbytes) )
+				BailOnSocketError( "send failed" );
+			numbytes = 0;
+		}
+
 		while( numbytes > 0 )
 		{
 #ifdef WIN32
@@ -471,36 +512,13 @@ namespace tcpip
 	{
 		/* receive length of vector */
 		unsigned char* bufLength = new unsigned char[4];
-		int bytesRead = 0;
-		int readThisTime = 0;				
-		
-		while (bytesRead<4)
-		{
-			
-			readThisTime = recv( socket_, (char*)(bufLength + bytesRead), 4-bytesRead, 0 );
-			
-			if( readThisTime <= 0 )
-				BailOnSocketError( "tcpip::ServerSocket::receive() 1 @ recv" );
-
-			bytesRead += readThisTime;
-		}
+		receiveComplete(bufLength, 4);
 		Storage length_storage(bufLength,4);
 		int NN = length_storage.readInt() - 4;
 						
 		/* receive vector */
 		unsigned char* buf = new unsigned char[NN];
-		bytesRead = 0;
-		readThisTime = 0;
-		
-		while (bytesRead<NN)
-		{
-			readThisTime = recv( socket_, (char*)(buf + bytesRead), NN-bytesRead, 0 );
-
-			if( readThisTime <= 0 )
-				BailOnSocketError( "tcpip::ServerSocket::receive() 2 @ recv" );
-
-			bytesRead += readThisTime;
-		}
+		receiveComplete(buf, NN);
 		msg.reset();
 		msg.writePacket(buf, NN);
 		
@@ -524,13 +542,38 @@ namespace tcpip
 	}
 	
 	
+	// ----------------------------------------------------------------------
+	void
+		ServerSocket::
+		receiveComplete(unsigned char * const buffer, std::size_t len)
+		const throw( SocketException )
+	{
+		if( shm_ != 0 )
+		{
+			if( !shm_->read(buffer, len) )
+				BailOnSocketError( "tcpip::ServerSocket::receive() @ shared memory read" );
+			return;
+		}
+
+		std::size_t bytesRead = 0;
+		while (bytesRead<len)
+		{
+			int readThisTime = recv( socket_, (char*)(buffer + bytesRead), static_cast<int>(len-bytesRead), 0 );
+
+			if( readThisTime <= 0 )
+				BailOnSocketError( "tcpip::ServerSocket::receive() @ recv" );
+
+			bytesRead += readThisTime;
+		}
+	}
+
 	// ----------------------------------------------------------------------
 	bool 
 		ServerSocket::
 		has_client_connection() 
 		const
 	{
-		return socket_ >= 0;
+		return socket_ >= 0 || shm_ != 0;
 	}
 
 	// ----------------------------------------------------------------------
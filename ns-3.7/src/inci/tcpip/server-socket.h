@@ -48,6 +48,7 @@
 #include <list>
 #include <deque>
 #include <iostream>
+#include <cstddef>
 
 
 struct in_addr;
@@ -55,6 +56,8 @@ struct in_addr;
 namespace tcpip
 {
 
+	class ShmChannel;
+
 	class SocketException: public std::exception
 	{
 	private:
@@ -78,6 +81,7 @@ namespace tcpip
 		friend class Response;
 	public:
 		/// Constructor that prepare to connect to host:port 
+		/// A "shm://<name>" host selects the shared memory transport (see ShmChannel)
 		ServerSocket(std::string host, int port);
 		
 		/// Constructor that prepare for accepting a connection on given port
@@ -114,12 +118,16 @@ namespace tcpip
 #endif
 		bool atoaddr(std::string, struct in_addr& addr);
 		bool datawaiting(int sock) const throw();
+		/// Receive exactly \p len bytes from the socket or the shared memory channel
+		void receiveComplete(unsigned char * const buffer, std::size_t len) const throw( SocketException );
 
 		std::string host_;
 		int port_;
 		int socket_;
 		int server_socket_;
 		bool blocking_;
+		/// Shared memory channel used instead of socket_ for "shm://" hosts
+		ShmChannel* shm_;
 
 		bool verbose_;
 #ifdef WIN32
@@ -118,17 +118,15 @@ itetrisPosHelper::Reset (const Vector &position, const float &speed, const float
 void 
 itetrisPosHelper::UpdateGeodecentricPosition (void)
 {
-  std::vector <double> geocentricPos = GeoToLocConvert (m_latitudeO, m_longitudeO, 0.0);
-  m_position.x = geocentricPos[0];
-  m_position.y = geocentricPos[1];
-  m_position.z = geocentricPos[2];
+  GeoToLoc (m_latitudeO, m_longitudeO, 0.0, m_position.x, m_position.y, m_position.z);
 }
 
 void itetrisPosHelper::UpdateGeodedesicPosition (void)
 {
-  std::vector <double> geodesicPos = LocToGeoConvert (m_position.x, m_position.y, m_position.z);
-  m_latitudeO = geodesicPos.at(0);
-  m_longitudeO = geodesicPos.at(1);
+  double latitude, longitude, height;
+  LocToGeo (m_position.x, m_position.y, m_position.z, latitude, longitude, height);
+  m_latitudeO = latitude;
+  m_longitudeO = longitude;
   m_latitude = (uint32_t) (m_latitudeO * 1000000 * 10);
   m_longitude = (uint32_t) (m_longitudeO * 1000000 * 10);
 }
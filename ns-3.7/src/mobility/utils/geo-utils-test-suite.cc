@@ -0,0 +1,112 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2009-2010, EU FP7 iTETRIS project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "geo-utils.h"
+
+using namespace ns3;
+
+// ===========================================================================
+// Test case to make sure that the conversion of arrays of local positions
+// gives the geodetic positions of the conversion of each position, around
+// the default origin and around another one.
+// ===========================================================================
+class GeoUtilsLocToGeoArrayTestCase : public TestCase
+{
+public:
+  GeoUtilsLocToGeoArrayTestCase ();
+  virtual ~GeoUtilsLocToGeoArrayTestCase ();
+
+private:
+  virtual bool DoRun (void);
+
+  void CheckArray (void);
+};
+
+GeoUtilsLocToGeoArrayTestCase::GeoUtilsLocToGeoArrayTestCase ()
+  : TestCase ("Check the conversion of arrays of local positions")
+{
+}
+
+GeoUtilsLocToGeoArrayTestCase::~GeoUtilsLocToGeoArrayTestCase ()
+{
+}
+
+void
+GeoUtilsLocToGeoArrayTestCase::CheckArray (void)
+{
+  const uint32_t n = 5;
+  double x[n] = {0, 100, -2500, 12000, 35.5};
+  double y[n] = {0, -50, 4000, -8000, 0.25};
+  double z[n] = {0, 0, 10, -3, 1.5};
+  double lat[n], lon[n], h[n];
+
+  LocToGeo (x, y, z, n, lat, lon, h);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      double expectedLat, expectedLon, expectedH;
+      LocToGeo (x[i], y[i], z[i], expectedLat, expectedLon, expectedH);
+      NS_TEST_EXPECT_MSG_EQ_TOL (lat[i], expectedLat, 1e-9, "Wrong latitude of position " << i);
+      NS_TEST_EXPECT_MSG_EQ_TOL (lon[i], expectedLon, 1e-9, "Wrong longitude of position " << i);
+      NS_TEST_EXPECT_MSG_EQ_TOL (h[i], expectedH, 1e-6, "Wrong height of position " << i);
+    }
+
+  // the results can overwrite the positions
+  LocToGeo (x, y, z, n, x, y, z);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (x[i], lat[i], "Wrong latitude of position " << i << " converted in place");
+      NS_TEST_EXPECT_MSG_EQ (y[i], lon[i], "Wrong longitude of position " << i << " converted in place");
+      NS_TEST_EXPECT_MSG_EQ (z[i], h[i], "Wrong height of position " << i << " converted in place");
+    }
+}
+
+bool
+GeoUtilsLocToGeoArrayTestCase::DoRun (void)
+{
+  double lat0, lon0, h0;
+  GetLocalOrigin (lat0, lon0, h0);
+
+  CheckArray ();
+
+  SetLocalOrigin (52.5163, 13.3777, 34.0);
+  double x = 0, y = 0, z = 0, lat, lon, h;
+  LocToGeo (&x, &y, &z, 1, &lat, &lon, &h);
+  NS_TEST_EXPECT_MSG_EQ_TOL (lat, 52.5163, 1e-9, "The local origin is not at the latitude of the origin");
+  NS_TEST_EXPECT_MSG_EQ_TOL (lon, 13.3777, 1e-9, "The local origin is not at the longitude of the origin");
+  NS_TEST_EXPECT_MSG_EQ_TOL (h, 34.0, 1e-6, "The local origin is not at the height of the origin");
+  CheckArray ();
+
+  SetLocalOrigin (lat0, lon0, h0);
+
+  return GetErrorStatus ();
+}
+
+class GeoUtilsTestSuite : public TestSuite
+{
+public:
+  GeoUtilsTestSuite ();
+};
+
+GeoUtilsTestSuite::GeoUtilsTestSuite ()
+  : TestSuite ("geo-utils", UNIT)
+{
+  AddTestCase (new GeoUtilsLocToGeoArrayTestCase);
+}
+
+GeoUtilsTestSuite geoUtilsTestSuite;
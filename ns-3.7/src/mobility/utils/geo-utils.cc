@@ -14,6 +14,120 @@ namespace ns3{
 using namespace GeographicLib;
 using namespace std;
 
+namespace {
+
+/**
+ * The local cartesian frame of the simulation, built once for its origin
+ * rather than for every conversion.
+ */
+class LocalFrame
+{
+public:
+  LocalFrame ()
+  {
+    // iTETRIS Sophia Antipolis scenario, the origin used before it could be configured
+    Reset (43.580573, 7.121054, 0.0);
+  }
+
+  void Reset (double lat0, double lon0, double h0)
+  {
+    m_lc.Reset (lat0, lon0, h0);
+    m_lat0 = m_lc.LatitudeOrigin ();
+    m_lon0 = m_lc.LongitudeOrigin ();
+    m_h0 = m_lc.HeightOrigin ();
+    Geocentric::WGS84.Forward (m_lat0, m_lon0, m_h0, m_x0, m_y0, m_z0);
+    // Local axes in geocentric coordinates, as LocalCartesian computes them
+    double phi = m_lat0 * Constants::degree ();
+    double lam = m_lon0 * Constants::degree ();
+    double sphi = sin (phi);
+    double cphi = fabs (m_lat0) == 90 ? 0 : cos (phi);
+    double slam = m_lon0 == -180 ? 0 : sin (lam);
+    double clam = fabs (m_lon0) == 90 ? 0 : cos (lam);
+    m_rxx = -slam; m_rxy = clam; m_rxz = 0;
+    m_ryx = -clam * sphi; m_ryy = -slam * sphi; m_ryz = cphi;
+    m_rzx = clam * cphi; m_rzy = slam * cphi; m_rzz = sphi;
+  }
+
+  LocalCartesian m_lc;
+  double m_lat0, m_lon0, m_h0;
+  double m_x0, m_y0, m_z0;
+  double m_rxx, m_rxy, m_rxz;
+  double m_ryx, m_ryy, m_ryz;
+  double m_rzx, m_rzy, m_rzz;
+};
+
+LocalFrame &
+GetLocalFrame (void)
+{
+  static LocalFrame frame;
+  return frame;
+}
+
+} // anonymous namespace
+
+void
+SetLocalOrigin (double lat0, double lon0, double h0)
+{
+  GetLocalFrame ().Reset (lat0, lon0, h0);
+}
+
+void
+GetLocalOrigin (double &lat0, double &lon0, double &h0)
+{
+  const LocalFrame &frame = GetLocalFrame ();
+  lat0 = frame.m_lat0;
+  lon0 = frame.m_lon0;
+  h0 = frame.m_h0;
+}
+
+void
+LocToGeo (double x, double y, double z, double &lat, double &lon, double &h)
+{
+  Math::real rlat, rlon, rh;
+  GetLocalFrame ().m_lc.Reverse (x, y, z, rlat, rlon, rh);
+  lat = rlat;
+  lon = rlon;
+  h = rh;
+}
+
+void
+GeoToLoc (double lat, double lon, double h, double &x, double &y, double &z)
+{
+  Math::real rx, ry, rz;
+  GetLocalFrame ().m_lc.Forward (lat, lon, h, rx, ry, rz);
+  x = rx;
+  y = ry;
+  z = rz;
+}
+
+void
+LocToGeo (const double *x, const double *y, const double *z, uint32_t n,
+          double *lat, double *lon, double *h)
+{
+  const LocalFrame &frame = GetLocalFrame ();
+  // First the rotation to geocentric coordinates over the whole arrays, a
+  // loop without branches or calls the compiler can vectorize...
+  for (uint32_t i = 0; i < n; i++)
+    {
+      double xc = frame.m_x0 + frame.m_rxx * x[i] + frame.m_ryx * y[i] + frame.m_rzx * z[i];
+      double yc = frame.m_y0 + frame.m_rxy * x[i] + frame.m_ryy * y[i] + frame.m_rzy * z[i];
+      double zc = frame.m_z0 + frame.m_rxz * x[i] + frame.m_ryz * y[i] + frame.m_rzz * z[i];
+      lat[i] = xc;
+      lon[i] = yc;
+      h[i] = zc;
+    }
+  // ...then the geocentric to geodetic conversion of each position, in place
+  const Geocentric &ec = Geocentric::WGS84;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Math::real rlat, rlon, rh;
+      ec.Reverse (lat[i], lon[i], h[i], rlat, rlon, rh);
+      lat[i] = rlat;
+      lon[i] = rlon;
+      h[i] = rh;
+    }
+}
+
 int
 ConvSUint16ToInt(uint16_t x)
 {
@@ -31,7 +145,6 @@ GeoCentrToGeoConvert (double x, double y, double z)
   const GeographicLib::Geocentric& ec = GeographicLib::Geocentric::WGS84;
 
   ec.Reverse(x, y, z, lat, lon, h);
-  std::cout << lat << " " << lon << " " << h << "\n";
   result.push_back(lat);
   result.push_back(lon);
   result.push_back(h);
@@ -43,20 +156,10 @@ vector <double>
 LocToGeoConvert (double x, double y, double z)
 {
   vector<double> result;
-  Math::real lat, lon, h;
+  double lat, lon, h;
 
-  ////////////////////////////////////////////////////
-  // NOTE Florent KAISSER 08/23/2016
-  //
-  // origin coordinate of the map is constant ????
-  // BIG problem, because this origin in ICS is 
-  // not constant, it's define in configurations file
-  // (see FacilitiesManager::configureICSFacilities)
-  const GeographicLib::LocalCartesian lc(43.580573,7.121054,0.0);
-  //
-  ////////////////////////////////////////////////////
-  
-  lc.Reverse(x, y, z, lat, lon, h);
+  // The origin is the one of the iCS facilities, see SetLocalOrigin
+  LocToGeo (x, y, z, lat, lon, h);
 
 //   std::cout << lat << " " << lon << " " << h << "\n";
 
@@ -90,13 +193,8 @@ std::vector <double>
 GeoToLocConvert(double lat, double lon, double h)
 {
   vector<double> result;
-  Math::real x, y, z;
-  Math::real latitude = (Math::real)lat;
-  Math::real longitude = (Math::real)lon;
-  Math::real  altitude = (Math::real)h;
-//   const GeographicLib::LocalCartesian lc;
-  const GeographicLib::LocalCartesian lc(43.580573,7.121054,0.0);
-  lc.Forward(latitude, longitude, altitude, x, y, z);
+  double x, y, z;
+  GeoToLoc (lat, lon, h, x, y, z);
 
   result.push_back(x);
   result.push_back(y);
@@ -113,7 +211,6 @@ GeoToGeoCentrConvert(uint32_t lat, uint32_t lon, uint16_t h)
   const GeographicLib::Geocentric& ec = GeographicLib::Geocentric::WGS84;
 
   ec.Forward(lat, lon, h, x, y, z);
-  std::cout << lat << " " << lon << " " << h << "\n";
   result.push_back(x);
   result.push_back(y);
   result.push_back(z);
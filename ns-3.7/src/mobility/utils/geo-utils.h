@@ -15,6 +15,29 @@ namespace ns3 {
     double seconds;
   };
 
+  /**
+   * Origin (degrees, meters) of the local cartesian coordinates of the
+   * simulation. It must be the origin of the iCS facilities; until it is set,
+   * the origin of the iTETRIS Sophia Antipolis scenario is used.
+   */
+  void SetLocalOrigin (double lat0, double lon0, double h0);
+  void GetLocalOrigin (double &lat0, double &lon0, double &h0);
+
+  /**
+   * Conversions between the local cartesian coordinates (meters) and the
+   * geodetic coordinates (degrees, meters) around the local origin. They
+   * do not allocate, unlike LocToGeoConvert and GeoToLocConvert.
+   */
+  void LocToGeo (double x, double y, double z, double &lat, double &lon, double &h);
+  void GeoToLoc (double lat, double lon, double h, double &x, double &y, double &z);
+
+  /**
+   * Converts n local positions given as arrays. lat, lon and h may be the
+   * same arrays as x, y and z.
+   */
+  void LocToGeo (const double *x, const double *y, const double *z, uint32_t n,
+                 double *lat, double *lon, double *h);
+
   std::vector <double> GeoCentrToGeoConvert (double x, double y, double z);
   std::vector <double> LocToGeoConvert (double x, double y, double z);
   std::vector <double> GeoToGeoCentrConvert(uint32_t lat, uint32_t lon, uint16_t h);
@@ -60,6 +60,8 @@ LocationTable::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
   m_node = 0;
+  m_neighboursByLat.clear ();
+  m_neighbours.clear ();
   Object::DoDispose ();
 }
 
@@ -166,18 +168,27 @@ LocationTable::AddPosEntry (c2cCommonHeader commonheader)
       return;
      else
       {
+       if (i->is_neigh)
+         RemoveFromIndex (*i);
        m_Table.erase (i);
        m_Table.push_back (entry);
+       AddToIndex (entry);
        return;
       }
      }
 
     }
   if (exist == false)
-    m_Table.push_back (entry);
+    {
+      m_Table.push_back (entry);
+      AddToIndex (entry);
+    }
   }
   else
-    m_Table.push_back (entry);
+    {
+      m_Table.push_back (entry);
+      AddToIndex (entry);
+    }
 }
 
 void 
@@ -214,6 +225,8 @@ LocationTable::AddPosEntry (struct c2cCommonHeader::LongPositionVector vector)
        else
        {
         bool was_neigh= i->is_neigh;
+        if (was_neigh)
+          RemoveFromIndex (*i);
         m_Table.erase (i);
         if (was_neigh == true){
           
@@ -224,6 +237,8 @@ LocationTable::AddPosEntry (struct c2cCommonHeader::LongPositionVector vector)
           NS_LOG_DEBUG  ("LOCATION_TABLE: Node "<< vector.gnAddr << " was NOT a neigh so I store it as such              isneigh= "<<entry.is_neigh);
          }
           m_Table.push_back (entry);
+          if (entry.is_neigh)
+            AddToIndex (entry);
         return;
        }
       }
@@ -237,6 +252,8 @@ LocationTable::AddPosEntry (struct c2cCommonHeader::LongPositionVector vector)
         NS_LOG_DEBUG  ("LOCATION_TABLE: Node "<< vector.gnAddr << " was not in the table, I store it as not a neigh             isneigh= "<<entry.is_neigh);
         }
         m_Table.push_back (entry);
+        if (entry.is_neigh)
+          AddToIndex (entry);
     }
   }
   else{
@@ -248,6 +265,8 @@ LocationTable::AddPosEntry (struct c2cCommonHeader::LongPositionVector vector)
            NS_LOG_DEBUG  ("LOCATION_TABLE: Node "<< vector.gnAddr << " was not in the table (table was empty), I store it as not a neigh              isneigh= "<<entry.is_neigh);
     }
     m_Table.push_back (entry);
+    if (entry.is_neigh)
+      AddToIndex (entry);
     }
 }
 
@@ -259,13 +278,17 @@ LocationTable::CleanTable ()
   if (m_Table.size() != 0)
   {
   for (Table::iterator i = m_Table.begin ();
-       i != m_Table.end (); i++)
+       i != m_Table.end (); )
     {
      interval = (time.GetSeconds ()) - (i->Ts);
      if (interval >= LOCATION_ENTRY_LIFETIME)
      {
-       m_Table.erase (i);
+       if (i->is_neigh)
+         RemoveFromIndex (*i);
+       i = m_Table.erase (i);
      }
+     else
+       i++;
     }
    }
 
@@ -290,6 +313,83 @@ LocationTable::GetNbNeighs ()
   return nb_neigh-1;
 }
 
+bool
+LocationTable::GetClosestNeighbour (double lat, double lon, double maxDistance, struct LocTableEntry &closest) const
+{
+  double best = maxDistance * maxDistance;
+  const IndexedNeighbour *found = 0;
+
+  // Walk away from the latitude of the position in both directions: once the
+  // latitude difference alone reaches the best distance, the rest is farther
+  NeighboursByLat::const_iterator start = m_neighboursByLat.lower_bound (lat);
+  for (NeighboursByLat::const_iterator i = start; i != m_neighboursByLat.end (); i++)
+    {
+      double dLat = i->first - lat;
+      if (dLat * dLat >= best)
+        break;
+      double dLong = i->second.Long - lon;
+      double distance = dLat * dLat + dLong * dLong;
+      if (distance < best)
+        {
+          best = distance;
+          found = &i->second;
+        }
+    }
+  for (NeighboursByLat::const_iterator i = start; i != m_neighboursByLat.begin (); )
+    {
+      i--;
+      double dLat = i->first - lat;
+      if (dLat * dLat >= best)
+        break;
+      double dLong = i->second.Long - lon;
+      double distance = dLat * dLat + dLong * dLong;
+      if (distance < best)
+        {
+          best = distance;
+          found = &i->second;
+        }
+    }
+
+  if (found == 0)
+    return false;
+  return GetNeighbour (found->gnAddr, closest);
+}
+
+bool
+LocationTable::GetNeighbour (uint64_t gnAddr, struct LocTableEntry &neighbour) const
+{
+  Neighbours::const_iterator i = m_neighbours.find (gnAddr);
+  if (i == m_neighbours.end ())
+    return false;
+  neighbour = i->second;
+  return true;
+}
+
+void
+LocationTable::AddToIndex (const struct LocTableEntry &entry)
+{
+  IndexedNeighbour indexed;
+  indexed.Long = entry.Long;
+  indexed.gnAddr = entry.gnAddr;
+  m_neighboursByLat.insert (std::make_pair ((double) entry.Lat, indexed));
+  m_neighbours[entry.gnAddr] = entry;
+}
+
+void
+LocationTable::RemoveFromIndex (const struct LocTableEntry &entry)
+{
+  std::pair<NeighboursByLat::iterator, NeighboursByLat::iterator> range = m_neighboursByLat.equal_range ((double) entry.Lat);
+  for (NeighboursByLat::iterator i = range.first; i != range.second; i++)
+    {
+      if (i->second.gnAddr == entry.gnAddr)
+        {
+          m_neighboursByLat.erase (i);
+          break;
+        }
+    }
+  m_neighbours.erase (entry.gnAddr);
+}
+
 LocationTable::Table 
 LocationTable::GetTable ()
 {
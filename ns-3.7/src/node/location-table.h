@@ -21,6 +21,7 @@
 #ifndef LOCATION_TABLE_H
 #define LOCATION_TABLE_H
 
+#include <map>
 #include <vector>
 
 #include "ns3/object.h"
@@ -83,6 +84,19 @@ public:
 
   Table GetTable();
   int GetNbNeighs();
+
+/**
+* Get the neighbour (the local node included) closest to a position, for
+* the greedy forwarding. The distance is the cartesian one on the
+* latitude and longitude, as CartesianDistance computes it.
+* \returns false if no neighbour is closer than maxDistance
+*/
+  bool GetClosestNeighbour (double lat, double lon, double maxDistance, struct LocTableEntry &closest) const;
+
+/**
+* \returns false if gnAddr is not a neighbour
+*/
+  bool GetNeighbour (uint64_t gnAddr, struct LocTableEntry &neighbour) const;
   void SetNode (Ptr<Node> node);
   void NotifyNewAggregate ();
 
@@ -94,6 +108,23 @@ private:
 
   void ScheduleCleanTable();
   void ScheduleUpdatePos();
+
+  /**
+  * Keep the index of the neighbours in sync with the entries of m_Table
+  */
+  void AddToIndex (const struct LocTableEntry &entry);
+  void RemoveFromIndex (const struct LocTableEntry &entry);
+
+  struct IndexedNeighbour
+  {
+    double Long;
+    uint64_t gnAddr;
+  };
+  // Neighbours sorted by latitude, to search the closest one around a position
+  typedef std::multimap<double, IndexedNeighbour> NeighboursByLat;
+  NeighboursByLat m_neighboursByLat;
+  typedef std::map<uint64_t, struct LocTableEntry> Neighbours;
+  Neighbours m_neighbours;
 };
 
 }; //namespace ns3
@@ -0,0 +1,204 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2009-2010, EURECOM, EU FP7 iTETRIS project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "duplicate-packet-cache.h"
+
+using namespace ns3;
+
+// ===========================================================================
+// Test case to make sure that a packet is a duplicate only if its source,
+// application index and sequence number were all seen before.
+// ===========================================================================
+class DuplicatePacketCacheDetectionTestCase : public TestCase
+{
+public:
+  DuplicatePacketCacheDetectionTestCase ();
+  virtual ~DuplicatePacketCacheDetectionTestCase ();
+
+private:
+  virtual bool DoRun (void);
+};
+
+DuplicatePacketCacheDetectionTestCase::DuplicatePacketCacheDetectionTestCase ()
+  : TestCase ("Check the detection of duplicate packets")
+{
+}
+
+DuplicatePacketCacheDetectionTestCase::~DuplicatePacketCacheDetectionTestCase ()
+{
+}
+
+bool
+DuplicatePacketCacheDetectionTestCase::DoRun (void)
+{
+  DuplicatePacketCache cache;
+  uint64_t source = 0x0001000200030004ULL;
+
+  NS_TEST_EXPECT_MSG_EQ (cache.IsDuplicate (source, 5, 100), false, "A new packet is not a duplicate");
+  NS_TEST_EXPECT_MSG_EQ (cache.IsDuplicate (source, 5, 100), true, "The same packet is a duplicate");
+  NS_TEST_EXPECT_MSG_EQ (cache.IsDuplicate (source, 5, 100), true, "The same packet is still a duplicate");
+  NS_TEST_EXPECT_MSG_EQ (cache.IsDuplicate (source + 1, 5, 100), false, "Another source is not a duplicate");
+  NS_TEST_EXPECT_MSG_EQ (cache.IsDuplicate (source, 6, 100), false, "Another application is not a duplicate");
+  NS_TEST_EXPECT_MSG_EQ (cache.IsDuplicate (source, 5, 101), false, "Another sequence number is not a duplicate");
+  // sources differing only in their upper 32 bits
+  NS_TEST_EXPECT_MSG_EQ (cache.IsDuplicate (source ^ (1ULL << 40), 5, 100), false,
+                         "A source differing in its upper bits is not a duplicate");
+  NS_TEST_EXPECT_MSG_EQ (cache.GetSize (), 5, "Expected five packets in the cache");
+
+  cache.Clear ();
+  NS_TEST_EXPECT_MSG_EQ (cache.GetSize (), 0, "The cache was not cleared");
+  NS_TEST_EXPECT_MSG_EQ (cache.IsDuplicate (source, 5, 100), false, "A cleared packet is not a duplicate");
+
+  return GetErrorStatus ();
+}
+
+// ===========================================================================
+// Test case to make sure that the packets are forgotten once they are older
+// than the lifetime of the cache.
+// ===========================================================================
+class DuplicatePacketCacheLifetimeTestCase : public TestCase
+{
+public:
+  DuplicatePacketCacheLifetimeTestCase ();
+  virtual ~DuplicatePacketCacheLifetimeTestCase ();
+
+private:
+  virtual bool DoRun (void);
+
+  void Check (uint16_t seqNb, bool duplicate, uint32_t size);
+
+  DuplicatePacketCache m_cache;
+};
+
+DuplicatePacketCacheLifetimeTestCase::DuplicatePacketCacheLifetimeTestCase ()
+  : TestCase ("Check the expiry of the packets after the lifetime")
+{
+}
+
+DuplicatePacketCacheLifetimeTestCase::~DuplicatePacketCacheLifetimeTestCase ()
+{
+}
+
+void
+DuplicatePacketCacheLifetimeTestCase::Check (uint16_t seqNb, bool duplicate, uint32_t size)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_cache.IsDuplicate (1, 0, seqNb), duplicate,
+                         "Wrong state of packet " << seqNb << " at " << Simulator::Now ().GetSeconds () << "s");
+  NS_TEST_EXPECT_MSG_EQ (m_cache.GetSize (), size,
+                         "Wrong cache size at " << Simulator::Now ().GetSeconds () << "s");
+}
+
+bool
+DuplicatePacketCacheLifetimeTestCase::DoRun (void)
+{
+  m_cache.SetLifetime (Seconds (2));
+  NS_TEST_EXPECT_MSG_EQ (m_cache.GetLifetime (), Seconds (2), "Wrong lifetime");
+
+  Simulator::Schedule (Seconds (1), &DuplicatePacketCacheLifetimeTestCase::Check, this, 1, false, 1);
+  Simulator::Schedule (Seconds (2), &DuplicatePacketCacheLifetimeTestCase::Check, this, 2, false, 2);
+  Simulator::Schedule (Seconds (2.5), &DuplicatePacketCacheLifetimeTestCase::Check, this, 1, true, 2);
+  // packet 1 expires at 3s, its duplicate at 2.5s did not extend its
+  // lifetime, and packet 2 is still remembered
+  Simulator::Schedule (Seconds (3), &DuplicatePacketCacheLifetimeTestCase::Check, this, 2, true, 1);
+  Simulator::Schedule (Seconds (3.5), &DuplicatePacketCacheLifetimeTestCase::Check, this, 1, false, 2);
+  Simulator::Schedule (Seconds (4), &DuplicatePacketCacheLifetimeTestCase::Check, this, 3, false, 2);
+  Simulator::Schedule (Seconds (10), &DuplicatePacketCacheLifetimeTestCase::Check, this, 3, false, 1);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  return GetErrorStatus ();
+}
+
+// ===========================================================================
+// Test case to make sure that the oldest packets are forgotten first when
+// the cache is full.
+// ===========================================================================
+class DuplicatePacketCacheCapacityTestCase : public TestCase
+{
+public:
+  DuplicatePacketCacheCapacityTestCase ();
+  virtual ~DuplicatePacketCacheCapacityTestCase ();
+
+private:
+  virtual bool DoRun (void);
+};
+
+DuplicatePacketCacheCapacityTestCase::DuplicatePacketCacheCapacityTestCase ()
+  : TestCase ("Check the eviction of the oldest packets at capacity")
+{
+}
+
+DuplicatePacketCacheCapacityTestCase::~DuplicatePacketCacheCapacityTestCase ()
+{
+}
+
+bool
+DuplicatePacketCacheCapacityTestCase::DoRun (void)
+{
+  DuplicatePacketCache cache;
+  cache.SetMaxEntries (3);
+  NS_TEST_EXPECT_MSG_EQ (cache.GetMaxEntries (), 3, "Wrong maximum size");
+
+  for (uint16_t seqNb = 1; seqNb <= 3; seqNb++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (cache.IsDuplicate (7, 0, seqNb), false, "Packet " << seqNb << " is new");
+    }
+  NS_TEST_EXPECT_MSG_EQ (cache.GetSize (), 3, "The cache should be full");
+
+  // packet 4 evicts packet 1, the oldest
+  NS_TEST_EXPECT_MSG_EQ (cache.IsDuplicate (7, 0, 4), false, "Packet 4 is new");
+  NS_TEST_EXPECT_MSG_EQ (cache.GetSize (), 3, "The cache grew above its maximum size");
+  NS_TEST_EXPECT_MSG_EQ (cache.IsDuplicate (7, 0, 2), true, "Packet 2 should be remembered");
+  NS_TEST_EXPECT_MSG_EQ (cache.IsDuplicate (7, 0, 3), true, "Packet 3 should be remembered");
+  NS_TEST_EXPECT_MSG_EQ (cache.IsDuplicate (7, 0, 4), true, "Packet 4 should be remembered");
+  // packet 1 is new again, and evicts packet 2
+  NS_TEST_EXPECT_MSG_EQ (cache.IsDuplicate (7, 0, 1), false, "Packet 1 should have been evicted");
+  NS_TEST_EXPECT_MSG_EQ (cache.IsDuplicate (7, 0, 2), false, "Packet 2 should have been evicted");
+
+  // shrinking the cache forgets the oldest packets on the next lookup
+  cache.SetMaxEntries (1);
+  NS_TEST_EXPECT_MSG_EQ (cache.IsDuplicate (7, 0, 2), true, "Packet 2 is the newest one");
+  NS_TEST_EXPECT_MSG_EQ (cache.GetSize (), 1, "The cache was not shrunk");
+  NS_TEST_EXPECT_MSG_EQ (cache.IsDuplicate (7, 0, 1), false, "Packet 1 should have been evicted");
+
+  // a cache without entries remembers nothing
+  cache.SetMaxEntries (0);
+  NS_TEST_EXPECT_MSG_EQ (cache.IsDuplicate (7, 0, 1), false, "An empty cache has no duplicates");
+  NS_TEST_EXPECT_MSG_EQ (cache.IsDuplicate (7, 0, 1), false, "An empty cache has no duplicates");
+  NS_TEST_EXPECT_MSG_EQ (cache.GetSize (), 0, "An empty cache keeps no packet");
+
+  return GetErrorStatus ();
+}
+
+class DuplicatePacketCacheTestSuite : public TestSuite
+{
+public:
+  DuplicatePacketCacheTestSuite ();
+};
+
+DuplicatePacketCacheTestSuite::DuplicatePacketCacheTestSuite ()
+  : TestSuite ("duplicate-packet-cache", UNIT)
+{
+  AddTestCase (new DuplicatePacketCacheDetectionTestCase);
+  AddTestCase (new DuplicatePacketCacheLifetimeTestCase);
+  AddTestCase (new DuplicatePacketCacheCapacityTestCase);
+}
+
+DuplicatePacketCacheTestSuite duplicatePacketCacheTestSuite;
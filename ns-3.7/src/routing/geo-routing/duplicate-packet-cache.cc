@@ -0,0 +1,127 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2009-2010, EURECOM, EU FP7 iTETRIS project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "duplicate-packet-cache.h"
+#include "ns3/simulator.h"
+
+namespace ns3
+{
+
+bool
+DuplicatePacketCache::Key::operator == (const Key &o) const
+{
+  return source == o.source && appIndex == o.appIndex && seqNb == o.seqNb;
+}
+
+size_t
+DuplicatePacketCache::KeyHash::operator () (const Key &key) const
+{
+  size_t h = (size_t) (key.source ^ (key.source >> 32));
+  h = h * 31 + key.appIndex;
+  h = h * 31 + key.seqNb;
+  return h;
+}
+
+DuplicatePacketCache::DuplicatePacketCache ()
+  : m_lifetime (Seconds (10)),
+    m_maxEntries (4096)
+{
+}
+
+bool
+DuplicatePacketCache::IsDuplicate (uint64_t source, uint32_t appIndex, uint16_t seqNb)
+{
+  Time now = Simulator::Now ();
+  Purge (now);
+
+  Key key;
+  key.source = source;
+  key.appIndex = appIndex;
+  key.seqNb = seqNb;
+  if (m_cache.find (key) != m_cache.end ())
+    {
+      return true;
+    }
+  if (m_maxEntries == 0)
+    {
+      return false;
+    }
+  if (m_cache.size () >= m_maxEntries)
+    {
+      m_cache.erase (m_arrivals.front ().second);
+      m_arrivals.pop_front ();
+    }
+  m_cache[key] = now;
+  m_arrivals.push_back (std::make_pair (now, key));
+  return false;
+}
+
+void
+DuplicatePacketCache::Purge (Time now)
+{
+  // Simulation time only moves forward, so the expired packets are at the front
+  while (!m_arrivals.empty () && m_arrivals.front ().first + m_lifetime <= now)
+    {
+      m_cache.erase (m_arrivals.front ().second);
+      m_arrivals.pop_front ();
+    }
+  while (m_arrivals.size () > m_maxEntries)
+    {
+      m_cache.erase (m_arrivals.front ().second);
+      m_arrivals.pop_front ();
+    }
+}
+
+void
+DuplicatePacketCache::SetLifetime (Time lifetime)
+{
+  m_lifetime = lifetime;
+}
+
+Time
+DuplicatePacketCache::GetLifetime (void) const
+{
+  return m_lifetime;
+}
+
+void
+DuplicatePacketCache::SetMaxEntries (uint32_t maxEntries)
+{
+  m_maxEntries = maxEntries;
+}
+
+uint32_t
+DuplicatePacketCache::GetMaxEntries (void) const
+{
+  return m_maxEntries;
+}
+
+uint32_t
+DuplicatePacketCache::GetSize (void) const
+{
+  return m_cache.size ();
+}
+
+void
+DuplicatePacketCache::Clear (void)
+{
+  m_cache.clear ();
+  m_arrivals.clear ();
+}
+
+}
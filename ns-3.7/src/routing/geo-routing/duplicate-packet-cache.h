@@ -0,0 +1,90 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2009-2010, EURECOM, EU FP7 iTETRIS project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef DUPLICATE_PACKET_CACHE_H_
+#define DUPLICATE_PACKET_CACHE_H_
+
+#include <deque>
+#include <functional>
+#include <stdint.h>
+
+#include "ns3/nstime.h"
+#include "ns3/sgi-hashmap.h"
+
+namespace ns3
+{
+/**
+ * \ingroup geoRouting
+ *
+ * \brief Packets already received by a node, to drop their duplicates.
+ *
+ * A packet is identified by its source GN address, the index of the
+ * application and its sequence number. Packets are forgotten once they are
+ * older than the lifetime, and the oldest ones are forgotten first when
+ * the cache is full, so the lookup cost and the memory do not grow with the
+ * length of the simulation.
+ */
+class DuplicatePacketCache
+{
+public:
+  DuplicatePacketCache ();
+
+  /**
+   * \param source the GN address of the source of the packet
+   * \param appIndex the index of the application that sent the packet
+   * \param seqNb the sequence number of the packet
+   * \returns true if the packet was received before, else the packet is
+   *          remembered and false is returned.
+   */
+  bool IsDuplicate (uint64_t source, uint32_t appIndex, uint16_t seqNb);
+
+  void SetLifetime (Time lifetime);
+  Time GetLifetime (void) const;
+  void SetMaxEntries (uint32_t maxEntries);
+  uint32_t GetMaxEntries (void) const;
+  uint32_t GetSize (void) const;
+  void Clear (void);
+
+private:
+  struct Key
+  {
+    uint64_t source;
+    uint32_t appIndex;
+    uint16_t seqNb;
+    bool operator == (const Key &o) const;
+  };
+  struct KeyHash : public std::unary_function<Key, size_t>
+  {
+    size_t operator () (const Key &key) const;
+  };
+  typedef sgi::hash_map<Key, Time, KeyHash> Cache;
+  typedef std::deque<std::pair<Time, Key> > Arrivals;
+
+  /// Forgets the packets received before the lifetime and the oldest ones above the maximum size.
+  void Purge (Time now);
+
+  Cache m_cache;
+  // Packets in the order they were received, to forget the oldest first
+  Arrivals m_arrivals;
+  Time m_lifetime;
+  uint32_t m_maxEntries;
+};
+
+}
+
+#endif /* DUPLICATE_PACKET_CACHE_H_ */
@@ -30,6 +30,7 @@
 #include <math.h>
 
 #include "ns3/app-index-tag.h"
+#include "ns3/uinteger.h"
 
 NS_LOG_COMPONENT_DEFINE ("geoBroadcast");
 namespace ns3
@@ -41,6 +42,18 @@ geoBroadcast::GetTypeId (void)
   static TypeId tid = TypeId ("ns3::geo-routing::geoBroadcast")
       .SetParent<c2cRoutingProtocol> ()
       .AddConstructor<geoBroadcast> ()
+      .AddAttribute ("DuplicateCacheLifetime",
+                     "Time a received packet is remembered to drop its duplicates.",
+                     TimeValue (Seconds (10)),
+                     MakeTimeAccessor (&geoBroadcast::SetDuplicateCacheLifetime,
+                                       &geoBroadcast::GetDuplicateCacheLifetime),
+                     MakeTimeChecker ())
+      .AddAttribute ("DuplicateCacheSize",
+                     "Maximum number of received packets remembered to drop their duplicates.",
+                     UintegerValue (4096),
+                     MakeUintegerAccessor (&geoBroadcast::SetDuplicateCacheSize,
+                                           &geoBroadcast::GetDuplicateCacheSize),
+                     MakeUintegerChecker<uint32_t> ())
   ;
   return tid;
 }
@@ -178,11 +191,10 @@ geoBroadcast::RouteInput (Ptr<const Packet> p, const c2cCommonHeader &header,
 //  std::cout<<"GeoBroadcast: RouteInput at Node "<<(m_c2c->GetObject<Node> ())->GetId()<<std::endl;
   //---------------- check iTETRIS ----------------------------
 
-  if (checkReception (p, header) == false)
+  GeoABcastHeader bheader;
+  p->PeekHeader (bheader);
+  if (checkReception (p, bheader) == false)
   {
-    Ptr<Packet> packetlcb = p->Copy ();
-    GeoABcastHeader bheader;
-    packetlcb->RemoveHeader (bheader);
 
     struct c2cCommonHeader::geoAreaPos areapos1 = bheader.GetGeoAreaPos1 ();
     struct c2cCommonHeader::geoAreaPos areapos2 = bheader.GetGeoAreaPos2 ();    
@@ -263,9 +275,11 @@ geoBroadcast::RouteInput (Ptr<const Packet> p, const c2cCommonHeader &header,
       //std::cout<<"GeoBroadcast RouteInput: Node "<< m_c2c->GetObject<Node> ()->GetId ()<<" is in the destination area "<<std::endl;
       //---------------- check iTETRIS ----------------------------
       //Local deliver
+      Ptr<Packet> packetlcb = p->Copy ();
+      packetlcb->RemoveHeader (bheader);
       lcb (packetlcb, header, saddr, daddr, iif);
       
-      std::cout<<"GeoBroadcast RouteInput: Forward "<< m_posvector.gnAddr <<" seq : " << bheader.GetSeqNb()  <<std::endl;
+      NS_LOG_INFO ("GeoBroadcast RouteInput: Forward "<< m_posvector.gnAddr <<" seq : " << bheader.GetSeqNb());
       //FORWARD packet !
       result.route->SetGateway (daddr);
       ucb (result, header);
@@ -392,78 +406,48 @@ geoBroadcast::checkReception (Ptr<const Packet> p)
 
 */
 
-bool // modified by MR - Vineet
-geoBroadcast::checkReception (Ptr<const Packet> p, const c2cCommonHeader &commonHeader)
+bool
+geoBroadcast::checkReception (Ptr<const Packet> p, const GeoABcastHeader &bheader)
 {
-  bool result = false;
-  Ptr<Packet> packet = p->Copy ();
-  GeoABcastHeader bheader;
-  packet->RemoveHeader (bheader);
+  if (m_c2c->GetObject<Node> ()->GetId() == bheader.GetSourPosVector().gnAddr)
+    {
+      // local node is the packet source (the local node has not to retransmit this packet)
+      return true;
+    }
 
-   AppIndexTag appindexTag;
-   bool found;
-   found = packet->PeekPacketTag (appindexTag);
-   NS_ASSERT (found);
-   uint32_t appindex = appindexTag.Get ();
+  AppIndexTag appindexTag;
+  bool found;
+  found = p->PeekPacketTag (appindexTag);
+  NS_ASSERT (found);
+  uint32_t appindex = appindexTag.Get ();
 
-   NS_LOG_INFO ("TopoBroadcast: checkreception: appindex tag= "<< appindex );
+  NS_LOG_INFO ("geoBroadcast: checkreception: appindex tag= "<< appindex );
 
-  if (m_c2c->GetObject<Node> ()->GetId() != bheader.GetSourPosVector().gnAddr)
-  {
-     if ((!m_packetReceived.empty()))  // local node did receive packets before
-     {
-         packetReceived::iterator iter = m_packetReceived.find (bheader.GetSourPosVector().gnAddr);
-         if (iter != m_packetReceived.end())  // local node did receive packets from this source before
-         {
-              AppPackets::iterator it =  iter->second.find (appindex);
-              if (it != iter->second.end())  // local node did receive packets belonging to this application from this node before
-              {
-                  for (PacketSequenceNumber::iterator i = it->second.begin (); i != it->second.end (); i++) // scan all the packets belonging to this application received from this node
-                  {
-                       if (*(i) == bheader.GetSeqNb()) //the local node has received a packet belonging to this application from this sender with the same SN as this one (the local node has not to retransmit this packet)
-                       {
-                          result = true;
-                          break;
-                       }
-                  }
-                  if (result == false) //the local node has received a packet belonging to this application from this sender but not with the same SN as this one
-                  {
-                      it->second.push_back (bheader.GetSeqNb());
-                  }
-              }
-              else //local node did not receive packets belonging to this application from this node before
-              {
-                  result = false;
-                  PacketSequenceNumber v;
-                  v.push_back (bheader.GetSeqNb());
-                  AppPackets AppPkts;
-                  AppPkts [appindex] = v;
-                  m_packetReceived [bheader.GetSourPosVector().gnAddr] = AppPkts;
-              }
-           }
-           else  // local node did not receive a packet from this source before
-             {
-                 result = false;
-                 PacketSequenceNumber v;
-                 v.push_back (bheader.GetSeqNb());
-                 AppPackets AppPkts;
-                 AppPkts [appindex] = v;
-                 m_packetReceived [bheader.GetSourPosVector().gnAddr] = AppPkts;
-             }
-     }
-     else  // local node did not receive any packet before
-     {
-        PacketSequenceNumber v;
-        v.push_back (bheader.GetSeqNb());
-        AppPackets AppPkts;
-        AppPkts [appindex] = v;
-        m_packetReceived [bheader.GetSourPosVector().gnAddr] = AppPkts;
-        result = false;
-     }
-  }
-  else // local node is the packet source (the local node has not to retransmit this packet)
-  result = true;
-  return result;
+  return m_duplicates.IsDuplicate (bheader.GetSourPosVector().gnAddr, appindex, bheader.GetSeqNb());
+}
+
+void
+geoBroadcast::SetDuplicateCacheLifetime (Time lifetime)
+{
+  m_duplicates.SetLifetime (lifetime);
+}
+
+Time
+geoBroadcast::GetDuplicateCacheLifetime (void) const
+{
+  return m_duplicates.GetLifetime ();
+}
+
+void
+geoBroadcast::SetDuplicateCacheSize (uint32_t size)
+{
+  m_duplicates.SetMaxEntries (size);
+}
+
+uint32_t
+geoBroadcast::GetDuplicateCacheSize (void) const
+{
+  return m_duplicates.GetMaxEntries ();
 }
 
 
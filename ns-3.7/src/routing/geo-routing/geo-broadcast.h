@@ -31,6 +31,9 @@
 #include "ns3/c2c-l3-protocol.h"
 #include "ns3/c2c-address.h"
 #include "ns3/c2c-common-header.h"
+#include "ns3/nstime.h"
+#include "duplicate-packet-cache.h"
+#include "geoBroadAnycast-header.h"
 #include "ns3/location-table.h"
 
 namespace ns3
@@ -57,8 +60,12 @@ public:
 
   virtual void Setc2c (Ptr<c2c> c2c);
 
+  void SetDuplicateCacheLifetime (Time lifetime);
+  Time GetDuplicateCacheLifetime (void) const;
+  void SetDuplicateCacheSize (uint32_t size);
+  uint32_t GetDuplicateCacheSize (void) const;
 
-  bool checkReception (Ptr<const Packet> p, const c2cCommonHeader &commonHeader);
+  bool checkReception (Ptr<const Packet> p, const GeoABcastHeader &bheader);
 
 protected:
   virtual void DoDispose (void);
@@ -71,10 +78,7 @@ private:
   // std::map<uint64_t,T> packetReceived;
 
 
-  typedef std::vector<uint16_t> PacketSequenceNumber;
-  typedef std::map<uint32_t,PacketSequenceNumber> AppPackets;
-  typedef std::map<uint64_t,AppPackets> packetReceived;
-  packetReceived m_packetReceived;
+  DuplicatePacketCache m_duplicates;
 
  // bool checkReception(Ptr<const Packet> p);
 };
@@ -22,6 +22,7 @@
 #include "geoUnicast-header.h"
 #include "utils.h"
 #include "ns3/app-index-tag.h" // Added by Ramon Bauza
+#include "ns3/uinteger.h"
 
 NS_LOG_COMPONENT_DEFINE ("geoUnicast");
 
@@ -38,6 +39,18 @@ geoUnicast::GetTypeId (void)
   static TypeId tid = TypeId ("ns3::geo-routing::geoUnicast")
       .SetParent<c2cRoutingProtocol> ()
       .AddConstructor<geoUnicast> ()
+      .AddAttribute ("DuplicateCacheLifetime",
+                     "Time a received packet is remembered to drop its duplicates.",
+                     TimeValue (Seconds (10)),
+                     MakeTimeAccessor (&geoUnicast::SetDuplicateCacheLifetime,
+                                       &geoUnicast::GetDuplicateCacheLifetime),
+                     MakeTimeChecker ())
+      .AddAttribute ("DuplicateCacheSize",
+                     "Maximum number of received packets remembered to drop their duplicates.",
+                     UintegerValue (4096),
+                     MakeUintegerAccessor (&geoUnicast::SetDuplicateCacheSize,
+                                           &geoUnicast::GetDuplicateCacheSize),
+                     MakeUintegerChecker<uint32_t> ())
   ;
   return tid;
 }
@@ -158,13 +171,10 @@ geoUnicast::RouteInput (Ptr<const Packet> p, const c2cCommonHeader &header,
  NS_LOG_INFO ("GeoUnicast: RouteInput at Node "<<(m_c2c->GetObject<Node> ())->GetId());
   //---------------- check iTETRIS ----------------------------
 
-//   if (checkReception (p) == false) // Modified by Ramon Bauza
-  if (checkReception (p,header) == false) // Added by Ramon Bauza
+  geoUnicastHeader uheader;
+  p->PeekHeader (uheader);
+  if (checkReception (p, uheader) == false)
   {
-    Ptr<Packet> packetlcb = p->Copy ();
-    geoUnicastHeader uheader;
-    packetlcb->RemoveHeader (uheader);
-
     Ptr<c2cAddress> saddr = CreateObject<c2cAddress> ();
     saddr->Set (uheader.GetSourPosVector().gnAddr, uheader.GetSourPosVector().Lat, uheader.GetSourPosVector().Long);
     Ptr<c2cAddress> daddr = CreateObject<c2cAddress> ();
@@ -189,6 +199,8 @@ geoUnicast::RouteInput (Ptr<const Packet> p, const c2cCommonHeader &header,
      if (uheader.GetDestPosVector().gnAddr == m_c2c->GetObject<Node> ()->GetId())
      {
       //Local deliver
+      Ptr<Packet> packetlcb = p->Copy ();
+      packetlcb->RemoveHeader (uheader);
       lcb (packetlcb, header, saddr, daddr, iif);
       return true;
      }
@@ -289,78 +301,48 @@ geoUnicast::RouteInput (Ptr<const Packet> p, const c2cCommonHeader &header,
 //   return result;
 // }
 
-bool 
-geoUnicast::checkReception (Ptr<const Packet> p, const c2cCommonHeader &commonHeader) 
+bool
+geoUnicast::checkReception (Ptr<const Packet> p, const geoUnicastHeader &uheader)
 {
-  bool result = false;
-  Ptr<Packet> packet = p->Copy ();
-  geoUnicastHeader uheader;
-  packet->RemoveHeader (uheader);
+  if (m_c2c->GetObject<Node> ()->GetId() == uheader.GetSourPosVector().gnAddr)
+    {
+      // local node is the packet source (the local node has not to retransmit this packet)
+      return true;
+    }
 
-   AppIndexTag appindexTag;
-   bool found;
-   found = packet->PeekPacketTag (appindexTag);
-   NS_ASSERT (found);
-   uint32_t appindex = appindexTag.Get ();
+  AppIndexTag appindexTag;
+  bool found;
+  found = p->PeekPacketTag (appindexTag);
+  NS_ASSERT (found);
+  uint32_t appindex = appindexTag.Get ();
 
-//   std::cout<<"Geounicast: checkreception: appindex tag= "<< appindex <<std::endl;
+  NS_LOG_INFO ("geoUnicast: checkreception: appindex tag= "<< appindex );
 
-  if (m_c2c->GetObject<Node> ()->GetId() != uheader.GetSourPosVector().gnAddr)
-  {
-     if ((!m_packetReceived.empty()))  // local node did receive packets before
-     {
-         packetReceived::iterator iter = m_packetReceived.find (uheader.GetSourPosVector().gnAddr);
-         if (iter != m_packetReceived.end())  // local node did receive packets from this source before
-         {
-              AppPackets::iterator it =  iter->second.find (appindex);
-              if (it != iter->second.end())  // local node did receive packets belonging to this application from this node before
-              {
-                  for (PacketSequenceNumber::iterator i = it->second.begin (); i != it->second.end (); i++) // scan all the packets belonging to this application received from this node
-                  {
-                       if (*(i) == uheader.GetSeqNb()) //the local node has received a packet belonging to this application from this sender with the same SN as this one (the local node has not to retransmit this packet)
-                       {
-                          result = true;
-                          break;
-                       }
-                  }
-                  if (result == false) //the local node has received a packet belonging to this application from this sender but not with the same SN as this one
-                  {
-                      it->second.push_back (uheader.GetSeqNb());
-                  }
-              }
-              else //local node did not receive packets belonging to this application from this node before
-              {
-                  result = false;
-                  PacketSequenceNumber v;
-                  v.push_back (uheader.GetSeqNb());
-                  AppPackets AppPkts;
-                  AppPkts [appindex] = v;
-                  m_packetReceived [uheader.GetSourPosVector().gnAddr] = AppPkts;
-              }
-           }
-           else  // local node did not receive a packet from this source before
-             {
-                 result = false;
-                 PacketSequenceNumber v;
-                 v.push_back (uheader.GetSeqNb());
-                 AppPackets AppPkts;
-                 AppPkts [appindex] = v;
-                 m_packetReceived [uheader.GetSourPosVector().gnAddr] = AppPkts;
-             }
-     }
-     else  // local node did not receive any packet before
-     {
-        PacketSequenceNumber v;
-        v.push_back (uheader.GetSeqNb());
-        AppPackets AppPkts;
-        AppPkts [appindex] = v;
-        m_packetReceived [uheader.GetSourPosVector().gnAddr] = AppPkts;
-        result = false;
-     }
-  }
-  else // local node is the packet source (the local node has not to retransmit this packet)
-  result = true;
-  return result;
+  return m_duplicates.IsDuplicate (uheader.GetSourPosVector().gnAddr, appindex, uheader.GetSeqNb());
+}
+
+void
+geoUnicast::SetDuplicateCacheLifetime (Time lifetime)
+{
+  m_duplicates.SetLifetime (lifetime);
+}
+
+Time
+geoUnicast::GetDuplicateCacheLifetime (void) const
+{
+  return m_duplicates.GetLifetime ();
+}
+
+void
+geoUnicast::SetDuplicateCacheSize (uint32_t size)
+{
+  m_duplicates.SetMaxEntries (size);
+}
+
+uint32_t
+geoUnicast::GetDuplicateCacheSize (void) const
+{
+  return m_duplicates.GetMaxEntries ();
 }
 
 }
@@ -31,11 +31,15 @@
 #include "ns3/c2c-l3-protocol.h"
 #include "ns3/c2c-address.h"
 #include "ns3/c2c-common-header.h"
+#include "ns3/nstime.h"
+#include "duplicate-packet-cache.h"
 #include "ns3/location-table.h"
 #include "ns3/mobility-model.h"
 
 namespace ns3
 {
+class geoUnicastHeader;
+
 /**
  * \ingroup geoRouting
  *
@@ -57,6 +61,11 @@ public:
 
   virtual void Setc2c (Ptr<c2c> c2c);
 
+  void SetDuplicateCacheLifetime (Time lifetime);
+  Time GetDuplicateCacheLifetime (void) const;
+  void SetDuplicateCacheSize (uint32_t size);
+  uint32_t GetDuplicateCacheSize (void) const;
+
 protected:
   virtual void DoDispose (void);
 
@@ -67,13 +76,10 @@ private:
 //   std::map<uint64_t,T> packetReceived; // Modified by Ramon Bauza
 
   // Added by Ramon Bauza
-  typedef std::vector<uint16_t> PacketSequenceNumber;
-  typedef std::map<uint32_t,PacketSequenceNumber> AppPackets;
-  typedef std::map<uint64_t,AppPackets> packetReceived;
-  packetReceived m_packetReceived;
+  DuplicatePacketCache m_duplicates;
 
 //   bool checkReception(Ptr<const Packet> p); // Modified by Ramon Bauza
-  bool checkReception (Ptr<const Packet> p, const c2cCommonHeader &commonHeader); // Added by Ramon Bauza
+  bool checkReception (Ptr<const Packet> p, const geoUnicastHeader &uheader); // Added by Ramon Bauza
 
 };
 
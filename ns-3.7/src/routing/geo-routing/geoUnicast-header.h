@@ -19,7 +19,7 @@
  */
 
 #ifndef GEOUNICAST_HEADER_H
-#define GEOUINCAST_HEADER_H
+#define GEOUNICAST_HEADER_H
 
 #include "ns3/header.h"
 #include "ns3/c2c-common-header.h"
@@ -21,6 +21,7 @@
 #include "topo-broadcast.h"
 #include "topoBroadcast-header.h"
 #include "ns3/app-index-tag.h"
+#include "ns3/uinteger.h"
 
 NS_LOG_COMPONENT_DEFINE ("topoBroadcast");
 
@@ -37,6 +38,18 @@ topoBroadcast::GetTypeId (void)
   static TypeId tid = TypeId ("ns3::geo-routing::topoBroadcast")
       .SetParent<c2cRoutingProtocol> ()
       .AddConstructor<topoBroadcast> ()
+      .AddAttribute ("DuplicateCacheLifetime",
+                     "Time a received packet is remembered to drop its duplicates.",
+                     TimeValue (Seconds (10)),
+                     MakeTimeAccessor (&topoBroadcast::SetDuplicateCacheLifetime,
+                                       &topoBroadcast::GetDuplicateCacheLifetime),
+                     MakeTimeChecker ())
+      .AddAttribute ("DuplicateCacheSize",
+                     "Maximum number of received packets remembered to drop their duplicates.",
+                     UintegerValue (4096),
+                     MakeUintegerAccessor (&topoBroadcast::SetDuplicateCacheSize,
+                                           &topoBroadcast::GetDuplicateCacheSize),
+                     MakeUintegerChecker<uint32_t> ())
   ;
   return tid;
 }
@@ -115,11 +128,10 @@ topoBroadcast::RouteInput (Ptr<const Packet> p, const c2cCommonHeader &header,
   //---------------- check iTETRIS ----------------------------
 
 
-  if (checkReception (p,header) == false) // Added by Ramon Bauza  // check whether this packet has been received before
+  topoBroadcastHeader tpheader;
+  p->PeekHeader (tpheader);
+  if (checkReception (p, tpheader) == false) // check whether this packet has been received before
   {
-    Ptr<Packet> packetlcb = p->Copy ();
-    topoBroadcastHeader tpheader;
-    packetlcb->RemoveHeader (tpheader);
 
     //Update location table
     Ptr <LocationTable> ltable = (m_c2c->GetObject<Node> ())->GetObject<LocationTable> ();
@@ -134,6 +146,8 @@ topoBroadcast::RouteInput (Ptr<const Packet> p, const c2cCommonHeader &header,
     daddr->Set (c2cAddress::BROAD, header.GetHopLimit());
 
     //Local deliver
+    Ptr<Packet> packetlcb = p->Copy ();
+    packetlcb->RemoveHeader (tpheader);
     lcb (packetlcb, header, saddr, daddr, iif);
     if (header.GetHopLimit()-1 != 0)
     {
@@ -155,78 +169,48 @@ topoBroadcast::RouteInput (Ptr<const Packet> p, const c2cCommonHeader &header,
 }
 
 
-bool // modified by MR
-topoBroadcast::checkReception (Ptr<const Packet> p, const c2cCommonHeader &commonHeader) 
+bool
+topoBroadcast::checkReception (Ptr<const Packet> p, const topoBroadcastHeader &tpheader)
 {
-  bool result = false;
-  Ptr<Packet> packet = p->Copy ();
-  topoBroadcastHeader tpheader;
-  packet->RemoveHeader (tpheader);
+  if (m_c2c->GetObject<Node> ()->GetId() == tpheader.GetSourPosVector().gnAddr)
+    {
+      // local node is the packet source (the local node has not to retransmit this packet)
+      return true;
+    }
 
-   AppIndexTag appindexTag;
-   bool found;
-   found = packet->PeekPacketTag (appindexTag);
-   NS_ASSERT (found);
-   uint32_t appindex = appindexTag.Get ();
+  AppIndexTag appindexTag;
+  bool found;
+  found = p->PeekPacketTag (appindexTag);
+  NS_ASSERT (found);
+  uint32_t appindex = appindexTag.Get ();
 
-   NS_LOG_INFO ("TopoBroadcast: checkreception: appindex tag= "<< appindex );
+  NS_LOG_INFO ("topoBroadcast: checkreception: appindex tag= "<< appindex );
 
-  if (m_c2c->GetObject<Node> ()->GetId() != tpheader.GetSourPosVector().gnAddr)
-  {
-     if ((!m_packetReceived.empty()))  // local node did receive packets before
-     {
-         packetReceived::iterator iter = m_packetReceived.find (tpheader.GetSourPosVector().gnAddr);
-         if (iter != m_packetReceived.end())  // local node did receive packets from this source before
-         {
-              AppPackets::iterator it =  iter->second.find (appindex);
-              if (it != iter->second.end())  // local node did receive packets belonging to this application from this node before
-              {
-                  for (PacketSequenceNumber::iterator i = it->second.begin (); i != it->second.end (); i++) // scan all the packets belonging to this application received from this node
-                  {
-                       if (*(i) == tpheader.GetSeqNb()) //the local node has received a packet belonging to this application from this sender with the same SN as this one (the local node has not to retransmit this packet)
-                       {
-                          result = true;
-                          break;
-                       }
-                  }
-                  if (result == false) //the local node has received a packet belonging to this application from this sender but not with the same SN as this one
-                  {
-                      it->second.push_back (tpheader.GetSeqNb());
-                  }
-              }
-              else //local node did not receive packets belonging to this application from this node before
-              {
-                  result = false;
-                  PacketSequenceNumber v;
-                  v.push_back (tpheader.GetSeqNb());
-                  AppPackets AppPkts;
-                  AppPkts [appindex] = v;
-                  m_packetReceived [tpheader.GetSourPosVector().gnAddr] = AppPkts;
-              }
-           }
-           else  // local node did not receive a packet from this source before
-             {
-                 result = false;
-                 PacketSequenceNumber v;
-                 v.push_back (tpheader.GetSeqNb());
-                 AppPackets AppPkts;
-                 AppPkts [appindex] = v;
-                 m_packetReceived [tpheader.GetSourPosVector().gnAddr] = AppPkts;
-             }
-     }
-     else  // local node did not receive any packet before
-     {
-        PacketSequenceNumber v;
-        v.push_back (tpheader.GetSeqNb());
-        AppPackets AppPkts;
-        AppPkts [appindex] = v;
-        m_packetReceived [tpheader.GetSourPosVector().gnAddr] = AppPkts;
-        result = false;
-     }
-  }
-  else // local node is the packet source (the local node has not to retransmit this packet)
-  result = true;
-  return result;
+  return m_duplicates.IsDuplicate (tpheader.GetSourPosVector().gnAddr, appindex, tpheader.GetSeqNb());
+}
+
+void
+topoBroadcast::SetDuplicateCacheLifetime (Time lifetime)
+{
+  m_duplicates.SetLifetime (lifetime);
+}
+
+Time
+topoBroadcast::GetDuplicateCacheLifetime (void) const
+{
+  return m_duplicates.GetLifetime ();
+}
+
+void
+topoBroadcast::SetDuplicateCacheSize (uint32_t size)
+{
+  m_duplicates.SetMaxEntries (size);
+}
+
+uint32_t
+topoBroadcast::GetDuplicateCacheSize (void) const
+{
+  return m_duplicates.GetMaxEntries ();
 }
 
 }
@@ -30,6 +30,9 @@
 #include "ns3/c2c-l3-protocol.h"
 #include "ns3/c2c-address.h"
 #include "ns3/c2c-common-header.h"
+#include "ns3/nstime.h"
+#include "duplicate-packet-cache.h"
+#include "topoBroadcast-header.h"
 
 namespace ns3
 {
@@ -53,7 +56,13 @@ public:
                            LocalDeliverCallback lcb, ErrorCallback ecb);
 
   virtual void Setc2c (Ptr<c2c> c2c);
-  bool checkReception (Ptr<const Packet> p, const c2cCommonHeader &commonHeader);
+
+  void SetDuplicateCacheLifetime (Time lifetime);
+  Time GetDuplicateCacheLifetime (void) const;
+  void SetDuplicateCacheSize (uint32_t size);
+  uint32_t GetDuplicateCacheSize (void) const;
+
+  bool checkReception (Ptr<const Packet> p, const topoBroadcastHeader &tpheader);
 
 protected:
   virtual void DoDispose (void);
@@ -61,10 +70,7 @@ protected:
 private:
   // c2c protocol
   Ptr<c2c> m_c2c;
-  typedef std::vector<uint16_t> PacketSequenceNumber;
-  typedef std::map<uint32_t,PacketSequenceNumber> AppPackets;
-  typedef std::map<uint64_t,AppPackets> packetReceived;
-  packetReceived m_packetReceived;
+  DuplicatePacketCache m_duplicates;
 };
 
 }
@@ -67,36 +67,23 @@ double DistanceInMeters(uint32_t lat2, uint32_t lon2, uint32_t lat1, uint32_t lo
 struct c2cCommonHeader::LongPositionVector getMinDistToDest(Ptr <LocationTable> ntable, Ptr<c2cAddress> daddr)
 {
     struct c2cCommonHeader::LongPositionVector vector;
-    if (ntable->m_Table.size() != 0)
-    {
+    LocationTable::LocTableEntry neighbour;
+    // neighbours farther than this from the destination are never chosen
     double min = 1000000;
 
-     for (uint32_t i = 0; i < (ntable->m_Table.size()); i++)
-       {
-        if (ntable->m_Table[i].is_neigh == true)
-        {
-        double distance = CartesianDistance (ntable->m_Table[i].Lat, ntable->m_Table[i].Long, daddr->GetGeoAreaPos1 ()->lat, daddr->GetGeoAreaPos1 ()->lon);
-
-        std::cout<<" UTILS: distance of neighbor "<<(ntable->m_Table[i]).gnAddr<<" to destination = "<<distance<<std::endl;
-
-        if(distance < min)
-        {
-          min = distance;
-          vector.gnAddr = ntable->m_Table[i].gnAddr;
-          vector.Ts = ntable->m_Table[i].Ts;
-          vector.Lat = ntable->m_Table[i].Lat;
-          vector.Long = ntable->m_Table[i].Long;
-          vector.Alt = ntable->m_Table[i].Alt;
-          vector.PosAcc = ntable->m_Table[i].PosAcc;
-          vector.AltAcc = ntable->m_Table[i].AltAcc;
-          vector.Speed = ntable->m_Table[i].Speed;
-          vector.Heading = ntable->m_Table[i].Heading;
-          vector.SpeedAcc = ntable->m_Table[i].SpeedAcc;
-          vector.HeadingAcc = ntable->m_Table[i].HeadingAcc;
-        }
-        }
-       }
-      std::cout<<" UTILS: the min dist to dest = "<<min<<" and is provided by node "<<vector.gnAddr<<std::endl;
+    if (ntable->GetClosestNeighbour (daddr->GetGeoAreaPos1 ()->lat, daddr->GetGeoAreaPos1 ()->lon, min, neighbour))
+    {
+      vector.gnAddr = neighbour.gnAddr;
+      vector.Ts = neighbour.Ts;
+      vector.Lat = neighbour.Lat;
+      vector.Long = neighbour.Long;
+      vector.Alt = neighbour.Alt;
+      vector.PosAcc = neighbour.PosAcc;
+      vector.AltAcc = neighbour.AltAcc;
+      vector.Speed = neighbour.Speed;
+      vector.Heading = neighbour.Heading;
+      vector.SpeedAcc = neighbour.SpeedAcc;
+      vector.HeadingAcc = neighbour.HeadingAcc;
     }
 
   return vector;
@@ -146,31 +133,14 @@ void store (Ptr<const Packet> p)
 
 Ptr<c2cAddress> DirectNeighbour (Ptr <LocationTable> ntable, Ptr<c2cAddress> daddr)
 {
-    bool isdirectneigh = false;
-    Ptr<c2cAddress> result;
-
-    if (ntable != 0)
-    {
-     for (LocationTable::Table::iterator i = ntable->m_Table.begin ();
-       i != ntable->m_Table.end (); i++)
-       {
-         if (daddr->GetId() == i->gnAddr)
-         {
-            if (i->is_neigh == true)
-            {
-              isdirectneigh = true;
-              // Added by Ramon Bauza
-              result = CreateObject<c2cAddress> ();
-              result->Set (i->gnAddr, i->Lat, i->Long);
-            }
-         }
-       }
-    }
-    if (isdirectneigh == true)
+    LocationTable::LocTableEntry neighbour;
+    if (ntable != 0 && ntable->GetNeighbour (daddr->GetId(), neighbour))
     {
+      // Added by Ramon Bauza
+      Ptr<c2cAddress> result = CreateObject<c2cAddress> ();
+      result->Set (neighbour.gnAddr, neighbour.Lat, neighbour.Long);
       return result;
     }
-    else
     return 0;
 }
 
@@ -162,6 +162,19 @@ DefaultSimulatorImpl::RunOneEvent (void)
   ProcessOneEvent ();
 }
 
+uint64_t
+DefaultSimulatorImpl::RunUntil (Time const &time)
+{
+  uint64_t limit = time.GetTimeStep ();
+  uint64_t nEvents = 0;
+  while (!m_events->IsEmpty () && !m_stop && m_events->PeekNext ().key.m_ts < limit)
+    {
+      ProcessOneEvent ();
+      nEvents++;
+    }
+  return nEvents;
+}
+
 void 
 DefaultSimulatorImpl::Stop (void)
 {
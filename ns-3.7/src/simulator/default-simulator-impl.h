@@ -53,6 +53,7 @@ public:
   virtual bool IsExpired (const EventId &ev) const;
   virtual void Run (void);
   virtual void RunOneEvent (void);
+  virtual uint64_t RunUntil (Time const &time);
   virtual Time Now (void) const;
   virtual Time GetDelayLeft (const EventId &id) const;
   virtual Time GetMaximumSimulationTime (void) const;
@@ -525,6 +525,22 @@ RealtimeSimulatorImpl::RunOneEvent (void)
   event->Unref ();
 }
 
+//
+// Like RunOneEvent, this does not synchronize with real time.
+//
+uint64_t
+RealtimeSimulatorImpl::RunUntil (Time const &time)
+{
+  NS_LOG_FUNCTION (time);
+  uint64_t nEvents = 0;
+  while (!IsFinished () && Next () < time)
+    {
+      RunOneEvent ();
+      nEvents++;
+    }
+  return nEvents;
+}
+
 void 
 RealtimeSimulatorImpl::Stop (void)
 {
@@ -180,6 +180,13 @@ Simulator::RunOneEvent (void)
   GetImpl ()->RunOneEvent ();
 }
 
+uint64_t
+Simulator::RunUntil (Time const &time)
+{
+  NS_LOG_FUNCTION (time);
+  return GetImpl ()->RunUntil (time);
+}
+
 void 
 Simulator::Stop (void)
 {
@@ -818,6 +825,54 @@ SimulatorTemplateTestCase::DoRun (void)
   return false;
 }
 
+class SimulatorRunUntilTestCase : public TestCase
+{
+public:
+  SimulatorRunUntilTestCase ();
+  virtual bool DoRun (void);
+  void Count (void);
+  void CountAndStop (void);
+  uint32_t m_count;
+};
+
+SimulatorRunUntilTestCase::SimulatorRunUntilTestCase ()
+  : TestCase ("Check that RunUntil stops before the time bound and can be resumed")
+{}
+void
+SimulatorRunUntilTestCase::Count (void)
+{
+  m_count++;
+}
+void
+SimulatorRunUntilTestCase::CountAndStop (void)
+{
+  m_count++;
+  Simulator::Stop ();
+}
+bool
+SimulatorRunUntilTestCase::DoRun (void)
+{
+  m_count = 0;
+  Simulator::Schedule (Seconds (1), &SimulatorRunUntilTestCase::Count, this);
+  Simulator::Schedule (Seconds (2), &SimulatorRunUntilTestCase::Count, this);
+  Simulator::Schedule (Seconds (2), &SimulatorRunUntilTestCase::Count, this);
+  Simulator::Schedule (Seconds (3), &SimulatorRunUntilTestCase::CountAndStop, this);
+  Simulator::Schedule (Seconds (4), &SimulatorRunUntilTestCase::Count, this);
+
+  NS_TEST_EXPECT_MSG_EQ (Simulator::RunUntil (Seconds (2)), 1, "Events at the bound must not run");
+  NS_TEST_EXPECT_MSG_EQ (m_count, 1, "");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::Now (), Seconds (1), "Time must stay at the last event");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::RunUntil (Seconds (2)), 0, "Nothing left before the bound");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::RunUntil (Seconds (3)), 2, "");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::RunUntil (Seconds (10)), 1, "Stop must end the run");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::IsFinished (), true, "");
+  NS_TEST_EXPECT_MSG_EQ (Simulator::RunUntil (Seconds (10)), 0, "A stopped simulation must not run");
+  NS_TEST_EXPECT_MSG_EQ (m_count, 4, "");
+
+  Simulator::Destroy ();
+  return false;
+}
+
 class SimulatorTestSuite : public TestSuite
 {
 public:
@@ -836,6 +891,7 @@ public:
     AddTestCase (new SimulatorEventsTestCase (factory));
     factory.SetTypeId (Ns2CalendarScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory));
+    AddTestCase (new SimulatorRunUntilTestCase ());
   }
 } g_simulatorTestSuite;
 
@@ -123,6 +123,17 @@ public:
    */
   static void RunOneEvent (void);
 
+  /**
+   * \param time absolute time bound of the run
+   * \returns the number of events processed
+   *
+   * Process all the events which expire strictly before time, unless
+   * Simulator::Stop is called or no events are left. Unlike
+   * Simulator::Stop (Time), no stop event is scheduled and the
+   * simulation can be resumed with another call.
+   */
+  static uint64_t RunUntil (Time const &time);
+
   /**
    * If an event invokes this method, it will be the last
    * event scheduled by the Simulator::run method before
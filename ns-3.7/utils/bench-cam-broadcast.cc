@@ -0,0 +1,209 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2009-2010, EU FP7 iTETRIS project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Reproduces the packet handling of a CAM broadcast in a dense scenario:
+ * every node sends one CAM carrying the iTETRIS tags and the radio channel
+ * hands a copy of it to every other node, which peeks and strips it as the
+ * wifi and c2c layers do. Reports the copies per second and the allocation
+ * counters of the packet pool.
+ */
+
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/packet.h"
+#include "ns3/packet-pool.h"
+#include "ns3/node-id-tag.h"
+#include "ns3/time-step-tag.h"
+#include "ns3/TStep-sequence-number-tag.h"
+#include "ns3/channel-tag.h"
+#include "ns3/tx-power-tag.h"
+#include "ns3/mcs-tag.h"
+#include "ns3/app-index-tag.h"
+#include <iostream>
+#include <string>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/* Stands for the c2c common and wifi mac headers of a CAM */
+class CamHeader : public Header
+{
+public:
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual void Print (std::ostream &os) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+
+  uint32_t m_source;
+};
+
+TypeId
+CamHeader::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CamHeader")
+    .SetParent<Header> ()
+    ;
+  return tid;
+}
+TypeId
+CamHeader::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+void
+CamHeader::Print (std::ostream &os) const
+{
+  os << "source=" << m_source;
+}
+uint32_t
+CamHeader::GetSerializedSize (void) const
+{
+  return 60;
+}
+void
+CamHeader::Serialize (Buffer::Iterator start) const
+{
+  start.WriteHtonU32 (m_source);
+  for (uint32_t i = 4; i < GetSerializedSize (); i++)
+    {
+      start.WriteU8 (i);
+    }
+}
+uint32_t
+CamHeader::Deserialize (Buffer::Iterator start)
+{
+  m_source = start.ReadNtohU32 ();
+  start.Next (GetSerializedSize () - 4);
+  return GetSerializedSize ();
+}
+
+static Ptr<Packet>
+CreateCam (uint32_t source, uint32_t payloadSize, uint32_t timeStep)
+{
+  Ptr<Packet> packet = Create<Packet> (payloadSize);
+  CamHeader header;
+  header.m_source = source;
+  packet->AddHeader (header);
+
+  NodeIdTag nodeIdTag;
+  nodeIdTag.Set (source);
+  packet->AddPacketTag (nodeIdTag);
+  TimeStepTag timeStepTag;
+  timeStepTag.Set (timeStep);
+  packet->AddPacketTag (timeStepTag);
+  TStepSequenceNumberTag sequenceTag;
+  sequenceTag.Set (source);
+  packet->AddPacketTag (sequenceTag);
+  ChannelTag channelTag;
+  channelTag.Set (178);
+  packet->AddPacketTag (channelTag);
+  TxPowerTag txPowerTag;
+  txPowerTag.Set (20);
+  packet->AddPacketTag (txPowerTag);
+  McsTag mcsTag;
+  mcsTag.Set (3);
+  packet->AddPacketTag (mcsTag);
+  AppIndexTag appIndexTag;
+  appIndexTag.Set (0);
+  packet->AddPacketTag (appIndexTag);
+  return packet;
+}
+
+static void
+Receive (Ptr<Packet> packet)
+{
+  ChannelTag channelTag;
+  packet->PeekPacketTag (channelTag);
+  McsTag mcsTag;
+  packet->PeekPacketTag (mcsTag);
+  TxPowerTag txPowerTag;
+  packet->RemovePacketTag (txPowerTag);
+  CamHeader header;
+  packet->RemoveHeader (header);
+  AppIndexTag appIndexTag;
+  packet->PeekPacketTag (appIndexTag);
+}
+
+static void
+PrintHelp (void)
+{
+  std::cout << "bench-cam-broadcast -n=<nodes> -r=<rounds> -s=<payloadSize>" << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t nNodes = 1000;
+  uint32_t nRounds = 1;
+  uint32_t payloadSize = 100;
+  while (argc > 1)
+    {
+      std::string arg = argv[1];
+      if (arg.find ("-n=") == 0)
+        {
+          nNodes = atoi (arg.c_str () + 3);
+        }
+      else if (arg.find ("-r=") == 0)
+        {
+          nRounds = atoi (arg.c_str () + 3);
+        }
+      else if (arg.find ("-s=") == 0)
+        {
+          payloadSize = atoi (arg.c_str () + 3);
+        }
+      else
+        {
+          PrintHelp ();
+          return 0;
+        }
+      argc--;
+      argv++;
+    }
+
+  PacketPool::ResetStats ();
+  uint64_t copies = 0;
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t round = 0; round < nRounds; round++)
+    {
+      for (uint32_t sender = 0; sender < nNodes; sender++)
+        {
+          Ptr<Packet> cam = CreateCam (sender, payloadSize, round);
+          for (uint32_t receiver = 0; receiver < nNodes; receiver++)
+            {
+              if (receiver == sender)
+                {
+                  continue;
+                }
+              Receive (cam->Copy ());
+              copies++;
+            }
+        }
+    }
+  unsigned long long ms = time.End ();
+
+  double seconds = ms / 1000.0;
+  std::cout << "nodes=" << nNodes << " rounds=" << nRounds << " copies=" << copies
+            << " time=" << ms << " ms (" << (seconds > 0 ? copies / seconds : 0) << " copies/s)" << std::endl;
+  std::cout << "pool ";
+  PacketPool::PrintStats (std::cout);
+  std::cout << std::endl;
+
+  return 0;
+}
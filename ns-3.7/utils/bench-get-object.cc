@@ -0,0 +1,214 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2009-2010, EU FP7 iTETRIS project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Measures the cost of Object::GetObject on aggregates shaped like the
+ * nodes of an iTETRIS vehicle (node, mobility, location table, c2c and IP
+ * stacks, facilities, ...): the lookups of the first object, of objects
+ * further in the aggregate, of a parent type, of a missing type and of
+ * several types in turn, as the radio channels and the geo-routing do for
+ * every packet.
+ */
+
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/object.h"
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+class BenchBase : public Object
+{
+public:
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ns3::BenchBase")
+      .SetParent<Object> ()
+      ;
+    return tid;
+  }
+};
+
+template <int N>
+class BenchObject : public BenchBase
+{
+public:
+  static TypeId GetTypeId (void);
+private:
+  static std::string GetTypeName (void);
+};
+
+template <int N>
+std::string
+BenchObject<N>::GetTypeName (void)
+{
+  std::ostringstream oss;
+  oss << "ns3::BenchObject<" << N << ">";
+  return oss.str ();
+}
+
+template <int N>
+TypeId
+BenchObject<N>::GetTypeId (void)
+{
+  static TypeId tid = TypeId (GetTypeName ().c_str ())
+    .SetParent<BenchBase> ()
+    ;
+  return tid;
+}
+
+/* Never aggregated */
+class BenchMissing : public Object
+{
+public:
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("ns3::BenchMissing")
+      .SetParent<Object> ()
+      ;
+    return tid;
+  }
+};
+
+static Ptr<Object>
+CreateAggregate (void)
+{
+  Ptr<Object> node = CreateObject<BenchObject<0> > ();
+  node->AggregateObject (CreateObject<BenchObject<1> > ());
+  node->AggregateObject (CreateObject<BenchObject<2> > ());
+  node->AggregateObject (CreateObject<BenchObject<3> > ());
+  node->AggregateObject (CreateObject<BenchObject<4> > ());
+  node->AggregateObject (CreateObject<BenchObject<5> > ());
+  node->AggregateObject (CreateObject<BenchObject<6> > ());
+  node->AggregateObject (CreateObject<BenchObject<7> > ());
+  node->AggregateObject (CreateObject<BenchObject<8> > ());
+  node->AggregateObject (CreateObject<BenchObject<9> > ());
+  return node;
+}
+
+template <typename T>
+static void
+RunBench (std::vector<Ptr<Object> > &aggregates, uint32_t n, char const *name)
+{
+  uint32_t found = 0;
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      for (std::vector<Ptr<Object> >::const_iterator j = aggregates.begin (); j != aggregates.end (); j++)
+        {
+          if ((*j)->GetObject<T> () != 0)
+            {
+              found++;
+            }
+        }
+    }
+  unsigned long long ms = time.End ();
+  double lookups = (double)n * aggregates.size ();
+  std::cout << name << "=" << ms << " ms (" << (ms * 1000000.0 / lookups) << " ns/lookup, "
+            << found << " found)" << std::endl;
+}
+
+/* The lookups of several types in turn, as the successive layers of a stack do */
+static void
+RunMixedBench (std::vector<Ptr<Object> > &aggregates, uint32_t n)
+{
+  uint32_t found = 0;
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      for (std::vector<Ptr<Object> >::const_iterator j = aggregates.begin (); j != aggregates.end (); j++)
+        {
+          if ((*j)->GetObject<BenchObject<3> > () != 0)
+            {
+              found++;
+            }
+          if ((*j)->GetObject<BenchObject<6> > () != 0)
+            {
+              found++;
+            }
+          if ((*j)->GetObject<BenchObject<9> > () != 0)
+            {
+              found++;
+            }
+          if ((*j)->GetObject<BenchMissing> () != 0)
+            {
+              found++;
+            }
+        }
+    }
+  unsigned long long ms = time.End ();
+  double lookups = 4.0 * n * aggregates.size ();
+  std::cout << "mixed=" << ms << " ms (" << (ms * 1000000.0 / lookups) << " ns/lookup, "
+            << found << " found)" << std::endl;
+}
+
+static void
+PrintHelp (void)
+{
+  std::cout << "bench-get-object -a=<aggregates> -n=<rounds>" << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t nAggregates = 1000;
+  uint32_t n = 10000;
+  while (argc > 1)
+    {
+      std::string arg = argv[1];
+      if (arg.find ("-a=") == 0)
+        {
+          nAggregates = atoi (arg.c_str () + 3);
+        }
+      else if (arg.find ("-n=") == 0)
+        {
+          n = atoi (arg.c_str () + 3);
+        }
+      else
+        {
+          PrintHelp ();
+          return 0;
+        }
+      argc--;
+      argv++;
+    }
+
+  std::vector<Ptr<Object> > aggregates;
+  for (uint32_t i = 0; i < nAggregates; i++)
+    {
+      aggregates.push_back (CreateAggregate ());
+    }
+  std::cout << "aggregates=" << nAggregates << " rounds=" << n << std::endl;
+
+  RunBench<BenchObject<0> > (aggregates, n, "first");
+  RunBench<BenchObject<5> > (aggregates, n, "middle");
+  RunBench<BenchObject<9> > (aggregates, n, "last");
+  RunBench<BenchBase> (aggregates, n, "parent");
+  RunBench<BenchMissing> (aggregates, n, "missing");
+  RunMixedBench (aggregates, n);
+
+  for (std::vector<Ptr<Object> >::const_iterator i = aggregates.begin (); i != aggregates.end (); i++)
+    {
+      (*i)->Dispose ();
+    }
+  return 0;
+}
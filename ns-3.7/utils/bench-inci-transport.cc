@@ -0,0 +1,177 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2009-2010, EU FP7 iTETRIS project
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ * Measures the number of iNCI-style request/response exchanges per second
+ * between two processes, over loopback TCP and over the shared memory channel.
+ * The server side runs in a forked child, as ns-3 would; the parent plays the iCS.
+ */
+
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/server-socket.h"
+#include "ns3/storage.h"
+#include <iostream>
+#include <string>
+#include <stdlib.h> // for exit ()
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace ns3;
+using namespace tcpip;
+
+static void
+RunServer (std::string host, int port, uint32_t n, uint32_t size)
+{
+  ServerSocket socket (host, port);
+  socket.accept ();
+  Storage in;
+  Storage out;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      socket.receiveExact (in);
+      out.reset ();
+      for (uint32_t j = 0; j < size; j++)
+        {
+          out.writeUnsignedByte (j & 0xff);
+        }
+      socket.sendExact (out);
+    }
+  socket.close ();
+}
+
+static void
+RunClient (std::string host, int port, uint32_t n, uint32_t size, const char *name)
+{
+  ServerSocket socket (host, port);
+  // Give the server time to listen / create the segment
+  for (int retry = 0; ; retry++)
+    {
+      try
+        {
+          socket.connect ();
+          break;
+        }
+      catch (SocketException e)
+        {
+          if (retry == 100)
+            {
+              std::cerr << name << ": unable to connect: " << e.what () << std::endl;
+              exit (1);
+            }
+          usleep (50000);
+        }
+    }
+
+  Storage out;
+  Storage in;
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      out.reset ();
+      for (uint32_t j = 0; j < size; j++)
+        {
+          out.writeUnsignedByte (j & 0xff);
+        }
+      socket.sendExact (out);
+      socket.receiveExact (in);
+    }
+  unsigned long long ms = time.End ();
+  socket.close ();
+
+  double seconds = ms / 1000.0;
+  std::cout << name << "=" << n << " round trips of " << size << " bytes in "
+            << ms << " ms (" << (seconds > 0 ? n / seconds : 0) << " round trips/s, "
+            << (seconds > 0 ? 2 * n / seconds : 0) << " messages/s)" << std::endl;
+}
+
+static void
+Bench (std::string host, int port, uint32_t n, uint32_t size, const char *name)
+{
+  pid_t pid = fork ();
+  if (pid < 0)
+    {
+      std::cerr << "fork failed" << std::endl;
+      exit (1);
+    }
+  if (pid == 0)
+    {
+      try
+        {
+          RunServer (host, port, n, size);
+        }
+      catch (SocketException e)
+        {
+          std::cerr << name << " server: " << e.what () << std::endl;
+          _exit (1);
+        }
+      _exit (0);
+    }
+  try
+    {
+      RunClient (host, port, n, size, name);
+    }
+  catch (SocketException e)
+    {
+      std::cerr << name << " client: " << e.what () << std::endl;
+    }
+  int status;
+  waitpid (pid, &status, 0);
+}
+
+static void
+PrintHelp (void)
+{
+  std::cout << "bench-inci-transport -n=<nExchanges> -s=<messageSize> -p=<port>" << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 100000;
+  uint32_t size = 32;
+  int port = 8890;
+  while (argc > 1)
+    {
+      std::string arg = argv[1];
+      if (arg.find ("-n=") == 0)
+        {
+          n = atoi (arg.c_str () + 3);
+        }
+      else if (arg.find ("-s=") == 0)
+        {
+          size = atoi (arg.c_str () + 3);
+        }
+      else if (arg.find ("-p=") == 0)
+        {
+          port = atoi (arg.c_str () + 3);
+        }
+      else
+        {
+          PrintHelp ();
+          return 0;
+        }
+      argc--;
+      argv++;
+    }
+
+  Bench ("localhost", port, n, size, "tcp-loopback");
+  Bench ("shm://bench", port, n, size, "shared-memory");
+
+  return 0;
+}